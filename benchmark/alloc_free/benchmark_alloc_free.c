@@ -10,6 +10,7 @@
 #include "benchmark_memory_pool.h"
 #include "benchmark_sowr_memory_pool.h"
 #include "benchmark_ts_memory_pool.h"
+#include "benchmark_slab_allocator.h"
 
 int main(int argc, char *argv[])
 {
@@ -272,5 +273,113 @@ int main(int argc, char *argv[])
 		muggle_ts_memory_pool_destroy(&pool);
 	}
 
+	// growable pool start with small chunk, grow until reach high water mark
+	int growable_threads[][2] = { {1, 1}, {4, 1}, {4, 4} };
+	for (int i = 0; i < sizeof(data_size)/sizeof(data_size[0]); i++)
+	{
+		for (int j = 0; j < sizeof(growable_threads)/sizeof(growable_threads[0]); j++)
+		{
+			muggle_ts_memory_pool_t pool;
+
+			MUGGLE_LOG_INFO("=======================================================");
+			muggle_ts_memory_pool_init_ex(&pool, mul_thread_pool_capacity / 16, data_size[i],
+				MUGGLE_TS_MEMORY_POOL_FLAG_GROWABLE);
+
+			snprintf(name, sizeof(name), "ts_growable_alloc_%d_free_%d_%d_%dbyte",
+				growable_threads[j][0], growable_threads[j][1], alloc_free_num, data_size[i]);
+			args.cnt_blocks = alloc_free_num;
+			args.allocator = &pool;
+			args.data_size = data_size[i];
+			args.cb_alloc = run_ts_memory_pool_alloc;
+			args.cb_free = run_ts_memory_pool_free;
+			args.num_alloc_threads = growable_threads[j][0];
+			args.num_free_threads = growable_threads[j][1];
+			run_alloc_free_benchmark(name, &args);
+
+			muggle_pool_stats_t stats;
+			muggle_ts_memory_pool_get_stats(&pool, &stats);
+			MUGGLE_LOG_INFO("%s: capacity=%d, high_water_mark=%d, fail_cnt=%d, grow_cnt=%d",
+				name, (int)stats.capacity, (int)stats.high_water_mark,
+				(int)stats.fail_cnt, (int)stats.grow_cnt);
+
+			muggle_ts_memory_pool_destroy(&pool);
+		}
+	}
+
+	for (int i = 0; i < sizeof(data_size)/sizeof(data_size[0]); i++)
+	{
+		muggle_slab_allocator_t slab;
+		muggle_slab_allocator_init(&slab);
+
+		MUGGLE_LOG_INFO("=======================================================");
+		snprintf(name, sizeof(name), "same_thread_slab_%d_%dbyte", alloc_free_num, data_size[i]);
+		args.cnt_blocks = alloc_free_num;
+		args.allocator = &slab;
+		args.data_size = data_size[i];
+		args.cb_alloc = run_slab_allocator_alloc;
+		args.cb_free = run_slab_allocator_free;
+		args.num_alloc_threads = 0;
+		args.num_free_threads = 0;
+		run_alloc_free_benchmark(name, &args);
+
+		MUGGLE_LOG_INFO("=======================================================");
+		snprintf(name, sizeof(name), "slab_alloc_1_free_1_%d_%dbyte", alloc_free_num, data_size[i]);
+		args.cnt_blocks = alloc_free_num;
+		args.allocator = &slab;
+		args.data_size = data_size[i];
+		args.cb_alloc = run_slab_allocator_alloc;
+		args.cb_free = run_slab_allocator_free;
+		args.num_alloc_threads = 1;
+		args.num_free_threads = 1;
+		run_alloc_free_benchmark(name, &args);
+
+		MUGGLE_LOG_INFO("=======================================================");
+		snprintf(name, sizeof(name), "slab_alloc_2_free_1_%d_%dbyte", alloc_free_num, data_size[i]);
+		args.cnt_blocks = alloc_free_num;
+		args.allocator = &slab;
+		args.data_size = data_size[i];
+		args.cb_alloc = run_slab_allocator_alloc;
+		args.cb_free = run_slab_allocator_free;
+		args.num_alloc_threads = 2;
+		args.num_free_threads = 1;
+		run_alloc_free_benchmark(name, &args);
+
+		MUGGLE_LOG_INFO("=======================================================");
+		snprintf(name, sizeof(name), "slab_alloc_4_free_1_%d_%dbyte", alloc_free_num, data_size[i]);
+		args.cnt_blocks = alloc_free_num;
+		args.allocator = &slab;
+		args.data_size = data_size[i];
+		args.cb_alloc = run_slab_allocator_alloc;
+		args.cb_free = run_slab_allocator_free;
+		args.num_alloc_threads = 4;
+		args.num_free_threads = 1;
+		run_alloc_free_benchmark(name, &args);
+
+		MUGGLE_LOG_INFO("=======================================================");
+		snprintf(name, sizeof(name), "slab_alloc_2_free_2_%d_%dbyte", alloc_free_num, data_size[i]);
+		args.cnt_blocks = alloc_free_num;
+		args.allocator = &slab;
+		args.data_size = data_size[i];
+		args.cb_alloc = run_slab_allocator_alloc;
+		args.cb_free = run_slab_allocator_free;
+		args.num_alloc_threads = 2;
+		args.num_free_threads = 2;
+		run_alloc_free_benchmark(name, &args);
+
+		MUGGLE_LOG_INFO("=======================================================");
+		snprintf(name, sizeof(name), "slab_alloc_4_free_4_%d_%dbyte", alloc_free_num, data_size[i]);
+		args.cnt_blocks = alloc_free_num;
+		args.allocator = &slab;
+		args.data_size = data_size[i];
+		args.cb_alloc = run_slab_allocator_alloc;
+		args.cb_free = run_slab_allocator_free;
+		args.num_alloc_threads = 4;
+		args.num_free_threads = 4;
+		run_alloc_free_benchmark(name, &args);
+
+		muggle_slab_allocator_flush(&slab);
+		muggle_slab_allocator_destroy(&slab);
+	}
+
 	return 0;
 }
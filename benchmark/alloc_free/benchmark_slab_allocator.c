@@ -0,0 +1,19 @@
+/*
+ *	author: muggle wei <mugglewei@gmail.com>
+ *
+ *	Use of this source code is governed by the MIT license that can be
+ *	found in the LICENSE file.
+ */
+
+#include "benchmark_slab_allocator.h"
+
+void* run_slab_allocator_alloc(void *allocator, size_t size)
+{
+	muggle_slab_allocator_t *slab = (muggle_slab_allocator_t*)allocator;
+	return muggle_slab_allocator_alloc(slab, size);
+}
+
+void run_slab_allocator_free(void *allocator, void *data)
+{
+	muggle_slab_allocator_free(data);
+}
@@ -0,0 +1,17 @@
+/*
+ *	author: muggle wei <mugglewei@gmail.com>
+ *
+ *	Use of this source code is governed by the MIT license that can be
+ *	found in the LICENSE file.
+ */
+
+#ifndef BENCHMARK_SLAB_ALLOCATOR_H_
+#define BENCHMARK_SLAB_ALLOCATOR_H_
+
+#include "alloc_free_runner.h"
+
+void* run_slab_allocator_alloc(void *allocator, size_t size);
+
+void run_slab_allocator_free(void *allocator, void *data);
+
+#endif
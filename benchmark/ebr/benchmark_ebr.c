@@ -0,0 +1,166 @@
+/*
+ *	author: muggle wei <mugglewei@gmail.com>
+ *
+ *	Use of this source code is governed by the MIT license that can be
+ *	found in the LICENSE file.
+ */
+
+#include "muggle_benchmark/muggle_benchmark.h"
+
+/*
+ * compare cost of protect shared object in reader threads:
+ *   - ebr: muggle_ebr_enter/muggle_ebr_exit, only write thread's own record
+ *   - ref: muggle_socket_peer_retain/muggle_socket_peer_release, all readers
+ *     CAS the same reference count
+ */
+
+#define BENCHMARK_EBR_MAX_THREAD 64
+
+struct benchmark_ebr_args
+{
+	muggle_ebr_t         *ebr;
+	muggle_socket_peer_t *peer;
+	muggle_atomic_int    *ready;
+	int                  cnt_thread;
+	uint64_t             cnt_op;
+	uint64_t             sum;
+	uint64_t             elapsed_ns;
+};
+
+static uint64_t benchmark_ebr_elapsed_ns(struct timespec *start, struct timespec *end)
+{
+	return (uint64_t)(end->tv_sec - start->tv_sec) * 1000000000 + end->tv_nsec - start->tv_nsec;
+}
+
+static muggle_thread_ret_t benchmark_ebr_reader(void *p_arg)
+{
+	struct benchmark_ebr_args *args = (struct benchmark_ebr_args*)p_arg;
+
+	muggle_ebr_thread_t thread;
+	muggle_ebr_register(args->ebr, &thread);
+
+	muggle_atomic_fetch_add(args->ready, 1, muggle_memory_order_relaxed);
+	while (muggle_atomic_load(args->ready, muggle_memory_order_relaxed) != args->cnt_thread);
+
+	// accumulate locally, args of threads share cache lines
+	uint64_t sum = 0;
+	struct timespec start, end;
+	timespec_get(&start, TIME_UTC);
+	for (uint64_t i = 0; i < args->cnt_op; i++)
+	{
+		muggle_ebr_enter(&thread);
+		sum += (uint64_t)args->peer->fd;
+		muggle_ebr_exit(&thread);
+	}
+	timespec_get(&end, TIME_UTC);
+	args->sum = sum;
+	args->elapsed_ns = benchmark_ebr_elapsed_ns(&start, &end);
+
+	muggle_ebr_unregister(&thread);
+
+	return 0;
+}
+
+static muggle_thread_ret_t benchmark_ref_reader(void *p_arg)
+{
+	struct benchmark_ebr_args *args = (struct benchmark_ebr_args*)p_arg;
+
+	muggle_atomic_fetch_add(args->ready, 1, muggle_memory_order_relaxed);
+	while (muggle_atomic_load(args->ready, muggle_memory_order_relaxed) != args->cnt_thread);
+
+	// accumulate locally, args of threads share cache lines
+	uint64_t sum = 0;
+	struct timespec start, end;
+	timespec_get(&start, TIME_UTC);
+	for (uint64_t i = 0; i < args->cnt_op; i++)
+	{
+		muggle_socket_peer_retain(args->peer);
+		sum += (uint64_t)args->peer->fd;
+		muggle_socket_peer_release(args->peer);
+	}
+	timespec_get(&end, TIME_UTC);
+	args->sum = sum;
+	args->elapsed_ns = benchmark_ebr_elapsed_ns(&start, &end);
+
+	return 0;
+}
+
+static void benchmark_ebr_run(const char *name, muggle_thread_routine routine, int cnt_thread, uint64_t cnt_op)
+{
+	muggle_ebr_t ebr;
+	muggle_ebr_init(&ebr);
+
+	// main thread hold a reference during the benchmark, peer is never closed
+	muggle_socket_peer_t peer;
+	muggle_socket_peer_init(&peer, MUGGLE_INVALID_SOCKET, MUGGLE_SOCKET_PEER_TYPE_NULL, NULL, 0);
+
+	muggle_atomic_int ready = 0;
+	muggle_thread_t threads[BENCHMARK_EBR_MAX_THREAD];
+	struct benchmark_ebr_args args[BENCHMARK_EBR_MAX_THREAD];
+	for (int i = 0; i < cnt_thread; i++)
+	{
+		memset(&args[i], 0, sizeof(args[i]));
+		args[i].ebr = &ebr;
+		args[i].peer = &peer;
+		args[i].ready = &ready;
+		args[i].cnt_thread = cnt_thread;
+		args[i].cnt_op = cnt_op;
+		muggle_thread_create(&threads[i], routine, &args[i]);
+	}
+
+	uint64_t elapsed_ns = 0;
+	for (int i = 0; i < cnt_thread; i++)
+	{
+		muggle_thread_join(&threads[i]);
+		elapsed_ns += args[i].elapsed_ns;
+	}
+
+	MUGGLE_LOG_INFO("%s: threads=%d, op per thread=%llu, avg %.2f ns/op",
+		name, cnt_thread, (unsigned long long)cnt_op,
+		(double)elapsed_ns / (double)(cnt_op * cnt_thread));
+
+	muggle_ebr_destroy(&ebr);
+}
+
+int main(int argc, char *argv[])
+{
+	// init log
+	if (muggle_log_simple_init(MUGGLE_LOG_LEVEL_INFO, MUGGLE_LOG_LEVEL_INFO) != 0)
+	{
+		MUGGLE_LOG_ERROR("failed initalize log");
+		exit(EXIT_FAILURE);
+	}
+
+	uint64_t cnt_op = 1000000;
+	if (argc > 1)
+	{
+		cnt_op = (uint64_t)strtoull(argv[1], NULL, 10);
+	}
+
+	int hc = muggle_thread_hardware_concurrency();
+	if (hc <= 0)
+	{
+		hc = 2;
+	}
+	if (hc > BENCHMARK_EBR_MAX_THREAD)
+	{
+		hc = BENCHMARK_EBR_MAX_THREAD;
+	}
+
+	// 1, 2, 4 ... threads, the last round use all cores
+	for (int cnt_thread = 1; ; cnt_thread *= 2)
+	{
+		if (cnt_thread > hc)
+		{
+			cnt_thread = hc;
+		}
+		benchmark_ebr_run("ebr enter/exit", benchmark_ebr_reader, cnt_thread, cnt_op);
+		benchmark_ebr_run("peer retain/release", benchmark_ref_reader, cnt_thread, cnt_op);
+		if (cnt_thread == hc)
+		{
+			break;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,150 @@
+/*
+ *	author: muggle wei <mugglewei@gmail.com>
+ *
+ *	Use of this source code is governed by the MIT license that can be
+ *	found in the LICENSE file.
+ */
+
+#include "muggle_benchmark/muggle_benchmark.h"
+
+/*
+ * compare caller side latency of async log handles:
+ *   - async: format message in caller thread, copy it into async message
+ *   - async deferred: only encode arguments and cpu cycle in caller thread,
+ *     format message in backend thread
+ */
+
+#define BENCHMARK_LOG_MAX_THREAD 64
+
+#if MUGGLE_PLATFORM_WINDOWS
+	#define BENCHMARK_LOG_NULL_PATH "NUL"
+#else
+	#define BENCHMARK_LOG_NULL_PATH "/dev/null"
+#endif
+
+struct benchmark_log_args
+{
+	muggle_log_category_t *category;
+	muggle_atomic_int     *ready;
+	int                   cnt_thread;
+	uint64_t              cnt_msg;
+	uint64_t              elapsed_ns;
+};
+
+static uint64_t benchmark_log_elapsed_ns(struct timespec *start, struct timespec *end)
+{
+	return (uint64_t)(end->tv_sec - start->tv_sec) * 1000000000 + end->tv_nsec - start->tv_nsec;
+}
+
+static muggle_thread_ret_t benchmark_log_writer(void *p_arg)
+{
+	struct benchmark_log_args *args = (struct benchmark_log_args*)p_arg;
+
+	muggle_atomic_fetch_add(args->ready, 1, muggle_memory_order_relaxed);
+	while (muggle_atomic_load(args->ready, muggle_memory_order_relaxed) != args->cnt_thread);
+
+	struct timespec start, end;
+	timespec_get(&start, TIME_UTC);
+	for (uint64_t i = 0; i < args->cnt_msg; i++)
+	{
+		MUGGLE_LOG(args->category, MUGGLE_LOG_LEVEL_INFO,
+			"benchmark log message: id=%llu, name=%s, value=%.3f",
+			(unsigned long long)i, "muggle", (double)i * 0.001);
+	}
+	timespec_get(&end, TIME_UTC);
+	args->elapsed_ns = benchmark_log_elapsed_ns(&start, &end);
+
+	return 0;
+}
+
+static void benchmark_log_run(const char *name, int write_type, int cnt_thread, uint64_t cnt_msg)
+{
+	muggle_log_handle_t handle;
+	int ret = muggle_log_handle_file_init(
+		&handle, write_type,
+		MUGGLE_LOG_FMT_LEVEL | MUGGLE_LOG_FMT_FILE | MUGGLE_LOG_FMT_TIME | MUGGLE_LOG_FMT_THREAD,
+		MUGGLE_LOG_LEVEL_INFO, 1024 * 64, NULL, NULL, BENCHMARK_LOG_NULL_PATH);
+	if (ret != MUGGLE_OK)
+	{
+		MUGGLE_LOG_ERROR("failed init log handle: %s", name);
+		return;
+	}
+
+	muggle_log_category_t category;
+	memset(&category, 0, sizeof(category));
+	category.lowest_log_level = MUGGLE_LOG_LEVEL_FATAL + 1;
+	muggle_log_category_add(&category, &handle);
+
+	muggle_atomic_int ready = 0;
+	muggle_thread_t threads[BENCHMARK_LOG_MAX_THREAD];
+	struct benchmark_log_args args[BENCHMARK_LOG_MAX_THREAD];
+	for (int i = 0; i < cnt_thread; i++)
+	{
+		memset(&args[i], 0, sizeof(args[i]));
+		args[i].category = &category;
+		args[i].ready = &ready;
+		args[i].cnt_thread = cnt_thread;
+		args[i].cnt_msg = cnt_msg;
+		muggle_thread_create(&threads[i], benchmark_log_writer, &args[i]);
+	}
+
+	uint64_t elapsed_ns = 0;
+	for (int i = 0; i < cnt_thread; i++)
+	{
+		muggle_thread_join(&threads[i]);
+		elapsed_ns += args[i].elapsed_ns;
+	}
+
+	struct timespec start, end;
+	timespec_get(&start, TIME_UTC);
+	muggle_log_category_destroy(&category, 1);
+	timespec_get(&end, TIME_UTC);
+
+	MUGGLE_LOG_INFO("%s: threads=%d, msg per thread=%llu, caller avg %.2f ns/msg, drain %.3f ms",
+		name, cnt_thread, (unsigned long long)cnt_msg,
+		(double)elapsed_ns / (double)(cnt_msg * cnt_thread),
+		(double)benchmark_log_elapsed_ns(&start, &end) / 1000000.0);
+}
+
+int main(int argc, char *argv[])
+{
+	// init log
+	if (muggle_log_simple_init(MUGGLE_LOG_LEVEL_INFO, MUGGLE_LOG_LEVEL_INFO) != 0)
+	{
+		MUGGLE_LOG_ERROR("failed initalize log");
+		exit(EXIT_FAILURE);
+	}
+
+	uint64_t cnt_msg = 100000;
+	if (argc > 1)
+	{
+		cnt_msg = (uint64_t)strtoull(argv[1], NULL, 10);
+	}
+
+	int hc = muggle_thread_hardware_concurrency();
+	if (hc <= 0)
+	{
+		hc = 2;
+	}
+	if (hc > BENCHMARK_LOG_MAX_THREAD)
+	{
+		hc = BENCHMARK_LOG_MAX_THREAD;
+	}
+
+	// 1, 2, 4 ... threads, the last round use all cores
+	for (int cnt_thread = 1; ; cnt_thread *= 2)
+	{
+		if (cnt_thread > hc)
+		{
+			cnt_thread = hc;
+		}
+		benchmark_log_run("async", MUGGLE_LOG_WRITE_TYPE_ASYNC, cnt_thread, cnt_msg);
+		benchmark_log_run("async deferred", MUGGLE_LOG_WRITE_TYPE_ASYNC_DEFERRED, cnt_thread, cnt_msg);
+		if (cnt_thread == hc)
+		{
+			break;
+		}
+	}
+
+	return 0;
+}
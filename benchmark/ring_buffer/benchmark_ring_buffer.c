@@ -25,6 +25,16 @@ struct producer_thread_args
 	int cnt_consumer;
 	uint64_t start_idx;
 	uint64_t end_idx;
+	int burst;
+};
+
+struct consumer_n_thread_args
+{
+	muggle_ring_buffer_t *ring;
+	muggle_atomic_int *consumer_ready;
+	muggle_atomic_int *consumer_exit;
+	int flag;
+	int burst;
 };
 
 muggle_thread_ret_t consumer_thread(void *void_arg)
@@ -81,6 +91,90 @@ muggle_thread_ret_t producer_thread(void *void_arg)
 	return 0;
 }
 
+muggle_thread_ret_t consumer_n_thread(void *void_arg)
+{
+	struct consumer_n_thread_args *arg = (struct consumer_n_thread_args*)void_arg;
+
+	muggle_atomic_int consumer_idx = muggle_atomic_fetch_add(arg->consumer_ready, 1, muggle_memory_order_relaxed);
+	void **datas = (void**)malloc(sizeof(void*) * arg->burst);
+	muggle_atomic_int pos = 0;
+	uint64_t idx = 0;
+	int running = 1;
+	while (running)
+	{
+		muggle_atomic_int n = muggle_ring_buffer_read_n(arg->ring, pos, datas, (muggle_atomic_int)arg->burst);
+		pos += n;
+		for (muggle_atomic_int i = 0; i < n; ++i)
+		{
+			muggle_benchmark_block_t *block = (muggle_benchmark_block_t*)datas[i];
+			if (!block)
+			{
+				running = 0;
+				break;
+			}
+			if (consumer_idx == 0 || (arg->flag & MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE))
+			{
+				timespec_get(&block->ts[2], TIME_UTC);
+			}
+			++idx;
+		}
+	}
+	consumer_read_num[consumer_idx] = idx;
+	free(datas);
+
+	muggle_atomic_fetch_add(arg->consumer_exit, 1, muggle_memory_order_release);
+
+	return 0;
+}
+
+muggle_thread_ret_t producer_n_thread(void *void_arg)
+{
+	struct producer_thread_args *arg = (struct producer_thread_args*)void_arg;
+	void **datas = (void**)malloc(sizeof(void*) * arg->burst);
+
+	while (muggle_atomic_load(arg->consumer_ready, muggle_memory_order_relaxed) != arg->cnt_consumer);
+
+	for (uint64_t i = 0; i < arg->config->loop; ++i)
+	{
+		for (uint64_t j = arg->start_idx; j < arg->end_idx; j += arg->burst)
+		{
+			uint64_t cnt = arg->end_idx - j;
+			if (cnt > (uint64_t)arg->burst)
+			{
+				cnt = (uint64_t)arg->burst;
+			}
+
+			uint64_t base = i * arg->config->cnt_per_loop + j;
+			for (uint64_t k = 0; k < cnt; ++k)
+			{
+				uint64_t idx = base + k;
+				memset(&arg->blocks[idx], 0, sizeof(muggle_benchmark_block_t));
+				arg->blocks[idx].idx = idx;
+				datas[k] = &arg->blocks[idx];
+				timespec_get(&arg->blocks[idx].ts[0], TIME_UTC);
+			}
+
+			muggle_ring_buffer_write_n(arg->ring, datas, (muggle_atomic_int)cnt);
+
+			struct timespec ts;
+			timespec_get(&ts, TIME_UTC);
+			for (uint64_t k = 0; k < cnt; ++k)
+			{
+				arg->blocks[base + k].ts[1] = ts;
+			}
+		}
+		if (arg->config->loop_interval_ms > 0)
+		{
+			muggle_msleep((unsigned long)arg->config->loop_interval_ms);
+		}
+	}
+
+	free(datas);
+	free(arg);
+
+	return 0;
+}
+
 void get_case_name(char *buf, size_t max_len, int cnt_producer, int cnt_consumer, int w_mode, int r_mode)
 {
 	const char *str_w_mode[] = {
@@ -92,7 +186,8 @@ void get_case_name(char *buf, size_t max_len, int cnt_producer, int cnt_consumer
 		"wait",
 		"single_wait",
 		"busy_loop",
-		"lock"
+		"lock",
+		"adaptive"
 	};
 
 	snprintf(buf, max_len, "%dw%s-%dr%s",
@@ -110,7 +205,7 @@ void Benchmark_wr(FILE *fp, muggle_benchmark_config_t *config, int cnt_producer,
 
 	muggle_ring_buffer_t ring;
 	muggle_ring_buffer_init(&ring, 1024 * 16, flag);
-	char case_name[1024];
+	char case_name[128];
 	get_case_name(case_name, sizeof(case_name)-1, cnt_producer, cnt_consumer, ring.write_mode, ring.read_mode);
 
 	printf("launch %s\n", case_name);
@@ -171,7 +266,7 @@ void Benchmark_wr(FILE *fp, muggle_benchmark_config_t *config, int cnt_producer,
 	free(consumers);
 	muggle_ring_buffer_destroy(&ring);
 
-	char buf[128];
+	char buf[256];
 
 	if (flag & MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE)
 	{
@@ -213,6 +308,122 @@ void Benchmark_wr(FILE *fp, muggle_benchmark_config_t *config, int cnt_producer,
 	free(blocks);
 }
 
+void Benchmark_wr_n(FILE *fp, muggle_benchmark_config_t *config, int cnt_producer, int cnt_consumer, int flag, int burst)
+{
+	uint64_t cnt = config->loop * config->cnt_per_loop;
+	muggle_benchmark_block_t *blocks = (muggle_benchmark_block_t*)malloc(cnt * sizeof(muggle_benchmark_block_t));
+	muggle_atomic_int consumer_ready = 0;
+	muggle_atomic_int consumer_exit = 0;
+
+	consumer_read_num = (uint64_t*)malloc(sizeof(uint64_t) * cnt_consumer);
+
+	muggle_ring_buffer_t ring;
+	muggle_ring_buffer_init(&ring, 1024 * 16, flag);
+	char name[128];
+	char case_name[192];
+	get_case_name(name, sizeof(name)-1, cnt_producer, cnt_consumer, ring.write_mode, ring.read_mode);
+	snprintf(case_name, sizeof(case_name)-1, "%s-burst%d", name, burst);
+
+	printf("launch %s\n", case_name);
+
+	// consumer
+	muggle_thread_t *consumers = (muggle_thread_t*)malloc(cnt_consumer * sizeof(muggle_thread_t));
+	struct consumer_n_thread_args consumer_args;
+	consumer_args.ring = &ring;
+	consumer_args.consumer_ready = &consumer_ready;
+	consumer_args.consumer_exit = &consumer_exit;
+	consumer_args.flag = flag;
+	consumer_args.burst = burst;
+	for (int i = 0; i < cnt_consumer; ++i)
+	{
+		muggle_thread_create(&consumers[i], consumer_n_thread, &consumer_args);
+	}
+
+	// producer
+	muggle_thread_t *producers = (muggle_thread_t*)malloc(cnt_producer * sizeof(muggle_thread_t));
+	for (int i = 0; i < cnt_producer; ++i)
+	{
+		struct producer_thread_args *producer_args = (struct producer_thread_args*)malloc(sizeof(struct producer_thread_args));
+		producer_args->ring = &ring;
+		producer_args->config = config;
+		producer_args->blocks = blocks;
+		producer_args->consumer_ready = &consumer_ready;
+		producer_args->cnt_consumer = cnt_consumer;
+		producer_args->start_idx = i * (config->cnt_per_loop / cnt_producer);
+		producer_args->end_idx = (i + 1) * (config->cnt_per_loop / cnt_producer);
+		producer_args->burst = burst;
+		if (i == cnt_producer - 1)
+		{
+			producer_args->end_idx = config->cnt_per_loop;
+		}
+		muggle_thread_create(&producers[i], producer_n_thread, producer_args);
+	}
+
+	for (int i = 0; i < cnt_producer; ++i)
+	{
+		muggle_thread_join(&producers[i]);
+	}
+
+	if (flag & MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE)
+	{
+		// one batch read may take more than one NULL, so keep writing
+		// until every consumer exit
+		while (muggle_atomic_load(&consumer_exit, muggle_memory_order_acquire) != cnt_consumer)
+		{
+			muggle_ring_buffer_write(&ring, NULL);
+			muggle_msleep(1);
+		}
+	}
+	else
+	{
+		muggle_ring_buffer_write(&ring, NULL);
+	}
+
+	for (int i = 0; i < cnt_consumer; ++i)
+	{
+		muggle_thread_join(&consumers[i]);
+	}
+
+	free(producers);
+	free(consumers);
+	muggle_ring_buffer_destroy(&ring);
+
+	char buf[256];
+
+	uint64_t cnt_consumer_reads = 0;
+	for (int i = 0; i < cnt_consumer; ++i)
+	{
+		cnt_consumer_reads += consumer_read_num[i];
+	}
+	if (flag & MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE)
+	{
+		printf("%s consumers read %llu %s\n",
+			case_name, (unsigned long long)cnt_consumer_reads,
+			cnt_consumer_reads == cnt ? "" : "(message loss)");
+	}
+	else
+	{
+		printf("%s consumers read %llu %s\n",
+			case_name, (unsigned long long)cnt_consumer_reads,
+			cnt_consumer_reads == cnt * cnt_consumer ? "" : "(message loss)");
+	}
+	free(consumer_read_num);
+
+	snprintf(buf, sizeof(buf) - 1, "%s-w", case_name);
+	muggle_benchmark_gen_reports_body(fp, config, blocks, buf, cnt, 0, 1, 0);
+
+	snprintf(buf, sizeof(buf) - 1, "%s-w-sorted", case_name);
+	muggle_benchmark_gen_reports_body(fp, config, blocks, buf, cnt, 0, 1, 1);
+
+	snprintf(buf, sizeof(buf) - 1, "%s-wr", case_name);
+	muggle_benchmark_gen_reports_body(fp, config, blocks, buf, cnt, 0, 2, 0);
+
+	snprintf(buf, sizeof(buf) - 1, "%s-wr-sorted", case_name);
+	muggle_benchmark_gen_reports_body(fp, config, blocks, buf, cnt, 0, 2, 1);
+
+	free(blocks);
+}
+
 int main()
 {
 	muggle_benchmark_config_t config;
@@ -257,7 +468,8 @@ int main()
 		MUGGLE_RING_BUFFER_FLAG_READ_ALL | MUGGLE_RING_BUFFER_FLAG_READ_WAIT,
 		MUGGLE_RING_BUFFER_FLAG_READ_BUSY_LOOP,
 		MUGGLE_RING_BUFFER_FLAG_SINGLE_READER | MUGGLE_RING_BUFFER_FLAG_READ_WAIT,
-		MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE 
+		MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE,
+		MUGGLE_RING_BUFFER_FLAG_READ_ADAPTIVE
 	};
 
 	for (int w_flag = 0; w_flag < (int)(sizeof(w_flags) / sizeof(w_flags[0])); ++w_flag)
@@ -286,5 +498,24 @@ int main()
 		}
 	}
 
+	// burst size sweep for batch write/read
+	int bursts[] = { 1, 16, 128, 1024 };
+	for (int w_flag = 0; w_flag < (int)(sizeof(w_flags) / sizeof(w_flags[0])); ++w_flag)
+	{
+		for (int r_flag = 0; r_flag < (int)(sizeof(r_flags) / sizeof(r_flags[0])); ++r_flag)
+		{
+			flag = w_flags[w_flag] | r_flags[r_flag];
+			for (int b = 0; b < (int)(sizeof(bursts) / sizeof(bursts[0])); ++b)
+			{
+				Benchmark_wr_n(fp, &config, 1, 1, flag, bursts[b]);
+
+				if (!(flag & MUGGLE_RING_BUFFER_FLAG_SINGLE_WRITER))
+				{
+					Benchmark_wr_n(fp, &config, hc_half, 1, flag, bursts[b]);
+				}
+			}
+		}
+	}
+
 	fclose(fp);
 }
@@ -23,6 +23,7 @@ struct producer_thread_args
 	muggle_benchmark_block_t *blocks;
 	muggle_atomic_int *consumer_ready;
 	int cnt_consumer;
+	int pool_flags;
 	uint64_t start_idx;
 	uint64_t end_idx;
 };
@@ -61,7 +62,9 @@ muggle_thread_ret_t producer_thread(void *void_arg)
 	while (muggle_atomic_load(arg->consumer_ready, muggle_memory_order_relaxed) != arg->cnt_consumer);
 
 	muggle_sowr_memory_pool_t pool;
-	muggle_sowr_memory_pool_init(&pool, (muggle_atomic_int)(arg->config->loop * (arg->end_idx - arg->start_idx) / 10), sizeof(muggle_benchmark_block_t));
+	muggle_sowr_memory_pool_init_ex(&pool,
+		(muggle_atomic_int)(arg->config->loop * (arg->end_idx - arg->start_idx) / 10),
+		sizeof(muggle_benchmark_block_t), arg->pool_flags);
 
 	for (uint64_t i = 0; i < arg->config->loop; ++i)
 	{
@@ -99,7 +102,7 @@ muggle_thread_ret_t producer_thread(void *void_arg)
 	return 0;
 }
 
-void Benchmark_wr(FILE *fp, muggle_benchmark_config_t *config, int cnt_producer, int cnt_consumer, int flag)
+void Benchmark_wr(FILE *fp, muggle_benchmark_config_t *config, int cnt_producer, int cnt_consumer, int flag, int pool_flags)
 {
 	uint64_t cnt = config->loop * config->cnt_per_loop;
 	muggle_benchmark_block_t *blocks = (muggle_benchmark_block_t*)malloc(cnt * sizeof(muggle_benchmark_block_t));
@@ -131,6 +134,7 @@ void Benchmark_wr(FILE *fp, muggle_benchmark_config_t *config, int cnt_producer,
 		producer_args->blocks = blocks;
 		producer_args->consumer_ready = &consumer_ready;
 		producer_args->cnt_consumer = cnt_consumer;
+		producer_args->pool_flags = pool_flags;
 		producer_args->start_idx = i * (config->cnt_per_loop / cnt_producer);
 		producer_args->end_idx = (i + 1) * (config->cnt_per_loop / cnt_producer);
 		if (i == cnt_producer - 1)
@@ -145,7 +149,12 @@ void Benchmark_wr(FILE *fp, muggle_benchmark_config_t *config, int cnt_producer,
 		muggle_thread_join(&producers[i]);
 	}
 
-	muggle_ring_buffer_write(&ring, NULL);
+	// every message only read once, each consumer need a stop message
+	int cnt_stop = (flag & MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE) ? cnt_consumer : 1;
+	for (int i = 0; i < cnt_stop; ++i)
+	{
+		muggle_ring_buffer_write(&ring, NULL);
+	}
 
 	for (int i = 0; i < cnt_consumer; ++i)
 	{
@@ -158,24 +167,33 @@ void Benchmark_wr(FILE *fp, muggle_benchmark_config_t *config, int cnt_producer,
 
 	char buf[128];
 
+	const char *mode = (pool_flags & MUGGLE_SOWR_MEMORY_POOL_FLAG_MULTI_FREE) ? "multi-free" : "seq-free";
+	uint64_t total_read = 0;
 	for (int i = 0; i < cnt_consumer; ++i)
 	{
-		printf("%dw%dr consumer[%d] read %llu %s\n",
-			cnt_producer, cnt_consumer, i, (unsigned long long)consumer_read_num[i],
-			consumer_read_num[i] == config->cnt_per_loop * config->loop ? "" : "(message loss)");
+		printf("%dw%dr-%s consumer[%d] read %llu %s\n",
+			cnt_producer, cnt_consumer, mode, i, (unsigned long long)consumer_read_num[i],
+			(flag & MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE) || consumer_read_num[i] == cnt ? "" : "(message loss)");
+		total_read += consumer_read_num[i];
+	}
+	if (flag & MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE)
+	{
+		printf("%dw%dr-%s total read %llu %s\n",
+			cnt_producer, cnt_consumer, mode, (unsigned long long)total_read,
+			total_read == cnt ? "" : "(message loss)");
 	}
 	free(consumer_read_num);
 
-	snprintf(buf, sizeof(buf) - 1, "%dw%dr-sowr-alloc", cnt_producer, cnt_consumer);
+	snprintf(buf, sizeof(buf) - 1, "%dw%dr-sowr-%s-alloc", cnt_producer, cnt_consumer, mode);
 	muggle_benchmark_gen_reports_body(fp, config, blocks, buf, cnt, 0, 1, 0);
 
-	snprintf(buf, sizeof(buf) - 1, "%dw%dr-sowr-alloc-sorted", cnt_producer, cnt_consumer);
+	snprintf(buf, sizeof(buf) - 1, "%dw%dr-sowr-%s-alloc-sorted", cnt_producer, cnt_consumer, mode);
 	muggle_benchmark_gen_reports_body(fp, config, blocks, buf, cnt, 0, 1, 1);
 
-	snprintf(buf, sizeof(buf) - 1, "%dw%dr-sowr-free", cnt_producer, cnt_consumer);
+	snprintf(buf, sizeof(buf) - 1, "%dw%dr-sowr-%s-free", cnt_producer, cnt_consumer, mode);
 	muggle_benchmark_gen_reports_body(fp, config, blocks, buf, cnt, 2, 3, 0);
 
-	snprintf(buf, sizeof(buf) - 1, "%dw%dr-sowr-free-sorted", cnt_producer, cnt_consumer);
+	snprintf(buf, sizeof(buf) - 1, "%dw%dr-sowr-%s-free-sorted", cnt_producer, cnt_consumer, mode);
 	muggle_benchmark_gen_reports_body(fp, config, blocks, buf, cnt, 2, 3, 1);
 
 	free(blocks);
@@ -208,13 +226,21 @@ int main()
 	int flag = 0;
 
 	// 1 writer, 1 reader
-	Benchmark_wr(fp, &config, 1, 1, flag);
+	Benchmark_wr(fp, &config, 1, 1, flag, MUGGLE_SOWR_MEMORY_POOL_FLAG_SEQ_FREE);
 
 	// hc write, 1 reader
-	Benchmark_wr(fp, &config, hc, 1, flag);
+	Benchmark_wr(fp, &config, hc, 1, flag, MUGGLE_SOWR_MEMORY_POOL_FLAG_SEQ_FREE);
 
 	// 2 * hc write, 1 reader
-	Benchmark_wr(fp, &config, 2 * hc, 1, flag);
+	Benchmark_wr(fp, &config, 2 * hc, 1, flag, MUGGLE_SOWR_MEMORY_POOL_FLAG_SEQ_FREE);
+
+	// 1 writer, 1 reader, multi-free mode
+	Benchmark_wr(fp, &config, 1, 1, flag, MUGGLE_SOWR_MEMORY_POOL_FLAG_MULTI_FREE);
+
+	// 1 writer, multiple readers compete messages and free out of order
+	flag = MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE;
+	Benchmark_wr(fp, &config, 1, 2, flag, MUGGLE_SOWR_MEMORY_POOL_FLAG_MULTI_FREE);
+	Benchmark_wr(fp, &config, 1, 4, flag, MUGGLE_SOWR_MEMORY_POOL_FLAG_MULTI_FREE);
 
 	fclose(fp);
 }
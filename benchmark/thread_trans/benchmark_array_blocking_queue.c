@@ -33,7 +33,7 @@ void run_array_blocking_queue(
 	int total_msg_num = num_thread * (int)args->cfg->loop * (int)args->cfg->cnt_per_loop;
 	muggle_array_blocking_queue_t queue;
 	muggle_atomic_int capacity = total_msg_num / 64;
-	if (muggle_array_blocking_queue_init(&queue, capacity))
+	if (muggle_array_blocking_queue_init_ex(&queue, capacity, flags))
 	{
 		MUGGLE_LOG_ERROR("failed init %s with capacity: %d", name, (int)capacity);
 		exit(EXIT_FAILURE);
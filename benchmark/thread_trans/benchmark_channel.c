@@ -61,3 +61,48 @@ void run_channel(
 
 	MUGGLE_LOG_INFO("report for benchmark %s complete", name);
 }
+void run_channel_mul_reader(
+	const char *name,
+	int flags,
+	struct write_thread_args *args,
+	int num_thread,
+	int num_reader,
+	muggle_benchmark_block_t *blocks)
+{
+	MUGGLE_LOG_INFO("run benchmark %s", name);
+
+	init_blocks(args, blocks, num_thread);
+
+	MUGGLE_LOG_INFO("init blocks ok");
+
+	int total_msg_num = (int)(num_thread * args->cfg->loop * args->cfg->cnt_per_loop);
+	muggle_channel_t chan;
+	muggle_atomic_int capacity = total_msg_num / 64;
+	if (muggle_channel_init(&chan, capacity, flags | MUGGLE_CHANNEL_FLAG_MULTI_READER) != 0)
+	{
+		MUGGLE_LOG_ERROR("failed init %s with capacity: %d", name, (int)capacity);
+		exit(EXIT_FAILURE);
+	}
+
+	MUGGLE_LOG_INFO("init %s ok", name);
+
+	for (int i = 0; i < num_thread; i++)
+	{
+		args[i].fn = channel_write;
+		args[i].trans_obj = (void*)&chan;
+	}
+
+	MUGGLE_LOG_INFO("start benchmark %s", name);
+
+	run_thread_trans_benchmark_mul_reader(args, num_thread, num_reader, channel_read);
+
+	MUGGLE_LOG_INFO("benchmark %s completed", name);
+
+	muggle_channel_destroy(&chan);
+
+	MUGGLE_LOG_INFO("gen report for benchmark %s", name);
+
+	gen_benchmark_report(name, blocks, args[0].cfg, total_msg_num);
+
+	MUGGLE_LOG_INFO("report for benchmark %s complete", name);
+}
@@ -18,5 +18,12 @@ void run_channel(
 	struct write_thread_args *args,
 	int num_thread,
 	muggle_benchmark_block_t *blocks);
+void run_channel_mul_reader(
+	const char *name,
+	int flags,
+	struct write_thread_args *args,
+	int num_thread,
+	int num_reader,
+	muggle_benchmark_block_t *blocks);
 
 #endif
@@ -58,11 +58,19 @@ int main(int argc, char *argv[])
 	benchmark_cfg.report_step = 10;
 	benchmark_cfg.elapsed_unit = MUGGLE_BENCHMARK_ELAPSED_UNIT_NS;
 
-	// allocate memory
-	int total_msg_num = num_thread * rounds * msg_per_round;
+	// allocate memory, enough for producer sweep
+	int sweep_producers[] = {1, 2, 4, 8, 16};
+	int num_sweep = (int)(sizeof(sweep_producers) / sizeof(sweep_producers[0]));
+	int max_thread = num_thread;
+	if (max_thread < sweep_producers[num_sweep - 1])
+	{
+		max_thread = sweep_producers[num_sweep - 1];
+	}
+
+	int total_msg_num = max_thread * rounds * msg_per_round;
 	muggle_benchmark_block_t *blocks = (muggle_benchmark_block_t*)malloc(sizeof(muggle_benchmark_block_t) * total_msg_num);
-	struct write_thread_args *args = (struct write_thread_args*)malloc(sizeof(struct write_thread_args) * num_thread);
-	for (int i = 0; i < num_thread; i++)
+	struct write_thread_args *args = (struct write_thread_args*)malloc(sizeof(struct write_thread_args) * max_thread);
+	for (int i = 0; i < max_thread; i++)
 	{
 		args[i].cfg = &benchmark_cfg;
 	}
@@ -91,7 +99,43 @@ int main(int argc, char *argv[])
 	snprintf(name, sizeof(name), "channel_%dw_futex_1r_busyloop", num_thread);
 	run_channel(name, flags, args, num_thread, blocks);
 
+	MUGGLE_LOG_INFO("=======================================================");
+	flags = MUGGLE_CHANNEL_FLAG_READ_ADAPTIVE;
+	snprintf(name, sizeof(name), "channel_%dw_mutex_1r_adaptive", num_thread);
+	run_channel(name, flags, args, num_thread, blocks);
+
+	MUGGLE_LOG_INFO("=======================================================");
+	flags = MUGGLE_CHANNEL_FLAG_WRITE_FUTEX | MUGGLE_CHANNEL_FLAG_READ_ADAPTIVE;
+	snprintf(name, sizeof(name), "channel_%dw_futex_1r_adaptive", num_thread);
+	run_channel(name, flags, args, num_thread, blocks);
+
+	MUGGLE_LOG_INFO("=======================================================");
+	flags = MUGGLE_CHANNEL_FLAG_MULTI_READER;
+	snprintf(name, sizeof(name), "channel_%dw_%dr_mpmc", num_thread, num_thread);
+	run_channel_mul_reader(name, flags, args, num_thread, num_thread, blocks);
+
+	MUGGLE_LOG_INFO("=======================================================");
+	flags = MUGGLE_CHANNEL_FLAG_MULTI_READER | MUGGLE_CHANNEL_FLAG_READ_BUSY_LOOP;
+	snprintf(name, sizeof(name), "channel_%dw_%dr_mpmc_busyloop", num_thread, num_thread);
+	run_channel_mul_reader(name, flags, args, num_thread, num_thread, blocks);
+
+	MUGGLE_LOG_INFO("=======================================================");
+	flags = MUGGLE_CHANNEL_FLAG_MULTI_READER | MUGGLE_CHANNEL_FLAG_READ_ADAPTIVE;
+	snprintf(name, sizeof(name), "channel_%dw_%dr_mpmc_adaptive", num_thread, num_thread);
+	run_channel_mul_reader(name, flags, args, num_thread, num_thread, blocks);
+
 	// benchmark ringbuffer
+	// default read wait mode, writer only wake reader when it parked
+	MUGGLE_LOG_INFO("=======================================================");
+	flags = MUGGLE_RING_BUFFER_FLAG_WRITE_LOCK | MUGGLE_RING_BUFFER_FLAG_READ_WAIT;
+	snprintf(name, sizeof(name), "ringbuffer_%dw_lock_1r_wait", num_thread);
+	run_ringbuffer(name, flags, args, num_thread, blocks);
+
+	MUGGLE_LOG_INFO("=======================================================");
+	flags = MUGGLE_RING_BUFFER_FLAG_WRITE_BUSY_LOOP | MUGGLE_RING_BUFFER_FLAG_READ_WAIT;
+	snprintf(name, sizeof(name), "ringbuffer_%dw_busyloop_1r_wait", num_thread);
+	run_ringbuffer(name, flags, args, num_thread, blocks);
+
 	MUGGLE_LOG_INFO("=======================================================");
 	flags = MUGGLE_RING_BUFFER_FLAG_WRITE_LOCK | MUGGLE_RING_BUFFER_FLAG_SINGLE_READER;
 	snprintf(name, sizeof(name), "ringbuffer_%dw_lock_1r_single", num_thread);
@@ -102,6 +146,11 @@ int main(int argc, char *argv[])
 	snprintf(name, sizeof(name), "ringbuffer_%dw_lock_1r_busyloop", num_thread);
 	run_ringbuffer(name, flags, args, num_thread, blocks);
 
+	MUGGLE_LOG_INFO("=======================================================");
+	flags = MUGGLE_RING_BUFFER_FLAG_WRITE_LOCK | MUGGLE_RING_BUFFER_FLAG_SINGLE_READER | MUGGLE_RING_BUFFER_FLAG_READ_ADAPTIVE;
+	snprintf(name, sizeof(name), "ringbuffer_%dw_lock_1r_adaptive", num_thread);
+	run_ringbuffer(name, flags, args, num_thread, blocks);
+
 	MUGGLE_LOG_INFO("=======================================================");
 	flags = MUGGLE_RING_BUFFER_FLAG_WRITE_BUSY_LOOP | MUGGLE_RING_BUFFER_FLAG_SINGLE_READER;
 	snprintf(name, sizeof(name), "ringbuffer_%dw_busyloop_1r_single", num_thread);
@@ -112,12 +161,38 @@ int main(int argc, char *argv[])
 	snprintf(name, sizeof(name), "ringbuffer_%dw_busyloop_1r_busyloop", num_thread);
 	run_ringbuffer(name, flags, args, num_thread, blocks);
 
+	MUGGLE_LOG_INFO("=======================================================");
+	flags = MUGGLE_RING_BUFFER_FLAG_WRITE_BUSY_LOOP | MUGGLE_RING_BUFFER_FLAG_SINGLE_READER | MUGGLE_RING_BUFFER_FLAG_READ_ADAPTIVE;
+	snprintf(name, sizeof(name), "ringbuffer_%dw_busyloop_1r_adaptive", num_thread);
+	run_ringbuffer(name, flags, args, num_thread, blocks);
+
 	// array blocking queue
 	MUGGLE_LOG_INFO("=======================================================");
 	flags = 0;
 	snprintf(name, sizeof(name), "array_blocking_queue_%dw_1r", num_thread);
 	run_array_blocking_queue(name, flags, args, num_thread, blocks);
 
+	MUGGLE_LOG_INFO("=======================================================");
+	flags = MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_LOCKFREE;
+	snprintf(name, sizeof(name), "array_blocking_queue_%dw_1r_lockfree", num_thread);
+	run_array_blocking_queue(name, flags, args, num_thread, blocks);
+
+	// array blocking queue producer sweep, lock vs lockfree
+	for (int i = 0; i < num_sweep; i++)
+	{
+		int n = sweep_producers[i];
+
+		MUGGLE_LOG_INFO("=======================================================");
+		flags = MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_LOCK;
+		snprintf(name, sizeof(name), "sweep_array_blocking_queue_%dw_1r", n);
+		run_array_blocking_queue(name, flags, args, n, blocks);
+
+		MUGGLE_LOG_INFO("=======================================================");
+		flags = MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_LOCKFREE;
+		snprintf(name, sizeof(name), "sweep_array_blocking_queue_%dw_1r_lockfree", n);
+		run_array_blocking_queue(name, flags, args, n, blocks);
+	}
+
 	// free memory
 	free(args);
 	free(blocks);
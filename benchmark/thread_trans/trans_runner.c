@@ -118,8 +118,157 @@ void run_thread_trans_benchmark(struct write_thread_args *args, int num_thread,
 	free(threads);
 }
 
+struct read_thread_args
+{
+	void              *trans_obj;
+	fn_trans_read     fn;
+	int               num_writer;
+	muggle_atomic_int *recv_null;
+	muggle_atomic_int *total_recv;
+};
+
+static muggle_thread_ret_t read_thread(void *p_arg)
+{
+	struct read_thread_args *arg = (struct read_thread_args*)p_arg;
+
+	int cnt_recv = 0;
+	while (1)
+	{
+		void* data = arg->fn(arg->trans_obj);
+		if (data)
+		{
+			muggle_benchmark_block_t *block = (muggle_benchmark_block_t*)data;
+			timespec_get(&block->ts[2], TIME_UTC);
+			cnt_recv++;
+		}
+		else
+		{
+			// NULLs from writers only mean writer end, exit when receive
+			// the NULL that main thread send after all writers end
+			muggle_atomic_int n = muggle_atomic_fetch_add(arg->recv_null, 1, muggle_memory_order_relaxed) + 1;
+			if (n > arg->num_writer)
+			{
+				break;
+			}
+		}
+	}
+
+	muggle_atomic_fetch_add(arg->total_recv, cnt_recv, muggle_memory_order_relaxed);
+	MUGGLE_LOG_INFO("recv thread end");
+
+	return 0;
+}
+
+void run_thread_trans_benchmark_mul_reader(
+	struct write_thread_args *args, int num_thread, int num_reader, fn_trans_read fn_read)
+{
+	muggle_atomic_int recv_null = 0;
+	muggle_atomic_int total_recv = 0;
+
+	struct read_thread_args read_args;
+	read_args.trans_obj = args[0].trans_obj;
+	read_args.fn = fn_read;
+	read_args.num_writer = num_thread;
+	read_args.recv_null = &recv_null;
+	read_args.total_recv = &total_recv;
+
+	muggle_thread_t *readers = (muggle_thread_t*)malloc(num_reader * sizeof(muggle_thread_t));
+	for (int i = 0; i < num_reader; i++)
+	{
+		muggle_thread_create(&readers[i], read_thread, &read_args);
+	}
+
+	muggle_thread_t *threads = (muggle_thread_t*)malloc(num_thread * sizeof(muggle_thread_t));
+	for (int i = 0; i < num_thread; i++)
+	{
+		muggle_thread_create(&threads[i], write_thread, &args[i]);
+	}
+
+	for (int i = 0; i < num_thread; i++)
+	{
+		muggle_thread_join(&threads[i]);
+	}
+
+	// wait all writers' NULL be consumed, then send one NULL for each reader
+	while (muggle_atomic_load(&recv_null, muggle_memory_order_relaxed) < num_thread)
+	{
+		muggle_msleep(1);
+	}
+	for (int i = 0; i < num_reader; i++)
+	{
+		while (args[0].fn(args[0].trans_obj, NULL) != 0)
+		{
+			muggle_thread_yield();
+		}
+	}
+
+	for (int i = 0; i < num_reader; i++)
+	{
+		muggle_thread_join(&readers[i]);
+	}
+
+	int total_msg_num = num_thread * (int)args[0].cfg->loop * (int)args[0].cfg->cnt_per_loop;
+	if (total_recv != total_msg_num)
+	{
+		MUGGLE_LOG_WARNING("total send message: %d, total recv message %d, lost message: %d",
+			total_msg_num, (int)total_recv, total_msg_num - (int)total_recv);
+	}
+	else
+	{
+		MUGGLE_LOG_INFO("total send message: %d, total recv message %d, lost message: %d",
+			total_msg_num, (int)total_recv, total_msg_num - (int)total_recv);
+	}
+
+	free(threads);
+	free(readers);
+}
 
 /****************** report ******************/
+static int compare_elapsed(const void *a, const void *b)
+{
+	const uint64_t arg1 = *(const uint64_t*)a;
+	const uint64_t arg2 = *(const uint64_t*)b;
+
+	if (arg1 < arg2) return -1;
+	if (arg1 > arg2) return 1;
+	return 0;
+}
+
+static void gen_percentile_report(
+	FILE *fp, const char *name, const char *case_name,
+	muggle_benchmark_block_t *blocks, int cnt, int ts_begin_idx, int ts_end_idx)
+{
+	uint64_t *elapseds = (uint64_t*)malloc(cnt * sizeof(uint64_t));
+	int n = 0;
+	for (int i = 0; i < cnt; i++)
+	{
+		if (blocks[i].ts[ts_begin_idx].tv_sec == 0 || blocks[i].ts[ts_end_idx].tv_sec == 0)
+		{
+			continue;
+		}
+		elapseds[n++] = get_elapsed_ns(&blocks[i], ts_begin_idx, ts_end_idx);
+	}
+
+	if (n == 0)
+	{
+		free(elapseds);
+		return;
+	}
+	qsort(elapseds, n, sizeof(uint64_t), compare_elapsed);
+
+	uint64_t p50 = elapseds[(int)(n * 0.50)];
+	uint64_t p99 = elapseds[(int)(n * 0.99)];
+	uint64_t p999 = elapseds[(int)(n * 0.999)];
+
+	MUGGLE_LOG_INFO("%s %s: p50=%lluns, p99=%lluns, p999=%lluns",
+		name, case_name,
+		(unsigned long long)p50, (unsigned long long)p99, (unsigned long long)p999);
+	fprintf(fp, "%s,%llu,%llu,%llu\n", case_name,
+		(unsigned long long)p50, (unsigned long long)p99, (unsigned long long)p999);
+
+	free(elapseds);
+}
+
 void gen_benchmark_report(const char *name, muggle_benchmark_block_t *blocks, muggle_benchmark_config_t *cfg, int cnt)
 {
 	strncpy(cfg->name, name, sizeof(cfg->name)-1);
@@ -139,5 +288,9 @@ void gen_benchmark_report(const char *name, muggle_benchmark_block_t *blocks, mu
 	muggle_benchmark_gen_reports_body(fp, cfg, blocks, "wr sort by idx", cnt, 0, 2, 0);
 	muggle_benchmark_gen_reports_body(fp, cfg, blocks, "wr sort by elapsed", cnt, 0, 2, 1);
 
+	fprintf(fp, "\npercentile,p50,p99,p999\n");
+	gen_percentile_report(fp, name, "w", blocks, cnt, 0, 1);
+	gen_percentile_report(fp, name, "wr", blocks, cnt, 0, 2);
+
 	fclose(fp);
 }
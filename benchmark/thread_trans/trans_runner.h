@@ -29,6 +29,9 @@ void init_blocks(struct write_thread_args *args, muggle_benchmark_block_t *block
 
 void run_thread_trans_benchmark(struct write_thread_args *args, int num_thread, fn_trans_read fn_read);
 
+void run_thread_trans_benchmark_mul_reader(
+	struct write_thread_args *args, int num_thread, int num_reader, fn_trans_read fn_read);
+
 /****************** report ******************/
 void gen_benchmark_report(const char *name, muggle_benchmark_block_t *blocks, muggle_benchmark_config_t *cfg, int cnt);
 
@@ -7,7 +7,7 @@ void example_log_handle_console(int write_type, int fmt_flag, int level)
 		&handle, write_type, fmt_flag, level, 0, NULL, NULL, 1);
 
 	muggle_log_fmt_arg_t arg = {
-		MUGGLE_LOG_LEVEL_INFO, __LINE__, __FILE__, __FUNCTION__, muggle_thread_current_id()
+		MUGGLE_LOG_LEVEL_INFO, __LINE__, __FILE__, __FUNCTION__, muggle_thread_current_id(), NULL
 	};
 	muggle_log_handle_write(&handle, &arg, "console logging");
 	arg.level = MUGGLE_LOG_LEVEL_TRACE;
@@ -34,7 +34,7 @@ void example_log_handle_file(int write_type, int fmt_flag, int level, const char
 	}
 
 	muggle_log_fmt_arg_t arg = {
-		MUGGLE_LOG_LEVEL_TRACE, __LINE__, __FILE__, __FUNCTION__, muggle_thread_current_id()
+		MUGGLE_LOG_LEVEL_TRACE, __LINE__, __FILE__, __FUNCTION__, muggle_thread_current_id(), NULL
 	};
 	muggle_log_handle_write(&handle, &arg, "message trace");
 	arg.level = MUGGLE_LOG_LEVEL_INFO;
@@ -69,7 +69,7 @@ void example_log_handle_rotating_file(int write_type, int fmt_flag, int level, c
 	}
 
 	muggle_log_fmt_arg_t arg = {
-		MUGGLE_LOG_LEVEL_TRACE, __LINE__, __FILE__, __FUNCTION__, muggle_thread_current_id()
+		MUGGLE_LOG_LEVEL_TRACE, __LINE__, __FILE__, __FUNCTION__, muggle_thread_current_id(), NULL
 	};
 	muggle_log_handle_write(&handle, &arg, "message trace");
 	arg.level = MUGGLE_LOG_LEVEL_INFO;
@@ -97,7 +97,7 @@ void example_log_handle_win_debug(int write_type, int fmt_flag, int level)
 		&handle, write_type, fmt_flag, level, 0, NULL, NULL);
 
 	muggle_log_fmt_arg_t arg = {
-		MUGGLE_LOG_LEVEL_INFO, __LINE__, __FILE__, __FUNCTION__, muggle_thread_current_id()
+		MUGGLE_LOG_LEVEL_INFO, __LINE__, __FILE__, __FUNCTION__, muggle_thread_current_id(), NULL
 	};
 	muggle_log_handle_write(&handle, &arg, "win debug logging");
 	arg.level = MUGGLE_LOG_LEVEL_TRACE;
@@ -138,7 +138,7 @@ void example_log_category(int write_type, int fmt_flag, int level)
 	muggle_log_category_add(&category, &handle_file);
 
 	muggle_log_fmt_arg_t arg = {
-		MUGGLE_LOG_LEVEL_INFO, __LINE__, __FILE__, __FUNCTION__, muggle_thread_current_id()
+		MUGGLE_LOG_LEVEL_INFO, __LINE__, __FILE__, __FUNCTION__, muggle_thread_current_id(), NULL
 	};
 	muggle_log_category_write(&category, &arg, "category");
 	arg.level = MUGGLE_LOG_LEVEL_TRACE;
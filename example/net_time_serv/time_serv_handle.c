@@ -26,7 +26,7 @@ void trace_output_peers(struct peer_container *container)
 #endif
 		++cnt;
 	}
-    MUGGLE_LOG_INFO(buf);
+    MUGGLE_LOG_INFO("%s", buf);
 }
 
 #endif
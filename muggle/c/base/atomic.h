@@ -14,6 +14,7 @@
 #define MUGGLE_C_ATOMIC_H_
 
 #include "muggle/c/base/macro.h"
+#include <stdint.h>
 
 #if MUGGLE_PLATFORM_WINDOWS
 
@@ -33,9 +34,11 @@
 
 // load
 #define muggle_atomic_load(ptr, memmodel) InterlockedOr(ptr, 0)
+#define muggle_atomic_load64(ptr, memmodel) InterlockedOr64(ptr, 0)
 
 // store
 #define muggle_atomic_store(ptr, val, memmodel) InterlockedExchange(ptr, val)
+#define muggle_atomic_store64(ptr, val, memmodel) InterlockedExchange64(ptr, val)
 
 // exchange
 #define muggle_atomic_exchange(ptr, val, memmodel) InterlockedExchange(ptr, val)
@@ -97,9 +100,11 @@ EXTERN_C_END
 
 // load
 #define muggle_atomic_load(ptr, memmodel) __atomic_load_n(ptr, memmodel)
+#define muggle_atomic_load64(ptr, memmodel) __atomic_load_n(ptr, memmodel)
 
 // store
 #define muggle_atomic_store(ptr, val, memmodel) __atomic_store_n(ptr, val, memmodel)
+#define muggle_atomic_store64(ptr, val, memmodel) __atomic_store_n(ptr, val, memmodel)
 
 // exchange
 #define muggle_atomic_exchange(ptr, val, memmodel) __atomic_exchange_n(ptr, val, memmodel)
@@ -33,6 +33,9 @@ enum
 	MUGGLE_ERR_CRYPT_PLAINTEXT_SIZE, // invalid plaintext size
 	MUGGLE_ERR_CRYPT_KEY_SIZE,       // invalid key size
 
+	MUGGLE_ERR_EMPTY,
+	MUGGLE_ERR_TIMEOUT,
+
 	MUGGLE_ERR_MAX,
 };
 
@@ -0,0 +1,44 @@
+/******************************************************************************
+ *  @file         iovec.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec scatter/gather io vector
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_IOVEC_H_
+#define MUGGLE_C_IOVEC_H_
+
+#include "muggle/c/base/macro.h"
+#include <stddef.h>
+
+#if !MUGGLE_PLATFORM_WINDOWS
+	#include <sys/uio.h>
+#endif
+
+EXTERN_C_BEGIN
+
+#if MUGGLE_PLATFORM_WINDOWS
+
+/**
+ * @brief io vector, same fields as posix struct iovec
+ */
+typedef struct muggle_iovec
+{
+	void   *iov_base;
+	size_t iov_len;
+}muggle_iovec_t;
+
+#else
+
+typedef struct iovec muggle_iovec_t;
+
+#endif
+
+#define MUGGLE_IOV_MAX 64 //!< max number of io vectors pass to system call once
+
+EXTERN_C_END
+
+#endif
@@ -156,6 +156,13 @@
 #define MUGGLE_CACHE_LINE_SIZE 64
 #define MUGGLE_STRUCT_CACHE_LINE_PADDING(idx) char cache_line_padding_##idx[MUGGLE_CACHE_LINE_SIZE]
 
+// hint cpu to load memory into cache for read
+#if defined(__GNUC__) || defined(__clang__)
+	#define MUGGLE_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+	#define MUGGLE_PREFETCH(addr) ((void)(addr))
+#endif
+
 // idx % capacity, capacity must be pow of 2
 #define IDX_IN_POW_OF_2_RING(idx, capacity) ((idx) & ((capacity) - 1))
 
@@ -45,6 +45,17 @@ typedef DWORD muggle_thread_id;
 typedef pthread_t muggle_thread_id;
 #endif
 
+// hint cpu that caller is in a spin-wait loop
+#if MUGGLE_PLATFORM_WINDOWS
+	#define muggle_thread_pause() YieldProcessor()
+#elif defined(__x86_64__) || defined(__i386__)
+	#define muggle_thread_pause() __builtin_ia32_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+	#define muggle_thread_pause() __asm__ __volatile__("yield")
+#else
+	#define muggle_thread_pause() do {} while (0)
+#endif
+
 /**
  * @brief starts a new thread in the calling process
  *
@@ -36,6 +36,7 @@ typedef struct muggle_avl_tree
 	muggle_avl_tree_node_t *root;  //!< root node of avl tree
 	muggle_dsaa_data_cmp   cmp;    //!< pointer to compare function for data
 	muggle_memory_pool_t   *pool;  //!< memory pool of tree, if it's NULL, use malloc and free by default
+	muggle_arena_t         *arena; //!< arena of tree nodes, not owned by tree, if it's not NULL, pool is not used
 }muggle_avl_tree_t;
 
 /**
@@ -50,6 +51,21 @@ typedef struct muggle_avl_tree
 MUGGLE_C_EXPORT
 bool muggle_avl_tree_init(muggle_avl_tree_t *p_avl_tree, muggle_dsaa_data_cmp cmp, size_t capacity);
 
+/**
+ * @brief initialize avl tree, nodes allocated from arena
+ *
+ * NOTE: erased nodes are not recycled, they are released when arena is
+ * reset, tree must not be used after its arena reset or rewind
+ *
+ * @param p_avl_tree pointer to avl tree
+ * @param cmp        pointer to compare function
+ * @param arena      arena for nodes
+ *
+ * @return boolean
+ */
+MUGGLE_C_EXPORT
+bool muggle_avl_tree_init_with_arena(muggle_avl_tree_t *p_avl_tree, muggle_dsaa_data_cmp cmp, muggle_arena_t *arena);
+
 /**
  * @brief destroy avl tree
  *
@@ -90,6 +90,42 @@ bool muggle_hash_table_init(muggle_hash_table_t *p_hash_table, size_t table_size
 	return true;
 }
 
+bool muggle_hash_table_init_with_arena(muggle_hash_table_t *p_hash_table, size_t table_size, hash_func hash, muggle_dsaa_data_cmp cmp, muggle_arena_t *arena)
+{
+	if (cmp == NULL || arena == NULL)
+	{
+		return false;
+	}
+
+	memset(p_hash_table, 0, sizeof(*p_hash_table));
+
+	if (table_size < 8)
+	{
+		table_size = HASH_TABLE_SIZE_10007;
+	}
+	p_hash_table->table_size = table_size;
+	p_hash_table->nodes = (muggle_hash_table_node_t*)muggle_arena_alloc(arena, sizeof(muggle_hash_table_node_t) * table_size);
+	if (p_hash_table->nodes == NULL)
+	{
+		return false;
+	}
+	memset(p_hash_table->nodes, 0, sizeof(muggle_hash_table_node_t) * table_size);
+
+	if (hash == NULL)
+	{
+		p_hash_table->hash = s_muggle_default_str_hash_func;
+	}
+	else
+	{
+		p_hash_table->hash = hash;
+	}
+
+	p_hash_table->cmp = cmp;
+	p_hash_table->arena = arena;
+
+	return true;
+}
+
 void muggle_hash_table_destroy(muggle_hash_table_t *p_hash_table,
 	muggle_dsaa_data_free key_func_free, void *key_pool,
 	muggle_dsaa_data_free value_func_free, void *value_pool)
@@ -105,7 +141,10 @@ void muggle_hash_table_destroy(muggle_hash_table_t *p_hash_table,
 	}
 
 	// free table
-	free(p_hash_table->nodes);
+	if (p_hash_table->arena == NULL)
+	{
+		free(p_hash_table->nodes);
+	}
 }
 
 void muggle_hash_table_clear(muggle_hash_table_t *p_hash_table,
@@ -168,7 +207,11 @@ muggle_hash_table_node_t* muggle_hash_table_put(muggle_hash_table_t *p_hash_tabl
 	}
 
 	muggle_hash_table_node_t *new_node = NULL;
-	if (p_hash_table->pool)
+	if (p_hash_table->arena)
+	{
+		new_node = (muggle_hash_table_node_t*)muggle_arena_alloc(p_hash_table->arena, sizeof(muggle_hash_table_node_t));
+	}
+	else if (p_hash_table->pool)
 	{
 		new_node = (muggle_hash_table_node_t*)muggle_memory_pool_alloc(p_hash_table->pool);
 	}
@@ -233,7 +276,11 @@ void muggle_hash_table_remove(
 		next->prev = prev;
 	}
 
-	if (p_hash_table->pool)
+	if (p_hash_table->arena)
+	{
+		// released when arena reset
+	}
+	else if (p_hash_table->pool)
 	{
 		muggle_memory_pool_free(p_hash_table->pool, node);
 	}
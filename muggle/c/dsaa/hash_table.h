@@ -38,6 +38,7 @@ typedef struct muggle_hash_table
 	hash_func                hash;        //!< pointer to hash function
 	muggle_dsaa_data_cmp     cmp;         //!< pointer to compare function
 	muggle_memory_pool_t     *pool;       //!< memory pool of tree, if it's NULL, use malloc and free by default
+	muggle_arena_t           *arena;      //!< arena of node array and nodes, not owned by table, if it's not NULL, pool is not used
 }muggle_hash_table_t;
 
 #define HASH_TABLE_SIZE_10007 10007
@@ -56,6 +57,23 @@ typedef struct muggle_hash_table
 MUGGLE_C_EXPORT
 bool muggle_hash_table_init(muggle_hash_table_t *p_hash_table, size_t table_size, hash_func hash, muggle_dsaa_data_cmp cmp, size_t capacity);
 
+/**
+ * @brief initialize hash table, node array and nodes allocated from arena
+ *
+ * NOTE: removed nodes are not recycled, they are released when arena is
+ * reset, table must not be used after its arena reset or rewind
+ *
+ * @param p_hash_table  pointer to hash table
+ * @param table_size    table size
+ * @param hash          hash function, if it's NULL, use default hash function
+ * @param cmp           compare function for key
+ * @param arena         arena for node array and nodes
+ *
+ * @return boolean
+ */
+MUGGLE_C_EXPORT
+bool muggle_hash_table_init_with_arena(muggle_hash_table_t *p_hash_table, size_t table_size, hash_func hash, muggle_dsaa_data_cmp cmp, muggle_arena_t *arena);
+
 // 
 MUGGLE_C_EXPORT
 /**
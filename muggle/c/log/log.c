@@ -24,6 +24,11 @@ void muggle_log_add_handle(muggle_log_handle_t *handle)
 	muggle_log_category_add(&g_log_default_category, handle);
 }
 
+void muggle_log_flush()
+{
+	muggle_log_category_flush(&g_log_default_category);
+}
+
 void muggle_log_destroy()
 {
 	muggle_log_category_destroy(&g_log_default_category, 1);
@@ -40,14 +45,17 @@ void muggle_log_function(
 		return;
 	}
 
-	char msg[MUGGLE_LOG_MAX_LEN];
 	va_list args;
 
 	va_start(args, format);
-	vsnprintf(msg, sizeof(msg), format, args);
+	muggle_log_category_vwrite(category, arg, format, args);
 	va_end(args);
 
-	muggle_log_category_write(category, arg, msg);
+	if (arg->level >= MUGGLE_LOG_LEVEL_FATAL)
+	{
+		// make sure records before fatal are output, process may exit soon
+		muggle_log_category_flush(category);
+	}
 
 #if MUGGLE_DEBUG
 	if (arg->level >= MUGGLE_LOG_LEVEL_FATAL)
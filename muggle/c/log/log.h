@@ -23,7 +23,7 @@ EXTERN_C_BEGIN
 do \
 { \
 	muggle_log_fmt_arg_t mlf_arg##__LINE__ = { \
-		level, __LINE__, __FILE__, __FUNCTION__, muggle_thread_current_id() \
+		level, __LINE__, __FILE__, __FUNCTION__, muggle_thread_current_id(), NULL \
 	}; \
 	muggle_log_function(&g_log_default_category, &mlf_arg##__LINE__, format, ##__VA_ARGS__); \
 } while (0)
@@ -32,7 +32,7 @@ do \
 do \
 { \
 	muggle_log_fmt_arg_t mlf_arg##__LINE__ = { \
-		level, __LINE__, __FILE__, __FUNCTION__, muggle_thread_current_id() \
+		level, __LINE__, __FILE__, __FUNCTION__, muggle_thread_current_id(), NULL \
 	}; \
 	muggle_log_function(p_log_category, &mlf_arg##__LINE__, format, ##__VA_ARGS__); \
 } while (0)
@@ -63,7 +63,7 @@ do \
 	if (!(x)) \
 	{ \
 		muggle_log_fmt_arg_t mlf_arg##__LINE__ = { \
-			MUGGLE_LOG_LEVEL_FATAL, __LINE__, __FILE__, __FUNCTION__, muggle_thread_current_id() \
+			MUGGLE_LOG_LEVEL_FATAL, __LINE__, __FILE__, __FUNCTION__, muggle_thread_current_id(), NULL \
 		}; \
 		muggle_log_function(&g_log_default_category, &mlf_arg##__LINE__, "Assertion: "#x); \
 	} \
@@ -75,7 +75,7 @@ do \
 	if (!(x)) \
 	{ \
 		muggle_log_fmt_arg_t mlf_arg##__LINE__ = { \
-			MUGGLE_LOG_LEVEL_FATAL, __LINE__, __FILE__, __FUNCTION__, muggle_thread_current_id() \
+			MUGGLE_LOG_LEVEL_FATAL, __LINE__, __FILE__, __FUNCTION__, muggle_thread_current_id(), NULL \
 		}; \
 		muggle_log_function(&g_log_default_category, &mlf_arg##__LINE__, "Assertion: "#x format, ##__VA_ARGS__); \
 	} \
@@ -107,6 +107,15 @@ void muggle_log_add_handle(muggle_log_handle_t *handle);
 MUGGLE_C_EXPORT
 void muggle_log_destroy();
 
+/**
+ * @brief wait until all records written before are output by default category
+ *
+ * NOTE: invoke it before exit without muggle_log_destroy, it's invoked
+ * automatically after output fatal level message
+ */
+MUGGLE_C_EXPORT
+void muggle_log_flush();
+
 /**
  * @brief output log, don't use this function immediately, use MUGGLE_LOG macro instead
  *
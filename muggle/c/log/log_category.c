@@ -9,7 +9,9 @@
  *****************************************************************************/
  
 #include "log_category.h"
+#include <stdio.h>
 #include "muggle/c/base/err.h"
+#include "muggle/c/log/log_deferred.h"
 
 int muggle_log_category_add(muggle_log_category_t *category, muggle_log_handle_t *handle)
 {
@@ -63,3 +65,79 @@ int muggle_log_category_write(
 
 	return ret;
 }
+
+int muggle_log_category_vwrite(
+	muggle_log_category_t *category,
+	muggle_log_fmt_arg_t *arg,
+	const char *format,
+	va_list args
+)
+{
+	char msg[MUGGLE_LOG_MAX_LEN];
+	char data[MUGGLE_LOG_MAX_LEN];
+	int has_msg = 0;
+	int data_len = -2; // -2: not encoded, -1: failed encode
+	va_list args_copy;
+
+	int ret = 0;
+	for (int i = 0; i < category->cnt; ++i)
+	{
+		muggle_log_handle_t *handle = category->handles[i];
+		if (arg->level < handle->level)
+		{
+			continue;
+		}
+
+		if (handle->write_type == MUGGLE_LOG_WRITE_TYPE_ASYNC_DEFERRED)
+		{
+			if (data_len == -2)
+			{
+				va_copy(args_copy, args);
+				data_len = muggle_log_deferred_encode(format, args_copy, data, (int)sizeof(data));
+				va_end(args_copy);
+			}
+
+			if (data_len >= 0)
+			{
+				ret = muggle_log_handle_write_deferred(handle, arg, format, data, data_len);
+				if (ret != MUGGLE_OK)
+				{
+					return ret;
+				}
+				continue;
+			}
+		}
+
+		// unsupported conversion or too long arguments fallback to formatted message
+		if (!has_msg)
+		{
+			va_copy(args_copy, args);
+			vsnprintf(msg, sizeof(msg), format, args_copy);
+			va_end(args_copy);
+			has_msg = 1;
+		}
+
+		ret = muggle_log_handle_write(handle, arg, msg);
+		if (ret != MUGGLE_OK)
+		{
+			return ret;
+		}
+	}
+
+	return ret;
+}
+
+int muggle_log_category_flush(muggle_log_category_t *category)
+{
+	int ret = 0;
+	for (int i = 0; i < category->cnt; ++i)
+	{
+		ret = muggle_log_handle_flush(category->handles[i]);
+		if (ret != MUGGLE_OK)
+		{
+			return ret;
+		}
+	}
+
+	return ret;
+}
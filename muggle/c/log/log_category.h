@@ -14,6 +14,7 @@
 #include "muggle/c/base/macro.h"
 #include "muggle/c/log/log_fmt.h"
 #include "muggle/c/log/log_handle.h"
+#include <stdarg.h>
 
 EXTERN_C_BEGIN
 
@@ -67,6 +68,38 @@ int muggle_log_category_write(
 	const char *msg
 );
 
+/**
+ * @brief output message with format string
+ *
+ * NOTE: arguments are encoded once for handles with write type
+ * MUGGLE_LOG_WRITE_TYPE_ASYNC_DEFERRED and formatted in backend thread,
+ * message is formatted once in caller thread only when other handles need it
+ *
+ * @param category log category
+ * @param arg      log format arguments
+ * @param format   format string
+ * @param args     arguments of format string
+ *
+ * @return  success returns 0, otherwise return err code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_log_category_vwrite(
+	muggle_log_category_t *category,
+	muggle_log_fmt_arg_t *arg,
+	const char *format,
+	va_list args
+);
+
+/**
+ * @brief wait until all records written before are output by all handles
+ *
+ * @param category log category
+ *
+ * @return success returns 0, otherwise return err code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_log_category_flush(muggle_log_category_t *category);
+
 EXTERN_C_END
 
 #endif
@@ -0,0 +1,480 @@
+/******************************************************************************
+ *  @file         log_deferred.c
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec log deferred formatting
+ *****************************************************************************/
+
+#include "log_deferred.h"
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+
+enum
+{
+	MUGGLE_LOG_DEFERRED_ARG_NONE = 0, //!< %%
+	MUGGLE_LOG_DEFERRED_ARG_INT,
+	MUGGLE_LOG_DEFERRED_ARG_LONG,
+	MUGGLE_LOG_DEFERRED_ARG_LLONG,
+	MUGGLE_LOG_DEFERRED_ARG_SIZE,
+	MUGGLE_LOG_DEFERRED_ARG_INTMAX,
+	MUGGLE_LOG_DEFERRED_ARG_PTRDIFF,
+	MUGGLE_LOG_DEFERRED_ARG_DOUBLE,
+	MUGGLE_LOG_DEFERRED_ARG_LDOUBLE,
+	MUGGLE_LOG_DEFERRED_ARG_PTR,
+	MUGGLE_LOG_DEFERRED_ARG_STR,
+};
+
+enum
+{
+	MUGGLE_LOG_DEFERRED_LEN_NONE = 0,
+	MUGGLE_LOG_DEFERRED_LEN_HH,
+	MUGGLE_LOG_DEFERRED_LEN_H,
+	MUGGLE_LOG_DEFERRED_LEN_L,
+	MUGGLE_LOG_DEFERRED_LEN_LL,
+	MUGGLE_LOG_DEFERRED_LEN_J,
+	MUGGLE_LOG_DEFERRED_LEN_Z,
+	MUGGLE_LOG_DEFERRED_LEN_T,
+	MUGGLE_LOG_DEFERRED_LEN_BIG_L,
+};
+
+#define MUGGLE_LOG_DEFERRED_MAX_SPEC_LEN 64
+#define MUGGLE_LOG_DEFERRED_MAX_PRECISION 0x7ffffff
+
+typedef struct muggle_log_deferred_spec
+{
+	const char *start;   //!< points to '%'
+	int        len;      //!< length of conversion specification
+	int        cnt_star; //!< number of '*' in width and precision
+	int        precision; //!< precision, -1 represent omitted, -2 represent '*'
+	int        arg_type; //!< MUGGLE_LOG_DEFERRED_ARG_*
+	int        is_unsigned;
+}muggle_log_deferred_spec_t;
+
+static int muggle_log_deferred_int_type(int len_mod)
+{
+	switch (len_mod)
+	{
+		case MUGGLE_LOG_DEFERRED_LEN_NONE:
+		case MUGGLE_LOG_DEFERRED_LEN_HH:
+		case MUGGLE_LOG_DEFERRED_LEN_H: return MUGGLE_LOG_DEFERRED_ARG_INT;
+		case MUGGLE_LOG_DEFERRED_LEN_L: return MUGGLE_LOG_DEFERRED_ARG_LONG;
+		case MUGGLE_LOG_DEFERRED_LEN_LL: return MUGGLE_LOG_DEFERRED_ARG_LLONG;
+		case MUGGLE_LOG_DEFERRED_LEN_J: return MUGGLE_LOG_DEFERRED_ARG_INTMAX;
+		case MUGGLE_LOG_DEFERRED_LEN_Z: return MUGGLE_LOG_DEFERRED_ARG_SIZE;
+		case MUGGLE_LOG_DEFERRED_LEN_T: return MUGGLE_LOG_DEFERRED_ARG_PTRDIFF;
+	}
+	return -1;
+}
+
+/**
+ * @brief parse conversion specification
+ *
+ * @param p     points to '%'
+ * @param spec  output specification
+ *
+ * @return on success, return pointer after the specification, otherwise return NULL
+ */
+static const char* muggle_log_deferred_parse_spec(const char *p, muggle_log_deferred_spec_t *spec)
+{
+	spec->start = p++;
+	spec->cnt_star = 0;
+	spec->precision = -1;
+	spec->is_unsigned = 0;
+
+	// flags
+	while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0' || *p == '\'')
+	{
+		++p;
+	}
+
+	// width
+	if (*p == '*')
+	{
+		++spec->cnt_star;
+		++p;
+	}
+	else
+	{
+		while (*p >= '0' && *p <= '9')
+		{
+			++p;
+		}
+	}
+
+	// precision
+	if (*p == '.')
+	{
+		++p;
+		if (*p == '*')
+		{
+			++spec->cnt_star;
+			spec->precision = -2;
+			++p;
+		}
+		else
+		{
+			spec->precision = 0;
+			while (*p >= '0' && *p <= '9')
+			{
+				if (spec->precision < MUGGLE_LOG_DEFERRED_MAX_PRECISION)
+				{
+					spec->precision = spec->precision * 10 + (*p - '0');
+				}
+				++p;
+			}
+		}
+	}
+
+	// length modifier
+	int len_mod = MUGGLE_LOG_DEFERRED_LEN_NONE;
+	switch (*p)
+	{
+		case 'h':
+		{
+			++p;
+			len_mod = MUGGLE_LOG_DEFERRED_LEN_H;
+			if (*p == 'h')
+			{
+				++p;
+				len_mod = MUGGLE_LOG_DEFERRED_LEN_HH;
+			}
+		}break;
+		case 'l':
+		{
+			++p;
+			len_mod = MUGGLE_LOG_DEFERRED_LEN_L;
+			if (*p == 'l')
+			{
+				++p;
+				len_mod = MUGGLE_LOG_DEFERRED_LEN_LL;
+			}
+		}break;
+		case 'j': ++p; len_mod = MUGGLE_LOG_DEFERRED_LEN_J; break;
+		case 'z': ++p; len_mod = MUGGLE_LOG_DEFERRED_LEN_Z; break;
+		case 't': ++p; len_mod = MUGGLE_LOG_DEFERRED_LEN_T; break;
+		case 'L': ++p; len_mod = MUGGLE_LOG_DEFERRED_LEN_BIG_L; break;
+	}
+
+	// conversion
+	switch (*p)
+	{
+		case 'd':
+		case 'i':
+		{
+			spec->arg_type = muggle_log_deferred_int_type(len_mod);
+		}break;
+		case 'u':
+		case 'o':
+		case 'x':
+		case 'X':
+		{
+			spec->arg_type = muggle_log_deferred_int_type(len_mod);
+			spec->is_unsigned = 1;
+		}break;
+		case 'c':
+		{
+			spec->arg_type = len_mod == MUGGLE_LOG_DEFERRED_LEN_NONE ? MUGGLE_LOG_DEFERRED_ARG_INT : -1;
+		}break;
+		case 'f':
+		case 'F':
+		case 'e':
+		case 'E':
+		case 'g':
+		case 'G':
+		case 'a':
+		case 'A':
+		{
+			if (len_mod == MUGGLE_LOG_DEFERRED_LEN_BIG_L)
+			{
+				spec->arg_type = MUGGLE_LOG_DEFERRED_ARG_LDOUBLE;
+			}
+			else if (len_mod == MUGGLE_LOG_DEFERRED_LEN_NONE || len_mod == MUGGLE_LOG_DEFERRED_LEN_L)
+			{
+				spec->arg_type = MUGGLE_LOG_DEFERRED_ARG_DOUBLE;
+			}
+			else
+			{
+				spec->arg_type = -1;
+			}
+		}break;
+		case 's':
+		{
+			spec->arg_type = len_mod == MUGGLE_LOG_DEFERRED_LEN_NONE ? MUGGLE_LOG_DEFERRED_ARG_STR : -1;
+		}break;
+		case 'p':
+		{
+			spec->arg_type = MUGGLE_LOG_DEFERRED_ARG_PTR;
+		}break;
+		case '%':
+		{
+			spec->arg_type = MUGGLE_LOG_DEFERRED_ARG_NONE;
+		}break;
+		default:
+		{
+			// %n, end of string or invalid conversion
+			spec->arg_type = -1;
+		}break;
+	}
+
+	if (spec->arg_type < 0)
+	{
+		return NULL;
+	}
+
+	++p;
+	spec->len = (int)(p - spec->start);
+
+	return p;
+}
+
+#define MUGGLE_LOG_DEFERRED_PUT(ptr, n) \
+do \
+{ \
+	if (w + (n) > end) \
+	{ \
+		return -1; \
+	} \
+	memcpy(w, ptr, n); \
+	w += (n); \
+} while (0)
+
+#define MUGGLE_LOG_DEFERRED_ENCODE_ARG(type) \
+do \
+{ \
+	type v = va_arg(args, type); \
+	MUGGLE_LOG_DEFERRED_PUT(&v, sizeof(v)); \
+} while (0)
+
+int muggle_log_deferred_encode(const char *format, va_list args, char *buf, int size)
+{
+	char *w = buf;
+	char *end = buf + size;
+	const char *p = format;
+	muggle_log_deferred_spec_t spec;
+
+	while ((p = strchr(p, '%')) != NULL)
+	{
+		p = muggle_log_deferred_parse_spec(p, &spec);
+		if (p == NULL)
+		{
+			return -1;
+		}
+
+		// precision '*' is always the last one
+		int precision = spec.precision;
+		for (int i = 0; i < spec.cnt_star; i++)
+		{
+			int v = va_arg(args, int);
+			MUGGLE_LOG_DEFERRED_PUT(&v, sizeof(v));
+			if (precision == -2 && i == spec.cnt_star - 1)
+			{
+				// negative precision is taken as if precision were omitted
+				precision = v < 0 ? -1 : v;
+			}
+		}
+
+		switch (spec.arg_type)
+		{
+			case MUGGLE_LOG_DEFERRED_ARG_INT: MUGGLE_LOG_DEFERRED_ENCODE_ARG(int); break;
+			case MUGGLE_LOG_DEFERRED_ARG_LONG: MUGGLE_LOG_DEFERRED_ENCODE_ARG(long); break;
+			case MUGGLE_LOG_DEFERRED_ARG_LLONG: MUGGLE_LOG_DEFERRED_ENCODE_ARG(long long); break;
+			case MUGGLE_LOG_DEFERRED_ARG_SIZE: MUGGLE_LOG_DEFERRED_ENCODE_ARG(size_t); break;
+			case MUGGLE_LOG_DEFERRED_ARG_INTMAX: MUGGLE_LOG_DEFERRED_ENCODE_ARG(intmax_t); break;
+			case MUGGLE_LOG_DEFERRED_ARG_PTRDIFF: MUGGLE_LOG_DEFERRED_ENCODE_ARG(ptrdiff_t); break;
+			case MUGGLE_LOG_DEFERRED_ARG_DOUBLE: MUGGLE_LOG_DEFERRED_ENCODE_ARG(double); break;
+			case MUGGLE_LOG_DEFERRED_ARG_LDOUBLE: MUGGLE_LOG_DEFERRED_ENCODE_ARG(long double); break;
+			case MUGGLE_LOG_DEFERRED_ARG_PTR: MUGGLE_LOG_DEFERRED_ENCODE_ARG(void*); break;
+			case MUGGLE_LOG_DEFERRED_ARG_STR:
+			{
+				// string may be freed before decode, copy it with terminator;
+				// with precision, string is not required to be terminated,
+				// so never read beyond precision
+				const char *s = va_arg(args, const char*);
+				if (s == NULL)
+				{
+					s = "(null)";
+				}
+				int str_len = 0;
+				if (precision >= 0)
+				{
+					const char *s_end = (const char*)memchr(s, '\0', (size_t)precision);
+					str_len = s_end ? (int)(s_end - s) : precision;
+				}
+				else
+				{
+					str_len = (int)strlen(s);
+				}
+				int n = str_len + 1;
+				MUGGLE_LOG_DEFERRED_PUT(&n, sizeof(n));
+				MUGGLE_LOG_DEFERRED_PUT(s, str_len);
+				MUGGLE_LOG_DEFERRED_PUT("", 1);
+			}break;
+		}
+	}
+
+	return (int)(w - buf);
+}
+
+#define MUGGLE_LOG_DEFERRED_GET(v) \
+do \
+{ \
+	if (r + sizeof(v) > r_end) \
+	{ \
+		return -1; \
+	} \
+	memcpy(&v, r, sizeof(v)); \
+	r += sizeof(v); \
+} while (0)
+
+#define MUGGLE_LOG_DEFERRED_DECODE_ARG(type, cast_type) \
+do \
+{ \
+	type v; \
+	MUGGLE_LOG_DEFERRED_GET(v); \
+	n = snprintf(w, remaining + 1, spec_buf, (cast_type)v); \
+} while (0)
+
+#define MUGGLE_LOG_DEFERRED_DECODE_INT(type, utype) \
+do \
+{ \
+	if (spec.is_unsigned) \
+	{ \
+		MUGGLE_LOG_DEFERRED_DECODE_ARG(type, utype); \
+	} \
+	else \
+	{ \
+		MUGGLE_LOG_DEFERRED_DECODE_ARG(type, type); \
+	} \
+} while (0)
+
+int muggle_log_deferred_decode(const char *format, const char *data, int len, char *buf, int size)
+{
+	if (buf == NULL || size <= 0)
+	{
+		return -1;
+	}
+
+	const char *r = data;
+	const char *r_end = data + len;
+	char *w = buf;
+	int remaining = size - 1;
+	const char *p = format;
+	muggle_log_deferred_spec_t spec;
+	char spec_buf[MUGGLE_LOG_DEFERRED_MAX_SPEC_LEN];
+
+	while (*p)
+	{
+		// literal text
+		const char *q = strchr(p, '%');
+		int n = q ? (int)(q - p) : (int)strlen(p);
+		if (n > remaining)
+		{
+			n = remaining;
+		}
+		memcpy(w, p, n);
+		w += n;
+		remaining -= n;
+
+		if (q == NULL)
+		{
+			break;
+		}
+
+		p = muggle_log_deferred_parse_spec(q, &spec);
+		if (p == NULL)
+		{
+			return -1;
+		}
+
+		if (spec.arg_type == MUGGLE_LOG_DEFERRED_ARG_NONE)
+		{
+			if (remaining > 0)
+			{
+				*w++ = '%';
+				--remaining;
+			}
+			continue;
+		}
+
+		// copy specification, replace '*' with encoded value
+		char *s = spec_buf;
+		char *s_end = spec_buf + sizeof(spec_buf) - 1;
+		for (int i = 0; i < spec.len; i++)
+		{
+			char c = spec.start[i];
+			if (c == '*')
+			{
+				int v;
+				MUGGLE_LOG_DEFERRED_GET(v);
+				if (v < 0 && s > spec_buf && s[-1] == '.')
+				{
+					// negative precision is taken as if precision were omitted
+					--s;
+					continue;
+				}
+				char num[16];
+				int num_len = snprintf(num, sizeof(num), "%d", v);
+				if (s + num_len > s_end)
+				{
+					return -1;
+				}
+				memcpy(s, num, num_len);
+				s += num_len;
+			}
+			else
+			{
+				if (s >= s_end)
+				{
+					return -1;
+				}
+				*s++ = c;
+			}
+		}
+		*s = '\0';
+
+		n = -1;
+		switch (spec.arg_type)
+		{
+			case MUGGLE_LOG_DEFERRED_ARG_INT: MUGGLE_LOG_DEFERRED_DECODE_INT(int, unsigned int); break;
+			case MUGGLE_LOG_DEFERRED_ARG_LONG: MUGGLE_LOG_DEFERRED_DECODE_INT(long, unsigned long); break;
+			case MUGGLE_LOG_DEFERRED_ARG_LLONG: MUGGLE_LOG_DEFERRED_DECODE_INT(long long, unsigned long long); break;
+			case MUGGLE_LOG_DEFERRED_ARG_SIZE: MUGGLE_LOG_DEFERRED_DECODE_ARG(size_t, size_t); break;
+			case MUGGLE_LOG_DEFERRED_ARG_INTMAX: MUGGLE_LOG_DEFERRED_DECODE_INT(intmax_t, uintmax_t); break;
+			case MUGGLE_LOG_DEFERRED_ARG_PTRDIFF: MUGGLE_LOG_DEFERRED_DECODE_ARG(ptrdiff_t, ptrdiff_t); break;
+			case MUGGLE_LOG_DEFERRED_ARG_DOUBLE: MUGGLE_LOG_DEFERRED_DECODE_ARG(double, double); break;
+			case MUGGLE_LOG_DEFERRED_ARG_LDOUBLE: MUGGLE_LOG_DEFERRED_DECODE_ARG(long double, long double); break;
+			case MUGGLE_LOG_DEFERRED_ARG_PTR: MUGGLE_LOG_DEFERRED_DECODE_ARG(void*, void*); break;
+			case MUGGLE_LOG_DEFERRED_ARG_STR:
+			{
+				int str_len;
+				MUGGLE_LOG_DEFERRED_GET(str_len);
+				if (str_len <= 0 || r + str_len > r_end || r[str_len - 1] != '\0')
+				{
+					return -1;
+				}
+				n = snprintf(w, remaining + 1, spec_buf, r);
+				r += str_len;
+			}break;
+		}
+
+		if (n < 0)
+		{
+			return -1;
+		}
+		if (n > remaining)
+		{
+			n = remaining;
+		}
+		w += n;
+		remaining -= n;
+	}
+
+	*w = '\0';
+
+	return (int)(w - buf);
+}
@@ -0,0 +1,68 @@
+/******************************************************************************
+ *  @file         log_deferred.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec log deferred formatting
+ *
+ * Split printf style formatting into two steps, so the expensive one can
+ * run in log backend thread:
+ * - encode: scan format string in caller thread, copy arguments into a
+ *   compact binary buffer, string arguments are copied up to their precision
+ * - decode: format every conversion with its argument into output buffer
+ *
+ * The encoded buffer only contains raw argument bytes, their types are
+ * implied by the format string, so the same format string must be passed
+ * to decode, and it must stay valid until decoded, e.g. string literal.
+ *
+ * Supported conversions: d i u o x X c f F e E g G a A s p and %%, with
+ * flags, width, precision ('*' is supported) and length modifiers
+ * hh h l ll j z t L. %n and wide characters/strings are not supported.
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_LOG_DEFERRED_H_
+#define MUGGLE_C_LOG_DEFERRED_H_
+
+#include "muggle/c/base/macro.h"
+#include <stdarg.h>
+
+EXTERN_C_BEGIN
+
+/**
+ * @brief encode arguments of format string
+ *
+ * @param format  format string
+ * @param args    arguments of format string
+ * @param buf     output encoded buffer
+ * @param size    size of buf
+ *
+ * @return
+ *     - on success, return number of bytes encoded
+ *     - return -1 if format contains unsupported conversion or buf is not
+ *       enough, user need format message immediately
+ */
+MUGGLE_C_EXPORT
+int muggle_log_deferred_encode(const char *format, va_list args, char *buf, int size);
+
+/**
+ * @brief format message from format string and encoded arguments
+ *
+ * @param format  format string passed to muggle_log_deferred_encode
+ * @param data    encoded arguments
+ * @param len     number of encoded bytes
+ * @param buf     output message buffer, it's always null terminated
+ * @param size    size of buf
+ *
+ * @return
+ *     - on success, return length of message, message is truncated when
+ *       buf is not enough
+ *     - return -1 if encoded data not match format
+ */
+MUGGLE_C_EXPORT
+int muggle_log_deferred_decode(const char *format, const char *data, int len, char *buf, int size);
+
+EXTERN_C_END
+
+#endif
@@ -14,12 +14,12 @@
 #include <time.h>
 #include <stdarg.h>
 #include <string.h>
+#include <stdint.h>
 #if MUGGLE_PLATFORM_WINDOWS
 	#include <windows.h>
 #else
 	#include <unistd.h>
 #endif
-#include "muggle/c/os/path.h"
 
  // default log priority string
 const char* g_muggle_log_level_str[MUGGLE_LOG_LEVEL_MAX] = {
@@ -31,118 +31,228 @@ const char* g_muggle_log_level_str[MUGGLE_LOG_LEVEL_MAX] = {
 	"FATAL"
 };
 
+#define MUGGLE_LOG_FMT_STR(s) { s, (int)sizeof(s) - 1 }
+
+// level fields and their lengths
+static const struct
+{
+	const char *str;
+	int len;
+} s_muggle_log_level_field[MUGGLE_LOG_LEVEL_MAX] = {
+	MUGGLE_LOG_FMT_STR(""),
+	MUGGLE_LOG_FMT_STR("<L>TRACE|"),
+	MUGGLE_LOG_FMT_STR("<L>INFO|"),
+	MUGGLE_LOG_FMT_STR("<L>WARNING|"),
+	MUGGLE_LOG_FMT_STR("<L>ERROR|"),
+	MUGGLE_LOG_FMT_STR("<L>FATAL|"),
+};
+
+static const char s_muggle_log_digits[] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+/**
+ * @brief convert unsigned integer to decimal digits, two digits a time
+ *
+ * @return number of digits, buf need at least 20 bytes
+ */
+static int muggle_log_fmt_u64toa(uint64_t v, char *buf)
+{
+	char tmp[20];
+	char *p = tmp + sizeof(tmp);
+	while (v >= 100)
+	{
+		unsigned int idx = (unsigned int)(v % 100) * 2;
+		v /= 100;
+		*--p = s_muggle_log_digits[idx + 1];
+		*--p = s_muggle_log_digits[idx];
+	}
+	if (v >= 10)
+	{
+		unsigned int idx = (unsigned int)v * 2;
+		*--p = s_muggle_log_digits[idx + 1];
+		*--p = s_muggle_log_digits[idx];
+	}
+	else
+	{
+		*--p = (char)('0' + v);
+	}
+
+	int len = (int)(tmp + sizeof(tmp) - p);
+	memcpy(buf, p, len);
+	return len;
+}
+
+/**
+ * @brief convert nanoseconds to 9 decimal digits with leading zeros
+ */
+static void muggle_log_fmt_nsec(unsigned int v, char *buf)
+{
+	buf[8] = (char)('0' + v % 10);
+	v /= 10;
+	for (int i = 6; i >= 0; i -= 2)
+	{
+		unsigned int idx = (v % 100) * 2;
+		v /= 100;
+		buf[i + 1] = s_muggle_log_digits[idx + 1];
+		buf[i] = s_muggle_log_digits[idx];
+	}
+}
+
+/**
+ * @brief copy as many bytes as possible before end
+ *
+ * @return position after copied bytes
+ */
+static char* muggle_log_fmt_append(char *p, char *end, const char *s, int len)
+{
+	int remaining = (int)(end - p);
+	if (len > remaining)
+	{
+		len = remaining;
+	}
+	memcpy(p, s, len);
+	return p + len;
+}
+
+static int muggle_log_fmt_time_prefix(time_t sec, char *buf)
+{
+	int len = 3;
+	memcpy(buf, "<T>", 3);
+	if (sec < 0)
+	{
+		buf[len++] = '-';
+		len += muggle_log_fmt_u64toa((uint64_t)0 - (uint64_t)sec, buf + len);
+	}
+	else
+	{
+		len += muggle_log_fmt_u64toa((uint64_t)sec, buf + len);
+	}
+	buf[len++] = '.';
+	return len;
+}
+
+void muggle_log_fmt_time_cache_init(muggle_log_fmt_time_cache_t *cache)
+{
+	memset(cache, 0, sizeof(*cache));
+}
+
 int muggle_log_fmt_gen(
 	int fmt_flag, muggle_log_fmt_arg_t *arg,
 	const char *msg, char *buf, int size)
 {
-	unsigned int remaining = size - 1, num_write = 0;
-	char *p = buf;
+	return muggle_log_fmt_gen_cached(fmt_flag, arg, msg, buf, size, NULL);
+}
 
+int muggle_log_fmt_gen_cached(
+	int fmt_flag, muggle_log_fmt_arg_t *arg,
+	const char *msg, char *buf, int size,
+	muggle_log_fmt_time_cache_t *cache)
+{
 	if (buf == NULL || size <= 0)
 	{
 		return 0;
 	}
 
-	if (remaining <= 0)
+	if (size == 1)
 	{
+		buf[0] = '\0';
 		return -1;
 	}
 
+	// fields are truncated at end, keep the last byte for '\0'
+	char *p = buf;
+	char *end = buf + size - 1;
+	char tmp[64];
+	int len = 0;
+
 	if (fmt_flag & MUGGLE_LOG_FMT_LEVEL)
 	{
 		int level = arg->level >> MUGGLE_LOG_LEVEL_OFFSET;
 		if (level > 0 && level < MUGGLE_LOG_LEVEL_MAX)
 		{
-			num_write = snprintf(p, remaining, "<L>%s|", g_muggle_log_level_str[level]);
-			if (num_write < 0)
-			{
-				return -1;
-			}
-			remaining -= num_write;
-			p += num_write;
-		}		
-
-		if (remaining <= 0)
-		{
-			return size - 1;
+			p = muggle_log_fmt_append(
+				p, end, s_muggle_log_level_field[level].str, s_muggle_log_level_field[level].len);
 		}
 	}
 	if (fmt_flag & MUGGLE_LOG_FMT_FILE)
 	{
-		char filename[MUGGLE_MAX_PATH];
-		muggle_path_basename(arg->file, filename, sizeof(filename));
-
-		num_write = snprintf(p, remaining, "<F>%s:%d|", filename, arg->line);
-		if (num_write == -1)
+		const char *file = arg->file ? arg->file : "";
+		int file_len = (int)strlen(file);
+		int pos = file_len;
+		while (pos > 0 && file[pos - 1] != '/' && file[pos - 1] != '\\')
 		{
-			return -1;
+			--pos;
 		}
-		remaining -= num_write;
-		p += num_write;
 
-		if (remaining <= 0)
-		{
-			return size - 1;
-		}
+		p = muggle_log_fmt_append(p, end, "<F>", 3);
+		p = muggle_log_fmt_append(p, end, file + pos, file_len - pos);
+		tmp[0] = ':';
+		len = 1 + muggle_log_fmt_u64toa(arg->line, tmp + 1);
+		tmp[len++] = '|';
+		p = muggle_log_fmt_append(p, end, tmp, len);
 	}
 	if (fmt_flag & MUGGLE_LOG_FMT_FUNC)
 	{
-		num_write = snprintf(p, remaining, "<f>%s|", arg->func);
-		if (num_write == -1)
-		{
-			return -1;
-		}
-		remaining -= num_write;
-		p += num_write;
-
-		if (remaining <= 0)
-		{
-			return size - 1;
-		}
+		const char *func = arg->func ? arg->func : "";
+		p = muggle_log_fmt_append(p, end, "<f>", 3);
+		p = muggle_log_fmt_append(p, end, func, (int)strlen(func));
+		p = muggle_log_fmt_append(p, end, "|", 1);
 	}
 	if (fmt_flag & MUGGLE_LOG_FMT_TIME)
 	{
 		struct timespec ts;
-		timespec_get(&ts, TIME_UTC);
-		num_write = snprintf(p, remaining, "<T>%lld.%09d|",
-			(long long)ts.tv_sec, (int)ts.tv_nsec);
-		if (num_write == -1)
+		if (arg->ts)
 		{
-			return -1;
+			ts = *arg->ts;
 		}
-		remaining -= num_write;
-		p += num_write;
-
-		if (remaining <= 0)
+		else
 		{
-			return size - 1;
+			timespec_get(&ts, TIME_UTC);
 		}
-	}
-	if (fmt_flag & MUGGLE_LOG_FMT_THREAD)
-	{
-		num_write = snprintf(p, remaining, "<t>%llu|", (unsigned long long)arg->tid);
-		if (num_write == -1)
+
+		if (cache)
 		{
-			return -1;
+			// second part only changes once a second
+			if (cache->len == 0 || cache->sec != ts.tv_sec)
+			{
+				cache->len = muggle_log_fmt_time_prefix(ts.tv_sec, cache->prefix);
+				cache->sec = ts.tv_sec;
+			}
+			memcpy(tmp, cache->prefix, cache->len);
+			len = cache->len;
 		}
-		remaining -= num_write;
-		p += num_write;
-
-		if (remaining <= 0)
+		else
 		{
-			return size - 1;
+			len = muggle_log_fmt_time_prefix(ts.tv_sec, tmp);
 		}
+		muggle_log_fmt_nsec((unsigned int)ts.tv_nsec, tmp + len);
+		len += 9;
+		tmp[len++] = '|';
+		p = muggle_log_fmt_append(p, end, tmp, len);
+	}
+	if (fmt_flag & MUGGLE_LOG_FMT_THREAD)
+	{
+		memcpy(tmp, "<t>", 3);
+		len = 3 + muggle_log_fmt_u64toa((uint64_t)arg->tid, tmp + 3);
+		tmp[len++] = '|';
+		p = muggle_log_fmt_append(p, end, tmp, len);
 	}
 	if (msg != NULL)
 	{
-		num_write = snprintf(p, remaining, " - %s\n", msg);
-		if (num_write == -1)
-		{
-			return -1;
-		}
-		remaining -= num_write;
-		p += num_write;
+		p = muggle_log_fmt_append(p, end, " - ", 3);
+		p = muggle_log_fmt_append(p, end, msg, (int)strlen(msg));
+		p = muggle_log_fmt_append(p, end, "\n", 1);
 	}
+	*p = '\0';
 
-	return size - 1 - remaining;
+	return (int)(p - buf);
 }
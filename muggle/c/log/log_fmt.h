@@ -13,6 +13,7 @@
 
 #include "muggle/c/base/macro.h"
 #include "muggle/c/base/thread.h"
+#include <time.h>
 
 EXTERN_C_BEGIN
 
@@ -43,8 +44,31 @@ typedef struct muggle_log_fmt_arg_tag
 	const char       *file; //!< file name
 	const char       *func; //!< function name
 	muggle_thread_id tid;   //!< thread id
+	const struct timespec *ts; //!< log time, NULL represent current time
 }muggle_log_fmt_arg_t;
 
+/**
+ * @brief time prefix cache of log formatter
+ *
+ * records in the same second share the same time prefix, it's rendered only
+ * when second changes. NOTE: it's not thread safe, every formatting thread
+ * (e.g. async backend thread) keep its own cache
+ */
+typedef struct muggle_log_fmt_time_cache_tag
+{
+	time_t sec;        //!< second of cached prefix
+	int    len;        //!< length of cached prefix, 0 represent empty
+	char   prefix[32]; //!< "<T>" + second + "."
+}muggle_log_fmt_time_cache_t;
+
+/**
+ * @brief initialize time prefix cache
+ *
+ * @param cache  time prefix cache
+ */
+MUGGLE_C_EXPORT
+void muggle_log_fmt_time_cache_init(muggle_log_fmt_time_cache_t *cache);
+
 /**
  * @brief generate formated message
  *
@@ -61,6 +85,24 @@ int muggle_log_fmt_gen(
 	int fmt_flag, muggle_log_fmt_arg_t *arg,
 	const char *msg, char *buf, int size);
 
+/**
+ * @brief generate formated message with time prefix cache
+ *
+ * @param fmt_flag format flag
+ * @param arg      format arguments
+ * @param msg      original message
+ * @param buf      the formated message output buffer
+ * @param size     the size of buf
+ * @param cache    time prefix cache, NULL represent render time every time
+ *
+ * @return  the len of formated message, negative represent failed
+ */
+MUGGLE_C_EXPORT
+int muggle_log_fmt_gen_cached(
+	int fmt_flag, muggle_log_fmt_arg_t *arg,
+	const char *msg, char *buf, int size,
+	muggle_log_fmt_time_cache_t *cache);
+
 EXTERN_C_END
 
 #endif
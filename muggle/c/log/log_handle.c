@@ -11,11 +11,16 @@
 #include "log_handle.h"
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include "muggle/c/base/err.h"
 #include "muggle/c/log/log_handle_console.h"
 #include "muggle/c/log/log_handle_file.h"
 #include "muggle/c/log/log_handle_rotating_file.h"
 #include "muggle/c/log/log_handle_win_debug.h"
+#include "muggle/c/log/log_deferred.h"
+#include "muggle/c/base/sleep.h"
+#include "muggle/c/time/cpu_cycle.h"
+#include "muggle/c/sync/futex.h"
 
 typedef int (*muggle_log_output_fn)(
 	muggle_log_handle_t *handle,
@@ -38,51 +43,753 @@ static muggle_log_handle_destroy_fn s_log_handle_destroy_fn[MUGGLE_LOG_TYPE_MAX]
 	muggle_log_handle_win_debug_destroy,
 };
 
+enum
+{
+	MUGGLE_LOG_ASYNC_RECORD_MSG = 0,  //!< data is formatted message
+	MUGGLE_LOG_ASYNC_RECORD_DEFERRED, //!< data is encoded arguments of format
+};
+
+/**
+ * @brief async record in staging ring, sized to its data; file, func and
+ * format have static storage duration, so they are kept by pointer
+ */
+typedef struct muggle_log_async_record_tag
+{
+	int type;              //!< MUGGLE_LOG_ASYNC_RECORD_*
+	int level;
+	unsigned int line;
+	int len;               //!< number of bytes in data
+	const char *file;
+	const char *func;
+	muggle_thread_id tid;
+	uint64_t tsc;          //!< cpu cycle when log, 0 represent use ts
+	struct timespec ts;    //!< log time when cpu cycle is not available
+	const char *format;
+	char data[];           //!< formatted message or encoded arguments
+}muggle_log_async_record_t;
+
+/**
+ * @brief staging ring of a logging thread, only the owner thread write it
+ * and only the backend thread read it
+ */
+typedef struct muggle_log_async_stage_tag
+{
+	muggle_byte_ring_t ring;
+	muggle_atomic_int closed;  //!< owner thread exit, free it after drained
+	struct muggle_log_async_stage_tag *next;
+	uint32_t flush_cursor;     //!< write cursor when flush began, only used by backend thread
+	int flush_wait;            //!< records before flush_cursor are not output yet
+
+}muggle_log_async_stage_t;
+
+// logging thread exit, backend thread free its stage after drained
+static void muggle_log_async_stage_close(void *arg)
+{
+	muggle_log_async_stage_t *stage = (muggle_log_async_stage_t*)arg;
+	muggle_atomic_store(&stage->closed, 1, muggle_memory_order_release);
+}
+
+#if MUGGLE_PLATFORM_WINDOWS
+
+static VOID WINAPI muggle_log_async_tls_destructor(PVOID arg)
+{
+	if (arg)
+	{
+		muggle_log_async_stage_close(arg);
+	}
+}
+
+static int muggle_log_async_tls_create(muggle_log_handle_t *handle)
+{
+	handle->async.tls_key = FlsAlloc(muggle_log_async_tls_destructor);
+	return handle->async.tls_key == FLS_OUT_OF_INDEXES ? MUGGLE_ERR_SYS_CALL : MUGGLE_OK;
+}
+
+static void muggle_log_async_tls_delete(muggle_log_handle_t *handle)
+{
+	// FlsFree invoke callback for current thread, clear it first
+	FlsSetValue(handle->async.tls_key, NULL);
+	FlsFree(handle->async.tls_key);
+}
+
+#define muggle_log_async_tls_get(handle) FlsGetValue((handle)->async.tls_key)
+#define muggle_log_async_tls_set(handle, stage) FlsSetValue((handle)->async.tls_key, stage)
+
+#else
+
+static int muggle_log_async_tls_create(muggle_log_handle_t *handle)
+{
+	return pthread_key_create(&handle->async.tls_key, muggle_log_async_stage_close) == 0 ?
+		MUGGLE_OK : MUGGLE_ERR_SYS_CALL;
+}
+
+static void muggle_log_async_tls_delete(muggle_log_handle_t *handle)
+{
+	pthread_key_delete(handle->async.tls_key);
+}
+
+#define muggle_log_async_tls_get(handle) pthread_getspecific((handle)->async.tls_key)
+#define muggle_log_async_tls_set(handle, stage) pthread_setspecific((handle)->async.tls_key, stage)
+
+#endif
+
+static muggle_log_async_stage_t* muggle_log_handle_async_stage(muggle_log_handle_t *handle)
+{
+	muggle_log_async_stage_t *stage = (muggle_log_async_stage_t*)muggle_log_async_tls_get(handle);
+	if (stage)
+	{
+		return stage;
+	}
+
+	stage = (muggle_log_async_stage_t*)malloc(sizeof(muggle_log_async_stage_t));
+	if (stage == NULL)
+	{
+		return NULL;
+	}
+	memset(stage, 0, sizeof(muggle_log_async_stage_t));
+
+	int ret = muggle_byte_ring_init(
+		&stage->ring, handle->async.stage_size,
+		MUGGLE_BYTE_RING_FLAG_SINGLE_WRITER | MUGGLE_BYTE_RING_FLAG_READ_BUSY_LOOP);
+	if (ret != MUGGLE_OK)
+	{
+		free(stage);
+		return NULL;
+	}
+
+	muggle_fast_mutex_lock(&handle->async.stage_mutex);
+	stage->next = handle->async.stages;
+	handle->async.stages = stage;
+	muggle_fast_mutex_unlock(&handle->async.stage_mutex);
+
+	muggle_log_async_tls_set(handle, stage);
+
+	return stage;
+}
+
+static void muggle_log_handle_async_notify(muggle_log_handle_t *handle)
+{
+	// pair with parked store in muggle_log_handle_run_async
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	if (muggle_atomic_load(&handle->async.parked, muggle_memory_order_relaxed))
+	{
+		muggle_atomic_fetch_add(&handle->async.notify_seq, 1, muggle_memory_order_relaxed);
+		muggle_futex_wake_one(&handle->async.notify_seq);
+	}
+}
+
+static muggle_log_async_record_t* muggle_log_handle_async_reserve(
+	muggle_log_async_stage_t *stage,
+	int type,
+	muggle_log_fmt_arg_t *arg,
+	int len
+)
+{
+	uint32_t size = (uint32_t)(sizeof(muggle_log_async_record_t) + len);
+	muggle_log_async_record_t *record = NULL;
+
+	// ring is full, wait backend thread consume records
+	while ((record = (muggle_log_async_record_t*)muggle_byte_ring_reserve(&stage->ring, size)) == NULL)
+	{
+		muggle_thread_yield();
+	}
+
+	record->type = type;
+	record->len = len;
+	record->level = arg->level;
+	record->line = arg->line;
+	record->file = arg->file;
+	record->func = arg->func;
+	record->tid = arg->tid;
+
+	// timestamp for output and merge records from different threads
+	record->tsc = muggle_get_cpu_cycle();
+	if (record->tsc == 0)
+	{
+		timespec_get(&record->ts, TIME_UTC);
+	}
+
+	return record;
+}
+
+static void muggle_log_handle_async_commit(
+	muggle_log_handle_t *handle,
+	muggle_log_async_stage_t *stage,
+	muggle_log_async_record_t *record
+)
+{
+	muggle_byte_ring_commit(&stage->ring, record);
+	muggle_log_handle_async_notify(handle);
+}
+
 static int muggle_log_handle_async_write(
 	muggle_log_handle_t *handle,
 	muggle_log_fmt_arg_t *arg,
 	const char *msg
 )
 {
-	muggle_log_asnyc_msg_t *async_msg = (muggle_log_asnyc_msg_t*)handle->p_alloc(sizeof(muggle_log_asnyc_msg_t));
-	if (async_msg == NULL)
+	muggle_log_async_stage_t *stage = muggle_log_handle_async_stage(handle);
+	if (stage == NULL)
+	{
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+
+	size_t len = strlen(msg);
+	if (len > MUGGLE_LOG_MAX_LEN - 1)
+	{
+		len = MUGGLE_LOG_MAX_LEN - 1;
+	}
+
+	muggle_log_async_record_t *record =
+		muggle_log_handle_async_reserve(stage, MUGGLE_LOG_ASYNC_RECORD_MSG, arg, (int)len + 1);
+	memcpy(record->data, msg, len);
+	record->data[len] = '\0';
+	muggle_log_handle_async_commit(handle, stage, record);
+
+	return MUGGLE_OK;
+}
+
+/**
+ * @brief cpu cycle to time converter of async backend thread
+ */
+typedef struct muggle_log_deferred_clock_tag
+{
+	uint64_t tsc_base;
+	struct timespec ts_base;
+	uint64_t tsc_calibrate;  //!< cpu cycle of last calibration
+	uint64_t tsc_interval;   //!< cpu cycles between calibrations
+	double ns_per_cycle;
+}muggle_log_deferred_clock_t;
+
+static void muggle_log_deferred_clock_calibrate(muggle_log_deferred_clock_t *clock)
+{
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	uint64_t tsc = muggle_get_cpu_cycle();
+
+	int64_t elapsed_ns =
+		(int64_t)(ts.tv_sec - clock->ts_base.tv_sec) * 1000000000 +
+		(ts.tv_nsec - clock->ts_base.tv_nsec);
+	if (tsc > clock->tsc_base && elapsed_ns > 0)
+	{
+		clock->ns_per_cycle = (double)elapsed_ns / (double)(tsc - clock->tsc_base);
+		clock->tsc_interval = (uint64_t)(1000000000.0 / clock->ns_per_cycle);
+	}
+	clock->tsc_calibrate = tsc;
+}
+
+static void muggle_log_deferred_clock_init(muggle_log_deferred_clock_t *clock)
+{
+	memset(clock, 0, sizeof(*clock));
+	timespec_get(&clock->ts_base, TIME_UTC);
+	clock->tsc_base = muggle_get_cpu_cycle();
+	if (clock->tsc_base == 0)
+	{
+		return;
+	}
+
+	// records written before calibration finished wait in ring
+	muggle_msleep(10);
+	muggle_log_deferred_clock_calibrate(clock);
+}
+
+static void muggle_log_deferred_clock_to_ts(
+	muggle_log_deferred_clock_t *clock, uint64_t tsc, struct timespec *ts)
+{
+	// the longer since base, the more accurate frequency; records stamped
+	// before last calibration are queued backlog, don't calibrate for them
+	if (tsc > clock->tsc_calibrate && tsc - clock->tsc_calibrate > clock->tsc_interval)
+	{
+		muggle_log_deferred_clock_calibrate(clock);
+	}
+
+	int64_t ns = (int64_t)((double)(int64_t)(tsc - clock->tsc_base) * clock->ns_per_cycle);
+	int64_t sec = ns / 1000000000;
+	ns = ns % 1000000000 + clock->ts_base.tv_nsec;
+	if (ns < 0)
+	{
+		ns += 1000000000;
+		sec -= 1;
+	}
+	else if (ns >= 1000000000)
+	{
+		ns -= 1000000000;
+		sec += 1;
+	}
+	ts->tv_sec = clock->ts_base.tv_sec + (time_t)sec;
+	ts->tv_nsec = (long)ns;
+}
+
+static uint64_t muggle_log_async_record_stamp(muggle_log_async_record_t *record)
+{
+	if (record->tsc != 0)
+	{
+		return record->tsc;
+	}
+	return (uint64_t)record->ts.tv_sec * 1000000000 + (uint64_t)record->ts.tv_nsec;
+}
+
+/**
+ * @brief context of async backend thread
+ */
+typedef struct muggle_log_async_backend_tag
+{
+	muggle_log_handle_t *handle;
+	muggle_log_deferred_clock_t clock;
+	muggle_log_async_stage_t **stages; //!< snapshot of staging rings
+	muggle_log_async_record_t **heads; //!< head record of each staging ring
+	int capacity;                      //!< capacity of stages and heads
+	char *batch;                       //!< formatted records wait for write, NULL represent output one by one, e.g. console
+	int batch_len;
+	struct timespec batch_ts;          //!< time of the first record appended into batch
+	muggle_log_fmt_time_cache_t time_cache;
+	char msg[MUGGLE_LOG_MAX_LEN];
+}muggle_log_async_backend_t;
+
+static void muggle_log_handle_async_batch_write(muggle_log_async_backend_t *backend)
+{
+	if (backend->batch_len == 0)
+	{
+		return;
+	}
+
+	muggle_log_handle_t *handle = backend->handle;
+	if (handle->type == MUGGLE_LOG_TYPE_ROTATING_FILE)
+	{
+		muggle_log_handle_rotating_file_output_raw(handle, backend->batch, backend->batch_len);
+	}
+	else
+	{
+		muggle_log_handle_file_output_raw(handle, backend->batch, backend->batch_len);
+	}
+	backend->batch_len = 0;
+}
+
+static void muggle_log_handle_async_batch_append(
+	muggle_log_async_backend_t *backend,
+	muggle_log_fmt_arg_t *arg,
+	const char *msg
+)
+{
+	muggle_log_handle_t *handle = backend->handle;
+
+	if (MUGGLE_LOG_ASYNC_BATCH_SIZE - backend->batch_len < MUGGLE_LOG_MAX_LEN)
+	{
+		muggle_log_handle_async_batch_write(backend);
+	}
+
+	int ret = muggle_log_fmt_gen_cached(
+		handle->fmt_flag, arg, msg, backend->batch + backend->batch_len, MUGGLE_LOG_MAX_LEN,
+		&backend->time_cache);
+	if (ret <= 0)
+	{
+		return;
+	}
+	if (backend->batch_len == 0)
+	{
+		timespec_get(&backend->batch_ts, TIME_UTC);
+	}
+	backend->batch_len += ret;
+
+	if (backend->batch_len >= muggle_atomic_load(&handle->async.flush_bytes, muggle_memory_order_relaxed))
+	{
+		muggle_log_handle_async_batch_write(backend);
+	}
+	else if (handle->type == MUGGLE_LOG_TYPE_ROTATING_FILE &&
+		(unsigned int)handle->rotating_file.offset + (unsigned int)backend->batch_len >=
+		handle->rotating_file.max_bytes)
+	{
+		// rotate at the same record as sync write
+		muggle_log_handle_async_batch_write(backend);
+	}
+}
+
+/**
+ * @brief nanoseconds before batch must be written
+ *
+ * @return remain nanoseconds, 0 represent write it now, -1 represent no limit
+ */
+static int64_t muggle_log_handle_async_batch_remain(muggle_log_async_backend_t *backend)
+{
+	if (backend->batch_len == 0)
+	{
+		return -1;
+	}
+
+	int interval_ms = muggle_atomic_load(&backend->handle->async.flush_interval_ms, muggle_memory_order_relaxed);
+	if (interval_ms <= 0)
+	{
+		return 0;
+	}
+
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	int64_t elapsed_ns =
+		(int64_t)(ts.tv_sec - backend->batch_ts.tv_sec) * 1000000000 +
+		(ts.tv_nsec - backend->batch_ts.tv_nsec);
+	int64_t remain_ns = (int64_t)interval_ms * 1000000 - elapsed_ns;
+
+	return remain_ns > 0 ? remain_ns : 0;
+}
+
+static void muggle_log_handle_async_output(
+	muggle_log_async_backend_t *backend,
+	muggle_log_async_record_t *record
+)
+{
+	struct timespec ts;
+	if (record->tsc == 0)
+	{
+		ts = record->ts;
+	}
+	else
+	{
+		muggle_log_deferred_clock_to_ts(&backend->clock, record->tsc, &ts);
+	}
+
+	muggle_log_fmt_arg_t arg = {
+		record->level,
+		record->line,
+		record->file,
+		record->func,
+		record->tid,
+		&ts
+	};
+
+	const char *output = record->data;
+	if (record->type == MUGGLE_LOG_ASYNC_RECORD_DEFERRED)
+	{
+		char *buf = backend->msg;
+		int size = (int)sizeof(backend->msg);
+		if (muggle_log_deferred_decode(record->format, record->data, record->len, buf, size) < 0)
+		{
+			strncpy(buf, record->format, size - 1);
+			buf[size - 1] = '\0';
+		}
+		output = buf;
+	}
+
+	if (backend->batch)
+	{
+		muggle_log_handle_async_batch_append(backend, &arg, output);
+	}
+	else
+	{
+		s_output_fn[backend->handle->type](backend->handle, &arg, output);
+	}
+}
+
+/**
+ * @brief snapshot staging rings, free closed stages that already drained
+ *
+ * @return number of stages in snapshot, -1 represent failed allocate memory
+ */
+static int muggle_log_handle_async_snapshot(muggle_log_async_backend_t *backend)
+{
+	muggle_log_handle_t *handle = backend->handle;
+	int cnt = 0;
+
+	muggle_fast_mutex_lock(&handle->async.stage_mutex);
+
+	muggle_log_async_stage_t **prev_next = &handle->async.stages;
+	muggle_log_async_stage_t *stage = handle->async.stages;
+	while (stage)
+	{
+		// owner exited, nothing will be written after closed; keep stage
+		// in snapshot until pending flush see it
+		if (!stage->flush_wait &&
+			muggle_atomic_load(&stage->closed, muggle_memory_order_acquire) &&
+			muggle_byte_ring_try_peek(&stage->ring, NULL) == NULL)
+		{
+			*prev_next = stage->next;
+			muggle_byte_ring_destroy(&stage->ring);
+			free(stage);
+			stage = *prev_next;
+			continue;
+		}
+
+		if (cnt == backend->capacity)
+		{
+			int capacity = backend->capacity == 0 ? 16 : backend->capacity * 2;
+			void *stages = realloc(backend->stages, sizeof(muggle_log_async_stage_t*) * capacity);
+			if (stages == NULL)
+			{
+				muggle_fast_mutex_unlock(&handle->async.stage_mutex);
+				return -1;
+			}
+			backend->stages = (muggle_log_async_stage_t**)stages;
+
+			void *heads = realloc(backend->heads, sizeof(muggle_log_async_record_t*) * capacity);
+			if (heads == NULL)
+			{
+				muggle_fast_mutex_unlock(&handle->async.stage_mutex);
+				return -1;
+			}
+			backend->heads = (muggle_log_async_record_t**)heads;
+
+			backend->capacity = capacity;
+		}
+		backend->stages[cnt++] = stage;
+
+		prev_next = &stage->next;
+		stage = stage->next;
+	}
+
+	muggle_fast_mutex_unlock(&handle->async.stage_mutex);
+
+	return cnt;
+}
+
+/**
+ * @brief drain staging rings, always output the earliest head record
+ *
+ * @return number of records output, less than MUGGLE_LOG_ASYNC_DRAIN_ROUND
+ * represent all staging rings were seen empty
+ */
+static int muggle_log_handle_async_drain(muggle_log_async_backend_t *backend, int cnt_stage)
+{
+	muggle_log_async_stage_t **stages = backend->stages;
+	muggle_log_async_record_t **heads = backend->heads;
+	int cnt = 0;
+	for (int i = 0; i < cnt_stage; i++)
+	{
+		heads[i] = NULL;
+	}
+
+	while (cnt < MUGGLE_LOG_ASYNC_DRAIN_ROUND)
+	{
+		int idx = -1;
+		uint64_t min_stamp = 0;
+		for (int i = 0; i < cnt_stage; i++)
+		{
+			if (heads[i] == NULL)
+			{
+				heads[i] = (muggle_log_async_record_t*)muggle_byte_ring_try_peek(&stages[i]->ring, NULL);
+				if (heads[i] == NULL)
+				{
+					continue;
+				}
+			}
+
+			uint64_t stamp = muggle_log_async_record_stamp(heads[i]);
+			if (idx == -1 || stamp < min_stamp)
+			{
+				idx = i;
+				min_stamp = stamp;
+			}
+		}
+
+		if (idx == -1)
+		{
+			break;
+		}
+
+		muggle_log_handle_async_output(backend, heads[idx]);
+		muggle_byte_ring_release(&stages[idx]->ring);
+		heads[idx] = NULL;
+		++cnt;
+	}
+
+	return cnt;
+}
+
+/**
+ * @brief begin flush, records committed before request are before current
+ * write cursor of staging rings in snapshot
+ */
+static void muggle_log_handle_async_flush_begin(muggle_log_async_backend_t *backend, int cnt_stage)
+{
+	for (int i = 0; i < cnt_stage; i++)
+	{
+		muggle_log_async_stage_t *stage = backend->stages[i];
+		stage->flush_cursor = (uint32_t)muggle_atomic_load(&stage->ring.write_cursor, muggle_memory_order_acquire);
+		stage->flush_wait = 1;
+	}
+}
+
+/**
+ * @brief check whether read cursors of staging rings passed flush cursors
+ *
+ * @return 1 represent all records committed before flush request are output
+ */
+static int muggle_log_handle_async_flush_reached(muggle_log_async_backend_t *backend, int cnt_stage)
+{
+	int reached = 1;
+	for (int i = 0; i < cnt_stage; i++)
+	{
+		muggle_log_async_stage_t *stage = backend->stages[i];
+		if (!stage->flush_wait)
+		{
+			continue;
+		}
+
+		// cursors wrap around as unsigned 32 bits integer
+		uint32_t read_cursor = (uint32_t)muggle_atomic_load(&stage->ring.read_cursor, muggle_memory_order_relaxed);
+		if ((int32_t)(read_cursor - stage->flush_cursor) >= 0)
+		{
+			stage->flush_wait = 0;
+		}
+		else
+		{
+			reached = 0;
+		}
+	}
+	return reached;
+}
+
+static int muggle_log_handle_async_empty(muggle_log_async_backend_t *backend, int cnt_stage)
+{
+	for (int i = 0; i < cnt_stage; i++)
+	{
+		if (muggle_byte_ring_try_peek(&backend->stages[i]->ring, NULL) != NULL)
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/**
+ * @brief allocate context of async backend thread
+ *
+ * NOTE: allocated before backend thread start, so failure is returned by
+ * muggle_log_handle_base_init instead of losing backend thread
+ */
+static int muggle_log_async_backend_create(muggle_log_handle_t *handle)
+{
+	muggle_log_async_backend_t *backend =
+		(muggle_log_async_backend_t*)malloc(sizeof(muggle_log_async_backend_t));
+	if (backend == NULL)
 	{
 		return MUGGLE_ERR_MEM_ALLOC;
 	}
+	memset(backend, 0, sizeof(*backend));
+
+	backend->handle = handle;
+	if (handle->type == MUGGLE_LOG_TYPE_FILE || handle->type == MUGGLE_LOG_TYPE_ROTATING_FILE)
+	{
+		backend->batch = (char*)malloc(MUGGLE_LOG_ASYNC_BATCH_SIZE);
+		if (backend->batch == NULL)
+		{
+			free(backend);
+			return MUGGLE_ERR_MEM_ALLOC;
+		}
+	}
+	muggle_log_fmt_time_cache_init(&backend->time_cache);
 
-	async_msg->level = arg->level;
-	async_msg->line = arg->line;
-	strncpy(async_msg->file, arg->file, sizeof(async_msg->file) - 1);
-	strncpy(async_msg->func, arg->file, sizeof(async_msg->func) - 1);
-	async_msg->tid = arg->tid;
-	strncpy(async_msg->msg, msg, sizeof(async_msg->msg) - 1);
+	handle->async.backend = backend;
 
-	return muggle_ring_buffer_write(&handle->async.ring, async_msg);
+	return MUGGLE_OK;
 }
 
-muggle_thread_ret_t muggle_log_handle_run_async(void *arg)
+static void muggle_log_async_backend_destroy(muggle_log_handle_t *handle)
 {
-	int idx = 0;
-	muggle_log_handle_t *handle = (muggle_log_handle_t*)arg;
+	muggle_log_async_backend_t *backend = handle->async.backend;
+	if (backend == NULL)
+	{
+		return;
+	}
+
+	free(backend->stages);
+	free(backend->heads);
+	free(backend->batch);
+	free(backend);
+	handle->async.backend = NULL;
+}
+
+muggle_thread_ret_t muggle_log_handle_run_async(void *p_arg)
+{
+	muggle_log_handle_t *handle = (muggle_log_handle_t*)p_arg;
+	muggle_log_async_backend_t *backend = handle->async.backend;
+
+	muggle_log_deferred_clock_init(&backend->clock);
+
+	muggle_atomic_int flush_done = muggle_atomic_load(&handle->async.flush_done, muggle_memory_order_relaxed);
+	muggle_atomic_int flush_req = flush_done; // flush request in progress
 	while (1)
 	{
-		muggle_log_asnyc_msg_t *async_msg = 
-			(muggle_log_asnyc_msg_t*)muggle_ring_buffer_read(&handle->async.ring, idx++);
-		if (async_msg == NULL)
+		int running = muggle_atomic_load(&handle->async.running, muggle_memory_order_acquire);
+
+		// records committed before flush request are in snapshot
+		muggle_atomic_int req = muggle_atomic_load(&handle->async.flush_req, muggle_memory_order_acquire);
+
+		int cnt_stage = muggle_log_handle_async_snapshot(backend);
+		if (cnt_stage < 0)
+		{
+			muggle_msleep(1);
+			continue;
+		}
+
+		if (flush_req == flush_done && req != flush_done)
+		{
+			// don't wait all staging rings empty, it may never happen under
+			// sustained load; only wait records committed before request
+			muggle_log_handle_async_flush_begin(backend, cnt_stage);
+			flush_req = req;
+		}
+
+		int cnt = muggle_log_handle_async_drain(backend, cnt_stage);
+
+		if (flush_req != flush_done &&
+			muggle_log_handle_async_flush_reached(backend, cnt_stage))
+		{
+			muggle_log_handle_async_batch_write(backend);
+			flush_done = flush_req;
+			muggle_atomic_store(&handle->async.flush_done, flush_done, muggle_memory_order_release);
+			muggle_futex_wake_all(&handle->async.flush_done);
+		}
+
+		if (cnt == MUGGLE_LOG_ASYNC_DRAIN_ROUND)
+		{
+			if (muggle_log_handle_async_batch_remain(backend) == 0 &&
+				muggle_atomic_load(&handle->async.flush_interval_ms, muggle_memory_order_relaxed) > 0)
+			{
+				muggle_log_handle_async_batch_write(backend);
+			}
+			continue;
+		}
+
+		if (!running)
 		{
+			// all records written before destroy are drained
+			muggle_log_handle_async_batch_write(backend);
+			if (flush_req != flush_done)
+			{
+				flush_done = flush_req;
+				muggle_atomic_store(&handle->async.flush_done, flush_done, muggle_memory_order_release);
+				muggle_futex_wake_all(&handle->async.flush_done);
+			}
 			break;
 		}
 
-		muggle_log_fmt_arg_t arg = {
-			async_msg->level,
-			async_msg->line,
-			async_msg->file,
-			async_msg->func,
-			async_msg->tid
-		};
-		s_output_fn[handle->type](handle, &arg, async_msg->msg);
+		int64_t remain_ns = muggle_log_handle_async_batch_remain(backend);
+		if (remain_ns == 0)
+		{
+			muggle_log_handle_async_batch_write(backend);
+			remain_ns = -1;
+		}
+
+		if (cnt > 0)
+		{
+			continue;
+		}
+
+		// park until logging thread commit record, flush requested or batch expired
+		struct timespec timeout;
+		timeout.tv_sec = (time_t)(remain_ns / 1000000000);
+		timeout.tv_nsec = (long)(remain_ns % 1000000000);
 
-		handle->p_free(async_msg);
+		muggle_atomic_int seq = muggle_atomic_load(&handle->async.notify_seq, muggle_memory_order_acquire);
+		muggle_atomic_store(&handle->async.parked, 1, muggle_memory_order_seq_cst);
+		muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+		if (flush_req == flush_done &&
+			muggle_log_handle_async_empty(backend, cnt_stage) &&
+			muggle_atomic_load(&handle->async.running, muggle_memory_order_seq_cst) &&
+			muggle_atomic_load(&handle->async.flush_req, muggle_memory_order_seq_cst) == flush_done)
+		{
+			muggle_futex_wait(&handle->async.notify_seq, seq, remain_ns > 0 ? &timeout : NULL);
+		}
+		muggle_atomic_store(&handle->async.parked, 0, muggle_memory_order_relaxed);
 	}
 
 	return 0;
@@ -124,13 +831,53 @@ int muggle_log_handle_base_init(
 		{
 			muggle_mutex_init(&handle->sync.mutex);
 		}break;
+		case MUGGLE_LOG_WRITE_TYPE_SYNC_FAST:
+		{
+			muggle_fast_mutex_init(&handle->sync.fast_mutex);
+		}break;
 		case MUGGLE_LOG_WRITE_TYPE_ASYNC:
+		case MUGGLE_LOG_WRITE_TYPE_ASYNC_DEFERRED:
 		{
-			muggle_ring_buffer_init(
-				&handle->async.ring,
-				async_capacity,
-				MUGGLE_RING_BUFFER_FLAG_WRITE_LOCK | MUGGLE_RING_BUFFER_FLAG_SINGLE_READER); 
-			muggle_thread_create(&handle->async.thread, muggle_log_handle_run_async, handle);
+			int64_t stage_size = (int64_t)async_capacity * MUGGLE_LOG_ASYNC_RECORD_RESERVE_SIZE;
+			if (stage_size < MUGGLE_LOG_MAX_LEN * 4)
+			{
+				stage_size = MUGGLE_LOG_MAX_LEN * 4;
+			}
+			else if (stage_size > (1 << 30))
+			{
+				stage_size = 1 << 30;
+			}
+			handle->async.stage_size = (muggle_atomic_int)stage_size;
+			handle->async.stages = NULL;
+			handle->async.backend = NULL;
+			handle->async.running = 1;
+			handle->async.parked = 0;
+			handle->async.notify_seq = 0;
+			handle->async.flush_bytes = MUGGLE_LOG_ASYNC_BATCH_SIZE;
+			handle->async.flush_interval_ms = 0;
+			handle->async.flush_req = 0;
+			handle->async.flush_done = 0;
+
+			int ret = muggle_log_async_backend_create(handle);
+			if (ret != MUGGLE_OK)
+			{
+				return ret;
+			}
+			ret = muggle_log_async_tls_create(handle);
+			if (ret != MUGGLE_OK)
+			{
+				muggle_log_async_backend_destroy(handle);
+				return ret;
+			}
+			muggle_fast_mutex_init(&handle->async.stage_mutex);
+			ret = muggle_thread_create(&handle->async.thread, muggle_log_handle_run_async, handle);
+			if (ret != MUGGLE_OK)
+			{
+				muggle_fast_mutex_destroy(&handle->async.stage_mutex);
+				muggle_log_async_tls_delete(handle);
+				muggle_log_async_backend_destroy(handle);
+				return ret;
+			}
 		}break;
 	}
 
@@ -145,16 +892,67 @@ int muggle_log_handle_destroy(muggle_log_handle_t *handle)
 		{
 			muggle_mutex_destroy(&handle->sync.mutex);
 		}break;
+		case MUGGLE_LOG_WRITE_TYPE_SYNC_FAST:
+		{
+			muggle_fast_mutex_destroy(&handle->sync.fast_mutex);
+		}break;
 		case MUGGLE_LOG_WRITE_TYPE_ASYNC:
+		case MUGGLE_LOG_WRITE_TYPE_ASYNC_DEFERRED:
 		{
-			muggle_ring_buffer_write(&handle->async.ring, NULL);
+			muggle_atomic_store(&handle->async.running, 0, muggle_memory_order_seq_cst);
+			muggle_atomic_fetch_add(&handle->async.notify_seq, 1, muggle_memory_order_seq_cst);
+			muggle_futex_wake_one(&handle->async.notify_seq);
 			muggle_thread_join(&handle->async.thread);
+
+			// no destructor invoked after tls key deleted, stages can be freed
+			muggle_log_async_tls_delete(handle);
+			muggle_log_async_stage_t *stage = handle->async.stages;
+			while (stage)
+			{
+				muggle_log_async_stage_t *next = stage->next;
+				muggle_byte_ring_destroy(&stage->ring);
+				free(stage);
+				stage = next;
+			}
+			handle->async.stages = NULL;
+			muggle_fast_mutex_destroy(&handle->async.stage_mutex);
+			muggle_log_async_backend_destroy(handle);
 		}break;
 	}
 
 	return s_log_handle_destroy_fn[handle->type](handle);
 }
 
+void muggle_log_handle_lock(muggle_log_handle_t *handle)
+{
+	switch (handle->write_type)
+	{
+		case MUGGLE_LOG_WRITE_TYPE_SYNC:
+		{
+			muggle_mutex_lock(&handle->sync.mutex);
+		}break;
+		case MUGGLE_LOG_WRITE_TYPE_SYNC_FAST:
+		{
+			muggle_fast_mutex_lock(&handle->sync.fast_mutex);
+		}break;
+	}
+}
+
+void muggle_log_handle_unlock(muggle_log_handle_t *handle)
+{
+	switch (handle->write_type)
+	{
+		case MUGGLE_LOG_WRITE_TYPE_SYNC:
+		{
+			muggle_mutex_unlock(&handle->sync.mutex);
+		}break;
+		case MUGGLE_LOG_WRITE_TYPE_SYNC_FAST:
+		{
+			muggle_fast_mutex_unlock(&handle->sync.fast_mutex);
+		}break;
+	}
+}
+
 int muggle_log_handle_write(
 	muggle_log_handle_t *handle,
 	muggle_log_fmt_arg_t *arg,
@@ -166,7 +964,8 @@ int muggle_log_handle_write(
 		return MUGGLE_OK;
 	}
 
-	if (handle->write_type == MUGGLE_LOG_WRITE_TYPE_ASYNC)
+	if (handle->write_type == MUGGLE_LOG_WRITE_TYPE_ASYNC ||
+		handle->write_type == MUGGLE_LOG_WRITE_TYPE_ASYNC_DEFERRED)
 	{
 		return muggle_log_handle_async_write(handle, arg, msg);
 	}
@@ -175,3 +974,100 @@ int muggle_log_handle_write(
 		return s_output_fn[handle->type](handle, arg, msg) > 0 ? MUGGLE_OK : MUGGLE_ERR_INVALID_PARAM;
 	}
 }
+
+int muggle_log_handle_write_deferred(
+	muggle_log_handle_t *handle,
+	muggle_log_fmt_arg_t *arg,
+	const char *format,
+	const char *data,
+	int len
+)
+{
+	if (arg->level < handle->level)
+	{
+		return MUGGLE_OK;
+	}
+
+	if (handle->write_type != MUGGLE_LOG_WRITE_TYPE_ASYNC_DEFERRED)
+	{
+		char msg[MUGGLE_LOG_MAX_LEN];
+		if (muggle_log_deferred_decode(format, data, len, msg, sizeof(msg)) < 0)
+		{
+			return MUGGLE_ERR_INVALID_PARAM;
+		}
+		return muggle_log_handle_write(handle, arg, msg);
+	}
+
+	if (len < 0 || len > MUGGLE_LOG_MAX_LEN)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	muggle_log_async_stage_t *stage = muggle_log_handle_async_stage(handle);
+	if (stage == NULL)
+	{
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+
+	muggle_log_async_record_t *record =
+		muggle_log_handle_async_reserve(stage, MUGGLE_LOG_ASYNC_RECORD_DEFERRED, arg, len);
+	record->format = format;
+	memcpy(record->data, data, len);
+	muggle_log_handle_async_commit(handle, stage, record);
+
+	return MUGGLE_OK;
+}
+
+int muggle_log_handle_set_async_flush(
+	muggle_log_handle_t *handle,
+	int flush_bytes,
+	int flush_interval_ms
+)
+{
+	if (handle->write_type != MUGGLE_LOG_WRITE_TYPE_ASYNC &&
+		handle->write_type != MUGGLE_LOG_WRITE_TYPE_ASYNC_DEFERRED)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	if (flush_bytes <= 0 || flush_bytes > MUGGLE_LOG_ASYNC_BATCH_SIZE)
+	{
+		flush_bytes = MUGGLE_LOG_ASYNC_BATCH_SIZE;
+	}
+	if (flush_interval_ms < 0)
+	{
+		flush_interval_ms = 0;
+	}
+
+	muggle_atomic_store(&handle->async.flush_bytes, flush_bytes, muggle_memory_order_relaxed);
+	muggle_atomic_store(&handle->async.flush_interval_ms, flush_interval_ms, muggle_memory_order_relaxed);
+
+	return MUGGLE_OK;
+}
+
+int muggle_log_handle_flush(muggle_log_handle_t *handle)
+{
+	if (handle->write_type != MUGGLE_LOG_WRITE_TYPE_ASYNC &&
+		handle->write_type != MUGGLE_LOG_WRITE_TYPE_ASYNC_DEFERRED)
+	{
+		return MUGGLE_OK;
+	}
+
+	// records of current thread are committed before request
+	muggle_atomic_int req = muggle_atomic_fetch_add(&handle->async.flush_req, 1, muggle_memory_order_seq_cst) + 1;
+
+	muggle_atomic_fetch_add(&handle->async.notify_seq, 1, muggle_memory_order_seq_cst);
+	muggle_futex_wake_one(&handle->async.notify_seq);
+
+	while (1)
+	{
+		muggle_atomic_int done = muggle_atomic_load(&handle->async.flush_done, muggle_memory_order_acquire);
+		if ((int32_t)((uint32_t)done - (uint32_t)req) >= 0)
+		{
+			break;
+		}
+		muggle_futex_wait(&handle->async.flush_done, done, NULL);
+	}
+
+	return MUGGLE_OK;
+}
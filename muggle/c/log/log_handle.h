@@ -16,8 +16,14 @@
 #include "muggle/c/base/atomic.h"
 #include "muggle/c/base/thread.h"
 #include "muggle/c/sync/mutex.h"
-#include "muggle/c/sync/ring_buffer.h"
+#include "muggle/c/sync/fast_mutex.h"
+#include "muggle/c/sync/byte_ring.h"
 #include "muggle/c/log/log_fmt.h"
+#if MUGGLE_PLATFORM_WINDOWS
+	#include <windows.h>
+#else
+	#include <pthread.h>
+#endif
 
 EXTERN_C_BEGIN
 
@@ -35,6 +41,8 @@ enum
 	MUGGLE_LOG_WRITE_TYPE_DEFAULT = 0, //!< log write without protect
 	MUGGLE_LOG_WRITE_TYPE_SYNC,        //!< log sync write with mutex
 	MUGGLE_LOG_WRITE_TYPE_ASYNC,       //!< log async write
+	MUGGLE_LOG_WRITE_TYPE_SYNC_FAST,   //!< log sync write with muggle_fast_mutex_t
+	MUGGLE_LOG_WRITE_TYPE_ASYNC_DEFERRED, //!< log async write, format message in backend thread
 	MUGGLE_LOG_WRITE_TYPE_MAX,
 };
 
@@ -42,27 +50,50 @@ enum
 {
 	MUGGLE_LOG_HANDLE_RESERVE_SIZE = 64,
 	MUGGLE_LOG_MAX_LEN = 4096,
+	MUGGLE_LOG_ASYNC_RECORD_RESERVE_SIZE = 256, //!< bytes of staging ring reserved for each message of async capacity
+	MUGGLE_LOG_ASYNC_DRAIN_ROUND = 1024,        //!< max records drained before refresh staging rings
+	MUGGLE_LOG_ASYNC_BATCH_SIZE = 64 * 1024,    //!< bytes of async backend output batch of file handles
 };
 
-typedef struct muggle_log_async_msg_tag
-{
-	int level;
-	unsigned int line;
-	char file[512];
-	char func[512];
-	muggle_thread_id tid;
-	char msg[MUGGLE_LOG_MAX_LEN];
-}muggle_log_asnyc_msg_t;
-
 typedef struct muggle_log_handle_property_sync_tag
 {
-	muggle_mutex_t mutex;
+	union
+	{
+		muggle_mutex_t      mutex;      //!< MUGGLE_LOG_WRITE_TYPE_SYNC
+		muggle_fast_mutex_t fast_mutex; //!< MUGGLE_LOG_WRITE_TYPE_SYNC_FAST
+	};
 }muggle_log_handle_property_sync_t;
 
+struct muggle_log_async_stage_tag;
+struct muggle_log_async_backend_tag;
+
+/**
+ * @brief async write property
+ *
+ * every logging thread lazily get its own single writer staging ring, so
+ * logging threads never share a cache line; the backend thread drain all
+ * staging rings and merge records by timestamp; file handles append formatted
+ * records into a batch buffer and write it at once
+ */
 typedef struct muggle_log_handle_property_async_tag
 {
-	muggle_ring_buffer_t ring;
 	muggle_thread_t thread;
+#if MUGGLE_PLATFORM_WINDOWS
+	DWORD tls_key;
+#else
+	pthread_key_t tls_key;
+#endif
+	muggle_fast_mutex_t stage_mutex;          //!< protect stages list
+	struct muggle_log_async_stage_tag *stages; //!< staging rings of all logging threads
+	struct muggle_log_async_backend_tag *backend; //!< context of backend thread
+	muggle_atomic_int stage_size;             //!< bytes of each staging ring
+	muggle_atomic_int running;
+	muggle_atomic_int parked;                 //!< backend thread is waiting notify
+	muggle_atomic_int notify_seq;             //!< futex word of backend thread
+	muggle_atomic_int flush_bytes;            //!< write batch when it reach this size
+	muggle_atomic_int flush_interval_ms;      //!< max delay of batched records, 0 represent write when no record ready
+	muggle_atomic_int flush_req;              //!< number of flush requests
+	muggle_atomic_int flush_done;             //!< futex word, number of finished flush requests
 }muggle_log_handle_property_async_t;
 
 typedef struct muggle_log_handle_property_console_tag
@@ -117,9 +148,21 @@ typedef struct muggle_log_handle_tag
  * @param write_type     use one of MUGGLE_LOG_WRITE_TYPE_*
  * @param fmt_flag       use MUGGLE_LOG_FMT_*
  * @param level          log level that the log handle will output
- * @param async_capacity if write_type == MUGGLE_LOG_WRITE_TYPE_ASYNC, use this specify async buffer capacity
- * @param p_alloc        function for async allocate memory, if NULL, use malloc
- * @param p_free         function for async free memory, if NULL, use free
+ * @param async_capacity if write_type == MUGGLE_LOG_WRITE_TYPE_ASYNC, use this specify
+ *                       number of messages staging ring of each logging thread
+ *                       can hold on average; every logging thread allocate
+ *                       async_capacity * MUGGLE_LOG_ASYNC_RECORD_RESERVE_SIZE
+ *                       bytes staging ring, e.g. the default 8K take 2MB per
+ *                       logging thread, so 32 logging threads take 64MB
+ * @param p_alloc        reserved, async records live in staging ring, if NULL, use malloc
+ * @param p_free         reserved, async records live in staging ring, if NULL, use free
+ *
+ * NOTE: async records keep file and func name by pointer, so they must have
+ * static storage duration, e.g. __FILE__ and __FUNCTION__.
+ * MUGGLE_LOG_WRITE_TYPE_ASYNC_DEFERRED only copy arguments and cpu cycle
+ * timestamp in caller thread, message is formatted in backend thread, so
+ * format string must have static storage duration too, e.g. string literal;
+ * string arguments are copied
  *
  * @return
  *     0 - success
@@ -146,11 +189,35 @@ int muggle_log_handle_base_init(
 MUGGLE_C_EXPORT
 int muggle_log_handle_destroy(muggle_log_handle_t *handle);
 
+/**
+ * @brief lock log handle output according to write type
+ *
+ * NOTE: used by log handle output functions, no-op unless write_type is
+ * MUGGLE_LOG_WRITE_TYPE_SYNC or MUGGLE_LOG_WRITE_TYPE_SYNC_FAST
+ *
+ * @param handle  log handle pointer
+ */
+MUGGLE_C_EXPORT
+void muggle_log_handle_lock(muggle_log_handle_t *handle);
+
+/**
+ * @brief unlock log handle output according to write type
+ *
+ * @param handle  log handle pointer
+ */
+MUGGLE_C_EXPORT
+void muggle_log_handle_unlock(muggle_log_handle_t *handle);
+
 /**
  * @brief  output message
  *
+ * NOTE: if write type of handle is MUGGLE_LOG_WRITE_TYPE_ASYNC or
+ * MUGGLE_LOG_WRITE_TYPE_ASYNC_DEFERRED, record keep arg->file and arg->func
+ * by pointer until output in backend thread, so they must have static
+ * storage duration, e.g. __FILE__ and __FUNCTION__
+ *
  * @param handle log handle pointer
- * @param arg    log format arguments
+ * @param arg    log format arguments, file and func with static storage duration
  * @param msg    log messages
  *
  * @return  success returns 0, otherwise return err code in err.h
@@ -162,6 +229,67 @@ int muggle_log_handle_write(
 	const char *msg
 );
 
+/**
+ * @brief output message with deferred formatting arguments
+ *
+ * NOTE: if write type of handle is not MUGGLE_LOG_WRITE_TYPE_ASYNC_DEFERRED,
+ * message is formatted immediately and output by muggle_log_handle_write
+ *
+ * @param handle log handle pointer
+ * @param arg    log format arguments
+ * @param format format string with static storage duration
+ * @param data   arguments encoded by muggle_log_deferred_encode
+ * @param len    number of bytes in data
+ *
+ * @return  success returns 0, otherwise return err code in err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_log_handle_write_deferred(
+	muggle_log_handle_t *handle,
+	muggle_log_fmt_arg_t *arg,
+	const char *format,
+	const char *data,
+	int len
+);
+
+/**
+ * @brief set when async backend thread write batched records of file handles
+ *
+ * NOTE: batch is written once no record ready by default
+ *
+ * @param handle            log handle pointer
+ * @param flush_bytes       write batch when it reach this size, value out of
+ *                          range [1, MUGGLE_LOG_ASYNC_BATCH_SIZE] represent
+ *                          MUGGLE_LOG_ASYNC_BATCH_SIZE
+ * @param flush_interval_ms if greater than 0, records are allowed to stay in
+ *                          batch at most this milliseconds even if no more
+ *                          record ready; otherwise write batch once no
+ *                          record ready
+ *
+ * @return  success returns 0, otherwise return err code in err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_log_handle_set_async_flush(
+	muggle_log_handle_t *handle,
+	int flush_bytes,
+	int flush_interval_ms
+);
+
+/**
+ * @brief wait until all records written before are output
+ *
+ * NOTE: for async write types, block until backend thread output records
+ * committed before this request and written batch, records committed later
+ * are not waited, so it returns under sustained load; other write types
+ * flush output when write, so return immediately
+ *
+ * @param handle log handle pointer
+ *
+ * @return  success returns 0, otherwise return err code in err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_log_handle_flush(muggle_log_handle_t *handle);
+
 EXTERN_C_END
 
 #endif
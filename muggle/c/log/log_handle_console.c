@@ -70,10 +70,7 @@ int muggle_log_handle_console_output(
 		fp = stderr;
 	}
 
-	if (handle->write_type == MUGGLE_LOG_WRITE_TYPE_SYNC)
-	{
-		muggle_mutex_lock(&handle->sync.mutex);
-	}
+	muggle_log_handle_lock(handle);
 
 	if (handle->console.enable_color && arg->level >= MUGGLE_LOG_LEVEL_WARNING)
 	{
@@ -124,10 +121,7 @@ int muggle_log_handle_console_output(
 		fflush(fp);
 	}
 
-	if (handle->write_type == MUGGLE_LOG_WRITE_TYPE_SYNC)
-	{
-		muggle_mutex_unlock(&handle->sync.mutex);
-	}
+	muggle_log_handle_unlock(handle);
 
 	return ret;
 }
@@ -63,21 +63,25 @@ int muggle_log_handle_file_output(
 		return ret;
 	}
 
-	if (handle->write_type == MUGGLE_LOG_WRITE_TYPE_SYNC)
-	{
-		muggle_mutex_lock(&handle->sync.mutex);
-	}
+	muggle_log_handle_lock(handle);
+	ret = muggle_log_handle_file_output_raw(handle, buf, ret);
+	muggle_log_handle_unlock(handle);
+
+	return ret;
+}
 
+int muggle_log_handle_file_output_raw(
+	muggle_log_handle_t *handle,
+	const char *buf,
+	int len
+)
+{
+	int ret = len;
 	if (handle->file.fp)
 	{
-		ret = (int)fwrite(buf, 1, ret, handle->file.fp);
+		ret = (int)fwrite(buf, 1, len, handle->file.fp);
 		fflush(handle->file.fp);
 	}
 
-	if (handle->write_type == MUGGLE_LOG_WRITE_TYPE_SYNC)
-	{
-		muggle_mutex_unlock(&handle->sync.mutex);
-	}
-
 	return ret;
 }
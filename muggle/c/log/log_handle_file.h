@@ -72,6 +72,25 @@ int muggle_log_handle_file_output(
 	const char *msg
 );
 
+/**
+ * @brief output formatted bytes without lock
+ *
+ * NOTE: caller must guarantee exclusive access to the handle, e.g. async
+ * backend thread write a batch of formatted records at once
+ *
+ * @param handle  file log handle pointer
+ * @param buf     formatted records
+ * @param len     number of bytes in buf
+ *
+ * @return success return number of bytes be writed to output, otherwise return negative
+ */
+MUGGLE_C_EXPORT
+int muggle_log_handle_file_output_raw(
+	muggle_log_handle_t *handle,
+	const char *buf,
+	int len
+);
+
 EXTERN_C_END
 
 #endif
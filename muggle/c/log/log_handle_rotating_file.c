@@ -126,14 +126,23 @@ int muggle_log_handle_rotating_file_output(
 		return ret;
 	}
 
-	if (handle->write_type == MUGGLE_LOG_WRITE_TYPE_SYNC)
-	{
-		muggle_mutex_lock(&handle->sync.mutex);
-	}
+	muggle_log_handle_lock(handle);
+	ret = muggle_log_handle_rotating_file_output_raw(handle, buf, ret);
+	muggle_log_handle_unlock(handle);
+
+	return ret;
+}
 
+int muggle_log_handle_rotating_file_output_raw(
+	muggle_log_handle_t *handle,
+	const char *buf,
+	int len
+)
+{
+	int ret = len;
 	if (handle->rotating_file.fp)
 	{
-		ret = (int)fwrite(buf, 1, ret, handle->rotating_file.fp);
+		ret = (int)fwrite(buf, 1, len, handle->rotating_file.fp);
 		fflush(handle->rotating_file.fp);
 	}
 
@@ -143,10 +152,5 @@ int muggle_log_handle_rotating_file_output(
 		muggle_log_handle_rotating_file_rotate(handle);
 	}
 
-	if (handle->write_type == MUGGLE_LOG_WRITE_TYPE_SYNC)
-	{
-		muggle_mutex_unlock(&handle->sync.mutex);
-	}
-
 	return ret;
 }
@@ -66,17 +66,11 @@ int muggle_log_handle_win_debug_output(
 	WCHAR w_buf[MUGGLE_LOG_MAX_LEN];
 	MultiByteToWideChar(CP_UTF8, 0, buf, -1, w_buf, sizeof(w_buf));
 
-	if (handle->write_type == MUGGLE_LOG_WRITE_TYPE_SYNC)
-	{
-		muggle_mutex_lock(&handle->sync.mutex);
-	}
+	muggle_log_handle_lock(handle);
 
 	OutputDebugStringW(w_buf);
 
-	if (handle->write_type == MUGGLE_LOG_WRITE_TYPE_SYNC)
-	{
-		muggle_mutex_unlock(&handle->sync.mutex);
-	}
+	muggle_log_handle_unlock(handle);
 
 
 	return ret;
@@ -0,0 +1,166 @@
+/******************************************************************************
+ *  @file         arena.c
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec arena allocator
+ *****************************************************************************/
+
+#include "arena.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include "muggle/c/base/err.h"
+
+static muggle_arena_block_t* muggle_arena_new_block(size_t capacity)
+{
+	muggle_arena_block_t *block =
+		(muggle_arena_block_t*)malloc(sizeof(muggle_arena_block_t) + capacity);
+	if (block == NULL)
+	{
+		return NULL;
+	}
+
+	block->next = NULL;
+	block->capacity = capacity;
+	block->offset = 0;
+
+	return block;
+}
+
+static void* muggle_arena_block_alloc(muggle_arena_block_t *block, size_t size, size_t alignment)
+{
+	uintptr_t base = (uintptr_t)(block + 1);
+	uintptr_t p = (base + block->offset + alignment - 1) & ~((uintptr_t)alignment - 1);
+	if (p - base > block->capacity || size > block->capacity - (p - base))
+	{
+		return NULL;
+	}
+
+	block->offset = (size_t)(p - base) + size;
+
+	return (void*)p;
+}
+
+int muggle_arena_init(muggle_arena_t *arena, size_t block_size)
+{
+	if (block_size == 0)
+	{
+		block_size = MUGGLE_ARENA_DEFAULT_BLOCK_SIZE;
+	}
+
+	arena->block_size = block_size;
+	arena->head = muggle_arena_new_block(block_size);
+	if (arena->head == NULL)
+	{
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+	arena->cur = arena->head;
+
+	return MUGGLE_OK;
+}
+
+void muggle_arena_destroy(muggle_arena_t *arena)
+{
+	muggle_arena_block_t *block = arena->head;
+	while (block)
+	{
+		muggle_arena_block_t *next = block->next;
+		free(block);
+		block = next;
+	}
+
+	arena->head = NULL;
+	arena->cur = NULL;
+}
+
+void* muggle_arena_alloc(muggle_arena_t *arena, size_t size)
+{
+	return muggle_arena_alloc_aligned(arena, size, MUGGLE_ARENA_DEFAULT_ALIGN);
+}
+
+void* muggle_arena_alloc_aligned(muggle_arena_t *arena, size_t size, size_t alignment)
+{
+	if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+	{
+		return NULL;
+	}
+
+	void *data = muggle_arena_block_alloc(arena->cur, size, alignment);
+	if (data)
+	{
+		return data;
+	}
+
+	// reuse block released by rewind or reset
+	muggle_arena_block_t *next = arena->cur->next;
+	if (next)
+	{
+		next->offset = 0;
+		data = muggle_arena_block_alloc(next, size, alignment);
+		if (data)
+		{
+			arena->cur = next;
+			return data;
+		}
+	}
+
+	// oversize data get a dedicated block, it's kept for reuse like others
+	if (size > SIZE_MAX - sizeof(muggle_arena_block_t) - alignment)
+	{
+		return NULL;
+	}
+
+	size_t capacity = arena->block_size;
+	if (size + alignment > capacity)
+	{
+		capacity = size + alignment;
+	}
+
+	muggle_arena_block_t *block = muggle_arena_new_block(capacity);
+	if (block == NULL)
+	{
+		return NULL;
+	}
+	block->next = next;
+	arena->cur->next = block;
+	arena->cur = block;
+
+	return muggle_arena_block_alloc(block, size, alignment);
+}
+
+void muggle_arena_free(void *arena, void *data)
+{
+	// data is released by rewind or reset
+	(void)arena;
+	(void)data;
+}
+
+void muggle_arena_mark(muggle_arena_t *arena, muggle_arena_mark_t *mark)
+{
+	mark->block = arena->cur;
+	mark->offset = arena->cur->offset;
+}
+
+void muggle_arena_rewind(muggle_arena_t *arena, const muggle_arena_mark_t *mark)
+{
+	arena->cur = mark->block;
+	arena->cur->offset = mark->offset;
+}
+
+void muggle_arena_reset(muggle_arena_t *arena)
+{
+	arena->cur = arena->head;
+	arena->cur->offset = 0;
+}
+
+size_t muggle_arena_capacity(muggle_arena_t *arena)
+{
+	size_t capacity = 0;
+	for (muggle_arena_block_t *block = arena->head; block; block = block->next)
+	{
+		capacity += block->capacity;
+	}
+	return capacity;
+}
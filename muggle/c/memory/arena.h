@@ -0,0 +1,154 @@
+/******************************************************************************
+ *  @file         arena.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec arena allocator
+ *
+ * Region allocator for scratch memory with the same lifetime, e.g. all
+ * temporary objects of a request. Allocation bump a pointer in current
+ * block, data can't be freed one by one, instead rewind to a mark or reset
+ * the whole arena in O(1). Blocks are kept for reuse until arena destroyed.
+ *
+ * NOTE: arena is not thread safe
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_ARENA_H_
+#define MUGGLE_C_ARENA_H_
+
+#include "muggle/c/base/macro.h"
+#include <stddef.h>
+
+EXTERN_C_BEGIN
+
+#define MUGGLE_ARENA_DEFAULT_BLOCK_SIZE (1024 * 16) //!< default block size
+#define MUGGLE_ARENA_DEFAULT_ALIGN (sizeof(void*) * 2) //!< default alignment of data
+
+/**
+ * @brief arena block head, data follow the head
+ */
+typedef struct muggle_arena_block
+{
+	struct muggle_arena_block *next;
+	size_t                    capacity; //!< bytes of data area
+	size_t                    offset;   //!< bytes used in data area
+}muggle_arena_block_t;
+
+/**
+ * @brief arena allocator
+ */
+typedef struct muggle_arena
+{
+	muggle_arena_block_t *head;       //!< first block
+	muggle_arena_block_t *cur;        //!< current block, blocks after it are free
+	size_t               block_size;  //!< default data bytes of new block
+}muggle_arena_t;
+
+/**
+ * @brief arena position, used to release all data allocated after it
+ */
+typedef struct muggle_arena_mark
+{
+	muggle_arena_block_t *block;
+	size_t               offset;
+}muggle_arena_mark_t;
+
+/**
+ * @brief init arena
+ *
+ * @param arena       pointer to arena
+ * @param block_size  data bytes of each block, if 0, use MUGGLE_ARENA_DEFAULT_BLOCK_SIZE
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_arena_init(muggle_arena_t *arena, size_t block_size);
+
+/**
+ * @brief destroy arena, return all blocks to system
+ *
+ * @param arena  pointer to arena
+ */
+MUGGLE_C_EXPORT
+void muggle_arena_destroy(muggle_arena_t *arena);
+
+/**
+ * @brief allocate data aligned to MUGGLE_ARENA_DEFAULT_ALIGN
+ *
+ * @param arena  pointer to arena
+ * @param size   data size
+ *
+ * @return on success return data that allocated, if failed, return NULL
+ */
+MUGGLE_C_EXPORT
+void* muggle_arena_alloc(muggle_arena_t *arena, size_t size);
+
+/**
+ * @brief allocate data with alignment
+ *
+ * @param arena      pointer to arena
+ * @param size       data size
+ * @param alignment  alignment of data, must be power of 2
+ *
+ * @return on success return data that allocated, if failed, return NULL
+ */
+MUGGLE_C_EXPORT
+void* muggle_arena_alloc_aligned(muggle_arena_t *arena, size_t size, size_t alignment);
+
+/**
+ * @brief free data, do nothing, data is released by rewind or reset
+ *
+ * NOTE: the signature match muggle_dsaa_data_free, so it can be passed to
+ * dsaa containers destroy and clear functions
+ *
+ * @param arena  pointer to arena
+ * @param data   data allocated by arena
+ */
+MUGGLE_C_EXPORT
+void muggle_arena_free(void *arena, void *data);
+
+/**
+ * @brief save current position of arena
+ *
+ * @param arena  pointer to arena
+ * @param mark   output mark
+ */
+MUGGLE_C_EXPORT
+void muggle_arena_mark(muggle_arena_t *arena, muggle_arena_mark_t *mark);
+
+/**
+ * @brief release all data allocated after mark
+ *
+ * NOTE: marks saved after this mark are invalid after rewind
+ *
+ * @param arena  pointer to arena
+ * @param mark   mark saved by muggle_arena_mark
+ */
+MUGGLE_C_EXPORT
+void muggle_arena_rewind(muggle_arena_t *arena, const muggle_arena_mark_t *mark);
+
+/**
+ * @brief release all data in arena, blocks are kept for reuse
+ *
+ * @param arena  pointer to arena
+ */
+MUGGLE_C_EXPORT
+void muggle_arena_reset(muggle_arena_t *arena);
+
+/**
+ * @brief get number of bytes arena hold from system
+ *
+ * @param arena  pointer to arena
+ *
+ * @return bytes of all blocks' data area
+ */
+MUGGLE_C_EXPORT
+size_t muggle_arena_capacity(muggle_arena_t *arena);
+
+EXTERN_C_END
+
+#endif
@@ -352,6 +352,100 @@ bool muggle_bytes_buffer_reader_move(muggle_bytes_buffer_t *bytes_buf, int num_b
 	}
 }
 
+int muggle_bytes_buffer_writable_iov(muggle_bytes_buffer_t *bytes_buf, muggle_iovec_t *iov)
+{
+	int cnt = 0;
+
+	int cw = muggle_bytes_buffer_contiguous_writable(bytes_buf);
+	if (cw > 0)
+	{
+		iov[cnt].iov_base = bytes_buf->buffer + bytes_buf->w;
+		iov[cnt].iov_len = (size_t)cw;
+		cnt++;
+	}
+
+	int jw = muggle_bytes_buffer_jump_writable(bytes_buf);
+	if (jw > 0)
+	{
+		iov[cnt].iov_base = bytes_buf->buffer;
+		iov[cnt].iov_len = (size_t)jw;
+		cnt++;
+	}
+
+	return cnt;
+}
+
+bool muggle_bytes_buffer_writer_move_iov(muggle_bytes_buffer_t *bytes_buf, int num_bytes)
+{
+	int cw = muggle_bytes_buffer_contiguous_writable(bytes_buf);
+	if (cw >= num_bytes)
+	{
+		return muggle_bytes_buffer_writer_move(bytes_buf, num_bytes);
+	}
+
+	int jw = muggle_bytes_buffer_jump_writable(bytes_buf);
+	if (cw + jw < num_bytes)
+	{
+		return false;
+	}
+
+	// bytes fill the tail then wrap around, so no truncate
+	bytes_buf->t = bytes_buf->c;
+	bytes_buf->w = num_bytes - cw;
+
+	return true;
+}
+
+int muggle_bytes_buffer_readable_iov(muggle_bytes_buffer_t *bytes_buf, muggle_iovec_t *iov)
+{
+	int cnt = 0;
+
+	int cr = muggle_bytes_buffer_contiguous_readable(bytes_buf);
+	if (cr > 0)
+	{
+		iov[cnt].iov_base = bytes_buf->buffer + bytes_buf->r;
+		iov[cnt].iov_len = (size_t)cr;
+		cnt++;
+	}
+
+	int jr = muggle_bytes_buffer_jump_readable(bytes_buf);
+	if (jr > 0)
+	{
+		iov[cnt].iov_base = bytes_buf->buffer;
+		iov[cnt].iov_len = (size_t)jr;
+		cnt++;
+	}
+
+	return cnt;
+}
+
+bool muggle_bytes_buffer_reader_move_iov(muggle_bytes_buffer_t *bytes_buf, int num_bytes)
+{
+	int cr = muggle_bytes_buffer_contiguous_readable(bytes_buf);
+	int jr = muggle_bytes_buffer_jump_readable(bytes_buf);
+	if (cr + jr < num_bytes)
+	{
+		return false;
+	}
+
+	if (num_bytes < cr)
+	{
+		bytes_buf->r += num_bytes;
+	}
+	else if (jr > 0)
+	{
+		bytes_buf->r = num_bytes - cr;
+	}
+	else
+	{
+		bytes_buf->r += num_bytes;
+	}
+
+	muggle_bytes_buffer_refresh(bytes_buf);
+
+	return true;
+}
+
 void muggle_bytes_buffer_clear(muggle_bytes_buffer_t *bytes_buf)
 {
 	bytes_buf->w = 0;
@@ -13,6 +13,7 @@
 
 #include "muggle/c/base/macro.h"
 #include "muggle/c/base/atomic.h"
+#include "muggle/c/base/iovec.h"
 #include <stdbool.h>
 
 EXTERN_C_BEGIN
@@ -176,6 +177,54 @@ void* muggle_bytes_buffer_reader_fc(muggle_bytes_buffer_t *bytes_buf, int num_by
 MUGGLE_C_EXPORT
 bool muggle_bytes_buffer_reader_move(muggle_bytes_buffer_t *bytes_buf, int num_bytes);
 
+/**
+ * @brief get writable memory as io vectors, at most 2 spans when wrap around
+ *
+ * NOTE: usually use with readv, then invoke muggle_bytes_buffer_writer_move_iov
+ *
+ * @param bytes_buf  pointer to bytes buffer
+ * @param iov        output io vectors, at least 2 elements
+ *
+ * @return number of io vectors filled
+ */
+MUGGLE_C_EXPORT
+int muggle_bytes_buffer_writable_iov(muggle_bytes_buffer_t *bytes_buf, muggle_iovec_t *iov);
+
+/**
+ * @brief move writer after bytes written into io vectors from muggle_bytes_buffer_writable_iov
+ *
+ * @param bytes_buf  pointer to bytes buffer
+ * @param num_bytes  number of bytes written
+ *
+ * @return if success return true, otherwise return false
+ */
+MUGGLE_C_EXPORT
+bool muggle_bytes_buffer_writer_move_iov(muggle_bytes_buffer_t *bytes_buf, int num_bytes);
+
+/**
+ * @brief get readable bytes as io vectors, at most 2 spans when wrap around
+ *
+ * NOTE: usually use with writev, then invoke muggle_bytes_buffer_reader_move_iov
+ *
+ * @param bytes_buf  pointer to bytes buffer
+ * @param iov        output io vectors, at least 2 elements
+ *
+ * @return number of io vectors filled
+ */
+MUGGLE_C_EXPORT
+int muggle_bytes_buffer_readable_iov(muggle_bytes_buffer_t *bytes_buf, muggle_iovec_t *iov);
+
+/**
+ * @brief move reader after bytes in io vectors from muggle_bytes_buffer_readable_iov consumed
+ *
+ * @param bytes_buf  pointer to bytes buffer
+ * @param num_bytes  number of bytes consumed
+ *
+ * @return if success return true, otherwise return false
+ */
+MUGGLE_C_EXPORT
+bool muggle_bytes_buffer_reader_move_iov(muggle_bytes_buffer_t *bytes_buf, int num_bytes);
+
 /**
  * @brief clear bytes in bytes buffer 
  *
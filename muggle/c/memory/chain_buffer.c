@@ -0,0 +1,550 @@
+/******************************************************************************
+ *  @file         chain_buffer.c
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec chain buffer
+ *****************************************************************************/
+
+#include "chain_buffer.h"
+#include <stdlib.h>
+#include <string.h>
+#include "muggle/c/base/err.h"
+
+muggle_chain_block_t* muggle_chain_block_new(int capacity)
+{
+	if (capacity <= 0)
+	{
+		return NULL;
+	}
+
+	muggle_chain_block_t *block = (muggle_chain_block_t*)malloc(sizeof(muggle_chain_block_t) + capacity);
+	if (block == NULL)
+	{
+		return NULL;
+	}
+
+	block->ref_cnt = 1;
+	block->capacity = capacity;
+	block->w = 0;
+	block->data = (char*)(block + 1);
+	block->fn_free = NULL;
+	block->free_ctx = NULL;
+
+	return block;
+}
+
+muggle_chain_block_t* muggle_chain_block_wrap(
+	void *data, int len, muggle_chain_block_free_fn fn_free, void *free_ctx)
+{
+	if (data == NULL || len < 0)
+	{
+		return NULL;
+	}
+
+	muggle_chain_block_t *block = (muggle_chain_block_t*)malloc(sizeof(muggle_chain_block_t));
+	if (block == NULL)
+	{
+		return NULL;
+	}
+
+	// wrapped data is readonly, so write frontier is the end
+	block->ref_cnt = 1;
+	block->capacity = len;
+	block->w = len;
+	block->data = (char*)data;
+	block->fn_free = fn_free;
+	block->free_ctx = free_ctx;
+
+	return block;
+}
+
+void muggle_chain_block_ref(muggle_chain_block_t *block)
+{
+	muggle_atomic_fetch_add(&block->ref_cnt, 1, muggle_memory_order_relaxed);
+}
+
+void muggle_chain_block_release(muggle_chain_block_t *block)
+{
+	if (muggle_atomic_fetch_sub(&block->ref_cnt, 1, muggle_memory_order_acq_rel) != 1)
+	{
+		return;
+	}
+
+	if (block->data != (char*)(block + 1) && block->fn_free)
+	{
+		block->fn_free(block->free_ctx, block->data);
+	}
+	free(block);
+}
+
+static muggle_chain_segment_t* muggle_chain_segment_new(muggle_chain_block_t *block, int offset, int len)
+{
+	muggle_chain_segment_t *seg = (muggle_chain_segment_t*)malloc(sizeof(muggle_chain_segment_t));
+	if (seg == NULL)
+	{
+		return NULL;
+	}
+
+	seg->next = NULL;
+	seg->block = block;
+	seg->offset = offset;
+	seg->len = len;
+
+	return seg;
+}
+
+static void muggle_chain_segment_free(muggle_chain_segment_t *seg)
+{
+	muggle_chain_block_release(seg->block);
+	free(seg);
+}
+
+static void muggle_chain_buffer_push_back(muggle_chain_buffer_t *buf, muggle_chain_segment_t *seg)
+{
+	seg->next = NULL;
+	if (buf->tail)
+	{
+		buf->tail->next = seg;
+	}
+	else
+	{
+		buf->head = seg;
+	}
+	buf->tail = seg;
+	buf->readable += seg->len;
+}
+
+static muggle_chain_segment_t* muggle_chain_buffer_pop_front(muggle_chain_buffer_t *buf)
+{
+	muggle_chain_segment_t *seg = buf->head;
+	buf->head = seg->next;
+	if (buf->head == NULL)
+	{
+		buf->tail = NULL;
+	}
+	buf->readable -= seg->len;
+	seg->next = NULL;
+	return seg;
+}
+
+// segments after write segment are empty, reserved for write; only the
+// write segment's view end at its block's write frontier and owned by this
+// buffer, so it's the only one can grow
+static muggle_chain_segment_t* muggle_chain_buffer_writable_seg(muggle_chain_buffer_t *buf)
+{
+	while (buf->write_seg)
+	{
+		muggle_chain_segment_t *seg = buf->write_seg;
+		if (seg->block->capacity > seg->block->w)
+		{
+			return seg;
+		}
+
+		if (seg->next == NULL)
+		{
+			break;
+		}
+		buf->write_seg = seg->next;
+	}
+
+	muggle_chain_block_t *block = muggle_chain_block_new(buf->block_size);
+	if (block == NULL)
+	{
+		return NULL;
+	}
+
+	muggle_chain_segment_t *seg = muggle_chain_segment_new(block, 0, 0);
+	if (seg == NULL)
+	{
+		muggle_chain_block_release(block);
+		return NULL;
+	}
+
+	muggle_chain_buffer_push_back(buf, seg);
+	buf->write_seg = seg;
+
+	return seg;
+}
+
+// stop write into current write segment, invoked before append foreign
+// segments, so bytes are always in order
+static void muggle_chain_buffer_close_write(muggle_chain_buffer_t *buf)
+{
+	muggle_chain_segment_t *seg = buf->write_seg;
+	if (seg == NULL)
+	{
+		return;
+	}
+
+	muggle_chain_segment_t *reserved = seg->next;
+	while (reserved)
+	{
+		muggle_chain_segment_t *next = reserved->next;
+		muggle_chain_segment_free(reserved);
+		reserved = next;
+	}
+	seg->next = NULL;
+	buf->tail = seg;
+	buf->write_seg = NULL;
+}
+
+int muggle_chain_buffer_init(muggle_chain_buffer_t *buf, int block_size)
+{
+	memset(buf, 0, sizeof(*buf));
+	buf->block_size = block_size > 0 ? block_size : MUGGLE_CHAIN_BUFFER_DEFAULT_BLOCK_SIZE;
+	return MUGGLE_OK;
+}
+
+void muggle_chain_buffer_destroy(muggle_chain_buffer_t *buf)
+{
+	muggle_chain_segment_t *seg = buf->head;
+	while (seg)
+	{
+		muggle_chain_segment_t *next = seg->next;
+		muggle_chain_segment_free(seg);
+		seg = next;
+	}
+
+	buf->head = NULL;
+	buf->tail = NULL;
+	buf->write_seg = NULL;
+	buf->readable = 0;
+}
+
+int muggle_chain_buffer_readable(muggle_chain_buffer_t *buf)
+{
+	return buf->readable;
+}
+
+int muggle_chain_buffer_write(muggle_chain_buffer_t *buf, const void *src, int len)
+{
+	if (len < 0)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	const char *p = (const char*)src;
+	while (len > 0)
+	{
+		muggle_chain_segment_t *seg = muggle_chain_buffer_writable_seg(buf);
+		if (seg == NULL)
+		{
+			return MUGGLE_ERR_MEM_ALLOC;
+		}
+
+		muggle_chain_block_t *block = seg->block;
+		int n = block->capacity - block->w;
+		if (n > len)
+		{
+			n = len;
+		}
+
+		memcpy(block->data + block->w, p, n);
+		block->w += n;
+		seg->len += n;
+		buf->readable += n;
+
+		p += n;
+		len -= n;
+	}
+
+	return MUGGLE_OK;
+}
+
+int muggle_chain_buffer_append_block(muggle_chain_buffer_t *buf, muggle_chain_block_t *block, int offset, int len)
+{
+	if (offset < 0 || len < 0 || offset > block->w - len)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	muggle_chain_segment_t *seg = muggle_chain_segment_new(block, offset, len);
+	if (seg == NULL)
+	{
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+	muggle_chain_block_ref(block);
+
+	muggle_chain_buffer_close_write(buf);
+	muggle_chain_buffer_push_back(buf, seg);
+
+	return MUGGLE_OK;
+}
+
+int muggle_chain_buffer_splice(muggle_chain_buffer_t *dst, muggle_chain_buffer_t *src, int len)
+{
+	if (dst == src || len < 0 || len > src->readable)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	muggle_chain_buffer_close_write(dst);
+
+	while (len > 0)
+	{
+		muggle_chain_segment_t *seg = src->head;
+		if (seg->len == 0)
+		{
+			// head is empty only when it's not write segment any more
+			muggle_chain_segment_free(muggle_chain_buffer_pop_front(src));
+			continue;
+		}
+
+		// move whole segment, write segment always split, so it's never
+		// able to write in other buffer
+		if (seg->len <= len && seg != src->write_seg)
+		{
+			len -= seg->len;
+			muggle_chain_buffer_push_back(dst, muggle_chain_buffer_pop_front(src));
+			continue;
+		}
+
+		int n = seg->len < len ? seg->len : len;
+		muggle_chain_segment_t *part = muggle_chain_segment_new(seg->block, seg->offset, n);
+		if (part == NULL)
+		{
+			return MUGGLE_ERR_MEM_ALLOC;
+		}
+		muggle_chain_block_ref(seg->block);
+
+		seg->offset += n;
+		seg->len -= n;
+		src->readable -= n;
+		muggle_chain_buffer_push_back(dst, part);
+
+		len -= n;
+	}
+
+	return MUGGLE_OK;
+}
+
+int muggle_chain_buffer_append_ref(muggle_chain_buffer_t *dst, muggle_chain_buffer_t *src, int len)
+{
+	if (dst == src || len < 0 || len > src->readable)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	muggle_chain_buffer_close_write(dst);
+
+	for (muggle_chain_segment_t *seg = src->head; seg && len > 0; seg = seg->next)
+	{
+		if (seg->len == 0)
+		{
+			continue;
+		}
+
+		int n = seg->len < len ? seg->len : len;
+		muggle_chain_segment_t *part = muggle_chain_segment_new(seg->block, seg->offset, n);
+		if (part == NULL)
+		{
+			return MUGGLE_ERR_MEM_ALLOC;
+		}
+		muggle_chain_block_ref(seg->block);
+		muggle_chain_buffer_push_back(dst, part);
+
+		len -= n;
+	}
+
+	return MUGGLE_OK;
+}
+
+void* muggle_chain_buffer_peek(muggle_chain_buffer_t *buf, int len, void *tmp)
+{
+	if (len < 0 || len > buf->readable)
+	{
+		return NULL;
+	}
+
+	muggle_chain_segment_t *seg = buf->head;
+	while (seg && seg->len == 0)
+	{
+		seg = seg->next;
+	}
+
+	if (seg && seg->len >= len)
+	{
+		return seg->block->data + seg->offset;
+	}
+
+	muggle_chain_buffer_fetch(buf, tmp, len);
+	return tmp;
+}
+
+int muggle_chain_buffer_fetch(muggle_chain_buffer_t *buf, void *dst, int len)
+{
+	if (len < 0 || len > buf->readable)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	char *p = (char*)dst;
+	for (muggle_chain_segment_t *seg = buf->head; seg && len > 0; seg = seg->next)
+	{
+		int n = seg->len < len ? seg->len : len;
+		memcpy(p, seg->block->data + seg->offset, n);
+		p += n;
+		len -= n;
+	}
+
+	return MUGGLE_OK;
+}
+
+int muggle_chain_buffer_read(muggle_chain_buffer_t *buf, void *dst, int len)
+{
+	int ret = muggle_chain_buffer_fetch(buf, dst, len);
+	if (ret != MUGGLE_OK)
+	{
+		return ret;
+	}
+	return muggle_chain_buffer_consume(buf, len);
+}
+
+int muggle_chain_buffer_consume(muggle_chain_buffer_t *buf, int len)
+{
+	if (len < 0 || len > buf->readable)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	while (buf->head)
+	{
+		muggle_chain_segment_t *seg = buf->head;
+		if (seg->len > len)
+		{
+			seg->offset += len;
+			seg->len -= len;
+			buf->readable -= len;
+			break;
+		}
+
+		// keep write segment, the rest of its block is still writable
+		if (seg == buf->write_seg)
+		{
+			seg->offset += seg->len;
+			buf->readable -= seg->len;
+			seg->len = 0;
+			break;
+		}
+
+		len -= seg->len;
+		muggle_chain_segment_free(muggle_chain_buffer_pop_front(buf));
+
+		if (len == 0 && buf->head && buf->head->len > 0)
+		{
+			break;
+		}
+	}
+
+	return MUGGLE_OK;
+}
+
+int muggle_chain_buffer_read_iov(muggle_chain_buffer_t *buf, muggle_iovec_t *iov, int max_iov)
+{
+	int cnt = 0;
+	for (muggle_chain_segment_t *seg = buf->head; seg && cnt < max_iov; seg = seg->next)
+	{
+		if (seg->len == 0)
+		{
+			continue;
+		}
+
+		iov[cnt].iov_base = seg->block->data + seg->offset;
+		iov[cnt].iov_len = (size_t)seg->len;
+		cnt++;
+	}
+	return cnt;
+}
+
+int muggle_chain_buffer_reserve_iov(muggle_chain_buffer_t *buf, int len, muggle_iovec_t *iov, int max_iov)
+{
+	if (max_iov <= 0)
+	{
+		return 0;
+	}
+
+	muggle_chain_segment_t *seg = muggle_chain_buffer_writable_seg(buf);
+	if (seg == NULL)
+	{
+		return 0;
+	}
+
+	int cnt = 0;
+	int total = 0;
+	while (1)
+	{
+		muggle_chain_block_t *block = seg->block;
+		iov[cnt].iov_base = block->data + block->w;
+		iov[cnt].iov_len = (size_t)(block->capacity - block->w);
+		total += block->capacity - block->w;
+		cnt++;
+
+		if (total >= len || cnt >= max_iov)
+		{
+			break;
+		}
+
+		if (seg->next == NULL)
+		{
+			block = muggle_chain_block_new(buf->block_size);
+			if (block == NULL)
+			{
+				break;
+			}
+
+			muggle_chain_segment_t *reserved = muggle_chain_segment_new(block, 0, 0);
+			if (reserved == NULL)
+			{
+				muggle_chain_block_release(block);
+				break;
+			}
+			muggle_chain_buffer_push_back(buf, reserved);
+		}
+		seg = seg->next;
+	}
+
+	return cnt;
+}
+
+int muggle_chain_buffer_commit(muggle_chain_buffer_t *buf, int len)
+{
+	if (len < 0)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	while (len > 0)
+	{
+		muggle_chain_segment_t *seg = buf->write_seg;
+		if (seg == NULL)
+		{
+			return MUGGLE_ERR_INVALID_PARAM;
+		}
+
+		muggle_chain_block_t *block = seg->block;
+		int n = block->capacity - block->w;
+		if (n == 0)
+		{
+			if (seg->next == NULL)
+			{
+				return MUGGLE_ERR_INVALID_PARAM;
+			}
+			buf->write_seg = seg->next;
+			continue;
+		}
+
+		if (n > len)
+		{
+			n = len;
+		}
+		block->w += n;
+		seg->len += n;
+		buf->readable += n;
+		len -= n;
+	}
+
+	return MUGGLE_OK;
+}
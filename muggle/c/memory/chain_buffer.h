@@ -0,0 +1,310 @@
+/******************************************************************************
+ *  @file         chain_buffer.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec chain buffer
+ *
+ * Bytes buffer made of a chain of segments, every segment is a view of a
+ * reference counted block. Unlike muggle_bytes_buffer_t, it never wraps or
+ * reallocates:
+ * - write append bytes into tail block, new block is chained when full
+ * - blocks and bytes of other buffer can be appended without copy
+ * - readable and writable space export as io vectors for readv/writev
+ *
+ * NOTE: chain buffer is not thread safe, but block reference count is
+ * atomic, so segments can be passed to other thread's buffer
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_CHAIN_BUFFER_H_
+#define MUGGLE_C_CHAIN_BUFFER_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/base/atomic.h"
+#include "muggle/c/base/iovec.h"
+
+EXTERN_C_BEGIN
+
+#define MUGGLE_CHAIN_BUFFER_DEFAULT_BLOCK_SIZE (1024 * 16) //!< default block size
+
+/**
+ * @brief prototype of free wrapped block data
+ *
+ * @param ctx   user context passed to muggle_chain_block_wrap
+ * @param data  wrapped data
+ */
+typedef void (*muggle_chain_block_free_fn)(void *ctx, void *data);
+
+/**
+ * @brief reference counted memory block
+ */
+typedef struct muggle_chain_block
+{
+	muggle_atomic_int          ref_cnt;
+	int                        capacity;  //!< bytes of data
+	int                        w;         //!< write frontier, bytes after it are not written yet
+	char                       *data;
+	muggle_chain_block_free_fn fn_free;   //!< free function of wrapped data, NULL when data follow the block
+	void                       *free_ctx;
+}muggle_chain_block_t;
+
+/**
+ * @brief segment, a view of block's bytes in [offset, offset + len)
+ */
+typedef struct muggle_chain_segment
+{
+	struct muggle_chain_segment *next;
+	muggle_chain_block_t        *block;
+	int                         offset;
+	int                         len;
+}muggle_chain_segment_t;
+
+/**
+ * @brief chain buffer
+ */
+typedef struct muggle_chain_buffer
+{
+	muggle_chain_segment_t *head;
+	muggle_chain_segment_t *tail;
+	muggle_chain_segment_t *write_seg;  //!< segment next written bytes go, NULL if need new block
+	int                    readable;    //!< number of readable bytes
+	int                    block_size;  //!< capacity of new block
+}muggle_chain_buffer_t;
+
+/**
+ * @brief allocate block, reference count is 1
+ *
+ * @param capacity  block capacity
+ *
+ * @return on success return block, otherwise return NULL
+ */
+MUGGLE_C_EXPORT
+muggle_chain_block_t* muggle_chain_block_new(int capacity);
+
+/**
+ * @brief wrap user data into block without copy, reference count is 1
+ *
+ * @param data      user data, it's readonly for block
+ * @param len       length of data
+ * @param fn_free   invoked when reference count reach 0, can be NULL
+ * @param free_ctx  context passed to fn_free
+ *
+ * @return on success return block, otherwise return NULL
+ */
+MUGGLE_C_EXPORT
+muggle_chain_block_t* muggle_chain_block_wrap(
+	void *data, int len, muggle_chain_block_free_fn fn_free, void *free_ctx);
+
+/**
+ * @brief increase block reference count
+ *
+ * @param block  pointer to block
+ */
+MUGGLE_C_EXPORT
+void muggle_chain_block_ref(muggle_chain_block_t *block);
+
+/**
+ * @brief decrease block reference count, free block when it reach 0
+ *
+ * @param block  pointer to block
+ */
+MUGGLE_C_EXPORT
+void muggle_chain_block_release(muggle_chain_block_t *block);
+
+/**
+ * @brief init chain buffer
+ *
+ * @param buf         pointer to chain buffer
+ * @param block_size  capacity of new block, if <= 0, use MUGGLE_CHAIN_BUFFER_DEFAULT_BLOCK_SIZE
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_chain_buffer_init(muggle_chain_buffer_t *buf, int block_size);
+
+/**
+ * @brief destroy chain buffer, release all segments
+ *
+ * @param buf  pointer to chain buffer
+ */
+MUGGLE_C_EXPORT
+void muggle_chain_buffer_destroy(muggle_chain_buffer_t *buf);
+
+/**
+ * @brief get number of readable bytes
+ *
+ * @param buf  pointer to chain buffer
+ *
+ * @return number of readable bytes
+ */
+MUGGLE_C_EXPORT
+int muggle_chain_buffer_readable(muggle_chain_buffer_t *buf);
+
+/**
+ * @brief copy bytes into buffer
+ *
+ * @param buf  pointer to chain buffer
+ * @param src  source bytes
+ * @param len  number of bytes
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_chain_buffer_write(muggle_chain_buffer_t *buf, const void *src, int len);
+
+/**
+ * @brief append bytes of block without copy
+ *
+ * NOTE: buffer take a new reference of block, caller still own its reference
+ *
+ * @param buf     pointer to chain buffer
+ * @param block   pointer to block
+ * @param offset  offset of bytes in block
+ * @param len     number of bytes
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_chain_buffer_append_block(muggle_chain_buffer_t *buf, muggle_chain_block_t *block, int offset, int len);
+
+/**
+ * @brief move first len bytes of src to the end of dst without copy
+ *
+ * NOTE: segment across the boundary is split, the two parts share block
+ *
+ * @param dst  destination chain buffer
+ * @param src  source chain buffer
+ * @param len  number of bytes
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_chain_buffer_splice(muggle_chain_buffer_t *dst, muggle_chain_buffer_t *src, int len);
+
+/**
+ * @brief append first len bytes of src to the end of dst without copy, src is not changed
+ *
+ * NOTE: use for forward the same bytes to multiple buffers
+ *
+ * @param dst  destination chain buffer
+ * @param src  source chain buffer
+ * @param len  number of bytes
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_chain_buffer_append_ref(muggle_chain_buffer_t *dst, muggle_chain_buffer_t *src, int len);
+
+/**
+ * @brief peek first len bytes
+ *
+ * @param buf  pointer to chain buffer
+ * @param len  number of bytes
+ * @param tmp  memory at least len bytes, used when bytes are not contiguous
+ *
+ * @return
+ *     - if bytes are contiguous in first segment, return pointer to it
+ *     - else if bytes are enough, copy into tmp and return tmp
+ *     - otherwise return NULL
+ */
+MUGGLE_C_EXPORT
+void* muggle_chain_buffer_peek(muggle_chain_buffer_t *buf, int len, void *tmp);
+
+/**
+ * @brief copy first len bytes into dst without consume
+ *
+ * @param buf  pointer to chain buffer
+ * @param dst  destination memory
+ * @param len  number of bytes
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_chain_buffer_fetch(muggle_chain_buffer_t *buf, void *dst, int len);
+
+/**
+ * @brief copy first len bytes into dst and consume
+ *
+ * @param buf  pointer to chain buffer
+ * @param dst  destination memory
+ * @param len  number of bytes
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_chain_buffer_read(muggle_chain_buffer_t *buf, void *dst, int len);
+
+/**
+ * @brief consume first len bytes
+ *
+ * @param buf  pointer to chain buffer
+ * @param len  number of bytes
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_chain_buffer_consume(muggle_chain_buffer_t *buf, int len);
+
+/**
+ * @brief export readable bytes as io vectors, used for writev
+ *
+ * NOTE: usually use with muggle_chain_buffer_consume
+ *
+ * @param buf      pointer to chain buffer
+ * @param iov      output io vectors
+ * @param max_iov  max number of io vectors
+ *
+ * @return number of io vectors filled
+ */
+MUGGLE_C_EXPORT
+int muggle_chain_buffer_read_iov(muggle_chain_buffer_t *buf, muggle_iovec_t *iov, int max_iov);
+
+/**
+ * @brief reserve writable space and export it as io vectors, used for readv
+ *
+ * NOTE: usually use with muggle_chain_buffer_commit
+ *
+ * @param buf      pointer to chain buffer
+ * @param len      number of bytes at least
+ * @param iov      output io vectors
+ * @param max_iov  max number of io vectors
+ *
+ * @return number of io vectors filled, return 0 when failed allocate block
+ */
+MUGGLE_C_EXPORT
+int muggle_chain_buffer_reserve_iov(muggle_chain_buffer_t *buf, int len, muggle_iovec_t *iov, int max_iov);
+
+/**
+ * @brief make len bytes written into reserved space readable
+ *
+ * @param buf  pointer to chain buffer
+ * @param len  number of bytes written
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_chain_buffer_commit(muggle_chain_buffer_t *buf, int len);
+
+EXTERN_C_END
+
+#endif
@@ -0,0 +1,293 @@
+/******************************************************************************
+ *  @file         ebr.c
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec epoch based reclamation
+ *****************************************************************************/
+
+#include "ebr.h"
+#include <stdlib.h>
+#include <string.h>
+#include "muggle/c/base/err.h"
+
+#define MUGGLE_EBR_ACTIVE 1
+#define MUGGLE_EBR_STATE(epoch, active) ((muggle_atomic_int)(((unsigned int)(epoch) << 1) | (active)))
+#define MUGGLE_EBR_STATE_EPOCH(state) ((muggle_atomic_int)((unsigned int)(state) >> 1))
+
+// epoch is masked to 31 bits, so it can be packed into state
+#define MUGGLE_EBR_EPOCH_MASK 0x7fffffff
+#define MUGGLE_EBR_EPOCH_DIFF(a, b) (((unsigned int)(a) - (unsigned int)(b)) & MUGGLE_EBR_EPOCH_MASK)
+
+static int muggle_ebr_limbo_push(muggle_ebr_limbo_t *limbo, void *ptr, muggle_ebr_free_fn fn_free)
+{
+	if (limbo->cnt == limbo->capacity)
+	{
+		int capacity = limbo->capacity == 0 ? MUGGLE_EBR_COLLECT_THRESHOLD : limbo->capacity * 2;
+		muggle_ebr_retired_t *nodes = (muggle_ebr_retired_t*)realloc(
+			limbo->nodes, sizeof(muggle_ebr_retired_t) * capacity);
+		if (nodes == NULL)
+		{
+			return MUGGLE_ERR_MEM_ALLOC;
+		}
+		limbo->nodes = nodes;
+		limbo->capacity = capacity;
+	}
+
+	limbo->nodes[limbo->cnt].ptr = ptr;
+	limbo->nodes[limbo->cnt].fn_free = fn_free;
+	limbo->cnt++;
+
+	return MUGGLE_OK;
+}
+
+// free all nodes in limbo, return number of nodes freed
+static int muggle_ebr_limbo_free(muggle_ebr_limbo_t *limbo)
+{
+	int cnt = limbo->cnt;
+	for (int i = 0; i < cnt; i++)
+	{
+		limbo->nodes[i].fn_free(limbo->nodes[i].ptr);
+	}
+	limbo->cnt = 0;
+	return cnt;
+}
+
+// move all nodes of src into dst
+static int muggle_ebr_limbo_move(muggle_ebr_limbo_t *dst, muggle_ebr_limbo_t *src)
+{
+	for (int i = 0; i < src->cnt; i++)
+	{
+		int ret = muggle_ebr_limbo_push(dst, src->nodes[i].ptr, src->nodes[i].fn_free);
+		if (ret != MUGGLE_OK)
+		{
+			return ret;
+		}
+	}
+	src->cnt = 0;
+	return MUGGLE_OK;
+}
+
+static void muggle_ebr_limbo_destroy(muggle_ebr_limbo_t *limbo)
+{
+	muggle_ebr_limbo_free(limbo);
+	free(limbo->nodes);
+	memset(limbo, 0, sizeof(muggle_ebr_limbo_t));
+}
+
+// try advance global epoch, must hold domain mutex
+static void muggle_ebr_try_advance(muggle_ebr_t *ebr)
+{
+	muggle_atomic_int epoch = muggle_atomic_load(&ebr->epoch, muggle_memory_order_acquire);
+
+	// pair with fence in enter, if a thread's announcement is not seen here,
+	// its reads in critical section see everything before this scan
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+
+	for (muggle_ebr_thread_t *thread = ebr->threads; thread; thread = thread->next)
+	{
+		muggle_atomic_int state = muggle_atomic_load(&thread->state, muggle_memory_order_relaxed);
+		if ((state & MUGGLE_EBR_ACTIVE) && MUGGLE_EBR_STATE_EPOCH(state) != epoch)
+		{
+			return;
+		}
+	}
+
+	muggle_atomic_int next_epoch = (epoch + 1) & MUGGLE_EBR_EPOCH_MASK;
+	muggle_atomic_cmp_exch_strong(&ebr->epoch, &epoch, next_epoch, muggle_memory_order_release);
+
+	// nodes of unregistered threads
+	if (ebr->orphans.cnt > 0)
+	{
+		epoch = muggle_atomic_load(&ebr->epoch, muggle_memory_order_acquire);
+		if (MUGGLE_EBR_EPOCH_DIFF(epoch, ebr->orphans.epoch) >= 2)
+		{
+			muggle_ebr_limbo_free(&ebr->orphans);
+		}
+	}
+}
+
+int muggle_ebr_init(muggle_ebr_t *ebr)
+{
+	memset(ebr, 0, sizeof(muggle_ebr_t));
+	ebr->epoch = 0;
+	ebr->threads = NULL;
+	return muggle_fast_mutex_init(&ebr->mutex);
+}
+
+void muggle_ebr_destroy(muggle_ebr_t *ebr)
+{
+	muggle_ebr_thread_t *thread = ebr->threads;
+	while (thread)
+	{
+		muggle_ebr_thread_t *next = thread->next;
+		for (int i = 0; i < MUGGLE_EBR_NUM_EPOCH; i++)
+		{
+			muggle_ebr_limbo_destroy(&thread->limbo[i]);
+		}
+		thread->pending = 0;
+		thread->ebr = NULL;
+		thread->prev = NULL;
+		thread->next = NULL;
+		thread = next;
+	}
+	ebr->threads = NULL;
+
+	muggle_ebr_limbo_destroy(&ebr->orphans);
+	muggle_fast_mutex_destroy(&ebr->mutex);
+}
+
+int muggle_ebr_register(muggle_ebr_t *ebr, muggle_ebr_thread_t *thread)
+{
+	memset(thread, 0, sizeof(muggle_ebr_thread_t));
+	thread->ebr = ebr;
+
+	muggle_fast_mutex_lock(&ebr->mutex);
+	thread->next = ebr->threads;
+	if (thread->next)
+	{
+		thread->next->prev = thread;
+	}
+	ebr->threads = thread;
+	muggle_fast_mutex_unlock(&ebr->mutex);
+
+	return MUGGLE_OK;
+}
+
+void muggle_ebr_unregister(muggle_ebr_thread_t *thread)
+{
+	muggle_ebr_t *ebr = thread->ebr;
+	if (ebr == NULL)
+	{
+		return;
+	}
+
+	muggle_fast_mutex_lock(&ebr->mutex);
+
+	if (thread->prev)
+	{
+		thread->prev->next = thread->next;
+	}
+	else
+	{
+		ebr->threads = thread->next;
+	}
+	if (thread->next)
+	{
+		thread->next->prev = thread->prev;
+	}
+
+	// orphans freed when global epoch pass the latest one of them
+	muggle_atomic_int epoch = muggle_atomic_load(&ebr->epoch, muggle_memory_order_acquire);
+	for (int i = 0; i < MUGGLE_EBR_NUM_EPOCH; i++)
+	{
+		muggle_ebr_limbo_t *limbo = &thread->limbo[i];
+		if (limbo->cnt > 0)
+		{
+			// stamp epoch before move, nodes already moved must not be
+			// freed by old epoch of orphans if move failed partway
+			ebr->orphans.epoch = epoch;
+			if (muggle_ebr_limbo_move(&ebr->orphans, limbo) != MUGGLE_OK)
+			{
+				// can't free nodes other threads may still hold, leak them
+				limbo->cnt = 0;
+			}
+		}
+		free(limbo->nodes);
+		memset(limbo, 0, sizeof(muggle_ebr_limbo_t));
+	}
+
+	muggle_fast_mutex_unlock(&ebr->mutex);
+
+	thread->pending = 0;
+	thread->ebr = NULL;
+	thread->prev = NULL;
+	thread->next = NULL;
+}
+
+void muggle_ebr_enter(muggle_ebr_thread_t *thread)
+{
+	if (thread->nest++ > 0)
+	{
+		return;
+	}
+
+	muggle_atomic_int epoch = muggle_atomic_load(&thread->ebr->epoch, muggle_memory_order_relaxed);
+	muggle_atomic_store(&thread->state, MUGGLE_EBR_STATE(epoch, MUGGLE_EBR_ACTIVE), muggle_memory_order_relaxed);
+
+	// announcement must be visible before any read of shared nodes
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+}
+
+void muggle_ebr_exit(muggle_ebr_thread_t *thread)
+{
+	if (--thread->nest > 0)
+	{
+		return;
+	}
+
+	muggle_atomic_int state = muggle_atomic_load(&thread->state, muggle_memory_order_relaxed);
+	muggle_atomic_store(&thread->state, state & ~MUGGLE_EBR_ACTIVE, muggle_memory_order_release);
+}
+
+int muggle_ebr_retire(muggle_ebr_thread_t *thread, void *ptr, muggle_ebr_free_fn fn_free)
+{
+	// load global epoch after node unlinked, threads can hold the node
+	// are all in this or previous epoch
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	muggle_atomic_int epoch = muggle_atomic_load(&thread->ebr->epoch, muggle_memory_order_relaxed);
+
+	muggle_ebr_limbo_t *limbo = &thread->limbo[epoch % MUGGLE_EBR_NUM_EPOCH];
+	if (limbo->cnt > 0 && limbo->epoch != epoch)
+	{
+		// the list is at least MUGGLE_EBR_NUM_EPOCH epochs old
+		thread->pending -= muggle_ebr_limbo_free(limbo);
+	}
+	limbo->epoch = epoch;
+
+	int ret = muggle_ebr_limbo_push(limbo, ptr, fn_free);
+	if (ret != MUGGLE_OK)
+	{
+		return ret;
+	}
+	thread->pending++;
+
+	if (thread->pending >= MUGGLE_EBR_COLLECT_THRESHOLD && thread->nest == 0)
+	{
+		muggle_ebr_collect(thread);
+	}
+
+	return MUGGLE_OK;
+}
+
+int muggle_ebr_collect(muggle_ebr_thread_t *thread)
+{
+	muggle_ebr_t *ebr = thread->ebr;
+
+	if (muggle_fast_mutex_trylock(&ebr->mutex) == MUGGLE_OK)
+	{
+		muggle_ebr_try_advance(ebr);
+		muggle_fast_mutex_unlock(&ebr->mutex);
+	}
+
+	int cnt = 0;
+	muggle_atomic_int epoch = muggle_atomic_load(&ebr->epoch, muggle_memory_order_acquire);
+	for (int i = 0; i < MUGGLE_EBR_NUM_EPOCH; i++)
+	{
+		muggle_ebr_limbo_t *limbo = &thread->limbo[i];
+		if (limbo->cnt > 0 && MUGGLE_EBR_EPOCH_DIFF(epoch, limbo->epoch) >= 2)
+		{
+			cnt += muggle_ebr_limbo_free(limbo);
+		}
+	}
+	thread->pending -= cnt;
+
+	return cnt;
+}
+
+int muggle_ebr_pending(muggle_ebr_thread_t *thread)
+{
+	return thread->pending;
+}
@@ -0,0 +1,202 @@
+/******************************************************************************
+ *  @file         ebr.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec epoch based reclamation
+ *
+ * Safe memory reclamation for lock-free data structures. A node removed
+ * from a structure may still be read by other threads, so it's retired
+ * instead of freed, and freed after all threads that may hold it left their
+ * critical sections.
+ * - every thread that access the structure register a muggle_ebr_thread_t
+ * - read shared nodes only between muggle_ebr_enter and muggle_ebr_exit
+ * - after unlink a node, invoke muggle_ebr_retire with its free function,
+ *   e.g. muggle_ts_memory_pool_free, muggle_slab_allocator_free or free
+ * - global epoch advance only when all threads in critical section have
+ *   observed it, nodes retired in epoch e are freed in batch when global
+ *   epoch reach e + 2
+ *
+ * enter and exit never lock, they only write the thread's own record.
+ * A thread that stay in critical section for a long time stall reclamation
+ * of all threads.
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_EBR_H_
+#define MUGGLE_C_EBR_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/base/atomic.h"
+#include "muggle/c/sync/fast_mutex.h"
+
+EXTERN_C_BEGIN
+
+#define MUGGLE_EBR_NUM_EPOCH 3             //!< number of retire lists per thread
+#define MUGGLE_EBR_COLLECT_THRESHOLD 64    //!< number of pending nodes trigger collect in retire
+
+/**
+ * @brief prototype of free retired node
+ *
+ * @param ptr  retired node
+ */
+typedef void (*muggle_ebr_free_fn)(void *ptr);
+
+/**
+ * @brief retired node
+ */
+typedef struct muggle_ebr_retired
+{
+	void              *ptr;
+	muggle_ebr_free_fn fn_free;
+}muggle_ebr_retired_t;
+
+/**
+ * @brief nodes retired in the same epoch
+ */
+typedef struct muggle_ebr_limbo
+{
+	muggle_ebr_retired_t *nodes;
+	int                  cnt;
+	int                  capacity;
+	muggle_atomic_int    epoch;    //!< epoch nodes retired in
+}muggle_ebr_limbo_t;
+
+struct muggle_ebr;
+
+/**
+ * @brief per thread record
+ */
+typedef struct muggle_ebr_thread
+{
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	muggle_atomic_int state;  //!< epoch << 1 | active, read by threads that try to advance epoch
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
+	struct muggle_ebr        *ebr;
+	struct muggle_ebr_thread *prev;
+	struct muggle_ebr_thread *next;
+	int                      nest;     //!< nesting level of critical section
+	int                      pending;  //!< number of nodes in limbo lists
+	muggle_ebr_limbo_t       limbo[MUGGLE_EBR_NUM_EPOCH];
+}muggle_ebr_thread_t;
+
+/**
+ * @brief epoch based reclamation domain
+ */
+typedef struct muggle_ebr
+{
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	muggle_atomic_int epoch;  //!< global epoch
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
+	muggle_fast_mutex_t mutex;        //!< protect thread records and orphans
+	muggle_ebr_thread_t *threads;     //!< registered threads
+	muggle_ebr_limbo_t  orphans;      //!< nodes left by unregistered threads
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(2);
+}muggle_ebr_t;
+
+/**
+ * @brief init epoch based reclamation domain
+ *
+ * @param ebr  pointer to ebr domain
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_ebr_init(muggle_ebr_t *ebr);
+
+/**
+ * @brief destroy ebr domain, free all retired nodes
+ *
+ * NOTE: user need guarantee no thread access the domain any more, records
+ * still registered are cleared but not freed
+ *
+ * @param ebr  pointer to ebr domain
+ */
+MUGGLE_C_EXPORT
+void muggle_ebr_destroy(muggle_ebr_t *ebr);
+
+/**
+ * @brief register thread record into ebr domain
+ *
+ * NOTE: a record can only be used by one thread at the same time
+ *
+ * @param ebr     pointer to ebr domain
+ * @param thread  pointer to thread record, memory is owned by user
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_ebr_register(muggle_ebr_t *ebr, muggle_ebr_thread_t *thread);
+
+/**
+ * @brief unregister thread record, nodes not freed yet are handed to domain
+ *
+ * NOTE: must not be in critical section
+ *
+ * @param thread  pointer to thread record
+ */
+MUGGLE_C_EXPORT
+void muggle_ebr_unregister(muggle_ebr_thread_t *thread);
+
+/**
+ * @brief enter critical section, can be nested
+ *
+ * @param thread  pointer to thread record
+ */
+MUGGLE_C_EXPORT
+void muggle_ebr_enter(muggle_ebr_thread_t *thread);
+
+/**
+ * @brief exit critical section
+ *
+ * @param thread  pointer to thread record
+ */
+MUGGLE_C_EXPORT
+void muggle_ebr_exit(muggle_ebr_thread_t *thread);
+
+/**
+ * @brief retire node that already unlinked from shared structure
+ *
+ * @param thread   pointer to thread record
+ * @param ptr      pointer to node
+ * @param fn_free  invoked with ptr when no thread can hold it
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h, node is not retired
+ */
+MUGGLE_C_EXPORT
+int muggle_ebr_retire(muggle_ebr_thread_t *thread, void *ptr, muggle_ebr_free_fn fn_free);
+
+/**
+ * @brief try to advance global epoch and free nodes retired by this thread
+ * that no thread can hold
+ *
+ * NOTE: invoked by muggle_ebr_retire automatically when pending nodes
+ * reach MUGGLE_EBR_COLLECT_THRESHOLD
+ *
+ * @param thread  pointer to thread record
+ *
+ * @return number of nodes freed
+ */
+MUGGLE_C_EXPORT
+int muggle_ebr_collect(muggle_ebr_thread_t *thread);
+
+/**
+ * @brief get number of nodes retired by thread and not freed yet
+ *
+ * @param thread  pointer to thread record
+ *
+ * @return number of pending nodes
+ */
+MUGGLE_C_EXPORT
+int muggle_ebr_pending(muggle_ebr_thread_t *thread);
+
+EXTERN_C_END
+
+#endif
@@ -11,6 +11,12 @@
 #include <assert.h>
 
 bool muggle_memory_pool_init(muggle_memory_pool_t* pool, unsigned int init_capacity, unsigned int block_size)
+{
+	return muggle_memory_pool_init_with_policy(pool, init_capacity, block_size, NULL);
+}
+bool muggle_memory_pool_init_with_policy(
+	muggle_memory_pool_t* pool, unsigned int init_capacity, unsigned int block_size,
+	const muggle_page_policy_t *policy)
 {
 	memset(pool, 0, sizeof(muggle_memory_pool_t));
 	init_capacity = init_capacity == 0 ? 8 : init_capacity;
@@ -19,6 +25,11 @@ bool muggle_memory_pool_init(muggle_memory_pool_t* pool, unsigned int init_capac
 		return false;
 	}
 
+	if (policy)
+	{
+		pool->page_policy = *policy;
+	}
+
 	pool->memory_pool_data_bufs = (void**)malloc(sizeof(void*));
 	if (pool->memory_pool_data_bufs == NULL)
 	{
@@ -31,7 +42,7 @@ bool muggle_memory_pool_init(muggle_memory_pool_t* pool, unsigned int init_capac
 		pool->memory_pool_data_bufs = NULL;
 		return false;
 	}
-	pool->memory_pool_data_bufs[0] = (void*)malloc(block_size * init_capacity);
+	pool->memory_pool_data_bufs[0] = muggle_page_alloc((size_t)block_size * init_capacity, &pool->page_policy);
 	if (pool->memory_pool_data_bufs[0] == NULL)
 	{
 		free(pool->memory_pool_data_bufs);
@@ -50,9 +61,11 @@ bool muggle_memory_pool_init(muggle_memory_pool_t* pool, unsigned int init_capac
 
 	pool->flag = 0;
 
-#if MUGGLE_DEBUG
 	pool->peak = 0;
-#endif
+	pool->alloc_cnt = 0;
+	pool->free_cnt = 0;
+	pool->fail_cnt = 0;
+	pool->grow_cnt = 0;
 
 	void* ptr_buf = pool->memory_pool_data_bufs[0];
 	unsigned int i;
@@ -68,7 +81,7 @@ void muggle_memory_pool_destroy(muggle_memory_pool_t* pool)
 	unsigned int i;
 	for (i = 0; i<pool->num_buf; ++i)
 	{
-		free((void*)pool->memory_pool_data_bufs[i]);
+		muggle_page_free((void*)pool->memory_pool_data_bufs[i]);
 	}
 	free((void*)pool->memory_pool_data_bufs);
 	free((void*)pool->memory_pool_ptr_buf);
@@ -81,16 +94,16 @@ void* muggle_memory_pool_alloc(muggle_memory_pool_t* pool)
 	{
 		if (!muggle_memory_pool_ensure_space(pool, pool->capacity * 2))
 		{
+			++pool->fail_cnt;
 			return NULL;
 		}
 	}
 	++pool->used;
-#if MUGGLE_DEBUG
+	++pool->alloc_cnt;
 	if (pool->used > pool->peak)
 	{
 		pool->peak = pool->used;
 	}
-#endif
 
 	void* ret = pool->memory_pool_ptr_buf[pool->alloc_index];
 	++pool->alloc_index;
@@ -109,6 +122,7 @@ void muggle_memory_pool_free(muggle_memory_pool_t* pool, void* p_data)
 		pool->free_index = 0;
 	}
 	--pool->used;
+	++pool->free_cnt;
 }
 
 bool muggle_memory_pool_ensure_space(muggle_memory_pool_t* pool, unsigned int capacity)
@@ -133,7 +147,7 @@ bool muggle_memory_pool_ensure_space(muggle_memory_pool_t* pool, unsigned int ca
 		return false;
 	}
 	memcpy(new_bufs, pool->memory_pool_data_bufs, sizeof(void*) * pool->num_buf);
-	new_bufs[pool->num_buf] = (void*)malloc(pool->block_size * delta_size);
+	new_bufs[pool->num_buf] = muggle_page_alloc((size_t)pool->block_size * delta_size, &pool->page_policy);
 	if (new_bufs[pool->num_buf] == NULL)
 	{
 		free(new_bufs);
@@ -144,7 +158,7 @@ bool muggle_memory_pool_ensure_space(muggle_memory_pool_t* pool, unsigned int ca
 	void** new_ptr_buf = (void**)malloc(sizeof(void*) * capacity);
 	if (new_ptr_buf == NULL)
 	{
-		free(new_bufs[pool->num_buf]);
+		muggle_page_free(new_bufs[pool->num_buf]);
 		free(new_bufs);
 		return false;
 	}
@@ -246,6 +260,7 @@ bool muggle_memory_pool_ensure_space(muggle_memory_pool_t* pool, unsigned int ca
 	// update pool data
 	++pool->num_buf;
 	pool->capacity = capacity;
+	++pool->grow_cnt;
 
 	return true;
 }
@@ -259,3 +274,14 @@ void muggle_memory_pool_set_flag(muggle_memory_pool_t* pool, unsigned int flag)
 {
 	pool->flag = flag;
 }
+
+void muggle_memory_pool_get_stats(muggle_memory_pool_t* pool, muggle_pool_stats_t *stats)
+{
+	stats->capacity = pool->capacity;
+	stats->in_use = pool->used;
+	stats->high_water_mark = pool->peak;
+	stats->alloc_cnt = pool->alloc_cnt;
+	stats->free_cnt = pool->free_cnt;
+	stats->fail_cnt = pool->fail_cnt;
+	stats->grow_cnt = pool->grow_cnt;
+}
@@ -12,6 +12,8 @@
 #define MUGGLE_C_MEMORY_POOL_H_
 
 #include "muggle/c/base/macro.h"
+#include "muggle/c/memory/page_provider.h"
+#include "muggle/c/memory/pool_stats.h"
 #include <stdbool.h>
 
 EXTERN_C_BEGIN
@@ -35,9 +37,14 @@ typedef struct muggle_memory_pool_tag
 
 	unsigned int	flag;					//!< flags
 
-#if MUGGLE_DEBUG
+	muggle_page_policy_t page_policy;       //!< allocation policy of data buffers
+
 	unsigned int	peak;                   //!< record max number of block in use
-#endif
+
+	uint64_t		alloc_cnt;              //!< number of successful allocations
+	uint64_t		free_cnt;               //!< number of frees
+	uint64_t		fail_cnt;               //!< number of failed allocations
+	uint64_t		grow_cnt;               //!< number of times pool grew
 }muggle_memory_pool_t;
 
 /**
@@ -52,6 +59,21 @@ typedef struct muggle_memory_pool_tag
 MUGGLE_C_EXPORT
 bool muggle_memory_pool_init(muggle_memory_pool_t* pool, unsigned int init_capacity, unsigned int block_size);
 
+/**
+ * @brief initialize memory pool with allocation policy of data buffers
+ *
+ * @param pool           memory pool pointer
+ * @param init_capacity  init capacity of memory pool
+ * @param block_size     data size of memory pool
+ * @param policy         allocation policy, if it's NULL, use malloc
+ *
+ * @return boolean
+ */
+MUGGLE_C_EXPORT
+bool muggle_memory_pool_init_with_policy(
+	muggle_memory_pool_t* pool, unsigned int init_capacity, unsigned int block_size,
+	const muggle_page_policy_t *policy);
+
 /**
  * @brief destroy memory pool
  *
@@ -113,6 +135,15 @@ unsigned int muggle_memory_pool_get_flag(muggle_memory_pool_t* pool);
 MUGGLE_C_EXPORT
 void muggle_memory_pool_set_flag(muggle_memory_pool_t* pool, unsigned int flag);
 
+/**
+ * @brief get memory pool statistics
+ *
+ * @param pool   pointer to memory pool
+ * @param stats  output statistics
+ */
+MUGGLE_C_EXPORT
+void muggle_memory_pool_get_stats(muggle_memory_pool_t* pool, muggle_pool_stats_t *stats);
+
 EXTERN_C_END
 
 #endif
@@ -0,0 +1,311 @@
+/******************************************************************************
+ *  @file         page_provider.c
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec page provider
+ *****************************************************************************/
+
+#include "page_provider.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include "muggle/c/sync/fast_mutex.h"
+
+#if MUGGLE_PLATFORM_WINDOWS
+	#include <windows.h>
+#else
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#if MUGGLE_PLATFORM_LINUX
+		#include <sys/syscall.h>
+	#endif
+#endif
+
+#ifndef MPOL_BIND
+	#define MPOL_BIND 2
+#endif
+
+/**
+ * @brief malloc allocation head, placed right before user memory
+ */
+typedef union muggle_page_head
+{
+	struct
+	{
+		void   *base;      //!< address returned by system
+		size_t map_size;   //!< bytes mapped from system
+		int    kind;       //!< MUGGLE_PAGE_KIND_*
+	};
+	char padding[MUGGLE_CACHE_LINE_SIZE];
+}muggle_page_head_t;
+
+/**
+ * @brief mapped region, kept out of band, so a size of power of 2 is mapped
+ * with exactly the pages it need instead of one more for head
+ */
+typedef struct muggle_page_region_tag
+{
+	void   *addr;     //!< address returned by system, also user memory
+	size_t map_size;  //!< bytes mapped from system
+	int    kind;      //!< MUGGLE_PAGE_KIND_*
+	struct muggle_page_region_tag *next;
+}muggle_page_region_t;
+
+#define MUGGLE_PAGE_ROUND_UP(x, align) (((x) + (align) - 1) / (align) * (align))
+
+// mapped regions, pages are allocated rarely, a list is enough
+static muggle_fast_mutex_t s_page_region_mutex = { MUGGLE_FAST_MUTEX_STATUS_UNLOCK };
+static muggle_page_region_t *s_page_regions = NULL;
+
+static void muggle_page_region_add(muggle_page_region_t *region)
+{
+	muggle_fast_mutex_lock(&s_page_region_mutex);
+	region->next = s_page_regions;
+	s_page_regions = region;
+	muggle_fast_mutex_unlock(&s_page_region_mutex);
+}
+
+/**
+ * @brief find mapped region of address
+ *
+ * @param addr    user memory
+ * @param remove  remove region from list when found
+ *
+ * @return region, NULL represent addr is allocated by malloc
+ */
+static muggle_page_region_t* muggle_page_region_find(void *addr, int remove)
+{
+	muggle_fast_mutex_lock(&s_page_region_mutex);
+
+	muggle_page_region_t **prev_next = &s_page_regions;
+	muggle_page_region_t *region = s_page_regions;
+	while (region)
+	{
+		if (region->addr == addr)
+		{
+			if (remove)
+			{
+				*prev_next = region->next;
+			}
+			break;
+		}
+		prev_next = &region->next;
+		region = region->next;
+	}
+
+	muggle_fast_mutex_unlock(&s_page_region_mutex);
+
+	return region;
+}
+
+static void muggle_page_prefault(void *addr, size_t size)
+{
+	size_t page_size = muggle_page_size();
+	for (size_t offset = 0; offset < size; offset += page_size)
+	{
+		((volatile char*)addr)[offset] = 0;
+	}
+}
+
+#if MUGGLE_PLATFORM_WINDOWS
+
+static void* muggle_page_map(size_t size, const muggle_page_policy_t *policy, size_t *map_size, int *kind)
+{
+	DWORD node = NUMA_NO_PREFERRED_NODE;
+	if (policy->flags & MUGGLE_PAGE_FLAG_NUMA)
+	{
+		node = (DWORD)policy->numa_node;
+	}
+
+	void *addr = NULL;
+	if (policy->flags & MUGGLE_PAGE_FLAG_HUGETLB)
+	{
+		// need SeLockMemoryPrivilege, otherwise fallback to normal pages
+		size_t large_page_size = GetLargePageMinimum();
+		if (large_page_size > 0)
+		{
+			*map_size = MUGGLE_PAGE_ROUND_UP(size, large_page_size);
+			addr = VirtualAllocExNuma(GetCurrentProcess(), NULL, *map_size,
+				MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE, node);
+			if (addr)
+			{
+				*kind = MUGGLE_PAGE_KIND_HUGETLB;
+				return addr;
+			}
+		}
+	}
+
+	*map_size = MUGGLE_PAGE_ROUND_UP(size, muggle_page_size());
+	addr = VirtualAllocExNuma(GetCurrentProcess(), NULL, *map_size,
+		MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, node);
+	*kind = MUGGLE_PAGE_KIND_MMAP;
+
+	return addr;
+}
+
+static void muggle_page_unmap(void *addr, size_t map_size)
+{
+	VirtualFree(addr, 0, MEM_RELEASE);
+}
+
+size_t muggle_page_size()
+{
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return (size_t)info.dwPageSize;
+}
+
+#else
+
+static void* muggle_page_map(size_t size, const muggle_page_policy_t *policy, size_t *map_size, int *kind)
+{
+	void *addr = MAP_FAILED;
+
+#if defined(MAP_HUGETLB)
+	if (policy->flags & MUGGLE_PAGE_FLAG_HUGETLB)
+	{
+		// fail when no huge page reserved in /proc/sys/vm/nr_hugepages
+		*map_size = MUGGLE_PAGE_ROUND_UP(size, MUGGLE_PAGE_HUGE_SIZE);
+		addr = mmap(NULL, *map_size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		*kind = MUGGLE_PAGE_KIND_HUGETLB;
+	}
+#endif
+
+	if (addr == MAP_FAILED)
+	{
+		*map_size = MUGGLE_PAGE_ROUND_UP(size, muggle_page_size());
+		addr = mmap(NULL, *map_size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (addr == MAP_FAILED)
+		{
+			return NULL;
+		}
+		*kind = MUGGLE_PAGE_KIND_MMAP;
+
+#if defined(MADV_HUGEPAGE)
+		if (policy->flags & MUGGLE_PAGE_FLAG_THP)
+		{
+			madvise(addr, *map_size, MADV_HUGEPAGE);
+		}
+#endif
+	}
+
+#if MUGGLE_PLATFORM_LINUX && defined(SYS_mbind)
+	// bind before any page is touched, otherwise touched pages stay where
+	// they are
+	if ((policy->flags & MUGGLE_PAGE_FLAG_NUMA) &&
+		policy->numa_node >= 0 && policy->numa_node < MUGGLE_PAGE_MAX_NUMA_NODE)
+	{
+		unsigned long nodemask[MUGGLE_PAGE_MAX_NUMA_NODE / (8 * sizeof(unsigned long))] = {0};
+		nodemask[policy->numa_node / (8 * sizeof(unsigned long))] |=
+			1UL << (policy->numa_node % (8 * sizeof(unsigned long)));
+		syscall(SYS_mbind, addr, *map_size, MPOL_BIND, nodemask, MUGGLE_PAGE_MAX_NUMA_NODE + 1, 0);
+	}
+#endif
+
+	return addr;
+}
+
+static void muggle_page_unmap(void *addr, size_t map_size)
+{
+	munmap(addr, map_size);
+}
+
+size_t muggle_page_size()
+{
+	static size_t s_page_size = 0;
+	if (s_page_size == 0)
+	{
+		long page_size = sysconf(_SC_PAGESIZE);
+		s_page_size = page_size > 0 ? (size_t)page_size : 4096;
+	}
+	return s_page_size;
+}
+
+#endif
+
+void* muggle_page_alloc(size_t size, const muggle_page_policy_t *policy)
+{
+	if (size > SIZE_MAX - MUGGLE_PAGE_HUGE_SIZE - sizeof(muggle_page_head_t))
+	{
+		return NULL;
+	}
+
+	muggle_page_head_t *head = NULL;
+
+	if (policy == NULL || policy->flags == 0)
+	{
+		// keep user memory cache line aligned
+		size_t total = sizeof(muggle_page_head_t) + size;
+		void *base = malloc(total + MUGGLE_CACHE_LINE_SIZE);
+		if (base == NULL)
+		{
+			return NULL;
+		}
+
+		head = (muggle_page_head_t*)MUGGLE_PAGE_ROUND_UP((uintptr_t)base, MUGGLE_CACHE_LINE_SIZE);
+		head->base = base;
+		head->map_size = total + MUGGLE_CACHE_LINE_SIZE;
+		head->kind = MUGGLE_PAGE_KIND_MALLOC;
+
+		return (void*)(head + 1);
+	}
+
+	muggle_page_region_t *region = (muggle_page_region_t*)malloc(sizeof(muggle_page_region_t));
+	if (region == NULL)
+	{
+		return NULL;
+	}
+
+	region->map_size = 0;
+	region->kind = MUGGLE_PAGE_KIND_MMAP;
+	region->addr = muggle_page_map(size > 0 ? size : 1, policy, &region->map_size, &region->kind);
+	if (region->addr == NULL)
+	{
+		free(region);
+		return NULL;
+	}
+
+	if (policy->flags & MUGGLE_PAGE_FLAG_PREFAULT)
+	{
+		muggle_page_prefault(region->addr, region->map_size);
+	}
+
+	muggle_page_region_add(region);
+
+	return region->addr;
+}
+
+void muggle_page_free(void *ptr)
+{
+	if (ptr == NULL)
+	{
+		return;
+	}
+
+	muggle_page_region_t *region = muggle_page_region_find(ptr, 1);
+	if (region)
+	{
+		muggle_page_unmap(region->addr, region->map_size);
+		free(region);
+		return;
+	}
+
+	muggle_page_head_t *head = (muggle_page_head_t*)ptr - 1;
+	free(head->base);
+}
+
+int muggle_page_kind(void *ptr)
+{
+	muggle_page_region_t *region = muggle_page_region_find(ptr, 0);
+	if (region)
+	{
+		return region->kind;
+	}
+
+	muggle_page_head_t *head = (muggle_page_head_t*)ptr - 1;
+	return head->kind;
+}
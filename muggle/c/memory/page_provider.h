@@ -0,0 +1,100 @@
+/******************************************************************************
+ *  @file         page_provider.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec page provider
+ *
+ * Backing store provider for pools and rings. Without policy flags it is
+ * plain malloc, otherwise memory is mapped from system directly:
+ * - MUGGLE_PAGE_FLAG_HUGETLB: try explicit huge pages, fallback to normal
+ *   pages when system has no huge page reserved
+ * - MUGGLE_PAGE_FLAG_THP: advise kernel to back memory with transparent
+ *   huge pages
+ * - MUGGLE_PAGE_FLAG_NUMA: bind memory to policy's numa node
+ * - MUGGLE_PAGE_FLAG_PREFAULT: touch all pages in allocation, so the first
+ *   access in hot path don't page fault
+ *
+ * Policy flags are hints, if a flag is not supported by platform or
+ * failed, it is ignored.
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_PAGE_PROVIDER_H_
+#define MUGGLE_C_PAGE_PROVIDER_H_
+
+#include "muggle/c/base/macro.h"
+#include <stddef.h>
+
+EXTERN_C_BEGIN
+
+enum
+{
+	MUGGLE_PAGE_FLAG_HUGETLB  = 0x01, //!< mmap with explicit huge pages
+	MUGGLE_PAGE_FLAG_THP      = 0x02, //!< madvise transparent huge pages
+	MUGGLE_PAGE_FLAG_NUMA     = 0x04, //!< bind to numa node
+	MUGGLE_PAGE_FLAG_PREFAULT = 0x08, //!< touch all pages when allocate
+};
+
+enum
+{
+	MUGGLE_PAGE_KIND_MALLOC = 0, //!< allocated by malloc
+	MUGGLE_PAGE_KIND_MMAP,       //!< mapped with normal pages
+	MUGGLE_PAGE_KIND_HUGETLB,    //!< mapped with explicit huge pages
+};
+
+#define MUGGLE_PAGE_HUGE_SIZE (2 * 1024 * 1024) //!< explicit huge page size
+#define MUGGLE_PAGE_MAX_NUMA_NODE 1024
+
+/**
+ * @brief allocation policy of backing store
+ */
+typedef struct muggle_page_policy
+{
+	int flags;     //!< bitwise or of MUGGLE_PAGE_FLAG_*
+	int numa_node; //!< numa node, only used with MUGGLE_PAGE_FLAG_NUMA
+}muggle_page_policy_t;
+
+/**
+ * @brief allocate memory with policy
+ *
+ * @param size    bytes of memory
+ * @param policy  allocation policy, if it's NULL, use malloc
+ *
+ * @return on success return memory aligned to MUGGLE_CACHE_LINE_SIZE, mapped
+ * memory is page aligned and takes size rounded up to pages; otherwise
+ * return NULL
+ */
+MUGGLE_C_EXPORT
+void* muggle_page_alloc(size_t size, const muggle_page_policy_t *policy);
+
+/**
+ * @brief free memory allocated by muggle_page_alloc
+ *
+ * @param ptr  memory allocated by muggle_page_alloc, can be NULL
+ */
+MUGGLE_C_EXPORT
+void muggle_page_free(void *ptr);
+
+/**
+ * @brief get how memory is actually provided
+ *
+ * @param ptr  memory allocated by muggle_page_alloc
+ *
+ * @return MUGGLE_PAGE_KIND_*
+ */
+MUGGLE_C_EXPORT
+int muggle_page_kind(void *ptr);
+
+/**
+ * @brief get system page size
+ *
+ * @return page size in bytes
+ */
+MUGGLE_C_EXPORT
+size_t muggle_page_size();
+
+EXTERN_C_END
+
+#endif
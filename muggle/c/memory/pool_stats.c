@@ -0,0 +1,155 @@
+/******************************************************************************
+ *  @file         pool_stats.c
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec pool statistics
+ *****************************************************************************/
+
+#include "pool_stats.h"
+#include <stdlib.h>
+#include <string.h>
+#include "muggle/c/base/err.h"
+#include "muggle/c/base/thread.h"
+#include "muggle/c/sync/fast_mutex.h"
+
+typedef struct muggle_pool_stats_entry
+{
+	struct muggle_pool_stats_entry *next;
+	char                 name[MUGGLE_POOL_STATS_NAME_LEN];
+	void                 *pool;
+	muggle_pool_stats_fn fn;
+}muggle_pool_stats_entry_t;
+
+// zero initialized fast mutex is unlocked
+static muggle_fast_mutex_t s_pool_stats_mutex;
+static muggle_pool_stats_entry_t *s_pool_stats_entries = NULL;
+
+static muggle_pool_counter_stripe_t* muggle_pool_counter_stripe(muggle_pool_counter_t *counter)
+{
+	// fibonacci hashing, thread id of posix is usually an aligned address
+	uint64_t tid = (uint64_t)(uintptr_t)muggle_thread_current_id();
+	uint64_t idx = (tid * 0x9E3779B97F4A7C15ULL) >> 32;
+	return &counter->stripes[idx & (MUGGLE_POOL_COUNTER_STRIPES - 1)];
+}
+
+void muggle_pool_counter_init(muggle_pool_counter_t *counter)
+{
+	memset(counter, 0, sizeof(muggle_pool_counter_t));
+}
+
+void muggle_pool_counter_alloc(muggle_pool_counter_t *counter)
+{
+	muggle_pool_counter_stripe_t *stripe = muggle_pool_counter_stripe(counter);
+	muggle_atomic_fetch_add64(&stripe->alloc_cnt, 1, muggle_memory_order_relaxed);
+}
+
+void muggle_pool_counter_free(muggle_pool_counter_t *counter)
+{
+	muggle_pool_counter_stripe_t *stripe = muggle_pool_counter_stripe(counter);
+	muggle_atomic_fetch_add64(&stripe->free_cnt, 1, muggle_memory_order_relaxed);
+}
+
+void muggle_pool_counter_sum(muggle_pool_counter_t *counter, uint64_t *alloc_cnt, uint64_t *free_cnt)
+{
+	uint64_t n_alloc = 0;
+	uint64_t n_free = 0;
+	for (int i = 0; i < MUGGLE_POOL_COUNTER_STRIPES; i++)
+	{
+		n_alloc += (uint64_t)muggle_atomic_load64(&counter->stripes[i].alloc_cnt, muggle_memory_order_relaxed);
+		n_free += (uint64_t)muggle_atomic_load64(&counter->stripes[i].free_cnt, muggle_memory_order_relaxed);
+	}
+	*alloc_cnt = n_alloc;
+	*free_cnt = n_free;
+}
+
+int muggle_pool_stats_register(const char *name, void *pool, muggle_pool_stats_fn fn)
+{
+	if (pool == NULL || fn == NULL)
+	{
+		return MUGGLE_ERR_NULL_PARAM;
+	}
+
+	muggle_pool_stats_entry_t *entry =
+		(muggle_pool_stats_entry_t*)malloc(sizeof(muggle_pool_stats_entry_t));
+	if (entry == NULL)
+	{
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+	memset(entry, 0, sizeof(muggle_pool_stats_entry_t));
+	if (name)
+	{
+		strncpy(entry->name, name, sizeof(entry->name) - 1);
+	}
+	entry->pool = pool;
+	entry->fn = fn;
+
+	muggle_fast_mutex_lock(&s_pool_stats_mutex);
+	entry->next = s_pool_stats_entries;
+	s_pool_stats_entries = entry;
+	muggle_fast_mutex_unlock(&s_pool_stats_mutex);
+
+	return MUGGLE_OK;
+}
+
+void muggle_pool_stats_unregister(void *pool)
+{
+	muggle_fast_mutex_lock(&s_pool_stats_mutex);
+	muggle_pool_stats_entry_t **pp = &s_pool_stats_entries;
+	while (*pp)
+	{
+		muggle_pool_stats_entry_t *entry = *pp;
+		if (entry->pool == pool)
+		{
+			*pp = entry->next;
+			free(entry);
+			break;
+		}
+		pp = &entry->next;
+	}
+	muggle_fast_mutex_unlock(&s_pool_stats_mutex);
+}
+
+int muggle_pool_stats_foreach(muggle_pool_stats_visit_fn fn, void *ctx)
+{
+	int cnt = 0;
+
+	muggle_fast_mutex_lock(&s_pool_stats_mutex);
+	for (muggle_pool_stats_entry_t *entry = s_pool_stats_entries; entry; entry = entry->next)
+	{
+		muggle_pool_stats_t stats;
+		memset(&stats, 0, sizeof(stats));
+		entry->fn(entry->pool, &stats);
+		fn(entry->name, entry->pool, &stats, ctx);
+		cnt++;
+	}
+	muggle_fast_mutex_unlock(&s_pool_stats_mutex);
+
+	return cnt;
+}
+
+static void muggle_pool_stats_dump_one(
+	const char *name, void *pool, const muggle_pool_stats_t *stats, void *ctx)
+{
+	(void)pool;
+	fprintf((FILE*)ctx,
+		"pool[%s]: capacity=%lld, in_use=%lld, high_water_mark=%lld, "
+		"alloc=%llu, free=%llu, fail=%llu, grow=%llu\n",
+		name,
+		(long long)stats->capacity,
+		(long long)stats->in_use,
+		(long long)stats->high_water_mark,
+		(unsigned long long)stats->alloc_cnt,
+		(unsigned long long)stats->free_cnt,
+		(unsigned long long)stats->fail_cnt,
+		(unsigned long long)stats->grow_cnt);
+}
+
+int muggle_pool_stats_dump(FILE *fp)
+{
+	int cnt = muggle_pool_stats_foreach(muggle_pool_stats_dump_one, (void*)fp);
+	fflush(fp);
+	return cnt;
+}
@@ -0,0 +1,172 @@
+/******************************************************************************
+ *  @file         pool_stats.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec pool statistics
+ *
+ * Common statistics of memory pools and a registry for introspection.
+ * - pools keep their counters always on, counters touched by multiple
+ *   threads are striped by thread, so alloc and free in different threads
+ *   don't contend on the same cache line, stripes are summed on demand
+ * - pools registered with muggle_pool_stats_register can be enumerated or
+ *   dumped at runtime
+ *
+ * Statistics of a pool in use are a snapshot of counters read one by one,
+ * so they can be slightly inconsistent with each other.
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_POOL_STATS_H_
+#define MUGGLE_C_POOL_STATS_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/base/atomic.h"
+#include <stdint.h>
+#include <stdio.h>
+
+EXTERN_C_BEGIN
+
+#define MUGGLE_POOL_COUNTER_STRIPES 16  //!< number of counter stripes, must be pow of 2
+#define MUGGLE_POOL_STATS_NAME_LEN 64   //!< max length of registered pool name
+
+/**
+ * @brief pool statistics
+ */
+typedef struct muggle_pool_stats
+{
+	int64_t  capacity;        //!< number of blocks pool currently own
+	int64_t  in_use;          //!< number of blocks allocated and not freed yet
+	int64_t  high_water_mark; //!< max in_use ever seen
+	uint64_t alloc_cnt;       //!< number of successful allocations
+	uint64_t free_cnt;        //!< number of frees
+	uint64_t fail_cnt;        //!< number of allocations that returned NULL
+	uint64_t grow_cnt;        //!< number of times pool grew
+}muggle_pool_stats_t;
+
+/**
+ * @brief counter stripe, every stripe in its own cache line
+ */
+typedef struct muggle_pool_counter_stripe
+{
+	muggle_atomic_int64 alloc_cnt;
+	muggle_atomic_int64 free_cnt;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+}muggle_pool_counter_stripe_t;
+
+/**
+ * @brief striped alloc/free counter
+ */
+typedef struct muggle_pool_counter
+{
+	muggle_pool_counter_stripe_t stripes[MUGGLE_POOL_COUNTER_STRIPES];
+}muggle_pool_counter_t;
+
+/**
+ * @brief prototype of get pool statistics
+ *
+ * @param pool   pointer to pool
+ * @param stats  output statistics
+ */
+typedef void (*muggle_pool_stats_fn)(void *pool, muggle_pool_stats_t *stats);
+
+/**
+ * @brief prototype of callback in muggle_pool_stats_foreach
+ *
+ * @param name   name of registered pool
+ * @param pool   pointer to pool
+ * @param stats  statistics of pool
+ * @param ctx    user context
+ */
+typedef void (*muggle_pool_stats_visit_fn)(
+	const char *name, void *pool, const muggle_pool_stats_t *stats, void *ctx);
+
+/**
+ * @brief init pool counter
+ *
+ * @param counter  pointer to pool counter
+ */
+MUGGLE_C_EXPORT
+void muggle_pool_counter_init(muggle_pool_counter_t *counter);
+
+/**
+ * @brief count an allocation in current thread's stripe
+ *
+ * @param counter  pointer to pool counter
+ */
+MUGGLE_C_EXPORT
+void muggle_pool_counter_alloc(muggle_pool_counter_t *counter);
+
+/**
+ * @brief count a free in current thread's stripe
+ *
+ * @param counter  pointer to pool counter
+ */
+MUGGLE_C_EXPORT
+void muggle_pool_counter_free(muggle_pool_counter_t *counter);
+
+/**
+ * @brief sum all stripes
+ *
+ * @param counter    pointer to pool counter
+ * @param alloc_cnt  output number of allocations
+ * @param free_cnt   output number of frees
+ */
+MUGGLE_C_EXPORT
+void muggle_pool_counter_sum(muggle_pool_counter_t *counter, uint64_t *alloc_cnt, uint64_t *free_cnt);
+
+/**
+ * @brief register pool for introspection
+ *
+ * e.g.
+ *   muggle_pool_stats_register("conn", &pool, (muggle_pool_stats_fn)muggle_ts_memory_pool_get_stats);
+ *
+ * NOTE: pool must be unregistered before it is destroyed
+ *
+ * @param name  pool name, truncated to MUGGLE_POOL_STATS_NAME_LEN - 1
+ * @param pool  pointer to pool
+ * @param fn    get statistics function of pool
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_pool_stats_register(const char *name, void *pool, muggle_pool_stats_fn fn);
+
+/**
+ * @brief unregister pool
+ *
+ * @param pool  pointer to pool
+ */
+MUGGLE_C_EXPORT
+void muggle_pool_stats_unregister(void *pool);
+
+/**
+ * @brief get statistics of all registered pools
+ *
+ * NOTE: callback is invoked with registry locked, don't register or
+ * unregister pool in callback
+ *
+ * @param fn   callback invoked for every registered pool
+ * @param ctx  user context passed to callback
+ *
+ * @return number of registered pools
+ */
+MUGGLE_C_EXPORT
+int muggle_pool_stats_foreach(muggle_pool_stats_visit_fn fn, void *ctx);
+
+/**
+ * @brief write statistics of all registered pools, one line per pool
+ *
+ * @param fp  output file
+ *
+ * @return number of registered pools
+ */
+MUGGLE_C_EXPORT
+int muggle_pool_stats_dump(FILE *fp);
+
+EXTERN_C_END
+
+#endif
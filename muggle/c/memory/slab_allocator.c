@@ -0,0 +1,511 @@
+/******************************************************************************
+ *  @file         slab_allocator.c
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec slab allocator
+ *****************************************************************************/
+
+#include "slab_allocator.h"
+#include <stdlib.h>
+#include <string.h>
+#include "muggle/c/base/err.h"
+
+// next free block, store in data of free block
+#define MUGGLE_SLAB_NEXT(block) (*(muggle_slab_block_head_t**)((block) + 1))
+
+/**
+ * @brief head of chunk carved from system
+ */
+typedef struct muggle_slab_chunk
+{
+	struct muggle_slab_chunk *next;
+	void *alignment_padding;
+}muggle_slab_chunk_t;
+
+static void muggle_slab_list_push(muggle_slab_free_list_t *list, muggle_slab_block_head_t *block)
+{
+	MUGGLE_SLAB_NEXT(block) = list->head;
+	list->head = block;
+	if (list->tail == NULL)
+	{
+		list->tail = block;
+	}
+	list->cnt++;
+}
+
+static muggle_slab_block_head_t* muggle_slab_list_pop(muggle_slab_free_list_t *list)
+{
+	muggle_slab_block_head_t *block = list->head;
+	list->head = MUGGLE_SLAB_NEXT(block);
+	if (list->head == NULL)
+	{
+		list->tail = NULL;
+	}
+	list->cnt--;
+	return block;
+}
+
+// prepend segment [first, last] with cnt blocks to list
+static void muggle_slab_list_prepend(
+	muggle_slab_free_list_t *list,
+	muggle_slab_block_head_t *first, muggle_slab_block_head_t *last, int cnt)
+{
+	MUGGLE_SLAB_NEXT(last) = list->head;
+	list->head = first;
+	if (list->tail == NULL)
+	{
+		list->tail = last;
+	}
+	list->cnt += cnt;
+}
+
+// move at most cnt blocks from head of src to dst
+static void muggle_slab_list_move(muggle_slab_free_list_t *dst, muggle_slab_free_list_t *src, int cnt)
+{
+	if (cnt > src->cnt)
+	{
+		cnt = src->cnt;
+	}
+	if (cnt <= 0)
+	{
+		return;
+	}
+
+	if (cnt == src->cnt)
+	{
+		muggle_slab_list_prepend(dst, src->head, src->tail, cnt);
+		src->head = NULL;
+		src->tail = NULL;
+		src->cnt = 0;
+		return;
+	}
+
+	muggle_slab_block_head_t *first = src->head;
+	muggle_slab_block_head_t *last = first;
+	for (int i = 1; i < cnt; i++)
+	{
+		last = MUGGLE_SLAB_NEXT(last);
+	}
+
+	src->head = MUGGLE_SLAB_NEXT(last);
+	src->cnt -= cnt;
+
+	muggle_slab_list_prepend(dst, first, last, cnt);
+}
+
+// keep keep_cnt recently freed blocks in src, move the colder rest to dst
+static void muggle_slab_list_move_tail(muggle_slab_free_list_t *dst, muggle_slab_free_list_t *src, int keep_cnt)
+{
+	if (keep_cnt <= 0)
+	{
+		muggle_slab_list_move(dst, src, src->cnt);
+		return;
+	}
+	if (src->cnt <= keep_cnt)
+	{
+		return;
+	}
+
+	muggle_slab_block_head_t *cut = src->head;
+	for (int i = 1; i < keep_cnt; i++)
+	{
+		cut = MUGGLE_SLAB_NEXT(cut);
+	}
+
+	muggle_slab_list_prepend(dst, MUGGLE_SLAB_NEXT(cut), src->tail, src->cnt - keep_cnt);
+
+	MUGGLE_SLAB_NEXT(cut) = NULL;
+	src->tail = cut;
+	src->cnt = keep_cnt;
+}
+
+// carve a new chunk into central list, must hold mutex of size class
+static int muggle_slab_carve(muggle_slab_allocator_t *allocator, int size_class)
+{
+	muggle_slab_size_class_t *cls = &allocator->classes[size_class];
+	size_t block_size = sizeof(muggle_slab_block_head_t) + (size_t)cls->data_size;
+
+	muggle_slab_chunk_t *chunk =
+		(muggle_slab_chunk_t*)malloc(sizeof(muggle_slab_chunk_t) + block_size * cls->batch_cnt);
+	if (chunk == NULL)
+	{
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+	chunk->next = (muggle_slab_chunk_t*)cls->chunks;
+	cls->chunks = chunk;
+	cls->chunk_cnt++;
+
+	char *p = (char*)(chunk + 1);
+	for (int i = 0; i < cls->batch_cnt; i++)
+	{
+		muggle_slab_block_head_t *block = (muggle_slab_block_head_t*)(p + block_size * i);
+		block->allocator = allocator;
+		block->size_class = size_class;
+		muggle_slab_list_push(&cls->free_list, block);
+	}
+
+	return MUGGLE_OK;
+}
+
+static void muggle_slab_cache_flush(muggle_slab_thread_cache_t *cache)
+{
+	muggle_slab_allocator_t *allocator = cache->allocator;
+	for (int i = 0; i < MUGGLE_SLAB_NUM_CLASS; i++)
+	{
+		muggle_slab_free_list_t *list = &cache->lists[i];
+		if (list->cnt == 0)
+		{
+			continue;
+		}
+
+		muggle_slab_size_class_t *cls = &allocator->classes[i];
+		muggle_fast_mutex_lock(&cls->mutex);
+		muggle_slab_list_move(&cls->free_list, list, list->cnt);
+		muggle_fast_mutex_unlock(&cls->mutex);
+	}
+}
+
+// flush and release cache when thread exit
+static void muggle_slab_cache_release(void *arg)
+{
+	muggle_slab_thread_cache_t *cache = (muggle_slab_thread_cache_t*)arg;
+	muggle_slab_allocator_t *allocator = cache->allocator;
+
+	muggle_slab_cache_flush(cache);
+
+	muggle_fast_mutex_lock(&allocator->cache_mutex);
+	muggle_atomic_fetch_add64(&allocator->retired_alloc_cnt, cache->alloc_cnt, muggle_memory_order_relaxed);
+	muggle_atomic_fetch_add64(&allocator->retired_free_cnt, cache->free_cnt, muggle_memory_order_relaxed);
+	if (cache->prev)
+	{
+		cache->prev->next = cache->next;
+	}
+	else
+	{
+		allocator->caches = cache->next;
+	}
+	if (cache->next)
+	{
+		cache->next->prev = cache->prev;
+	}
+	muggle_fast_mutex_unlock(&allocator->cache_mutex);
+
+	free(cache);
+}
+
+#if MUGGLE_PLATFORM_WINDOWS
+
+static VOID WINAPI muggle_slab_tls_destructor(PVOID arg)
+{
+	if (arg)
+	{
+		muggle_slab_cache_release(arg);
+	}
+}
+
+static int muggle_slab_tls_create(muggle_slab_allocator_t *allocator)
+{
+	allocator->tls_key = FlsAlloc(muggle_slab_tls_destructor);
+	return allocator->tls_key == FLS_OUT_OF_INDEXES ? MUGGLE_ERR_SYS_CALL : MUGGLE_OK;
+}
+
+static void muggle_slab_tls_delete(muggle_slab_allocator_t *allocator)
+{
+	// FlsFree invoke callback for current thread, clear it first
+	FlsSetValue(allocator->tls_key, NULL);
+	FlsFree(allocator->tls_key);
+}
+
+#define muggle_slab_tls_get(allocator) FlsGetValue((allocator)->tls_key)
+#define muggle_slab_tls_set(allocator, cache) FlsSetValue((allocator)->tls_key, cache)
+
+#else
+
+static int muggle_slab_tls_create(muggle_slab_allocator_t *allocator)
+{
+	return pthread_key_create(&allocator->tls_key, muggle_slab_cache_release) == 0 ?
+		MUGGLE_OK : MUGGLE_ERR_SYS_CALL;
+}
+
+static void muggle_slab_tls_delete(muggle_slab_allocator_t *allocator)
+{
+	pthread_key_delete(allocator->tls_key);
+}
+
+#define muggle_slab_tls_get(allocator) pthread_getspecific((allocator)->tls_key)
+#define muggle_slab_tls_set(allocator, cache) pthread_setspecific((allocator)->tls_key, cache)
+
+#endif
+
+static muggle_slab_thread_cache_t* muggle_slab_get_cache(muggle_slab_allocator_t *allocator)
+{
+	muggle_slab_thread_cache_t *cache =
+		(muggle_slab_thread_cache_t*)muggle_slab_tls_get(allocator);
+	if (cache)
+	{
+		return cache;
+	}
+
+	cache = (muggle_slab_thread_cache_t*)malloc(sizeof(muggle_slab_thread_cache_t));
+	if (cache == NULL)
+	{
+		return NULL;
+	}
+	memset(cache, 0, sizeof(muggle_slab_thread_cache_t));
+	cache->allocator = allocator;
+
+	muggle_fast_mutex_lock(&allocator->cache_mutex);
+	cache->next = allocator->caches;
+	if (cache->next)
+	{
+		cache->next->prev = cache;
+	}
+	allocator->caches = cache;
+	muggle_fast_mutex_unlock(&allocator->cache_mutex);
+
+	muggle_slab_tls_set(allocator, cache);
+
+	return cache;
+}
+
+// counters of thread cache only written by its owner thread, relaxed load
+// and store avoid locked instruction
+static inline void muggle_slab_cache_count(muggle_atomic_int64 *cnt)
+{
+	muggle_atomic_store64(cnt,
+		muggle_atomic_load64(cnt, muggle_memory_order_relaxed) + 1,
+		muggle_memory_order_relaxed);
+}
+
+// count in current thread's cache, the counter cache line is not shared
+static void muggle_slab_count_alloc(muggle_slab_allocator_t *allocator, muggle_slab_thread_cache_t *cache)
+{
+	if (cache)
+	{
+		muggle_slab_cache_count(&cache->alloc_cnt);
+	}
+	else
+	{
+		muggle_atomic_fetch_add64(&allocator->retired_alloc_cnt, 1, muggle_memory_order_relaxed);
+	}
+}
+
+static void muggle_slab_count_free(muggle_slab_allocator_t *allocator, muggle_slab_thread_cache_t *cache)
+{
+	if (cache)
+	{
+		muggle_slab_cache_count(&cache->free_cnt);
+	}
+	else
+	{
+		muggle_atomic_fetch_add64(&allocator->retired_free_cnt, 1, muggle_memory_order_relaxed);
+	}
+}
+
+int muggle_slab_allocator_size_class(size_t size)
+{
+	if (size > ((size_t)1 << MUGGLE_SLAB_MAX_SHIFT))
+	{
+		return MUGGLE_SLAB_LARGE_CLASS;
+	}
+
+	int size_class = 0;
+	while (((size_t)1 << (size_class + MUGGLE_SLAB_MIN_SHIFT)) < size)
+	{
+		size_class++;
+	}
+	return size_class;
+}
+
+int muggle_slab_allocator_init(muggle_slab_allocator_t *allocator)
+{
+	memset(allocator, 0, sizeof(muggle_slab_allocator_t));
+
+	for (int i = 0; i < MUGGLE_SLAB_NUM_CLASS; i++)
+	{
+		muggle_slab_size_class_t *cls = &allocator->classes[i];
+		muggle_fast_mutex_init(&cls->mutex);
+		cls->data_size = 1 << (i + MUGGLE_SLAB_MIN_SHIFT);
+
+		int batch_cnt = MUGGLE_SLAB_BATCH_BYTES / (int)(cls->data_size + sizeof(muggle_slab_block_head_t));
+		if (batch_cnt < MUGGLE_SLAB_MIN_BATCH_CNT)
+		{
+			batch_cnt = MUGGLE_SLAB_MIN_BATCH_CNT;
+		}
+		else if (batch_cnt > MUGGLE_SLAB_MAX_BATCH_CNT)
+		{
+			batch_cnt = MUGGLE_SLAB_MAX_BATCH_CNT;
+		}
+		cls->batch_cnt = batch_cnt;
+	}
+
+	muggle_fast_mutex_init(&allocator->cache_mutex);
+
+	return muggle_slab_tls_create(allocator);
+}
+
+void muggle_slab_allocator_destroy(muggle_slab_allocator_t *allocator)
+{
+	// after delete key, thread exit will not touch caches
+	muggle_slab_tls_delete(allocator);
+
+	muggle_slab_thread_cache_t *cache = allocator->caches;
+	while (cache)
+	{
+		muggle_slab_thread_cache_t *next = cache->next;
+		free(cache);
+		cache = next;
+	}
+	allocator->caches = NULL;
+
+	for (int i = 0; i < MUGGLE_SLAB_NUM_CLASS; i++)
+	{
+		muggle_slab_size_class_t *cls = &allocator->classes[i];
+		muggle_slab_chunk_t *chunk = (muggle_slab_chunk_t*)cls->chunks;
+		while (chunk)
+		{
+			muggle_slab_chunk_t *next = chunk->next;
+			free(chunk);
+			chunk = next;
+		}
+		cls->chunks = NULL;
+		cls->chunk_cnt = 0;
+		memset(&cls->free_list, 0, sizeof(cls->free_list));
+		muggle_fast_mutex_destroy(&cls->mutex);
+	}
+
+	muggle_fast_mutex_destroy(&allocator->cache_mutex);
+}
+
+void* muggle_slab_allocator_alloc(muggle_slab_allocator_t *allocator, size_t size)
+{
+	int size_class = muggle_slab_allocator_size_class(size);
+	if (size_class == MUGGLE_SLAB_LARGE_CLASS)
+	{
+		muggle_slab_block_head_t *block =
+			(muggle_slab_block_head_t*)malloc(sizeof(muggle_slab_block_head_t) + size);
+		if (block == NULL)
+		{
+			muggle_atomic_fetch_add64(&allocator->fail_cnt, 1, muggle_memory_order_relaxed);
+			return NULL;
+		}
+		block->allocator = allocator;
+		block->size_class = MUGGLE_SLAB_LARGE_CLASS;
+		muggle_slab_count_alloc(allocator, muggle_slab_get_cache(allocator));
+		return (void*)(block + 1);
+	}
+
+	muggle_slab_thread_cache_t *cache = muggle_slab_get_cache(allocator);
+	if (cache == NULL)
+	{
+		muggle_atomic_fetch_add64(&allocator->fail_cnt, 1, muggle_memory_order_relaxed);
+		return NULL;
+	}
+
+	muggle_slab_free_list_t *list = &cache->lists[size_class];
+	if (list->cnt == 0)
+	{
+		muggle_slab_size_class_t *cls = &allocator->classes[size_class];
+		muggle_fast_mutex_lock(&cls->mutex);
+		if (cls->free_list.cnt == 0)
+		{
+			if (muggle_slab_carve(allocator, size_class) != MUGGLE_OK)
+			{
+				muggle_fast_mutex_unlock(&cls->mutex);
+				muggle_atomic_fetch_add64(&allocator->fail_cnt, 1, muggle_memory_order_relaxed);
+				return NULL;
+			}
+		}
+		muggle_slab_list_move(list, &cls->free_list, cls->batch_cnt);
+		muggle_fast_mutex_unlock(&cls->mutex);
+	}
+
+	muggle_slab_count_alloc(allocator, cache);
+	return (void*)(muggle_slab_list_pop(list) + 1);
+}
+
+void muggle_slab_allocator_free(void *data)
+{
+	muggle_slab_block_head_t *block = (muggle_slab_block_head_t*)data - 1;
+	muggle_slab_allocator_t *allocator = block->allocator;
+	if (block->size_class == MUGGLE_SLAB_LARGE_CLASS)
+	{
+		muggle_slab_count_free(allocator, muggle_slab_get_cache(allocator));
+		free(block);
+		return;
+	}
+
+	muggle_slab_size_class_t *cls = &allocator->classes[block->size_class];
+	muggle_slab_thread_cache_t *cache = muggle_slab_get_cache(allocator);
+	muggle_slab_count_free(allocator, cache);
+	if (cache == NULL)
+	{
+		muggle_fast_mutex_lock(&cls->mutex);
+		muggle_slab_list_push(&cls->free_list, block);
+		muggle_fast_mutex_unlock(&cls->mutex);
+		return;
+	}
+
+	muggle_slab_free_list_t *list = &cache->lists[block->size_class];
+	muggle_slab_list_push(list, block);
+
+	// keep one batch of hot blocks for next allocate, return the rest
+	if (list->cnt >= cls->batch_cnt * 2)
+	{
+		muggle_fast_mutex_lock(&cls->mutex);
+		muggle_slab_list_move_tail(&cls->free_list, list, cls->batch_cnt);
+		muggle_fast_mutex_unlock(&cls->mutex);
+	}
+}
+
+void muggle_slab_allocator_flush(muggle_slab_allocator_t *allocator)
+{
+	muggle_slab_thread_cache_t *cache =
+		(muggle_slab_thread_cache_t*)muggle_slab_tls_get(allocator);
+	if (cache)
+	{
+		muggle_slab_cache_flush(cache);
+	}
+}
+
+void muggle_slab_allocator_get_stats(muggle_slab_allocator_t *allocator, muggle_pool_stats_t *stats)
+{
+	int64_t capacity = 0;
+	uint64_t chunk_cnt = 0;
+	for (int i = 0; i < MUGGLE_SLAB_NUM_CLASS; i++)
+	{
+		muggle_slab_size_class_t *cls = &allocator->classes[i];
+		muggle_fast_mutex_lock(&cls->mutex);
+		capacity += (int64_t)cls->chunk_cnt * cls->batch_cnt;
+		chunk_cnt += (uint64_t)cls->chunk_cnt;
+		muggle_fast_mutex_unlock(&cls->mutex);
+	}
+
+	// sum free counters first, so in use is never negative
+	uint64_t free_cnt = 0;
+	uint64_t alloc_cnt = 0;
+	muggle_fast_mutex_lock(&allocator->cache_mutex);
+	free_cnt = (uint64_t)muggle_atomic_load64(&allocator->retired_free_cnt, muggle_memory_order_relaxed);
+	for (muggle_slab_thread_cache_t *cache = allocator->caches; cache; cache = cache->next)
+	{
+		free_cnt += (uint64_t)muggle_atomic_load64(&cache->free_cnt, muggle_memory_order_relaxed);
+	}
+	muggle_atomic_thread_fence(muggle_memory_order_acquire);
+	alloc_cnt = (uint64_t)muggle_atomic_load64(&allocator->retired_alloc_cnt, muggle_memory_order_relaxed);
+	for (muggle_slab_thread_cache_t *cache = allocator->caches; cache; cache = cache->next)
+	{
+		alloc_cnt += (uint64_t)muggle_atomic_load64(&cache->alloc_cnt, muggle_memory_order_relaxed);
+	}
+	muggle_fast_mutex_unlock(&allocator->cache_mutex);
+
+	stats->capacity = capacity;
+	stats->in_use = alloc_cnt > free_cnt ? (int64_t)(alloc_cnt - free_cnt) : 0;
+	stats->high_water_mark = capacity > stats->in_use ? capacity : stats->in_use;
+	stats->alloc_cnt = alloc_cnt;
+	stats->free_cnt = free_cnt;
+	stats->fail_cnt = (uint64_t)muggle_atomic_load64(&allocator->fail_cnt, muggle_memory_order_relaxed);
+	stats->grow_cnt = chunk_cnt;
+}
@@ -0,0 +1,204 @@
+/******************************************************************************
+ *  @file         slab_allocator.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec slab allocator
+ *
+ * Thread caching allocator for variable size data. Request size is rounded
+ * up to a power of 2 size class, from 2^MUGGLE_SLAB_MIN_SHIFT to
+ * 2^MUGGLE_SLAB_MAX_SHIFT bytes, larger request fallback to malloc.
+ *
+ * - every thread own a free list cache per size class, alloc and free hit
+ *   the cache without any lock
+ * - cache miss fetch a batch of blocks from the size class's central list,
+ *   cache that hold too many blocks return a batch back to central list
+ * - central list carve new chunk from system when it is empty
+ * - free recover allocator and size class from block head, so data can be
+ *   freed in any thread
+ *
+ * Blocks are returned to system only when allocator is destroyed.
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_SLAB_ALLOCATOR_H_
+#define MUGGLE_C_SLAB_ALLOCATOR_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/base/atomic.h"
+#include "muggle/c/sync/fast_mutex.h"
+#include "muggle/c/memory/pool_stats.h"
+#include <stddef.h>
+
+#if MUGGLE_PLATFORM_WINDOWS
+	#include <windows.h>
+#else
+	#include <pthread.h>
+#endif
+
+EXTERN_C_BEGIN
+
+#define MUGGLE_SLAB_MIN_SHIFT 4  //!< smallest size class, 16 bytes
+#define MUGGLE_SLAB_MAX_SHIFT 16 //!< largest size class, 64K bytes
+#define MUGGLE_SLAB_NUM_CLASS (MUGGLE_SLAB_MAX_SHIFT - MUGGLE_SLAB_MIN_SHIFT + 1)
+#define MUGGLE_SLAB_LARGE_CLASS -1 //!< size class of data fallback to malloc
+
+// bytes move between thread cache and central list per batch
+#define MUGGLE_SLAB_BATCH_BYTES (1024 * 64)
+#define MUGGLE_SLAB_MIN_BATCH_CNT 4
+#define MUGGLE_SLAB_MAX_BATCH_CNT 128
+
+struct muggle_slab_allocator;
+
+/**
+ * @brief slab allocator block head
+ */
+typedef struct muggle_slab_block_head
+{
+	struct muggle_slab_allocator *allocator;
+	int size_class;        //!< index of size class or MUGGLE_SLAB_LARGE_CLASS
+	int alignment_padding;
+}muggle_slab_block_head_t;
+
+/**
+ * @brief singly linked list of free blocks, link store in block data
+ */
+typedef struct muggle_slab_free_list
+{
+	muggle_slab_block_head_t *head; //!< most recently freed block
+	muggle_slab_block_head_t *tail;
+	int cnt;
+}muggle_slab_free_list_t;
+
+/**
+ * @brief per thread cache
+ */
+typedef struct muggle_slab_thread_cache
+{
+	struct muggle_slab_allocator *allocator;
+	struct muggle_slab_thread_cache *prev;
+	struct muggle_slab_thread_cache *next;
+	muggle_slab_free_list_t lists[MUGGLE_SLAB_NUM_CLASS];
+	muggle_atomic_int64 alloc_cnt; //!< only written by owner thread
+	muggle_atomic_int64 free_cnt;  //!< only written by owner thread
+}muggle_slab_thread_cache_t;
+
+/**
+ * @brief central list of a size class
+ */
+typedef struct muggle_slab_size_class
+{
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	muggle_fast_mutex_t     mutex;
+	int                     data_size;  //!< max user data size of this class
+	int                     batch_cnt;  //!< number of blocks per batch
+	muggle_slab_free_list_t free_list;
+	void                    *chunks;    //!< chunks carved from system
+	int                     chunk_cnt;
+}muggle_slab_size_class_t;
+
+/**
+ * @brief slab allocator
+ */
+typedef struct muggle_slab_allocator
+{
+	muggle_slab_size_class_t classes[MUGGLE_SLAB_NUM_CLASS];
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+#if MUGGLE_PLATFORM_WINDOWS
+	DWORD tls_key;
+#else
+	pthread_key_t tls_key;
+#endif
+	muggle_fast_mutex_t        cache_mutex;
+	muggle_slab_thread_cache_t *caches;    //!< all thread caches
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
+	muggle_atomic_int64 retired_alloc_cnt; //!< counters of exited threads and thread without cache
+	muggle_atomic_int64 retired_free_cnt;
+	muggle_atomic_int64 fail_cnt;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(2);
+}muggle_slab_allocator_t;
+
+/**
+ * @brief init slab allocator
+ *
+ * @param allocator  pointer to slab allocator
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_slab_allocator_init(muggle_slab_allocator_t *allocator);
+
+/**
+ * @brief destroy slab allocator
+ *
+ * NOTE: all chunks are returned to system, user need guarantee no thread
+ * use the allocator any more
+ *
+ * @param allocator  pointer to slab allocator
+ */
+MUGGLE_C_EXPORT
+void muggle_slab_allocator_destroy(muggle_slab_allocator_t *allocator);
+
+/**
+ * @brief allocate data
+ *
+ * @param allocator  pointer to slab allocator
+ * @param size       data size
+ *
+ * @return on success return data that allocated, if failed, return NULL
+ */
+MUGGLE_C_EXPORT
+void* muggle_slab_allocator_alloc(muggle_slab_allocator_t *allocator, size_t size);
+
+/**
+ * @brief recycle data into current thread's cache
+ *
+ * @param data  data allocated by slab allocator
+ */
+MUGGLE_C_EXPORT
+void muggle_slab_allocator_free(void *data);
+
+/**
+ * @brief return all blocks cached by current thread to central lists
+ *
+ * NOTE: thread cache is flushed automatically when thread exit, invoke
+ * this when a thread stop using the allocator but will keep running
+ *
+ * @param allocator  pointer to slab allocator
+ */
+MUGGLE_C_EXPORT
+void muggle_slab_allocator_flush(muggle_slab_allocator_t *allocator);
+
+/**
+ * @brief get size class index of size
+ *
+ * @param size  data size
+ *
+ * @return size class index or MUGGLE_SLAB_LARGE_CLASS
+ */
+MUGGLE_C_EXPORT
+int muggle_slab_allocator_size_class(size_t size);
+
+/**
+ * @brief get slab allocator statistics
+ *
+ * NOTE:
+ *   - alloc_cnt and free_cnt are summed from counters of all thread caches
+ *   - capacity is number of blocks carved for size classes, blocks are
+ *     carved only when all blocks of a class are in use or cached, so it's
+ *     also used as high water mark
+ *   - data fallback to malloc is counted in alloc_cnt, free_cnt and in_use,
+ *     but not in capacity
+ *
+ * @param allocator  pointer to slab allocator
+ * @param stats      output statistics
+ */
+MUGGLE_C_EXPORT
+void muggle_slab_allocator_get_stats(muggle_slab_allocator_t *allocator, muggle_pool_stats_t *stats);
+
+EXTERN_C_END
+
+#endif
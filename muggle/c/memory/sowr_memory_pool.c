@@ -16,6 +16,19 @@
 #include "muggle/c/base/utils.h"
 
 int muggle_sowr_memory_pool_init(muggle_sowr_memory_pool_t *pool, muggle_atomic_int capacity, muggle_atomic_int data_size)
+{
+	return muggle_sowr_memory_pool_init_ex(pool, capacity, data_size, MUGGLE_SOWR_MEMORY_POOL_FLAG_SEQ_FREE);
+}
+
+int muggle_sowr_memory_pool_init_ex(
+	muggle_sowr_memory_pool_t *pool, muggle_atomic_int capacity, muggle_atomic_int data_size, int flags)
+{
+	return muggle_sowr_memory_pool_init_with_policy(pool, capacity, data_size, flags, NULL);
+}
+
+int muggle_sowr_memory_pool_init_with_policy(
+	muggle_sowr_memory_pool_t *pool, muggle_atomic_int capacity, muggle_atomic_int data_size, int flags,
+	const muggle_page_policy_t *policy)
 {
 	memset(pool, 0, sizeof(muggle_sowr_memory_pool_t));
 	if (capacity <= 0)
@@ -29,8 +42,13 @@ int muggle_sowr_memory_pool_init(muggle_sowr_memory_pool_t *pool, muggle_atomic_
 		return MUGGLE_ERR_INVALID_PARAM;
 	}
 	pool->capacity = capacity;
+	pool->flags = flags;
 	pool->block_size = (muggle_atomic_int)next_pow_of_2((uint64_t)(data_size + sizeof(muggle_sowr_block_head_t)));
-	pool->blocks = malloc(pool->block_size * pool->capacity);
+	pool->blocks = muggle_page_alloc((size_t)pool->block_size * pool->capacity, policy);
+	if (pool->blocks == NULL)
+	{
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
 	pool->alloc_idx = 0;
 	pool->free_idx = 0;
 	pool->cached_free_pos = pool->capacity - 1;
@@ -40,6 +58,7 @@ int muggle_sowr_memory_pool_init(muggle_sowr_memory_pool_t *pool, muggle_atomic_
 		muggle_sowr_block_head_t *block = (muggle_sowr_block_head_t*)((char*)pool->blocks + pool->block_size * i);
 		block->pool = pool;
 		block->block_idx = i;
+		block->released = 0;
 	}
 
 	return MUGGLE_OK;
@@ -47,16 +66,86 @@ int muggle_sowr_memory_pool_init(muggle_sowr_memory_pool_t *pool, muggle_atomic_
 
 void muggle_sowr_memory_pool_destroy(muggle_sowr_memory_pool_t *pool)
 {
-	free(pool->blocks);
+	muggle_page_free(pool->blocks);
+}
+
+#define MUGGLE_SOWR_BLOCK_AT(pool, pos) \
+	((muggle_sowr_block_head_t*)((char*)(pool)->blocks + (pool)->block_size * (pos)))
+
+// counters only written by allocate thread, relaxed load and store avoid locked instruction
+static inline void muggle_sowr_memory_pool_count(muggle_atomic_int64 *cnt)
+{
+	muggle_atomic_store64(cnt,
+		muggle_atomic_load64(cnt, muggle_memory_order_relaxed) + 1,
+		muggle_memory_order_relaxed);
+}
+
+// record allocation, blocks between free index and alloc index are in use;
+// cached free position is only refreshed when allocator catch up with it,
+// so use current free index, otherwise mark climb to capacity every lap
+static inline void muggle_sowr_memory_pool_on_alloc(muggle_sowr_memory_pool_t *pool)
+{
+	muggle_sowr_memory_pool_count(&pool->alloc_cnt);
+	muggle_atomic_int free_idx = muggle_atomic_load(&pool->free_idx, muggle_memory_order_relaxed);
+	muggle_atomic_int in_use = IDX_IN_POW_OF_2_RING(pool->alloc_idx - free_idx, pool->capacity);
+	if (in_use > pool->high_water_mark)
+	{
+		pool->high_water_mark = in_use;
+	}
+}
+
+// reclaim released blocks from the oldest allocated one, stop at the first
+// block still in use
+static void muggle_sowr_memory_pool_reclaim(muggle_sowr_memory_pool_t *pool, muggle_atomic_int alloc_pos)
+{
+	muggle_atomic_int pos = IDX_IN_POW_OF_2_RING(pool->cached_free_pos + 1, pool->capacity);
+	while (pos != alloc_pos)
+	{
+		muggle_sowr_block_head_t *block = MUGGLE_SOWR_BLOCK_AT(pool, pos);
+		if (!muggle_atomic_load(&block->released, muggle_memory_order_acquire))
+		{
+			break;
+		}
+
+		muggle_atomic_store(&block->released, 0, muggle_memory_order_relaxed);
+		pool->cached_free_pos = pos;
+		pos = IDX_IN_POW_OF_2_RING(pos + 1, pool->capacity);
+	}
+
+	muggle_atomic_store(&pool->free_idx, pool->cached_free_pos + 1, muggle_memory_order_relaxed);
+}
+
+static void* muggle_sowr_memory_pool_alloc_multi_free(muggle_sowr_memory_pool_t *pool)
+{
+	muggle_atomic_int alloc_pos = IDX_IN_POW_OF_2_RING(pool->alloc_idx, pool->capacity);
+	if (alloc_pos == pool->cached_free_pos)
+	{
+		muggle_sowr_memory_pool_reclaim(pool, alloc_pos);
+		if (alloc_pos == pool->cached_free_pos)
+		{
+			muggle_sowr_memory_pool_count(&pool->fail_cnt);
+			return NULL;
+		}
+	}
+
+	++pool->alloc_idx;
+	muggle_sowr_memory_pool_on_alloc(pool);
+	return (void*)(MUGGLE_SOWR_BLOCK_AT(pool, alloc_pos) + 1);
 }
 
 void* muggle_sowr_memory_pool_alloc(muggle_sowr_memory_pool_t *pool)
 {
+	if (pool->flags & MUGGLE_SOWR_MEMORY_POOL_FLAG_MULTI_FREE)
+	{
+		return muggle_sowr_memory_pool_alloc_multi_free(pool);
+	}
+
 	int alloc_pos = IDX_IN_POW_OF_2_RING(pool->alloc_idx, pool->capacity);
 	if (alloc_pos != pool->cached_free_pos)
 	{
 		muggle_sowr_block_head_t *block = (muggle_sowr_block_head_t*)((char*)pool->blocks + pool->block_size * alloc_pos);
 		++pool->alloc_idx;
+		muggle_sowr_memory_pool_on_alloc(pool);
 		return (void*)(block + 1);
 	}
 
@@ -67,9 +156,11 @@ void* muggle_sowr_memory_pool_alloc(muggle_sowr_memory_pool_t *pool)
 	{
 		muggle_sowr_block_head_t *block = (muggle_sowr_block_head_t*)((char*)pool->blocks + pool->block_size * alloc_pos);
 		++pool->alloc_idx;
+		muggle_sowr_memory_pool_on_alloc(pool);
 		return (void*)(block + 1);
 	}
 
+	muggle_sowr_memory_pool_count(&pool->fail_cnt);
 	return NULL;
 }
 
@@ -77,15 +168,51 @@ void muggle_sowr_memory_pool_free(void *data)
 {
 	muggle_sowr_block_head_t *block = (muggle_sowr_block_head_t*)data - 1;
 	muggle_sowr_memory_pool_t *pool = block->pool;
+	if (pool->flags & MUGGLE_SOWR_MEMORY_POOL_FLAG_MULTI_FREE)
+	{
+		// pair with acquire load in muggle_sowr_memory_pool_reclaim
+		muggle_atomic_store(&block->released, 1, muggle_memory_order_release);
+		return;
+	}
 	muggle_atomic_store(&pool->free_idx, block->block_idx + 1, muggle_memory_order_relaxed);
 }
 
 
 int muggle_sowr_memory_pool_is_all_free(muggle_sowr_memory_pool_t *pool)
 {
+	if (pool->flags & MUGGLE_SOWR_MEMORY_POOL_FLAG_MULTI_FREE)
+	{
+		muggle_atomic_int alloc_pos = IDX_IN_POW_OF_2_RING(pool->alloc_idx, pool->capacity);
+		muggle_atomic_int pos = IDX_IN_POW_OF_2_RING(pool->cached_free_pos + 1, pool->capacity);
+		for (; pos != alloc_pos; pos = IDX_IN_POW_OF_2_RING(pos + 1, pool->capacity))
+		{
+			if (!muggle_atomic_load(&MUGGLE_SOWR_BLOCK_AT(pool, pos)->released, muggle_memory_order_acquire))
+			{
+				return 0;
+			}
+		}
+		return 1;
+	}
+
 	muggle_atomic_int free_idx = muggle_atomic_load(&pool->free_idx, muggle_memory_order_relaxed);
 	muggle_atomic_int free_pos = IDX_IN_POW_OF_2_RING(free_idx, pool->capacity);
 	muggle_atomic_int alloc_pos = IDX_IN_POW_OF_2_RING(pool->alloc_idx, pool->capacity);
 
 	return free_pos == alloc_pos ? 1 : 0;
 }
+
+void muggle_sowr_memory_pool_get_stats(muggle_sowr_memory_pool_t *pool, muggle_pool_stats_t *stats)
+{
+	// load free index first, free never run ahead of allocate
+	muggle_atomic_int free_idx = muggle_atomic_load(&pool->free_idx, muggle_memory_order_acquire);
+	muggle_atomic_int alloc_idx = muggle_atomic_load(&pool->alloc_idx, muggle_memory_order_acquire);
+
+	stats->capacity = pool->capacity;
+	stats->in_use = IDX_IN_POW_OF_2_RING(alloc_idx - free_idx, pool->capacity);
+	stats->high_water_mark = muggle_atomic_load(&pool->high_water_mark, muggle_memory_order_relaxed);
+	stats->alloc_cnt = (uint64_t)muggle_atomic_load64(&pool->alloc_cnt, muggle_memory_order_relaxed);
+	stats->free_cnt = stats->alloc_cnt > (uint64_t)stats->in_use ?
+		stats->alloc_cnt - (uint64_t)stats->in_use : 0;
+	stats->fail_cnt = (uint64_t)muggle_atomic_load64(&pool->fail_cnt, muggle_memory_order_relaxed);
+	stats->grow_cnt = 0;
+}
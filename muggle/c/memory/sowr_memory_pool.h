@@ -15,6 +15,15 @@
  * - allocate A happen before allocate B, if free A, must happen before free B
  * - allocate b1, b2, b3, b4, b5 and free b1, b2, b3, b4, b5, it's ok
  * - allocate b1, b2, b3, b4, b5 and only free b5, it's ok too, it's mean free b5 and all blocks allocate before b5
+ *
+ * With MUGGLE_SOWR_MEMORY_POOL_FLAG_MULTI_FREE, blocks can be freed in any
+ * order by any number of threads, but still only one thread allocate
+ * - free only set released flag in block head, never touch pool
+ * - when allocator catch up the reclaimed position, it scan released flags
+ *   from the oldest allocated block and reclaim until meet a block in use
+ * - allocate is wait-free, scan visit at most capacity blocks
+ * - a block that hold for a long time stall reclaim of blocks allocated
+ *   after it, until it is freed
  *****************************************************************************/
  
 #ifndef MUGGLE_C_SOWR_MEMORY_POOL_H_
@@ -22,6 +31,8 @@
 
 #include "muggle/c/base/macro.h"
 #include "muggle/c/base/atomic.h"
+#include "muggle/c/memory/page_provider.h"
+#include "muggle/c/memory/pool_stats.h"
 
 #if MUGGLE_PLATFORM_WINDOWS
 	#include <windows.h>
@@ -31,6 +42,11 @@
 
 EXTERN_C_BEGIN
 
+enum
+{
+	MUGGLE_SOWR_MEMORY_POOL_FLAG_SEQ_FREE   = 0x00, //!< default, only one thread free in allocate order
+	MUGGLE_SOWR_MEMORY_POOL_FLAG_MULTI_FREE = 0x01, //!< multiple threads free in any order
+};
 
 struct muggle_sowr_memory_pool_tag;
 
@@ -41,7 +57,7 @@ typedef struct muggle_sowr_block_head_tag
 {
 	struct muggle_sowr_memory_pool_tag *pool;
 	int block_idx;
-	int alignment_padding;
+	muggle_atomic_int released; //!< only used in MUGGLE_SOWR_MEMORY_POOL_FLAG_MULTI_FREE
 }muggle_sowr_block_head_t;
 
 /**
@@ -52,9 +68,16 @@ typedef struct muggle_sowr_memory_pool_tag
 	void *blocks;
 	muggle_atomic_int capacity;
 	muggle_atomic_int block_size;
+	int flags;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
 	muggle_atomic_int alloc_idx;
-	muggle_atomic_int free_idx;
 	muggle_atomic_int cached_free_pos;
+	muggle_atomic_int high_water_mark; //!< max blocks not reclaimed yet seen by allocator
+	muggle_atomic_int64 alloc_cnt;
+	muggle_atomic_int64 fail_cnt;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
+	muggle_atomic_int free_idx;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(2);
 }muggle_sowr_memory_pool_t;
 
 /**
@@ -73,6 +96,44 @@ typedef struct muggle_sowr_memory_pool_tag
 MUGGLE_C_EXPORT
 int muggle_sowr_memory_pool_init(muggle_sowr_memory_pool_t *pool, muggle_atomic_int capacity, muggle_atomic_int data_size);
 
+/**
+ * @brief initialize sowr memory pool with flags
+ *
+ * NOTE: init capacity is not real capacity, actual capacity is pow of 2
+ *
+ * @param pool       sowr memory pool pointer
+ * @param capacity   init capacity
+ * @param data_size  memory data size
+ * @param flags      bitwise or of MUGGLE_SOWR_MEMORY_POOL_FLAG_*
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_sowr_memory_pool_init_ex(
+	muggle_sowr_memory_pool_t *pool, muggle_atomic_int capacity, muggle_atomic_int data_size, int flags);
+
+/**
+ * @brief initialize sowr memory pool with flags and allocation policy of blocks
+ *
+ * NOTE: init capacity is not real capacity, actual capacity is pow of 2
+ *
+ * @param pool       sowr memory pool pointer
+ * @param capacity   init capacity
+ * @param data_size  memory data size
+ * @param flags      bitwise or of MUGGLE_SOWR_MEMORY_POOL_FLAG_*
+ * @param policy     allocation policy of blocks, if it's NULL, use malloc
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_sowr_memory_pool_init_with_policy(
+	muggle_sowr_memory_pool_t *pool, muggle_atomic_int capacity, muggle_atomic_int data_size, int flags,
+	const muggle_page_policy_t *policy);
+
 /**
  * @brief destroy sowr memory pool
  *
@@ -111,6 +172,21 @@ void muggle_sowr_memory_pool_free(void *data);
 MUGGLE_C_EXPORT
 int muggle_sowr_memory_pool_is_all_free(muggle_sowr_memory_pool_t *pool);
 
+/**
+ * @brief get sowr memory pool statistics
+ *
+ * NOTE:
+ *   - in_use count blocks not reclaimed by allocator yet, with
+ *     MUGGLE_SOWR_MEMORY_POOL_FLAG_MULTI_FREE, released blocks allocated
+ *     after a block still in use are counted too
+ *   - free_cnt is derived from alloc_cnt and in_use
+ *
+ * @param pool   sowr memory pool pointer
+ * @param stats  output statistics
+ */
+MUGGLE_C_EXPORT
+void muggle_sowr_memory_pool_get_stats(muggle_sowr_memory_pool_t *pool, muggle_pool_stats_t *stats);
+
 EXTERN_C_END
 
 #endif
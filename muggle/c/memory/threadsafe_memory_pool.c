@@ -13,8 +13,181 @@
 #include "muggle/c/base/err.h"
 #include "muggle/c/base/utils.h"
 #include "muggle/c/sync/futex.h"
+#include "muggle/c/base/thread.h"
+
+#define MUGGLE_TS_POOL_TOP(tag, idx) \
+	((muggle_atomic_int64)(((uint64_t)(uint32_t)(tag) << 32) | (uint64_t)(uint32_t)(idx)))
+#define MUGGLE_TS_POOL_TOP_TAG(top) ((uint32_t)((uint64_t)(top) >> 32))
+#define MUGGLE_TS_POOL_TOP_IDX(top) ((muggle_atomic_int)(int32_t)(uint32_t)((uint64_t)(top) & 0xffffffff))
+
+static muggle_ts_memory_pool_head_t* muggle_ts_memory_pool_block(
+	muggle_ts_memory_pool_t *pool, muggle_atomic_int idx)
+{
+	char *chunk = (char*)pool->chunks[idx >> pool->chunk_shift];
+	return (muggle_ts_memory_pool_head_t*)(chunk +
+		(size_t)IDX_IN_POW_OF_2_RING(idx, pool->capacity) * pool->block_size);
+}
+
+// push blocks [first, last] linked by next into free list
+static void muggle_ts_memory_pool_push(
+	muggle_ts_memory_pool_t *pool,
+	muggle_ts_memory_pool_head_t *first,
+	muggle_ts_memory_pool_head_t *last)
+{
+	muggle_atomic_int64 top = pool->free_top;
+	do {
+		muggle_atomic_store(&last->next, MUGGLE_TS_POOL_TOP_IDX(top), muggle_memory_order_relaxed);
+	} while (!muggle_atomic_cmp_exch_weak64(&pool->free_top, &top,
+			MUGGLE_TS_POOL_TOP(MUGGLE_TS_POOL_TOP_TAG(top) + 1, first->idx), muggle_memory_order_release));
+}
+
+static muggle_ts_memory_pool_head_t* muggle_ts_memory_pool_pop(muggle_ts_memory_pool_t *pool)
+{
+	muggle_atomic_int64 top = pool->free_top;
+	while (1)
+	{
+		// pair with release in push, chunk of the index must be visible
+		muggle_atomic_thread_fence(muggle_memory_order_acquire);
+
+		muggle_atomic_int idx = MUGGLE_TS_POOL_TOP_IDX(top);
+		if (idx == MUGGLE_TS_MEMORY_POOL_NIL_IDX)
+		{
+			return NULL;
+		}
+
+		// block may be popped by other thread at the same time and next is
+		// stale, tag make the cas failed in that case; chunks never return to
+		// system before pool destroy, so read block is always safe
+		muggle_ts_memory_pool_head_t *block = muggle_ts_memory_pool_block(pool, idx);
+		muggle_atomic_int next = muggle_atomic_load(&block->next, muggle_memory_order_relaxed);
+		if (muggle_atomic_cmp_exch_weak64(&pool->free_top, &top,
+				MUGGLE_TS_POOL_TOP(MUGGLE_TS_POOL_TOP_TAG(top) + 1, next), muggle_memory_order_acquire))
+		{
+			return block;
+		}
+	}
+}
+
+// carve a new chunk and push all blocks into free list, only one thread grow
+// at the same time
+static int muggle_ts_memory_pool_grow(muggle_ts_memory_pool_t *pool)
+{
+	muggle_atomic_int chunk_idx = muggle_atomic_load(&pool->chunk_cnt, muggle_memory_order_relaxed);
+	if (chunk_idx >= pool->max_chunk)
+	{
+		return MUGGLE_ERR_FULL;
+	}
+
+	char *chunk = (char*)muggle_page_alloc((size_t)pool->capacity * pool->block_size, &pool->page_policy);
+	if (chunk == NULL)
+	{
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+
+	muggle_atomic_int base_idx = chunk_idx << pool->chunk_shift;
+	for (muggle_atomic_int i = 0; i < pool->capacity; i++)
+	{
+		muggle_ts_memory_pool_head_t *block =
+			(muggle_ts_memory_pool_head_t*)(chunk + (size_t)pool->block_size * i);
+		block->pool = pool;
+		block->idx = base_idx + i;
+		block->next = base_idx + i + 1;
+	}
+
+	pool->chunks[chunk_idx] = chunk;
+	muggle_atomic_store(&pool->chunk_cnt, chunk_idx + 1, muggle_memory_order_release);
+
+	muggle_ts_memory_pool_push(pool,
+		(muggle_ts_memory_pool_head_t*)chunk,
+		(muggle_ts_memory_pool_head_t*)(chunk + (size_t)pool->block_size * (pool->capacity - 1)));
+
+	return MUGGLE_OK;
+}
+
+static void muggle_ts_memory_pool_update_hwm(muggle_ts_memory_pool_t *pool, muggle_atomic_int in_use)
+{
+	muggle_atomic_int hwm = muggle_atomic_load(&pool->high_water_mark, muggle_memory_order_relaxed);
+	while (in_use > hwm)
+	{
+		if (muggle_atomic_cmp_exch_weak(&pool->high_water_mark, &hwm, in_use, muggle_memory_order_relaxed))
+		{
+			break;
+		}
+	}
+}
+
+static int muggle_ts_memory_pool_init_growable(muggle_ts_memory_pool_t *pool)
+{
+	muggle_atomic_int shift = 0;
+	while (((muggle_atomic_int)1 << shift) < pool->capacity)
+	{
+		shift++;
+	}
+	pool->chunk_shift = shift;
+
+	// block index must fit in 31 bits
+	pool->max_chunk = MUGGLE_TS_MEMORY_POOL_MAX_CHUNK;
+	while (pool->max_chunk > 1 && ((int64_t)pool->max_chunk << shift) > ((int64_t)1 << 31))
+	{
+		pool->max_chunk >>= 1;
+	}
+
+	pool->chunks = (void**)malloc(sizeof(void*) * pool->max_chunk);
+	if (pool->chunks == NULL)
+	{
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+
+	pool->free_top = MUGGLE_TS_POOL_TOP(0, MUGGLE_TS_MEMORY_POOL_NIL_IDX);
+	pool->chunk_cnt = 0;
+	pool->growing = 0;
+
+	int ret = muggle_ts_memory_pool_grow(pool);
+	if (ret != MUGGLE_OK)
+	{
+		free(pool->chunks);
+		pool->chunks = NULL;
+		return ret;
+	}
+
+	return MUGGLE_OK;
+}
+
+static int muggle_ts_memory_pool_lock_init(muggle_ts_memory_pool_t *pool)
+{
+	if (pool->flags & MUGGLE_TS_MEMORY_POOL_FLAG_FAST_MUTEX)
+	{
+		return muggle_fast_mutex_init(&pool->free_fast_mutex);
+	}
+	return muggle_mutex_init(&pool->free_mutex);
+}
+
+static void muggle_ts_memory_pool_lock_destroy(muggle_ts_memory_pool_t *pool)
+{
+	if (pool->flags & MUGGLE_TS_MEMORY_POOL_FLAG_FAST_MUTEX)
+	{
+		muggle_fast_mutex_destroy(&pool->free_fast_mutex);
+	}
+	else
+	{
+		muggle_mutex_destroy(&pool->free_mutex);
+	}
+}
 
 int muggle_ts_memory_pool_init(muggle_ts_memory_pool_t *pool, muggle_atomic_int capacity, muggle_atomic_int data_size)
+{
+	return muggle_ts_memory_pool_init_ex(pool, capacity, data_size, MUGGLE_TS_MEMORY_POOL_FLAG_MUTEX);
+}
+
+int muggle_ts_memory_pool_init_ex(
+	muggle_ts_memory_pool_t *pool, muggle_atomic_int capacity, muggle_atomic_int data_size, int flags)
+{
+	return muggle_ts_memory_pool_init_with_policy(pool, capacity, data_size, flags, NULL);
+}
+
+int muggle_ts_memory_pool_init_with_policy(
+	muggle_ts_memory_pool_t *pool, muggle_atomic_int capacity, muggle_atomic_int data_size, int flags,
+	const muggle_page_policy_t *policy)
 {
 	if (capacity <= 0)
 	{
@@ -39,32 +212,43 @@ int muggle_ts_memory_pool_init(muggle_ts_memory_pool_t *pool, muggle_atomic_int
 		return MUGGLE_ERR_INVALID_PARAM;
 	}
 
-	int ret = muggle_mutex_init(&pool->free_mutex);
+	pool->flags = flags;
+	pool->page_policy.flags = policy ? policy->flags : 0;
+	pool->page_policy.numa_node = policy ? policy->numa_node : 0;
+	pool->capacity = capacity;
+	pool->block_size = block_size;
+	pool->data = NULL;
+	pool->ptrs = NULL;
+	pool->chunks = NULL;
+	pool->in_use = 0;
+	pool->high_water_mark = 0;
+	pool->fail_cnt = 0;
+	muggle_pool_counter_init(&pool->counter);
+
+	if (flags & MUGGLE_TS_MEMORY_POOL_FLAG_GROWABLE)
+	{
+		return muggle_ts_memory_pool_init_growable(pool);
+	}
+
+	int ret = muggle_ts_memory_pool_lock_init(pool);
 	if (ret != 0)
 	{
 		return ret;
 	}
 
-	pool->capacity = capacity;
-	pool->block_size = block_size;
-	pool->data = malloc(capacity * block_size);
-	pool->ptrs = (muggle_ts_memory_pool_head_ptr_t*)malloc(capacity * sizeof(muggle_ts_memory_pool_head_ptr_t));
+	pool->chunk_cnt = 1;
+	pool->data = muggle_page_alloc((size_t)capacity * block_size, &pool->page_policy);
+	pool->ptrs = (muggle_ts_memory_pool_head_ptr_t*)muggle_page_alloc(
+		capacity * sizeof(muggle_ts_memory_pool_head_ptr_t), &pool->page_policy);
 	pool->alloc_cursor = 0;
 	pool->free_cursor = capacity;
 
 	if (pool->data == NULL || pool->ptrs == NULL)
 	{
-		muggle_mutex_destroy(&pool->free_mutex);
+		muggle_ts_memory_pool_lock_destroy(pool);
 
-		if (pool->data)
-		{
-			free(pool->data);
-		}
-
-		if (pool->ptrs)
-		{
-			free(pool->ptrs);
-		}
+		muggle_page_free(pool->data);
+		muggle_page_free(pool->ptrs);
 
 		return MUGGLE_ERR_MEM_ALLOC;
 	}
@@ -82,31 +266,98 @@ int muggle_ts_memory_pool_init(muggle_ts_memory_pool_t *pool, muggle_atomic_int
 
 void muggle_ts_memory_pool_destroy(muggle_ts_memory_pool_t *pool)
 {
-	muggle_mutex_destroy(&pool->free_mutex);
-
-	if (pool->data)
+	if (pool->flags & MUGGLE_TS_MEMORY_POOL_FLAG_GROWABLE)
 	{
-		free(pool->data);
-		pool->data = NULL;
+		if (pool->chunks)
+		{
+			for (muggle_atomic_int i = 0; i < pool->chunk_cnt; i++)
+			{
+				muggle_page_free(pool->chunks[i]);
+			}
+			free(pool->chunks);
+			pool->chunks = NULL;
+		}
+		return;
 	}
 
-	if (pool->ptrs)
+	muggle_ts_memory_pool_lock_destroy(pool);
+
+	muggle_page_free(pool->data);
+	pool->data = NULL;
+
+	muggle_page_free(pool->ptrs);
+	pool->ptrs = NULL;
+}
+
+static void* muggle_ts_memory_pool_alloc_growable(muggle_ts_memory_pool_t *pool)
+{
+	muggle_ts_memory_pool_head_t *block = NULL;
+	while ((block = muggle_ts_memory_pool_pop(pool)) == NULL)
 	{
-		free(pool->ptrs);
-		pool->ptrs = NULL;
+		muggle_atomic_int growing = 0;
+		if (muggle_atomic_cmp_exch_strong(&pool->growing, &growing, 1, muggle_memory_order_acquire))
+		{
+			// other thread may freed blocks or finished growing just now
+			int ret = MUGGLE_OK;
+			block = muggle_ts_memory_pool_pop(pool);
+			if (block == NULL)
+			{
+				ret = muggle_ts_memory_pool_grow(pool);
+			}
+			muggle_atomic_store(&pool->growing, 0, muggle_memory_order_release);
+
+			if (ret != MUGGLE_OK)
+			{
+				muggle_atomic_fetch_add(&pool->fail_cnt, 1, muggle_memory_order_relaxed);
+				return NULL;
+			}
+			if (block != NULL)
+			{
+				break;
+			}
+			continue;
+		}
+
+		// only the thread that hit the empty list wait for growing, alloc
+		// and free in other threads are not blocked
+		if (muggle_atomic_load(&pool->chunk_cnt, muggle_memory_order_relaxed) >= pool->max_chunk)
+		{
+			block = muggle_ts_memory_pool_pop(pool);
+			if (block == NULL)
+			{
+				muggle_atomic_fetch_add(&pool->fail_cnt, 1, muggle_memory_order_relaxed);
+				return NULL;
+			}
+			break;
+		}
+		muggle_thread_yield();
 	}
+
+	muggle_atomic_int in_use = muggle_atomic_fetch_add(&pool->in_use, 1, muggle_memory_order_relaxed) + 1;
+	muggle_ts_memory_pool_update_hwm(pool, in_use);
+	muggle_pool_counter_alloc(&pool->counter);
+
+	return (void*)(block + 1);
 }
 
 void* muggle_ts_memory_pool_alloc(muggle_ts_memory_pool_t *pool)
 {
+	if (pool->flags & MUGGLE_TS_MEMORY_POOL_FLAG_GROWABLE)
+	{
+		return muggle_ts_memory_pool_alloc_growable(pool);
+	}
+
 	muggle_atomic_int expected = pool->alloc_cursor;
 	muggle_atomic_int alloc_cursor = 0;
 	muggle_atomic_int alloc_pos = 0;
+	muggle_atomic_int free_cursor = 0;
 	void *data = NULL;
 	do {
 		alloc_cursor = expected;
-		if (alloc_cursor == muggle_atomic_load(&pool->free_cursor, muggle_memory_order_acquire))
+		free_cursor = muggle_atomic_load(&pool->free_cursor, muggle_memory_order_acquire);
+		if (alloc_cursor == free_cursor)
 		{
+			muggle_atomic_fetch_add(&pool->fail_cnt, 1, muggle_memory_order_relaxed);
 			return NULL;
 		}
 
@@ -120,6 +371,10 @@ void* muggle_ts_memory_pool_alloc(muggle_ts_memory_pool_t *pool)
 	} while (!muggle_atomic_cmp_exch_weak(&pool->alloc_cursor, &expected, alloc_cursor + 1, muggle_memory_order_relaxed)
 			&& expected != alloc_pos);
 
+	// free_cursor may be stale, so this is an upper bound of in use blocks
+	muggle_ts_memory_pool_update_hwm(pool, alloc_cursor + 1 - (free_cursor - pool->capacity));
+	muggle_pool_counter_alloc(&pool->counter);
+
 	return data;
 }
 
@@ -128,7 +383,23 @@ void muggle_ts_memory_pool_free(void *data)
 	muggle_ts_memory_pool_head_t *block = (muggle_ts_memory_pool_head_t*)data - 1;
 	muggle_ts_memory_pool_t *pool = block->pool;
 
-	muggle_mutex_lock(&pool->free_mutex);
+	muggle_pool_counter_free(&pool->counter);
+
+	if (pool->flags & MUGGLE_TS_MEMORY_POOL_FLAG_GROWABLE)
+	{
+		muggle_ts_memory_pool_push(pool, block, block);
+		muggle_atomic_fetch_sub(&pool->in_use, 1, muggle_memory_order_relaxed);
+		return;
+	}
+
+	if (pool->flags & MUGGLE_TS_MEMORY_POOL_FLAG_FAST_MUTEX)
+	{
+		muggle_fast_mutex_lock(&pool->free_fast_mutex);
+	}
+	else
+	{
+		muggle_mutex_lock(&pool->free_mutex);
+	}
 
 	muggle_atomic_int free_pos = IDX_IN_POW_OF_2_RING(pool->free_cursor, pool->capacity);
 	pool->ptrs[free_pos].ptr = block;
@@ -136,5 +407,33 @@ void muggle_ts_memory_pool_free(void *data)
 	// use atomic store for writer see correct order
 	muggle_atomic_store(&pool->free_cursor, pool->free_cursor + 1, muggle_memory_order_release);
 
-	muggle_mutex_unlock(&pool->free_mutex);
+	if (pool->flags & MUGGLE_TS_MEMORY_POOL_FLAG_FAST_MUTEX)
+	{
+		muggle_fast_mutex_unlock(&pool->free_fast_mutex);
+	}
+	else
+	{
+		muggle_mutex_unlock(&pool->free_mutex);
+	}
+}
+
+void muggle_ts_memory_pool_get_stats(muggle_ts_memory_pool_t *pool, muggle_pool_stats_t *stats)
+{
+	muggle_atomic_int chunk_cnt = muggle_atomic_load(&pool->chunk_cnt, muggle_memory_order_acquire);
+	stats->capacity = (int64_t)pool->capacity * chunk_cnt;
+	if (pool->flags & MUGGLE_TS_MEMORY_POOL_FLAG_GROWABLE)
+	{
+		stats->in_use = muggle_atomic_load(&pool->in_use, muggle_memory_order_relaxed);
+		stats->grow_cnt = chunk_cnt > 1 ? (uint64_t)(chunk_cnt - 1) : 0;
+	}
+	else
+	{
+		muggle_atomic_int free_cursor = muggle_atomic_load(&pool->free_cursor, muggle_memory_order_acquire);
+		muggle_atomic_int alloc_cursor = muggle_atomic_load(&pool->alloc_cursor, muggle_memory_order_relaxed);
+		stats->in_use = alloc_cursor - (free_cursor - pool->capacity);
+		stats->grow_cnt = 0;
+	}
+	stats->high_water_mark = muggle_atomic_load(&pool->high_water_mark, muggle_memory_order_relaxed);
+	stats->fail_cnt = (uint64_t)muggle_atomic_load(&pool->fail_cnt, muggle_memory_order_relaxed);
+	muggle_pool_counter_sum(&pool->counter, &stats->alloc_cnt, &stats->free_cnt);
 }
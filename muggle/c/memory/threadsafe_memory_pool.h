@@ -14,9 +14,22 @@
 #include "muggle/c/base/macro.h"
 #include "muggle/c/base/atomic.h"
 #include "muggle/c/sync/mutex.h"
+#include "muggle/c/sync/fast_mutex.h"
+#include "muggle/c/memory/page_provider.h"
+#include "muggle/c/memory/pool_stats.h"
 
 EXTERN_C_BEGIN
 
+enum
+{
+	MUGGLE_TS_MEMORY_POOL_FLAG_MUTEX      = 0x00, //!< default, free lock use muggle_mutex_t
+	MUGGLE_TS_MEMORY_POOL_FLAG_FAST_MUTEX = 0x01, //!< free lock use muggle_fast_mutex_t
+	MUGGLE_TS_MEMORY_POOL_FLAG_GROWABLE   = 0x02, //!< lock-free free list, chain new chunk when exhausted
+};
+
+#define MUGGLE_TS_MEMORY_POOL_MAX_CHUNK 1024 //!< max number of chunks in growable mode
+#define MUGGLE_TS_MEMORY_POOL_NIL_IDX -1     //!< end of free list in growable mode
+
 struct muggle_ts_memory_pool;
 
 /**
@@ -26,6 +39,8 @@ typedef struct muggle_ts_memory_pool_head
 {
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
 	struct muggle_ts_memory_pool *pool;
+	muggle_atomic_int idx;  //!< block index, only used in growable mode
+	muggle_atomic_int next; //!< next free block index, only used in growable mode
 }muggle_ts_memory_pool_head_t;
 
 /**
@@ -44,16 +59,35 @@ typedef struct muggle_ts_memory_pool
 {
 	muggle_atomic_int                capacity;
 	muggle_atomic_int                block_size;
+	int                              flags;
 	void                             *data;
 	muggle_ts_memory_pool_head_ptr_t *ptrs;
+	void                             **chunks;     //!< growable mode chunks
+	muggle_atomic_int                max_chunk;
+	muggle_atomic_int                chunk_shift;  //!< log2(capacity)
+	muggle_page_policy_t             page_policy;  //!< allocation policy of blocks
 
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
 	muggle_atomic_int alloc_cursor;
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
 	muggle_atomic_int free_cursor;
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(2);
-	muggle_mutex_t free_mutex;
+	union
+	{
+		muggle_mutex_t      free_mutex;      //!< MUGGLE_TS_MEMORY_POOL_FLAG_MUTEX
+		muggle_fast_mutex_t free_fast_mutex; //!< MUGGLE_TS_MEMORY_POOL_FLAG_FAST_MUTEX
+	};
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(3);
+	muggle_atomic_int64 free_top;  //!< growable mode free list, ABA tag << 32 | block index
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(4);
+	muggle_atomic_int chunk_cnt;
+	muggle_atomic_int growing;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(5);
+	muggle_atomic_int in_use;
+	muggle_atomic_int high_water_mark;
+	muggle_atomic_int fail_cnt;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(6);
+	muggle_pool_counter_t counter;  //!< alloc and free counter striped by thread
 }muggle_ts_memory_pool_t;
 
 /**
@@ -70,6 +104,45 @@ typedef struct muggle_ts_memory_pool
 MUGGLE_C_EXPORT
 int muggle_ts_memory_pool_init(muggle_ts_memory_pool_t *pool, muggle_atomic_int capacity, muggle_atomic_int data_size);
 
+/**
+ * @brief init muggle thread safe memory pool with flags
+ *
+ * NOTE: with MUGGLE_TS_MEMORY_POOL_FLAG_GROWABLE, capacity is the number of
+ * blocks per chunk, when free list is empty, alloc chain a new chunk until
+ * reach MUGGLE_TS_MEMORY_POOL_MAX_CHUNK chunks; free push block into a
+ * lock-free stack, MUGGLE_TS_MEMORY_POOL_FLAG_FAST_MUTEX is ignored
+ *
+ * @param pool       pointer to ts_memory_pool
+ * @param capacity   expected capacity of pool
+ * @param data_size  user data size
+ * @param flags      bitwise or of MUGGLE_TS_MEMORY_POOL_FLAG_*
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise failed and return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_ts_memory_pool_init_ex(
+	muggle_ts_memory_pool_t *pool, muggle_atomic_int capacity, muggle_atomic_int data_size, int flags);
+
+/**
+ * @brief init muggle thread safe memory pool with flags and allocation policy of blocks
+ *
+ * @param pool       pointer to ts_memory_pool
+ * @param capacity   expected capacity of pool
+ * @param data_size  user data size
+ * @param flags      bitwise or of MUGGLE_TS_MEMORY_POOL_FLAG_*
+ * @param policy     allocation policy of blocks, if it's NULL, use malloc
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise failed and return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_ts_memory_pool_init_with_policy(
+	muggle_ts_memory_pool_t *pool, muggle_atomic_int capacity, muggle_atomic_int data_size, int flags,
+	const muggle_page_policy_t *policy);
+
 /**
  * @brief destroy thread safe memory pool
  *
@@ -96,6 +169,18 @@ void* muggle_ts_memory_pool_alloc(muggle_ts_memory_pool_t *pool);
 MUGGLE_C_EXPORT
 void muggle_ts_memory_pool_free(void *data);
 
+/**
+ * @brief get thread safe memory pool statistics
+ *
+ * NOTE: counters are updated without lock, values are approximate when
+ * other threads are allocating or freeing
+ *
+ * @param pool   pointer to ts_memory_pool
+ * @param stats  output statistics
+ */
+MUGGLE_C_EXPORT
+void muggle_ts_memory_pool_get_stats(muggle_ts_memory_pool_t *pool, muggle_pool_stats_t *stats);
+
 EXTERN_C_END
 
 #endif
@@ -27,6 +27,7 @@
 #include "muggle/c/base/thread.h"
 #include "muggle/c/base/atomic.h"
 #include "muggle/c/base/sleep.h"
+#include "muggle/c/base/iovec.h"
 
 // memory
 #include "muggle/c/memory/memory_pool.h"
@@ -35,11 +36,18 @@
 #include "muggle/c/memory/bytes_buffer.h"
 #include "muggle/c/memory/threadsafe_memory_pool.h"
 #include "muggle/c/memory/pointer_slot.h"
+#include "muggle/c/memory/slab_allocator.h"
+#include "muggle/c/memory/arena.h"
+#include "muggle/c/memory/page_provider.h"
+#include "muggle/c/memory/chain_buffer.h"
+#include "muggle/c/memory/pool_stats.h"
+#include "muggle/c/memory/ebr.h"
 
 // time
 #include "muggle/c/time/win_gettimeofday.h"
 #include "muggle/c/time/win_gmtime.h"
 #include "muggle/c/time/cpu_cycle.h"
+#include "muggle/c/time/deadline.h"
 
 // os
 #include "muggle/c/os/os.h"
@@ -49,15 +57,21 @@
 
 // sync
 #include "muggle/c/sync/mutex.h"
+#include "muggle/c/sync/fast_mutex.h"
 #include "muggle/c/sync/condition_variable.h"
+#include "muggle/c/sync/fast_condition_variable.h"
 #include "muggle/c/sync/futex.h"
 #include "muggle/c/sync/ring_buffer.h"
 #include "muggle/c/sync/array_blocking_queue.h"
 #include "muggle/c/sync/double_buffer.h"
 #include "muggle/c/sync/channel.h"
+#include "muggle/c/sync/inline_ring.h"
+#include "muggle/c/sync/byte_ring.h"
+#include "muggle/c/sync/broadcast_ring.h"
 
 // log
 #include "muggle/c/log/log_fmt.h"
+#include "muggle/c/log/log_deferred.h"
 #include "muggle/c/log/log_handle.h"
 #include "muggle/c/log/log_handle_console.h"
 #include "muggle/c/log/log_handle_file.h"
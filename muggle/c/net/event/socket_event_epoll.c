@@ -34,53 +34,48 @@ static void muggle_socket_event_epoll_listen(
 		}
 
 		// get new peer
-		muggle_socket_peer_list_node_t *node = muggle_socket_event_memmgr_allocate(mem_mgr);
-		if (node == NULL)
+		muggle_socket_peer_slot_t *slot = muggle_socket_event_memmgr_allocate(mem_mgr);
+		if (slot == NULL)
 		{
 			muggle_socket_event_refuse_accept(listen_peer);
 			break;
 		}
 
 		// accept new connection
-		muggle_socket_event_accept(listen_peer, &node->peer);
-		if (node->peer.fd == MUGGLE_INVALID_SOCKET)
+		muggle_socket_event_accept(listen_peer, &slot->peer);
+		if (slot->peer.fd == MUGGLE_INVALID_SOCKET)
 		{
-			muggle_socket_event_memmgr_free(mem_mgr, node);
+			muggle_socket_event_memmgr_free(mem_mgr, slot);
 			break;
 		}
+		muggle_socket_event_memmgr_bind_fd(mem_mgr, slot);
 
-		// add new connection socket into epoll
+		// add new connection socket into epoll, use handle so events of
+		// recycled and reused slot can be detected
 		struct epoll_event epev;
 		memset(&epev, 0, sizeof(epev));
-		epev.data.ptr = node;
+		epev.data.u64 = muggle_socket_event_memmgr_handle(slot);
 		epev.events = EPOLLIN | EPOLLET;
-		if (epoll_ctl(*epfd, EPOLL_CTL_ADD, node->peer.fd, &epev) == MUGGLE_INVALID_SOCKET)
+		if (epoll_ctl(*epfd, EPOLL_CTL_ADD, slot->peer.fd, &epev) == MUGGLE_INVALID_SOCKET)
 		{
 			char err_msg[1024] = {0};
 			muggle_socket_strerror(MUGGLE_SOCKET_LAST_ERRNO, err_msg, sizeof(err_msg));
 			MUGGLE_LOG_ERROR("failed epoll_ctl EPOLL_CTL_ADD - %s", err_msg);
 
-			muggle_socket_event_memmgr_recycle(mem_mgr, node);
+			muggle_socket_event_memmgr_recycle(mem_mgr, slot);
 			continue;
 		}
 		++(*cnt_fd);
 
 		// notify user
-		node->peer.ev = ev;
+		slot->peer.ev = ev;
 		if (ev->on_connect)
 		{
-			ev->on_connect(ev, listen_peer, &node->peer);
+			ev->on_connect(ev, listen_peer, &slot->peer);
 		}
 
 #if MUGGLE_ENABLE_TRACE
-		char debug_buf[4096];
-		int debug_offset = 0;
-		debug_offset = snprintf(debug_buf, sizeof(debug_buf) - debug_offset, "active list | ");
-		muggle_socket_event_memmgr_debug_print(mem_mgr->active_head.next, debug_buf, debug_offset, sizeof(debug_buf));
-
-		debug_offset = 0;
-		debug_offset = snprintf(debug_buf, sizeof(debug_buf) - debug_offset, "recycle list | ");
-		muggle_socket_event_memmgr_debug_print(mem_mgr->recycle_head.next, debug_buf, debug_offset, sizeof(debug_buf));
+		muggle_socket_event_memmgr_debug_print(mem_mgr);
 #endif
 	}
 }
@@ -116,28 +111,26 @@ void muggle_socket_event_epoll(muggle_socket_event_t *ev)
 		return;
 	}
 
-	int cnt_fd;
+	int cnt_fd = 0;
 	struct epoll_event epev;
-	muggle_socket_peer_list_node_t *node = muggle_socket_event_memmgr_get_node(p_mem_mgr);
-	while (node)
+	for (int i = muggle_socket_event_memmgr_active_count(p_mem_mgr) - 1; i >= 0; --i)
 	{
+		muggle_socket_peer_slot_t *slot = muggle_socket_event_memmgr_active_at(p_mem_mgr, i);
+
 		memset(&epev, 0, sizeof(epev));
-		epev.data.ptr = node;
+		epev.data.u64 = muggle_socket_event_memmgr_handle(slot);
 		epev.events = EPOLLIN | EPOLLET;
 
-		if (epoll_ctl(epfd, EPOLL_CTL_ADD, node->peer.fd, &epev) == MUGGLE_INVALID_SOCKET)
+		if (epoll_ctl(epfd, EPOLL_CTL_ADD, slot->peer.fd, &epev) == MUGGLE_INVALID_SOCKET)
 		{
 			char err_msg[1024] = {0};
 			muggle_socket_strerror(MUGGLE_SOCKET_LAST_ERRNO, err_msg, sizeof(err_msg));
 			MUGGLE_LOG_ERROR("failed epoll_ctl EPOLL_CTL_ADD - %s", err_msg);
 
-			muggle_socket_peer_list_node_t *next_node = node->next;
-			muggle_socket_event_memmgr_recycle(p_mem_mgr, node);
-			node = next_node;
+			muggle_socket_event_memmgr_recycle(p_mem_mgr, slot);
 			continue;
 		}
 
-		node = node->next;
 		++cnt_fd;
 	}
 
@@ -157,8 +150,19 @@ void muggle_socket_event_epoll(muggle_socket_event_t *ev)
 		{
 			for (int i = 0; i < n; ++i)
 			{
-				muggle_socket_peer_list_node_t *node = (muggle_socket_peer_list_node_t*)ret_epevs[i].data.ptr;
-				muggle_socket_peer_t *peer = &node->peer;
+				if (i + 1 < n)
+				{
+					MUGGLE_PREFETCH(&p_mem_mgr->slots[MUGGLE_SOCKET_PEER_HANDLE_IDX(ret_epevs[i + 1].data.u64)]);
+				}
+
+				// skip slot recycled by previous event in this batch
+				muggle_socket_peer_slot_t *slot =
+					muggle_socket_event_memmgr_resolve(p_mem_mgr, ret_epevs[i].data.u64);
+				if (slot == NULL)
+				{
+					continue;
+				}
+				muggle_socket_peer_t *peer = &slot->peer;
 
 				if (ret_epevs[i].events & EPOLLIN)
 				{
@@ -193,7 +197,7 @@ void muggle_socket_event_epoll(muggle_socket_event_t *ev)
 
 					epoll_ctl(epfd, EPOLL_CTL_DEL, peer->fd, &ret_epevs[i]);
 
-					muggle_socket_event_memmgr_recycle(p_mem_mgr, node);
+					muggle_socket_event_memmgr_recycle(p_mem_mgr, slot);
 					--cnt_fd;
 				}
 			}
@@ -230,7 +234,7 @@ void muggle_socket_event_epoll(muggle_socket_event_t *ev)
 			break;
 		}
 
-		// recycle node
+		// free recycled slots no longer referenced
 		muggle_socket_event_memmgr_clear(p_mem_mgr);
 	}
 
@@ -9,217 +9,356 @@
  *****************************************************************************/
 
 #include "socket_event_memmgr.h"
+#include <stdlib.h>
 #include <string.h>
 #include "muggle/c/base/sleep.h"
 #include "muggle/c/log/log.h"
 
+#define MUGGLE_SOCKET_EVENT_FD_TABLE_INIT_SIZE 1024
+
 #if MUGGLE_ENABLE_TRACE
 
-void muggle_socket_event_memmgr_debug_print(
-	muggle_socket_peer_list_node_t *node,
+static int muggle_socket_event_memmgr_debug_print_arr(
+	muggle_socket_event_memmgr_t *mgr, uint32_t *arr, int cnt,
 	char *buf, int offset, int bufsize)
 {
-	while (node)
+	for (int i = 0; i < cnt; i++)
 	{
+		muggle_socket_peer_t *peer = &mgr->slots[arr[i]].peer;
+
 		char straddr[MUGGLE_SOCKET_ADDR_STRLEN];
-		if (node->peer.addr_len == 0 ||
-			muggle_socket_ntop((struct sockaddr*)&node->peer.addr, straddr, MUGGLE_SOCKET_ADDR_STRLEN, 0) == NULL)
+		if (peer->addr_len == 0 ||
+			muggle_socket_ntop((struct sockaddr*)&peer->addr, straddr, MUGGLE_SOCKET_ADDR_STRLEN, 0) == NULL)
 		{
 			snprintf(straddr, MUGGLE_SOCKET_ADDR_STRLEN, "?:?");
 		}
 
 #if MUGGLE_PLATFORM_WINDOWS
-		offset += snprintf(buf + offset, bufsize - offset, "[%s](%d) -> ", straddr, node->peer.ref_cnt);
+		offset += snprintf(buf + offset, bufsize - offset, "[%s](%d) -> ", straddr, peer->ref_cnt);
 #else
-		offset += snprintf(buf + offset, bufsize - offset, "%d[%s](%d) -> ", node->peer.fd, straddr, node->peer.ref_cnt);
+		offset += snprintf(buf + offset, bufsize - offset, "%d[%s](%d) -> ", peer->fd, straddr, peer->ref_cnt);
 #endif
 
 		if (offset >= bufsize - 1)
 		{
-			break;
+			return offset;
 		}
-
-		node = node->next;
 	}
 
 	if (offset < bufsize - 1)
 	{
-		snprintf(buf + offset, bufsize - offset, "NULL");
+		offset += snprintf(buf + offset, bufsize - offset, "NULL");
 	}
-	MUGGLE_DEBUG_INFO(buf);
+
+	return offset;
+}
+
+void muggle_socket_event_memmgr_debug_print(muggle_socket_event_memmgr_t *mgr)
+{
+	char debug_buf[4096];
+	int debug_offset = 0;
+
+	debug_offset = snprintf(debug_buf, sizeof(debug_buf), "active list | ");
+	muggle_socket_event_memmgr_debug_print_arr(
+		mgr, mgr->active, mgr->cnt_active, debug_buf, debug_offset, (int)sizeof(debug_buf));
+	MUGGLE_DEBUG_INFO("%s", debug_buf);
+
+	debug_offset = snprintf(debug_buf, sizeof(debug_buf), "recycle list | ");
+	muggle_socket_event_memmgr_debug_print_arr(
+		mgr, mgr->recycle, mgr->cnt_recycle, debug_buf, debug_offset, (int)sizeof(debug_buf));
+	MUGGLE_DEBUG_INFO("%s", debug_buf);
 }
 
 #endif
 
-void muggle_socket_event_memmgr_insert_node(muggle_socket_peer_list_node_t *head, muggle_socket_peer_list_node_t *node)
+/*
+ * dense index array helpers, slot->pos is position in the array
+ * */
+static void muggle_socket_event_memmgr_arr_push(uint32_t *arr, int *cnt, muggle_socket_peer_slot_t *slot)
 {
-	node->next = head->next;
-	if (node->next)
+	slot->pos = *cnt;
+	arr[(*cnt)++] = slot->idx;
+}
+
+static void muggle_socket_event_memmgr_arr_remove(
+	muggle_socket_event_memmgr_t *mgr, uint32_t *arr, int *cnt, muggle_socket_peer_slot_t *slot)
+{
+	int last = --(*cnt);
+	if (slot->pos != last)
 	{
-		node->next->prev = node;
+		uint32_t last_idx = arr[last];
+		arr[slot->pos] = last_idx;
+		mgr->slots[last_idx].pos = slot->pos;
 	}
-	head->next = node;
-	node->prev = head;
+	slot->pos = -1;
 }
 
-void muggle_socket_event_memmgr_remove_node(muggle_socket_peer_list_node_t *node)
+static void muggle_socket_event_memmgr_unbind_fd(muggle_socket_event_memmgr_t *mgr, muggle_socket_peer_slot_t *slot)
 {
-	if (node->prev)
+#if !MUGGLE_PLATFORM_WINDOWS
+	int fd = slot->peer.fd;
+	if (fd >= 0 && fd < mgr->fd_table_size &&
+		mgr->fd_table[fd] == muggle_socket_event_memmgr_handle(slot))
 	{
-		node->prev->next = node->next;
+		mgr->fd_table[fd] = 0;
 	}
+#endif
+}
 
-	if (node->next)
+// put slot back to free stack, handles of this slot become stale
+static void muggle_socket_event_memmgr_release_slot(muggle_socket_event_memmgr_t *mgr, muggle_socket_peer_slot_t *slot)
+{
+	slot->state = MUGGLE_SOCKET_PEER_SLOT_FREE;
+	if (++slot->gen == 0)
 	{
-		node->next->prev = node->prev;
+		slot->gen = 1;
 	}
-
-	node->prev = NULL;
-	node->next = NULL;
+	mgr->free_idx[mgr->cnt_free++] = slot->idx;
 }
 
 int muggle_socket_event_memmgr_init(
 	muggle_socket_event_t *ev, muggle_socket_event_init_arg_t *ev_init_arg, muggle_socket_event_memmgr_t *mgr)
 {
-	// fixed size pool for peers
-	if (!muggle_memory_pool_init(&mgr->peer_pool, ev->capacity, sizeof(muggle_socket_peer_list_node_t)))
+	memset(mgr, 0, sizeof(muggle_socket_event_memmgr_t));
+
+	int capacity = ev->capacity;
+	if (capacity < ev_init_arg->cnt_peer)
+	{
+		MUGGLE_LOG_ERROR("socket event capacity: %d less than number of input peers: %d",
+			capacity, ev_init_arg->cnt_peer);
+		return -1;
+	}
+
+	mgr->slots = (muggle_socket_peer_slot_t*)malloc(sizeof(muggle_socket_peer_slot_t) * capacity);
+	mgr->free_idx = (uint32_t*)malloc(sizeof(uint32_t) * capacity);
+	mgr->active = (uint32_t*)malloc(sizeof(uint32_t) * capacity);
+	mgr->recycle = (uint32_t*)malloc(sizeof(uint32_t) * capacity);
+	if (mgr->slots == NULL || mgr->free_idx == NULL || mgr->active == NULL || mgr->recycle == NULL)
 	{
-		MUGGLE_LOG_ERROR("failed init memory pool for capacity: %d, unit size: %d",
-			ev->capacity, sizeof(muggle_socket_peer_list_node_t));
+		MUGGLE_LOG_ERROR("failed allocate slab for capacity: %d, slot size: %d",
+			capacity, (int)sizeof(muggle_socket_peer_slot_t));
+		muggle_socket_event_memmgr_destroy(mgr);
 		return -1;
 	}
-	muggle_memory_pool_set_flag(&mgr->peer_pool, MUGGLE_MEMORY_POOL_CONSTANT_SIZE);
+	mgr->capacity = capacity;
 
-	// active and recycle peer node list
-	mgr->active_head.prev = NULL;
-	mgr->active_head.next = NULL;
-	mgr->recycle_head.prev = NULL;
-	mgr->recycle_head.next = NULL;
+	// slot with lower index is allocated first, keep hot slots together
+	for (int i = 0; i < capacity; ++i)
+	{
+		muggle_socket_peer_slot_t *slot = &mgr->slots[i];
+		memset(slot, 0, sizeof(muggle_socket_peer_slot_t));
+		slot->idx = (uint32_t)i;
+		slot->gen = 1;
+		slot->state = MUGGLE_SOCKET_PEER_SLOT_FREE;
+		slot->pos = -1;
+
+		mgr->free_idx[capacity - 1 - i] = (uint32_t)i;
+	}
+	mgr->cnt_free = capacity;
 
-	// put input peers into active list
+	// put input peers into active array
 	for (int i = 0; i < ev_init_arg->cnt_peer; ++i)
 	{
-		muggle_socket_peer_list_node_t* node = (muggle_socket_peer_list_node_t*)muggle_memory_pool_alloc(&mgr->peer_pool);
-		if (node == NULL)
+		muggle_socket_peer_slot_t *slot = muggle_socket_event_memmgr_allocate(mgr);
+		MUGGLE_ASSERT(slot != NULL);
+
+		memcpy(&slot->peer, &ev_init_arg->peers[i], sizeof(muggle_socket_peer_t));
+		slot->peer.ref_cnt = 1;
+		muggle_socket_set_nonblock(slot->peer.fd, 1);
+		slot->peer.status = MUGGLE_SOCKET_PEER_STATUS_ACTIVE;
+
+		if (muggle_socket_event_memmgr_bind_fd(mgr, slot) != 0)
 		{
-			MUGGLE_ASSERT(node != NULL);
-			muggle_memory_pool_destroy(&mgr->peer_pool);
+			muggle_socket_event_memmgr_destroy(mgr);
 			return -1;
 		}
 
-		memcpy(&node->peer, &ev_init_arg->peers[i], sizeof(muggle_socket_peer_t));
-		node->peer.ref_cnt = 1;
-		muggle_socket_set_nonblock(node->peer.fd, 1);
-		node->peer.status = MUGGLE_SOCKET_PEER_STATUS_ACTIVE;
-
-		muggle_socket_event_memmgr_insert_node(&mgr->active_head, node);
-
 		// return peers holds by ev
 		if (ev_init_arg->p_peers)
 		{
-			ev_init_arg->p_peers[i] = &node->peer;
+			ev_init_arg->p_peers[i] = &slot->peer;
+		}
+	}
+
+	return 0;
+}
+
+muggle_socket_peer_slot_t* muggle_socket_event_memmgr_allocate(muggle_socket_event_memmgr_t *mgr)
+{
+	if (mgr->cnt_free == 0)
+	{
+		return NULL;
+	}
+
+	muggle_socket_peer_slot_t *slot = &mgr->slots[mgr->free_idx[--mgr->cnt_free]];
+	memset(&slot->peer, 0, sizeof(muggle_socket_peer_t));
+	slot->state = MUGGLE_SOCKET_PEER_SLOT_ACTIVE;
+	muggle_socket_event_memmgr_arr_push(mgr->active, &mgr->cnt_active, slot);
+
+	return slot;
+}
+
+int muggle_socket_event_memmgr_bind_fd(muggle_socket_event_memmgr_t *mgr, muggle_socket_peer_slot_t *slot)
+{
+#if !MUGGLE_PLATFORM_WINDOWS
+	int fd = slot->peer.fd;
+	if (fd < 0)
+	{
+		return -1;
+	}
+
+	if (fd >= mgr->fd_table_size)
+	{
+		int size = mgr->fd_table_size > 0 ? mgr->fd_table_size : MUGGLE_SOCKET_EVENT_FD_TABLE_INIT_SIZE;
+		while (size <= fd)
+		{
+			size *= 2;
+		}
+
+		muggle_socket_peer_handle_t *fd_table = (muggle_socket_peer_handle_t*)realloc(
+			mgr->fd_table, sizeof(muggle_socket_peer_handle_t) * size);
+		if (fd_table == NULL)
+		{
+			MUGGLE_LOG_ERROR("failed allocate fd table for fd: %d", fd);
+			return -1;
 		}
+		memset(fd_table + mgr->fd_table_size, 0,
+			sizeof(muggle_socket_peer_handle_t) * (size - mgr->fd_table_size));
+
+		mgr->fd_table = fd_table;
+		mgr->fd_table_size = size;
 	}
 
+	mgr->fd_table[fd] = muggle_socket_event_memmgr_handle(slot);
+#endif
+
 	return 0;
 }
 
-muggle_socket_peer_list_node_t* muggle_socket_event_memmgr_allocate(muggle_socket_event_memmgr_t *mgr)
+muggle_socket_peer_slot_t* muggle_socket_event_memmgr_find(muggle_socket_event_memmgr_t *mgr, muggle_socket_t fd)
+{
+#if MUGGLE_PLATFORM_WINDOWS
+	// socket is a handle on windows, not suitable for index
+	for (int i = 0; i < mgr->cnt_active; i++)
+	{
+		muggle_socket_peer_slot_t *slot = &mgr->slots[mgr->active[i]];
+		if (slot->peer.fd == fd)
+		{
+			return slot;
+		}
+	}
+	return NULL;
+#else
+	if (fd < 0 || fd >= mgr->fd_table_size)
+	{
+		return NULL;
+	}
+	return muggle_socket_event_memmgr_resolve(mgr, mgr->fd_table[fd]);
+#endif
+}
+
+muggle_socket_peer_handle_t muggle_socket_event_memmgr_handle(muggle_socket_peer_slot_t *slot)
+{
+	return MUGGLE_SOCKET_PEER_HANDLE(slot->gen, slot->idx);
+}
+
+muggle_socket_peer_slot_t* muggle_socket_event_memmgr_resolve(
+	muggle_socket_event_memmgr_t *mgr, muggle_socket_peer_handle_t handle)
 {
-	muggle_socket_peer_list_node_t* node = (muggle_socket_peer_list_node_t*)muggle_memory_pool_alloc(&mgr->peer_pool);
-	if (node)
+	uint32_t idx = MUGGLE_SOCKET_PEER_HANDLE_IDX(handle);
+	if (handle == 0 || idx >= (uint32_t)mgr->capacity)
+	{
+		return NULL;
+	}
+
+	muggle_socket_peer_slot_t *slot = &mgr->slots[idx];
+	if (slot->gen != MUGGLE_SOCKET_PEER_HANDLE_GEN(handle) ||
+		slot->state != MUGGLE_SOCKET_PEER_SLOT_ACTIVE)
 	{
-		memset(node, 0, sizeof(muggle_socket_peer_list_node_t));
-		muggle_socket_event_memmgr_insert_node(&mgr->active_head, node);
+		return NULL;
 	}
 
-	return node;
+	return slot;
+}
+
+int muggle_socket_event_memmgr_active_count(muggle_socket_event_memmgr_t *mgr)
+{
+	return mgr->cnt_active;
 }
 
-muggle_socket_peer_list_node_t* muggle_socket_event_memmgr_get_node(muggle_socket_event_memmgr_t *mgr)
+muggle_socket_peer_slot_t* muggle_socket_event_memmgr_active_at(muggle_socket_event_memmgr_t *mgr, int pos)
 {
-	return mgr->active_head.next;
+	return &mgr->slots[mgr->active[pos]];
 }
 
-void muggle_socket_event_memmgr_free(muggle_socket_event_memmgr_t *mgr, muggle_socket_peer_list_node_t *node)
+void muggle_socket_event_memmgr_free(muggle_socket_event_memmgr_t *mgr, muggle_socket_peer_slot_t *slot)
 {
-	muggle_socket_event_memmgr_remove_node(node);
-	muggle_memory_pool_free(&mgr->peer_pool, node);
+	MUGGLE_ASSERT(slot->state == MUGGLE_SOCKET_PEER_SLOT_ACTIVE);
+
+	muggle_socket_event_memmgr_unbind_fd(mgr, slot);
+	muggle_socket_event_memmgr_arr_remove(mgr, mgr->active, &mgr->cnt_active, slot);
+	muggle_socket_event_memmgr_release_slot(mgr, slot);
 }
 
-void muggle_socket_event_memmgr_recycle(muggle_socket_event_memmgr_t *mgr, muggle_socket_peer_list_node_t *node)
+void muggle_socket_event_memmgr_recycle(muggle_socket_event_memmgr_t *mgr, muggle_socket_peer_slot_t *slot)
 {
-	MUGGLE_ASSERT(node->prev != NULL);
+	MUGGLE_ASSERT(slot->state == MUGGLE_SOCKET_PEER_SLOT_ACTIVE);
 
-	muggle_socket_event_memmgr_remove_node(node);
+	muggle_socket_event_memmgr_unbind_fd(mgr, slot);
+	muggle_socket_event_memmgr_arr_remove(mgr, mgr->active, &mgr->cnt_active, slot);
 
-	int ref_cnt = muggle_socket_peer_release(&node->peer);
+	int ref_cnt = muggle_socket_peer_release(&slot->peer);
 	if (ref_cnt == 0)
 	{
-		muggle_memory_pool_free(&mgr->peer_pool, node);
+		muggle_socket_event_memmgr_release_slot(mgr, slot);
 	}
 	else
 	{
-		muggle_socket_event_memmgr_insert_node(&mgr->recycle_head, node);
+		slot->state = MUGGLE_SOCKET_PEER_SLOT_RECYCLE;
+		muggle_socket_event_memmgr_arr_push(mgr->recycle, &mgr->cnt_recycle, slot);
 	}
 
 #if MUGGLE_ENABLE_TRACE
 	MUGGLE_DEBUG_INFO("muggle socket event memmgr recycle");
-
-	char debug_buf[4096];
-	int debug_offset = 0;
-	debug_offset = snprintf(debug_buf, sizeof(debug_buf) - debug_offset, "active list | ");
-	muggle_socket_event_memmgr_debug_print(mgr->active_head.next, debug_buf, debug_offset, sizeof(debug_buf));
-
-	debug_offset = 0;
-	debug_offset = snprintf(debug_buf, sizeof(debug_buf) - debug_offset, "recycle list | ");
-	muggle_socket_event_memmgr_debug_print(mgr->recycle_head.next, debug_buf, debug_offset, sizeof(debug_buf));
+	muggle_socket_event_memmgr_debug_print(mgr);
 #endif
 }
 
 void muggle_socket_event_memmgr_clear(muggle_socket_event_memmgr_t *mgr)
 {
-	muggle_socket_peer_list_node_t *node = mgr->recycle_head.next;
-	while (node)
+	for (int i = mgr->cnt_recycle - 1; i >= 0; --i)
 	{
-		muggle_socket_peer_list_node_t *next_node = node->next;
-		if (node->peer.ref_cnt == 0)
+		muggle_socket_peer_slot_t *slot = &mgr->slots[mgr->recycle[i]];
+		if (muggle_atomic_load(&slot->peer.ref_cnt, muggle_memory_order_acquire) == 0)
 		{
-			muggle_socket_event_memmgr_free(mgr, node);
+			muggle_socket_event_memmgr_arr_remove(mgr, mgr->recycle, &mgr->cnt_recycle, slot);
+			muggle_socket_event_memmgr_release_slot(mgr, slot);
 #if MUGGLE_ENABLE_TRACE
 			MUGGLE_DEBUG_INFO("muggle socket event memmgr clear");
-
-			char debug_buf[4096];
-			int debug_offset = 0;
-			debug_offset = snprintf(debug_buf, sizeof(debug_buf) - debug_offset, "active list | ");
-			muggle_socket_event_memmgr_debug_print(mgr->active_head.next, debug_buf, debug_offset, sizeof(debug_buf));
-
-			debug_offset = 0;
-			debug_offset = snprintf(debug_buf, sizeof(debug_buf) - debug_offset, "recycle list | ");
-			muggle_socket_event_memmgr_debug_print(mgr->recycle_head.next, debug_buf, debug_offset, sizeof(debug_buf));
+			muggle_socket_event_memmgr_debug_print(mgr);
 #endif
 		}
-		node = next_node;
 	}
 }
 
 void muggle_socket_event_memmgr_destroy(muggle_socket_event_memmgr_t *mgr)
 {
-	muggle_socket_peer_list_node_t *node = mgr->active_head.next;
-	while (node)
+	if (mgr->slots && mgr->active && mgr->recycle && mgr->free_idx)
 	{
-		muggle_socket_peer_list_node_t *next_node = node->next;
-		muggle_socket_event_memmgr_recycle(mgr, node);
-		node = next_node;
-	}
+		while (mgr->cnt_active > 0)
+		{
+			muggle_socket_event_memmgr_recycle(mgr, muggle_socket_event_memmgr_active_at(mgr, mgr->cnt_active - 1));
+		}
 
-	int retry_cnt = 0;
-	node = mgr->recycle_head.next;
-	while (node)
-	{
-		muggle_socket_peer_list_node_t *next_node = node->next;
-		while (node->peer.ref_cnt != 0)
+		int retry_cnt = 0;
+		while (mgr->cnt_recycle > 0)
 		{
+			muggle_socket_event_memmgr_clear(mgr);
+			if (mgr->cnt_recycle == 0)
+			{
+				break;
+			}
+
 			retry_cnt++;
 			muggle_msleep(100);
 			if (retry_cnt > 100)
@@ -228,9 +367,14 @@ void muggle_socket_event_memmgr_destroy(muggle_socket_event_memmgr_t *mgr)
 				MUGGLE_LOG_WARNING("socket event memory manager destroy retry 100 times");
 			}
 		}
-		muggle_socket_event_memmgr_free(mgr, node);
-		node = next_node;
 	}
 
-	muggle_memory_pool_destroy(&mgr->peer_pool);
+	free(mgr->slots);
+	free(mgr->free_idx);
+	free(mgr->active);
+	free(mgr->recycle);
+#if !MUGGLE_PLATFORM_WINDOWS
+	free(mgr->fd_table);
+#endif
+	memset(mgr, 0, sizeof(muggle_socket_event_memmgr_t));
 }
@@ -6,116 +6,185 @@
  *  @copyright    Copyright 2021 Muggle Wei
  *  @license      MIT License
  *  @brief        mugglec socket event memory manager
+ *
+ * Peers live in a dense slab of slots addressed by index:
+ * - free slots are a stack of indices, allocate and free are O(1) and never
+ *   touch other slots
+ * - active and recycle slots are dense index arrays, a slot remembers its
+ *   position, so remove is O(1) swap with the last one
+ * - every slot has a generation number, increased each time the slot is
+ *   freed, a handle (generation, index) of a reused slot is detected stale
+ * - on posix, an fd indexed table maps socket fd to handle of its slot
  *****************************************************************************/
 
 #ifndef MUGGLE_C_NET_SOCKET_EVENT_MEMMGR_H_
 #define MUGGLE_C_NET_SOCKET_EVENT_MEMMGR_H_
 
 #include "muggle/c/net/socket_event.h"
-#include "muggle/c/memory/memory_pool.h"
+#include <stdint.h>
 
 EXTERN_C_BEGIN
 
+enum
+{
+	MUGGLE_SOCKET_PEER_SLOT_FREE = 0,
+	MUGGLE_SOCKET_PEER_SLOT_ACTIVE,
+	MUGGLE_SOCKET_PEER_SLOT_RECYCLE,
+};
+
+/**
+ * @brief handle of peer slot, generation in high 32 bits and index in low 32
+ * bits, 0 is invalid handle
+ */
+typedef uint64_t muggle_socket_peer_handle_t;
+
+#define MUGGLE_SOCKET_PEER_HANDLE(gen, idx) (((uint64_t)(gen) << 32) | (uint32_t)(idx))
+#define MUGGLE_SOCKET_PEER_HANDLE_GEN(handle) ((uint32_t)((handle) >> 32))
+#define MUGGLE_SOCKET_PEER_HANDLE_IDX(handle) ((uint32_t)(handle))
 
 /**
- * @brief socket peer node in memory manager's linked list
+ * @brief socket peer slot in memory manager's slab
  */
-typedef struct muggle_socket_peer_list_node
+typedef struct muggle_socket_peer_slot
 {
-	struct muggle_socket_peer_list_node *prev;
-	struct muggle_socket_peer_list_node *next;
-	muggle_socket_peer_t                peer;
-}muggle_socket_peer_list_node_t;
+	muggle_socket_peer_t peer;  // must be the first field
+	uint32_t             idx;   // index in slab
+	uint32_t             gen;   // generation, increased when slot freed
+	int                  state; // MUGGLE_SOCKET_PEER_SLOT_*
+	int                  pos;   // position in active or recycle array
+}muggle_socket_peer_slot_t;
 
 /**
  * @brief socket event memory manager
  */
 typedef struct muggle_socket_event_memmgr
 {
-	muggle_memory_pool_t           peer_pool;    // socket peer list node memory pool
-	muggle_socket_peer_list_node_t active_head;  // active peer node list head
-	muggle_socket_peer_list_node_t recycle_head; // recycle peer node list head
+	muggle_socket_peer_slot_t *slots;    // dense slab of peer slots
+	int                       capacity;  // number of slots
+	uint32_t                  *free_idx; // stack of free slot indices
+	int                       cnt_free;
+	uint32_t                  *active;   // indices of active slots
+	int                       cnt_active;
+	uint32_t                  *recycle;  // indices of closed slots still referenced by other threads
+	int                       cnt_recycle;
+#if !MUGGLE_PLATFORM_WINDOWS
+	muggle_socket_peer_handle_t *fd_table; // fd -> handle of slot
+	int                         fd_table_size;
+#endif
 }muggle_socket_event_memmgr_t;
 
 #if MUGGLE_ENABLE_TRACE
 
-void muggle_socket_event_memmgr_debug_print(
-	muggle_socket_peer_list_node_t *node,
-	char *buf, int offset, int bufsize);
+void muggle_socket_event_memmgr_debug_print(muggle_socket_event_memmgr_t *mgr);
 
 #endif
 
+/**
+ * @brief initialize socket event memory manager
+ *
+ * @param ev          socket event
+ * @param ev_init_arg socket event initialize arguments
+ * @param mgr         socket event memory manager pointer
+ *
+ * @return
+ *     - success return 0
+ *     - otherwise failed init
+ */
+int muggle_socket_event_memmgr_init(
+	muggle_socket_event_t *ev, muggle_socket_event_init_arg_t *ev_init_arg, muggle_socket_event_memmgr_t *mgr);
+
+/**
+ * @brief allocate socket peer slot and put it into active array
+ *
+ * @param mgr   socket event memory manager pointer
+ *
+ * @return allocated slot, NULL if no free slot
+ */
+muggle_socket_peer_slot_t* muggle_socket_event_memmgr_allocate(muggle_socket_event_memmgr_t *mgr);
 
 /**
- * @brief socket event memory manager insert node
+ * @brief map slot peer's fd to slot, invoke after fd of peer is set
  *
- * @param head  head of socket event memory manager's linked list
- * @param node  socket peer list node
+ * @param mgr   socket event memory manager pointer
+ * @param slot  active slot
+ *
+ * @return
+ *     - success return 0
+ *     - otherwise failed allocate fd table
  */
-void muggle_socket_event_memmgr_insert_node(muggle_socket_peer_list_node_t *head, muggle_socket_peer_list_node_t *node);
+int muggle_socket_event_memmgr_bind_fd(muggle_socket_event_memmgr_t *mgr, muggle_socket_peer_slot_t *slot);
 
 /**
- * @brief remove socket peer node from socket event memory manager's linked list
+ * @brief find active slot by socket fd
  *
- * @param node socket peer list node
+ * @param mgr  socket event memory manager pointer
+ * @param fd   socket fd
+ *
+ * @return slot of fd, NULL if not found
  */
-void muggle_socket_event_memmgr_remove_node(muggle_socket_peer_list_node_t *node);
+muggle_socket_peer_slot_t* muggle_socket_event_memmgr_find(muggle_socket_event_memmgr_t *mgr, muggle_socket_t fd);
 
 /**
- * 
+ * @brief get handle of slot
+ *
+ * @param slot  socket peer slot
  *
- * RETURN: 
+ * @return handle of slot
  */
+muggle_socket_peer_handle_t muggle_socket_event_memmgr_handle(muggle_socket_peer_slot_t *slot);
+
 /**
- * @brief initialize socket event memory manager
+ * @brief get slot by handle
  *
- * @param ev          socket event
- * @param ev_init_arg socket event initialize arguments
- * @param mgr         socket event memory manager pointer
+ * @param mgr     socket event memory manager pointer
+ * @param handle  handle of slot
  *
- * @return 
- *     - success return 0
- *     - otherwise failed init
+ * @return slot, NULL if slot already freed or reused
  */
-int muggle_socket_event_memmgr_init(
-	muggle_socket_event_t *ev, muggle_socket_event_init_arg_t *ev_init_arg, muggle_socket_event_memmgr_t *mgr);
+muggle_socket_peer_slot_t* muggle_socket_event_memmgr_resolve(
+	muggle_socket_event_memmgr_t *mgr, muggle_socket_peer_handle_t handle);
 
 /**
- * @brief allocate socket peer list node
+ * @brief get number of active slots
  *
  * @param mgr   socket event memory manager pointer
  *
- * @return allocated list node
+ * @return number of active slots
  */
-muggle_socket_peer_list_node_t* muggle_socket_event_memmgr_allocate(muggle_socket_event_memmgr_t *mgr);
+int muggle_socket_event_memmgr_active_count(muggle_socket_event_memmgr_t *mgr);
 
 /**
- * @brief get first active socket peer list node
+ * @brief get active slot by position
+ *
+ * NOTE: recycle or free slot move the last active slot to its position, so
+ * iterate from the last position if slots may be recycled during iteration
  *
  * @param mgr   socket event memory manager pointer
+ * @param pos   position in [0, active count)
  *
- * @return first node in socket event memory manager
+ * @return active slot
  */
-muggle_socket_peer_list_node_t* muggle_socket_event_memmgr_get_node(muggle_socket_event_memmgr_t *mgr);
+muggle_socket_peer_slot_t* muggle_socket_event_memmgr_active_at(muggle_socket_event_memmgr_t *mgr, int pos);
 
 /**
- * @brief free socket peer list node
+ * @brief free active slot directly, used when peer is never exposed to user
  *
  * @param mgr   socket event memory manager pointer
- * @param node  node need to be free
+ * @param slot  slot need to be free
  */
-void muggle_socket_event_memmgr_free(muggle_socket_event_memmgr_t *mgr, muggle_socket_peer_list_node_t *node);
+void muggle_socket_event_memmgr_free(muggle_socket_event_memmgr_t *mgr, muggle_socket_peer_slot_t *slot);
 
 /**
- * @brief recycle active socket peer list node
+ * @brief recycle active slot, release the reference of event loop, slot
+ * still referenced by other threads is freed in muggle_socket_event_memmgr_clear
  *
  * @param mgr   socket event memory manager pointer
- * @param node  node need to be recycle
+ * @param slot  slot need to be recycle
  */
-void muggle_socket_event_memmgr_recycle(muggle_socket_event_memmgr_t *mgr, muggle_socket_peer_list_node_t *node);
+void muggle_socket_event_memmgr_recycle(muggle_socket_event_memmgr_t *mgr, muggle_socket_peer_slot_t *slot);
 
 /**
- * @brief clear closed socket peer list node
+ * @brief free recycled slots that no longer referenced
  *
  * @param mgr   socket event memory manager pointer
  */
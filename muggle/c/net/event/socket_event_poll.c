@@ -20,7 +20,7 @@ static void muggle_socket_event_poll_listen(
 	muggle_socket_peer_t *listen_peer,
 	muggle_socket_event_memmgr_t *mem_mgr,
 	struct pollfd *fds,
-	muggle_socket_peer_list_node_t **p_nodes,
+	muggle_socket_peer_slot_t **p_slots,
 	int capacity, int *cnt_fd)
 {
 	while (1)
@@ -33,44 +33,38 @@ static void muggle_socket_event_poll_listen(
 		}
 
 		// get new peer
-		muggle_socket_peer_list_node_t *node = muggle_socket_event_memmgr_allocate(mem_mgr);
-		if (node == NULL)
+		muggle_socket_peer_slot_t *slot = muggle_socket_event_memmgr_allocate(mem_mgr);
+		if (slot == NULL)
 		{
 			muggle_socket_event_refuse_accept(listen_peer);
 			break;
 		}
 
 		// accept new connection
-		muggle_socket_event_accept(listen_peer, &node->peer);
-		if (node->peer.fd == MUGGLE_INVALID_SOCKET)
+		muggle_socket_event_accept(listen_peer, &slot->peer);
+		if (slot->peer.fd == MUGGLE_INVALID_SOCKET)
 		{
-			muggle_socket_event_memmgr_free(mem_mgr, node);
+			muggle_socket_event_memmgr_free(mem_mgr, slot);
 			break;
 		}
+		muggle_socket_event_memmgr_bind_fd(mem_mgr, slot);
 
-		// add new connection socket into nodes
-		p_nodes[*cnt_fd] = node;
+		// add new connection socket into slots
+		p_slots[*cnt_fd] = slot;
 		memset(&fds[*cnt_fd], 0, sizeof(struct pollfd));
-		fds[*cnt_fd].fd = node->peer.fd;
+		fds[*cnt_fd].fd = slot->peer.fd;
 		fds[*cnt_fd].events = POLLIN;
 		++(*cnt_fd);
 
 		// notify user
-		node->peer.ev = ev;
+		slot->peer.ev = ev;
 		if (ev->on_connect)
 		{
-			ev->on_connect(ev, listen_peer, &node->peer);
+			ev->on_connect(ev, listen_peer, &slot->peer);
 		}
 
 #if MUGGLE_ENABLE_TRACE
-		char debug_buf[4096];
-		int debug_offset = 0;
-		debug_offset = snprintf(debug_buf, sizeof(debug_buf) - debug_offset, "active list | ");
-		muggle_socket_event_memmgr_debug_print(mem_mgr->active_head.next, debug_buf, debug_offset, sizeof(debug_buf));
-
-		debug_offset = 0;
-		debug_offset = snprintf(debug_buf, sizeof(debug_buf) - debug_offset, "recycle list | ");
-		muggle_socket_event_memmgr_debug_print(mem_mgr->recycle_head.next, debug_buf, debug_offset, sizeof(debug_buf));
+		muggle_socket_event_memmgr_debug_print(mem_mgr);
 #endif
 	}
 }
@@ -83,18 +77,18 @@ void muggle_socket_event_poll(muggle_socket_event_t *ev)
 	muggle_socket_event_memmgr_t *p_mem_mgr = (muggle_socket_event_memmgr_t*)ev->mem_mgr;
 
 	struct pollfd *fds = (struct pollfd*)malloc(ev->capacity * sizeof(struct pollfd));
-	muggle_socket_peer_list_node_t **p_nodes =
-		(muggle_socket_peer_list_node_t**)malloc(ev->capacity * sizeof(muggle_socket_peer_list_node_t*));
-	if (fds == NULL || p_nodes == NULL)
+	muggle_socket_peer_slot_t **p_slots =
+		(muggle_socket_peer_slot_t**)malloc(ev->capacity * sizeof(muggle_socket_peer_slot_t*));
+	if (fds == NULL || p_slots == NULL)
 	{
 		if (fds)
 		{
 			free(fds);
 		}
 
-		if (p_nodes)
+		if (p_slots)
 		{
-			free(p_nodes);
+			free(p_slots);
 		}
 
 		muggle_socket_event_memmgr_destroy(p_mem_mgr);
@@ -103,20 +97,18 @@ void muggle_socket_event_poll(muggle_socket_event_t *ev)
 
 	for (int i = 0; i < ev->capacity; ++i)
 	{
-		p_nodes[i] = NULL;
+		p_slots[i] = NULL;
 		memset(&fds[i], 0, sizeof(struct pollfd));
 	}
 
 	int cnt_fd = 0;
-	muggle_socket_peer_list_node_t *node = muggle_socket_event_memmgr_get_node(p_mem_mgr);
-	while (node)
+	for (int i = 0; i < muggle_socket_event_memmgr_active_count(p_mem_mgr); ++i)
 	{
-		p_nodes[cnt_fd] = node;
-		fds[cnt_fd].fd = node->peer.fd;
+		muggle_socket_peer_slot_t *slot = muggle_socket_event_memmgr_active_at(p_mem_mgr, i);
+		p_slots[cnt_fd] = slot;
+		fds[cnt_fd].fd = slot->peer.fd;
 		fds[cnt_fd].events = POLLIN;
 		cnt_fd++;
-
-		node = node->next;
 	}
 
 	// set timeout
@@ -139,14 +131,14 @@ void muggle_socket_event_poll(muggle_socket_event_t *ev)
 		{
 			for (int i = cnt_fd - 1; i >= 0; --i)
 			{
-				muggle_socket_peer_t *peer = &p_nodes[i]->peer;
+				muggle_socket_peer_t *peer = &p_slots[i]->peer;
 				if (fds[i].revents & POLLIN)
 				{
 					switch (peer->peer_type)
 					{
 					case MUGGLE_SOCKET_PEER_TYPE_TCP_LISTEN:
 						{
-							muggle_socket_event_poll_listen(ev, peer, p_mem_mgr, fds, p_nodes, ev->capacity, &cnt_fd);
+							muggle_socket_event_poll_listen(ev, peer, p_mem_mgr, fds, p_slots, ev->capacity, &cnt_fd);
 						}break;
 					case MUGGLE_SOCKET_PEER_TYPE_TCP_PEER:
 					case MUGGLE_SOCKET_PEER_TYPE_UDP_PEER:
@@ -177,16 +169,16 @@ void muggle_socket_event_poll(muggle_socket_event_t *ev)
 
 					if (i != cnt_fd - 1)
 					{
-						muggle_socket_peer_list_node_t *p_tmp;
-						p_tmp = p_nodes[i];
-						p_nodes[i] = p_nodes[cnt_fd - 1];
-						p_nodes[cnt_fd - 1] = p_tmp;
+						muggle_socket_peer_slot_t *p_tmp;
+						p_tmp = p_slots[i];
+						p_slots[i] = p_slots[cnt_fd - 1];
+						p_slots[cnt_fd - 1] = p_tmp;
 
 						memcpy(&fds[i], &fds[cnt_fd - 1], sizeof(struct pollfd));
 					}
 
-					muggle_socket_event_memmgr_recycle(p_mem_mgr, p_nodes[cnt_fd - 1]);
-					p_nodes[cnt_fd - 1] = NULL;
+					muggle_socket_event_memmgr_recycle(p_mem_mgr, p_slots[cnt_fd - 1]);
+					p_slots[cnt_fd - 1] = NULL;
 
 					--cnt_fd;
 				}
@@ -229,11 +221,11 @@ void muggle_socket_event_poll(muggle_socket_event_t *ev)
 			break;
 		}
 
-		// recycle node
+		// free recycled slots no longer referenced
 		muggle_socket_event_memmgr_clear(p_mem_mgr);
 	}
 
 	// free memory
 	free(fds);
-	free(p_nodes);
+	free(p_slots);
 }
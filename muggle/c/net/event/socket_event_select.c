@@ -24,46 +24,40 @@ static void muggle_socket_event_select_listen(
 	while (1)
 	{
 		// get new peer
-		muggle_socket_peer_list_node_t *node = muggle_socket_event_memmgr_allocate(mem_mgr);
-		if (node == NULL)
+		muggle_socket_peer_slot_t *slot = muggle_socket_event_memmgr_allocate(mem_mgr);
+		if (slot == NULL)
 		{
 			muggle_socket_event_refuse_accept(listen_peer);
 			break;
 		}
 
 		// accept new connection
-		muggle_socket_event_accept(listen_peer, &node->peer);
-		if (node->peer.fd == MUGGLE_INVALID_SOCKET)
+		muggle_socket_event_accept(listen_peer, &slot->peer);
+		if (slot->peer.fd == MUGGLE_INVALID_SOCKET)
 		{
-			muggle_socket_event_memmgr_free(mem_mgr, node);
+			muggle_socket_event_memmgr_free(mem_mgr, slot);
 			break;
 		}
+		muggle_socket_event_memmgr_bind_fd(mem_mgr, slot);
 
 		// add new connection socket into read fds
-		FD_SET(node->peer.fd, allset);
+		FD_SET(slot->peer.fd, allset);
 #if !MUGGLE_PLATFORM_WINDOWS
-		if (node->peer.fd > *nfds)
+		if (slot->peer.fd > *nfds)
 		{
-			*nfds = node->peer.fd;
+			*nfds = slot->peer.fd;
 		}
 #endif
 
 		// notify user
-		node->peer.ev = ev;
+		slot->peer.ev = ev;
 		if (ev->on_connect)
 		{
-			ev->on_connect(ev, listen_peer, &node->peer);
+			ev->on_connect(ev, listen_peer, &slot->peer);
 		}
 
 #if MUGGLE_ENABLE_TRACE
-		char debug_buf[4096];
-		int debug_offset = 0;
-		debug_offset = snprintf(debug_buf, sizeof(debug_buf) - debug_offset, "active list | ");
-		muggle_socket_event_memmgr_debug_print(mem_mgr->active_head.next, debug_buf, debug_offset, sizeof(debug_buf));
-
-		debug_offset = 0;
-		debug_offset = snprintf(debug_buf, sizeof(debug_buf) - debug_offset, "recycle list | ");
-		muggle_socket_event_memmgr_debug_print(mem_mgr->recycle_head.next, debug_buf, debug_offset, sizeof(debug_buf));
+		muggle_socket_event_memmgr_debug_print(mem_mgr);
 #endif
 	}
 }
@@ -100,19 +94,16 @@ void muggle_socket_event_select(muggle_socket_event_t *ev)
 	int nfds = 0;
 	fd_set rset, allset;
 	FD_ZERO(&allset);
-	muggle_socket_peer_list_node_t *node = NULL;
-
-	node = muggle_socket_event_memmgr_get_node(p_mem_mgr);
-	while (node)
+	for (int i = 0; i < muggle_socket_event_memmgr_active_count(p_mem_mgr); ++i)
 	{
+		muggle_socket_peer_slot_t *slot = muggle_socket_event_memmgr_active_at(p_mem_mgr, i);
 #if !MUGGLE_PLATFORM_WINDOWS
-		if (node->peer.fd > nfds)
+		if (slot->peer.fd > nfds)
 		{
-			nfds = node->peer.fd;
+			nfds = slot->peer.fd;
 		}
 #endif
-		FD_SET(node->peer.fd, &allset);
-		node = node->next;
+		FD_SET(slot->peer.fd, &allset);
 	}
 
 	while (1)
@@ -128,54 +119,48 @@ void muggle_socket_event_select(muggle_socket_event_t *ev)
 		int n = select(nfds + 1, &rset, NULL, NULL, p_timeout);
 		if (n > 0)
 		{
-			node = muggle_socket_event_memmgr_get_node(p_mem_mgr);
-			while (node)
+			// iterate from the last, recycle move the last active slot to
+			// current position, and new accepted slots are appended
+			for (int i = muggle_socket_event_memmgr_active_count(p_mem_mgr) - 1; i >= 0; --i)
 			{
-				if (FD_ISSET(node->peer.fd, &rset))
+				muggle_socket_peer_slot_t *slot = muggle_socket_event_memmgr_active_at(p_mem_mgr, i);
+				if (!FD_ISSET(slot->peer.fd, &rset))
+				{
+					continue;
+				}
+
+				switch (slot->peer.peer_type)
 				{
-					switch (node->peer.peer_type)
+				case MUGGLE_SOCKET_PEER_TYPE_TCP_LISTEN:
 					{
-					case MUGGLE_SOCKET_PEER_TYPE_TCP_LISTEN:
-						{
-							muggle_socket_event_select_listen(ev, &node->peer, p_mem_mgr, &allset, &nfds);
-						}break;
-					case MUGGLE_SOCKET_PEER_TYPE_TCP_PEER:
-					case MUGGLE_SOCKET_PEER_TYPE_UDP_PEER:
-						{
-							muggle_socket_event_on_message(ev, &node->peer);
-						}break;
-					default:
-						{
-							MUGGLE_LOG_ERROR("invalid peer type: %d", node->peer.peer_type);
-						}break;
-					}
-					
-					if (node->peer.status == MUGGLE_SOCKET_PEER_STATUS_CLOSED)
+						muggle_socket_event_select_listen(ev, &slot->peer, p_mem_mgr, &allset, &nfds);
+					}break;
+				case MUGGLE_SOCKET_PEER_TYPE_TCP_PEER:
+				case MUGGLE_SOCKET_PEER_TYPE_UDP_PEER:
 					{
-						if (ev->on_error)
-						{
-							ev->on_error(ev, &node->peer);
-						}
-
-						FD_CLR(node->peer.fd, &allset);
-
-						muggle_socket_peer_list_node_t *next_node = node->next;
-						muggle_socket_event_memmgr_recycle(p_mem_mgr, node);
-						node = next_node;
-					}
-					else
+						muggle_socket_event_on_message(ev, &slot->peer);
+					}break;
+				default:
 					{
-						node = node->next;
-					}
+						MUGGLE_LOG_ERROR("invalid peer type: %d", slot->peer.peer_type);
+					}break;
+				}
 
-					if (--n <= 0)
+				if (slot->peer.status == MUGGLE_SOCKET_PEER_STATUS_CLOSED)
+				{
+					if (ev->on_error)
 					{
-						break;
+						ev->on_error(ev, &slot->peer);
 					}
+
+					FD_CLR(slot->peer.fd, &allset);
+
+					muggle_socket_event_memmgr_recycle(p_mem_mgr, slot);
 				}
-				else
+
+				if (--n <= 0)
 				{
-					node = node->next;
+					break;
 				}
 			}
 
@@ -211,7 +196,7 @@ void muggle_socket_event_select(muggle_socket_event_t *ev)
 			break;
 		}
 
-		// recycle node
+		// free recycled slots no longer referenced
 		muggle_socket_event_memmgr_clear(p_mem_mgr);
 	}
 }
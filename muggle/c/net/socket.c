@@ -116,3 +116,54 @@ int muggle_socket_recvfrom(muggle_socket_t fd, void *buf, size_t len, int flags,
 	return (int)recvfrom(fd, buf, len, flags, addr, addrlen);
 #endif
 }
+
+int muggle_socket_readv(muggle_socket_t fd, const muggle_iovec_t *iov, int iovcnt)
+{
+#if MUGGLE_PLATFORM_WINDOWS
+	WSABUF bufs[MUGGLE_IOV_MAX];
+	if (iovcnt > MUGGLE_IOV_MAX)
+	{
+		iovcnt = MUGGLE_IOV_MAX;
+	}
+	for (int i = 0; i < iovcnt; i++)
+	{
+		bufs[i].buf = (CHAR*)iov[i].iov_base;
+		bufs[i].len = (ULONG)iov[i].iov_len;
+	}
+
+	DWORD num_bytes = 0;
+	DWORD flags = 0;
+	if (WSARecv(fd, bufs, (DWORD)iovcnt, &num_bytes, &flags, NULL, NULL) != 0)
+	{
+		return MUGGLE_SOCKET_ERROR;
+	}
+	return (int)num_bytes;
+#else
+	return (int)readv(fd, iov, iovcnt);
+#endif
+}
+
+int muggle_socket_writev(muggle_socket_t fd, const muggle_iovec_t *iov, int iovcnt)
+{
+#if MUGGLE_PLATFORM_WINDOWS
+	WSABUF bufs[MUGGLE_IOV_MAX];
+	if (iovcnt > MUGGLE_IOV_MAX)
+	{
+		iovcnt = MUGGLE_IOV_MAX;
+	}
+	for (int i = 0; i < iovcnt; i++)
+	{
+		bufs[i].buf = (CHAR*)iov[i].iov_base;
+		bufs[i].len = (ULONG)iov[i].iov_len;
+	}
+
+	DWORD num_bytes = 0;
+	if (WSASend(fd, bufs, (DWORD)iovcnt, &num_bytes, 0, NULL, NULL) != 0)
+	{
+		return MUGGLE_SOCKET_ERROR;
+	}
+	return (int)num_bytes;
+#else
+	return (int)writev(fd, iov, iovcnt);
+#endif
+}
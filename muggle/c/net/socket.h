@@ -12,6 +12,7 @@
 #define MUGGLE_C_SOCKET_H_
 
 #include "muggle/c/base/macro.h"
+#include "muggle/c/base/iovec.h"
 
 EXTERN_C_BEGIN
 
@@ -212,6 +213,34 @@ MUGGLE_C_EXPORT
 int muggle_socket_recvfrom(muggle_socket_t fd, void *buf, size_t len, int flags,
 	struct sockaddr *addr, muggle_socklen_t *addrlen);
 
+/**
+ * @brief socket scatter receive, the same as unix readv
+ *
+ * @param fd       socket file descriptor
+ * @param iov      io vectors store receive bytes
+ * @param iovcnt   number of io vectors, at most MUGGLE_IOV_MAX
+ *
+ * @return
+ * return the number of bytes received, or -1 if an error occurred.
+ * if error occurred, MUGGLE_SOCKET_LAST_ERRNO is set.
+ */
+MUGGLE_C_EXPORT
+int muggle_socket_readv(muggle_socket_t fd, const muggle_iovec_t *iov, int iovcnt);
+
+/**
+ * @brief socket gather send, the same as unix writev
+ *
+ * @param fd       socket file descriptor
+ * @param iov      io vectors of bytes need to send
+ * @param iovcnt   number of io vectors, at most MUGGLE_IOV_MAX
+ *
+ * @return 
+ *     - on success, return the number of bytes sent
+ *     - on error, -1 is returned and MUGGLE_SOCKET_LAST_ERRNO is set
+ */
+MUGGLE_C_EXPORT
+int muggle_socket_writev(muggle_socket_t fd, const muggle_iovec_t *iov, int iovcnt);
+
 EXTERN_C_END
 
 #endif
@@ -225,3 +225,159 @@ int muggle_socket_peer_send(muggle_socket_peer_t *peer, const void *buf, size_t
 	}
 	return num_bytes;
 }
+
+int muggle_bytes_buffer_recv_from(muggle_bytes_buffer_t *bytes_buf, muggle_socket_peer_t *peer)
+{
+	muggle_iovec_t iov[2];
+	int iovcnt = muggle_bytes_buffer_writable_iov(bytes_buf, iov);
+	if (iovcnt == 0)
+	{
+		return 0;
+	}
+
+	int n = 0;
+	while (1)
+	{
+		n = muggle_socket_readv(peer->fd, iov, iovcnt);
+		if (n > 0)
+		{
+			muggle_bytes_buffer_writer_move_iov(bytes_buf, n);
+			break;
+		}
+		else
+		{
+			if (n < 0)
+			{
+				if (MUGGLE_SOCKET_LAST_ERRNO == MUGGLE_SYS_ERRNO_INTR)
+				{
+					continue;
+				}
+				else if (MUGGLE_SOCKET_LAST_ERRNO == MUGGLE_SYS_ERRNO_WOULDBLOCK)
+				{
+					break;
+				}
+			}
+
+			muggle_socket_peer_close(peer);
+			break;
+		}
+	}
+
+	return n;
+}
+
+int muggle_bytes_buffer_send_to(muggle_bytes_buffer_t *bytes_buf, muggle_socket_peer_t *peer)
+{
+	muggle_iovec_t iov[2];
+	int iovcnt = muggle_bytes_buffer_readable_iov(bytes_buf, iov);
+	if (iovcnt == 0)
+	{
+		return 0;
+	}
+
+	int n = 0;
+	while (1)
+	{
+		n = muggle_socket_writev(peer->fd, iov, iovcnt);
+		if (n >= 0)
+		{
+			muggle_bytes_buffer_reader_move_iov(bytes_buf, n);
+			break;
+		}
+
+		int last_errno = MUGGLE_SOCKET_LAST_ERRNO;
+		if (last_errno == MUGGLE_SYS_ERRNO_INTR)
+		{
+			continue;
+		}
+		else if (last_errno != MUGGLE_SYS_ERRNO_WOULDBLOCK)
+		{
+			char err_msg[1024] = { 0 };
+			muggle_socket_strerror(last_errno, err_msg, sizeof(err_msg));
+			MUGGLE_LOG_TRACE("failed send msg - %s", err_msg);
+
+			muggle_socket_peer_close(peer);
+		}
+		break;
+	}
+
+	return n;
+}
+
+int muggle_chain_buffer_recv_from(muggle_chain_buffer_t *buf, muggle_socket_peer_t *peer, int len)
+{
+	muggle_iovec_t iov[MUGGLE_IOV_MAX];
+	int iovcnt = muggle_chain_buffer_reserve_iov(buf, len, iov, MUGGLE_IOV_MAX);
+	if (iovcnt == 0)
+	{
+		return 0;
+	}
+
+	int n = 0;
+	while (1)
+	{
+		n = muggle_socket_readv(peer->fd, iov, iovcnt);
+		if (n > 0)
+		{
+			muggle_chain_buffer_commit(buf, n);
+			break;
+		}
+		else
+		{
+			if (n < 0)
+			{
+				if (MUGGLE_SOCKET_LAST_ERRNO == MUGGLE_SYS_ERRNO_INTR)
+				{
+					continue;
+				}
+				else if (MUGGLE_SOCKET_LAST_ERRNO == MUGGLE_SYS_ERRNO_WOULDBLOCK)
+				{
+					break;
+				}
+			}
+
+			muggle_socket_peer_close(peer);
+			break;
+		}
+	}
+
+	return n;
+}
+
+int muggle_chain_buffer_send_to(muggle_chain_buffer_t *buf, muggle_socket_peer_t *peer)
+{
+	muggle_iovec_t iov[MUGGLE_IOV_MAX];
+	int iovcnt = muggle_chain_buffer_read_iov(buf, iov, MUGGLE_IOV_MAX);
+	if (iovcnt == 0)
+	{
+		return 0;
+	}
+
+	int n = 0;
+	while (1)
+	{
+		n = muggle_socket_writev(peer->fd, iov, iovcnt);
+		if (n >= 0)
+		{
+			muggle_chain_buffer_consume(buf, n);
+			break;
+		}
+
+		int last_errno = MUGGLE_SOCKET_LAST_ERRNO;
+		if (last_errno == MUGGLE_SYS_ERRNO_INTR)
+		{
+			continue;
+		}
+		else if (last_errno != MUGGLE_SYS_ERRNO_WOULDBLOCK)
+		{
+			char err_msg[1024] = { 0 };
+			muggle_socket_strerror(last_errno, err_msg, sizeof(err_msg));
+			MUGGLE_LOG_TRACE("failed send msg - %s", err_msg);
+
+			muggle_socket_peer_close(peer);
+		}
+		break;
+	}
+
+	return n;
+}
@@ -13,6 +13,8 @@
 
 #include "muggle/c/net/socket.h"
 #include "muggle/c/base/atomic.h"
+#include "muggle/c/memory/bytes_buffer.h"
+#include "muggle/c/memory/chain_buffer.h"
 
 EXTERN_C_BEGIN
 
@@ -161,6 +163,74 @@ int muggle_socket_peer_sendto(muggle_socket_peer_t *peer, const void *buf, size_
 MUGGLE_C_EXPORT
 int muggle_socket_peer_send(muggle_socket_peer_t *peer, const void *buf, size_t len, int flags);
 
+/**
+ * @brief receive bytes from socket peer into bytes buffer directly
+ *
+ * both spans of writable memory are filled in one readv, so no
+ * intermediate buffer and copy is needed
+ *
+ * @param bytes_buf  pointer to bytes buffer
+ * @param peer       socket peer pointer
+ *
+ * @return 
+ *     - return the number of bytes received
+ *     - return 0 when bytes buffer is full, or when peer closed, check peer status to distinguish
+ *     - return -1 when error occurred, if error is not would block, peer is closed
+ */
+MUGGLE_C_EXPORT
+int muggle_bytes_buffer_recv_from(muggle_bytes_buffer_t *bytes_buf, muggle_socket_peer_t *peer);
+
+/**
+ * @brief send readable bytes of bytes buffer to socket peer directly
+ *
+ * both spans of readable bytes are sent in one writev, bytes sent are
+ * consumed, the rest stay in bytes buffer when socket send buffer is full
+ *
+ * @param bytes_buf  pointer to bytes buffer
+ * @param peer       socket peer pointer
+ *
+ * @return 
+ *     - return the number of bytes sent
+ *     - return -1 when error occurred, if error is not would block, peer is closed
+ */
+MUGGLE_C_EXPORT
+int muggle_bytes_buffer_send_to(muggle_bytes_buffer_t *bytes_buf, muggle_socket_peer_t *peer);
+
+/**
+ * @brief receive bytes from socket peer into chain buffer directly
+ *
+ * writable space of tail blocks is reserved and filled in one readv, then
+ * bytes received are committed
+ *
+ * @param buf   pointer to chain buffer
+ * @param peer  socket peer pointer
+ * @param len   number of bytes at least reserved for receive
+ *
+ * @return 
+ *     - return the number of bytes received
+ *     - return 0 when failed reserve space, or when peer closed, check peer status to distinguish
+ *     - return -1 when error occurred, if error is not would block, peer is closed
+ */
+MUGGLE_C_EXPORT
+int muggle_chain_buffer_recv_from(muggle_chain_buffer_t *buf, muggle_socket_peer_t *peer, int len);
+
+/**
+ * @brief send readable bytes of chain buffer to socket peer directly
+ *
+ * segments are sent in one writev (at most MUGGLE_IOV_MAX segments), bytes
+ * sent are consumed, the rest stay in chain buffer when socket send buffer
+ * is full
+ *
+ * @param buf   pointer to chain buffer
+ * @param peer  socket peer pointer
+ *
+ * @return 
+ *     - return the number of bytes sent
+ *     - return -1 when error occurred, if error is not would block, peer is closed
+ */
+MUGGLE_C_EXPORT
+int muggle_chain_buffer_send_to(muggle_chain_buffer_t *buf, muggle_socket_peer_t *peer);
+
 EXTERN_C_END
 
 #endif
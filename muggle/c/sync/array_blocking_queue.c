@@ -13,6 +13,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include "muggle/c/base/err.h"
+#include "muggle/c/base/utils.h"
+#include "muggle/c/base/thread.h"
+#include "muggle/c/sync/futex.h"
+#include "muggle/c/time/deadline.h"
 
 static void muggle_array_blocking_queue_enqueue(muggle_array_blocking_queue_t *queue, void *data)
 {
@@ -37,7 +41,187 @@ static void* muggle_array_blocking_queue_dequeue(muggle_array_blocking_queue_t *
 	return data;
 }
 
+/***************** lockfree *****************/
+// try claim a slot and put data, return 0 when queue is full
+static int muggle_array_blocking_queue_lockfree_try_enqueue(muggle_array_blocking_queue_t *queue, void *data)
+{
+	muggle_array_blocking_queue_slot_t *slot = NULL;
+	muggle_atomic_int pos = muggle_atomic_load(&queue->enqueue_pos, muggle_memory_order_relaxed);
+	while (1)
+	{
+		slot = &queue->slots[IDX_IN_POW_OF_2_RING(pos, queue->capacity)];
+		muggle_atomic_int seq = muggle_atomic_load(&slot->seq, muggle_memory_order_acquire);
+		muggle_atomic_int diff = seq - pos;
+		if (diff == 0)
+		{
+			if (muggle_atomic_cmp_exch_weak(&queue->enqueue_pos, &pos, pos + 1, muggle_memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (diff < 0)
+		{
+			return 0;
+		}
+		else
+		{
+			pos = muggle_atomic_load(&queue->enqueue_pos, muggle_memory_order_relaxed);
+		}
+	}
+
+	slot->data = data;
+	muggle_atomic_store(&slot->seq, pos + 1, muggle_memory_order_release);
+
+	return 1;
+}
+
+// try claim a slot and take data, return 0 when queue is empty
+static int muggle_array_blocking_queue_lockfree_try_dequeue(muggle_array_blocking_queue_t *queue, void **data)
+{
+	muggle_array_blocking_queue_slot_t *slot = NULL;
+	muggle_atomic_int pos = muggle_atomic_load(&queue->dequeue_pos, muggle_memory_order_relaxed);
+	while (1)
+	{
+		slot = &queue->slots[IDX_IN_POW_OF_2_RING(pos, queue->capacity)];
+		muggle_atomic_int seq = muggle_atomic_load(&slot->seq, muggle_memory_order_acquire);
+		muggle_atomic_int diff = seq - (pos + 1);
+		if (diff == 0)
+		{
+			if (muggle_atomic_cmp_exch_weak(&queue->dequeue_pos, &pos, pos + 1, muggle_memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (diff < 0)
+		{
+			return 0;
+		}
+		else
+		{
+			pos = muggle_atomic_load(&queue->dequeue_pos, muggle_memory_order_relaxed);
+		}
+	}
+
+	*data = slot->data;
+	muggle_atomic_store(&slot->seq, pos + queue->capacity, muggle_memory_order_release);
+
+	return 1;
+}
+
+// register as waiter, recheck futex value and wait
+static void muggle_array_blocking_queue_lockfree_park(
+	muggle_atomic_int *futex_addr, muggle_atomic_int val,
+	muggle_atomic_int *waiters, const struct timespec *timeout)
+{
+	muggle_atomic_fetch_add(waiters, 1, muggle_memory_order_seq_cst);
+	if (muggle_atomic_load(futex_addr, muggle_memory_order_seq_cst) == val)
+	{
+		muggle_futex_wait(futex_addr, val, timeout);
+	}
+	muggle_atomic_fetch_sub(waiters, 1, muggle_memory_order_relaxed);
+}
+
+// only issue futex wake when some thread already parked
+static void muggle_array_blocking_queue_lockfree_wake(muggle_atomic_int *futex_addr, muggle_atomic_int *waiters)
+{
+	// pair with waiters increase in muggle_array_blocking_queue_lockfree_park
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	if (muggle_atomic_load(waiters, muggle_memory_order_relaxed) > 0)
+	{
+		muggle_futex_wake_one(futex_addr);
+	}
+}
+
+// when wait is 0, only try once; when deadline is NULL, wait until success
+static int muggle_array_blocking_queue_lockfree_put(
+	muggle_array_blocking_queue_t *queue, void *data, int wait, const struct timespec *deadline)
+{
+	struct timespec remain;
+	const struct timespec *timeout = NULL;
+	while (1)
+	{
+		if (muggle_array_blocking_queue_lockfree_try_enqueue(queue, data))
+		{
+			muggle_array_blocking_queue_lockfree_wake(&queue->enqueue_pos, &queue->take_waiters);
+			return MUGGLE_OK;
+		}
+
+		if (!wait)
+		{
+			return MUGGLE_ERR_FULL;
+		}
+
+		if (deadline)
+		{
+			if (!muggle_deadline_remaining(deadline, &remain))
+			{
+				return MUGGLE_ERR_TIMEOUT;
+			}
+			timeout = &remain;
+		}
+
+		// park only when no taker in the middle of dequeue, so any take
+		// change dequeue_pos after this point
+		muggle_atomic_int d_pos = muggle_atomic_load(&queue->dequeue_pos, muggle_memory_order_acquire);
+		muggle_atomic_int e_pos = muggle_atomic_load(&queue->enqueue_pos, muggle_memory_order_relaxed);
+		if (e_pos - d_pos < queue->capacity)
+		{
+			muggle_thread_yield();
+			continue;
+		}
+
+		muggle_array_blocking_queue_lockfree_park(&queue->dequeue_pos, d_pos, &queue->put_waiters, timeout);
+	}
+}
+
+// when wait is 0, only try once; when deadline is NULL, wait until success
+static int muggle_array_blocking_queue_lockfree_take(
+	muggle_array_blocking_queue_t *queue, void **data, int wait, const struct timespec *deadline)
+{
+	struct timespec remain;
+	const struct timespec *timeout = NULL;
+	while (1)
+	{
+		if (muggle_array_blocking_queue_lockfree_try_dequeue(queue, data))
+		{
+			muggle_array_blocking_queue_lockfree_wake(&queue->dequeue_pos, &queue->put_waiters);
+			return MUGGLE_OK;
+		}
+
+		if (!wait)
+		{
+			return MUGGLE_ERR_EMPTY;
+		}
+
+		if (deadline)
+		{
+			if (!muggle_deadline_remaining(deadline, &remain))
+			{
+				return MUGGLE_ERR_TIMEOUT;
+			}
+			timeout = &remain;
+		}
+
+		// park only when no putter in the middle of enqueue, so any put
+		// change enqueue_pos after this point
+		muggle_atomic_int e_pos = muggle_atomic_load(&queue->enqueue_pos, muggle_memory_order_acquire);
+		muggle_atomic_int d_pos = muggle_atomic_load(&queue->dequeue_pos, muggle_memory_order_relaxed);
+		if (e_pos != d_pos)
+		{
+			muggle_thread_yield();
+			continue;
+		}
+
+		muggle_array_blocking_queue_lockfree_park(&queue->enqueue_pos, e_pos, &queue->take_waiters, timeout);
+	}
+}
+
 int muggle_array_blocking_queue_init(muggle_array_blocking_queue_t *queue, int capacity)
+{
+	return muggle_array_blocking_queue_init_ex(queue, capacity, MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_LOCK);
+}
+
+int muggle_array_blocking_queue_init_ex(muggle_array_blocking_queue_t *queue, int capacity, int flags)
 {
 	memset(queue, 0, sizeof(muggle_array_blocking_queue_t));
 
@@ -45,6 +229,35 @@ int muggle_array_blocking_queue_init(muggle_array_blocking_queue_t *queue, int c
 	{
 		return MUGGLE_ERR_INVALID_PARAM;
 	}
+	queue->flags = flags;
+
+	if (flags & MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_LOCKFREE)
+	{
+		capacity = (int)next_pow_of_2((uint64_t)capacity);
+		if (capacity <= 0)
+		{
+			return MUGGLE_ERR_INVALID_PARAM;
+		}
+		queue->capacity = capacity;
+		queue->slots = (muggle_array_blocking_queue_slot_t*)malloc(
+			sizeof(muggle_array_blocking_queue_slot_t) * capacity);
+		if (queue->slots == NULL)
+		{
+			return MUGGLE_ERR_MEM_ALLOC;
+		}
+		for (int i = 0; i < capacity; i++)
+		{
+			queue->slots[i].seq = i;
+			queue->slots[i].data = NULL;
+		}
+		queue->enqueue_pos = 0;
+		queue->dequeue_pos = 0;
+		queue->take_waiters = 0;
+		queue->put_waiters = 0;
+
+		return MUGGLE_OK;
+	}
+
 	queue->capacity = capacity;
 	queue->datas = (void**)malloc(sizeof(void*) * capacity);
 	if (queue->datas == NULL)
@@ -80,6 +293,13 @@ int muggle_array_blocking_queue_init(muggle_array_blocking_queue_t *queue, int c
 
 int muggle_array_blocking_queue_destroy(muggle_array_blocking_queue_t *queue)
 {
+	if (queue->flags & MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_LOCKFREE)
+	{
+		free(queue->slots);
+		queue->slots = NULL;
+		return MUGGLE_OK;
+	}
+
 	free(queue->datas);
 	muggle_mutex_destroy(&queue->mutex);
 	muggle_condition_variable_destroy(&queue->cv_not_full);
@@ -89,6 +309,11 @@ int muggle_array_blocking_queue_destroy(muggle_array_blocking_queue_t *queue)
 
 int muggle_array_blocking_queue_put(muggle_array_blocking_queue_t *queue, void *data)
 {
+	if (queue->flags & MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_LOCKFREE)
+	{
+		return muggle_array_blocking_queue_lockfree_put(queue, data, 1, NULL);
+	}
+
 	int ret = 0;
 	ret = muggle_mutex_lock(&queue->mutex);
 	if (ret != MUGGLE_OK)
@@ -109,6 +334,13 @@ int muggle_array_blocking_queue_put(muggle_array_blocking_queue_t *queue, void *
 
 void* muggle_array_blocking_queue_take(muggle_array_blocking_queue_t *queue)
 {
+	if (queue->flags & MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_LOCKFREE)
+	{
+		void *data = NULL;
+		muggle_array_blocking_queue_lockfree_take(queue, &data, 1, NULL);
+		return data;
+	}
+
 	int ret = 0;
 	ret = muggle_mutex_lock(&queue->mutex);
 	if (ret != MUGGLE_OK)
@@ -126,3 +358,118 @@ void* muggle_array_blocking_queue_take(muggle_array_blocking_queue_t *queue)
 
 	return data;
 }
+
+int muggle_array_blocking_queue_try_put(muggle_array_blocking_queue_t *queue, void *data)
+{
+	if (queue->flags & MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_LOCKFREE)
+	{
+		return muggle_array_blocking_queue_lockfree_put(queue, data, 0, NULL);
+	}
+
+	int ret = 0;
+	ret = muggle_mutex_lock(&queue->mutex);
+	if (ret != MUGGLE_OK)
+	{
+		return ret;
+	}
+
+	if (queue->cnt == queue->capacity)
+	{
+		muggle_mutex_unlock(&queue->mutex);
+		return MUGGLE_ERR_FULL;
+	}
+	muggle_array_blocking_queue_enqueue(queue, data);
+
+	muggle_mutex_unlock(&queue->mutex);
+
+	return MUGGLE_OK;
+}
+
+int muggle_array_blocking_queue_put_timed(
+	muggle_array_blocking_queue_t *queue, void *data, const struct timespec *deadline)
+{
+	if (queue->flags & MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_LOCKFREE)
+	{
+		return muggle_array_blocking_queue_lockfree_put(queue, data, 1, deadline);
+	}
+
+	int ret = 0;
+	ret = muggle_mutex_lock(&queue->mutex);
+	if (ret != MUGGLE_OK)
+	{
+		return ret;
+	}
+
+	while (queue->cnt == queue->capacity)
+	{
+		ret = muggle_condition_variable_wait_until(&queue->cv_not_full, &queue->mutex, deadline);
+		if (ret != MUGGLE_OK && queue->cnt == queue->capacity)
+		{
+			muggle_mutex_unlock(&queue->mutex);
+			return ret;
+		}
+	}
+	muggle_array_blocking_queue_enqueue(queue, data);
+
+	muggle_mutex_unlock(&queue->mutex);
+
+	return MUGGLE_OK;
+}
+
+int muggle_array_blocking_queue_try_take(muggle_array_blocking_queue_t *queue, void **data)
+{
+	if (queue->flags & MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_LOCKFREE)
+	{
+		return muggle_array_blocking_queue_lockfree_take(queue, data, 0, NULL);
+	}
+
+	int ret = 0;
+	ret = muggle_mutex_lock(&queue->mutex);
+	if (ret != MUGGLE_OK)
+	{
+		return ret;
+	}
+
+	if (queue->cnt == 0)
+	{
+		muggle_mutex_unlock(&queue->mutex);
+		return MUGGLE_ERR_EMPTY;
+	}
+	*data = muggle_array_blocking_queue_dequeue(queue);
+
+	muggle_mutex_unlock(&queue->mutex);
+
+	return MUGGLE_OK;
+}
+
+int muggle_array_blocking_queue_take_timed(
+	muggle_array_blocking_queue_t *queue, const struct timespec *deadline, void **data)
+{
+	if (queue->flags & MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_LOCKFREE)
+	{
+		return muggle_array_blocking_queue_lockfree_take(queue, data, 1, deadline);
+	}
+
+	int ret = 0;
+	ret = muggle_mutex_lock(&queue->mutex);
+	if (ret != MUGGLE_OK)
+	{
+		return ret;
+	}
+
+	while (queue->cnt == 0)
+	{
+		// data arrived together with timeout still count as success
+		ret = muggle_condition_variable_wait_until(&queue->cv_not_empty, &queue->mutex, deadline);
+		if (ret != MUGGLE_OK && queue->cnt == 0)
+		{
+			muggle_mutex_unlock(&queue->mutex);
+			return ret;
+		}
+	}
+	*data = muggle_array_blocking_queue_dequeue(queue);
+
+	muggle_mutex_unlock(&queue->mutex);
+
+	return MUGGLE_OK;
+}
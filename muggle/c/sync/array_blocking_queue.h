@@ -12,11 +12,28 @@
 #define MUGGLE_C_ARRAY_BLOCKING_QUEUE_H_
 
 #include "muggle/c/base/macro.h"
+#include "muggle/c/base/atomic.h"
 #include "muggle/c/sync/mutex.h"
 #include "muggle/c/sync/condition_variable.h"
 
 EXTERN_C_BEGIN
 
+enum
+{
+	MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_LOCK     = 0x00, //!< default, put and take serialized by mutex
+	MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_LOCKFREE = 0x01, //!< bounded MPMC with per slot sequence, futex wait only when full or empty
+};
+
+/**
+ * @brief array blocking queue slot, only use in MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_LOCKFREE
+ */
+typedef struct muggle_array_blocking_queue_slot
+{
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	muggle_atomic_int seq;
+	void *data;
+}muggle_array_blocking_queue_slot_t;
+
 /**
  * @brief array blocking queue
  */
@@ -30,6 +47,19 @@ typedef struct muggle_array_blocking_queue_tag
 	muggle_mutex_t mutex;
 	muggle_condition_variable_t cv_not_empty;
 	muggle_condition_variable_t cv_not_full;
+
+	// lockfree mode
+	int flags;
+	muggle_array_blocking_queue_slot_t *slots;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	muggle_atomic_int enqueue_pos;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
+	muggle_atomic_int dequeue_pos;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(2);
+	muggle_atomic_int take_waiters; //!< number of parked takers
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(3);
+	muggle_atomic_int put_waiters;  //!< number of parked putters
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(4);
 }muggle_array_blocking_queue_t;
 
 /**
@@ -45,6 +75,23 @@ typedef struct muggle_array_blocking_queue_tag
 MUGGLE_C_EXPORT
 int muggle_array_blocking_queue_init(muggle_array_blocking_queue_t *queue, int capacity);
 
+/**
+ * @brief initialize array blocking queue with flags
+ *
+ * in MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_LOCKFREE mode, capacity is round up to
+ * power of 2
+ *
+ * @param queue     array blocking queue pointer
+ * @param capacity  initialize capacity for queue
+ * @param flags     bitwise or of MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_*
+ *
+ * @return 
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_array_blocking_queue_init_ex(muggle_array_blocking_queue_t *queue, int capacity, int flags);
+
 /**
  * @brief destroy array blocking queue
  *
@@ -82,6 +129,66 @@ int muggle_array_blocking_queue_put(muggle_array_blocking_queue_t *queue, void *
 MUGGLE_C_EXPORT
 void* muggle_array_blocking_queue_take(muggle_array_blocking_queue_t *queue);
 
+/**
+ * @brief put data into queue without wait
+ *
+ * @param queue   array blocking queue pointer
+ * @param data    data pointer
+ *
+ * @return
+ *     - return 0 on success
+ *     - return MUGGLE_ERR_FULL when queue is full
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_array_blocking_queue_try_put(muggle_array_blocking_queue_t *queue, void *data);
+
+/**
+ * @brief put data into queue, wait until deadline when queue is full
+ *
+ * @param queue     array blocking queue pointer
+ * @param data      data pointer
+ * @param deadline  absolute deadline, see muggle/c/time/deadline.h
+ *
+ * @return
+ *     - return 0 on success
+ *     - return MUGGLE_ERR_TIMEOUT when deadline is reached
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_array_blocking_queue_put_timed(
+	muggle_array_blocking_queue_t *queue, void *data, const struct timespec *deadline);
+
+/**
+ * @brief take data from queue without wait
+ *
+ * @param queue   array blocking queue pointer
+ * @param data    output data pointer
+ *
+ * @return
+ *     - return 0 on success
+ *     - return MUGGLE_ERR_EMPTY when queue is empty
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_array_blocking_queue_try_take(muggle_array_blocking_queue_t *queue, void **data);
+
+/**
+ * @brief take data from queue, wait until deadline when queue is empty
+ *
+ * @param queue     array blocking queue pointer
+ * @param deadline  absolute deadline, see muggle/c/time/deadline.h
+ * @param data      output data pointer
+ *
+ * @return
+ *     - return 0 on success
+ *     - return MUGGLE_ERR_TIMEOUT when deadline is reached
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_array_blocking_queue_take_timed(
+	muggle_array_blocking_queue_t *queue, const struct timespec *deadline, void **data);
+
 EXTERN_C_END
 
 #endif
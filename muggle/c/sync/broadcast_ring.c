@@ -0,0 +1,402 @@
+/******************************************************************************
+ *  @file         broadcast_ring.c
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec bounded broadcast ring
+ *****************************************************************************/
+
+#include "broadcast_ring.h"
+#include <stdlib.h>
+#include <string.h>
+#include "muggle/c/base/err.h"
+#include "muggle/c/base/utils.h"
+#include "muggle/c/base/thread.h"
+#include "muggle/c/sync/futex.h"
+
+int muggle_broadcast_ring_init(
+	muggle_broadcast_ring_t *ring, muggle_atomic_int capacity,
+	int max_reader, int policy, int flags)
+{
+	memset(ring, 0, sizeof(muggle_broadcast_ring_t));
+
+	if (capacity <= 0 || max_reader <= 0 ||
+		policy < 0 || policy >= MUGGLE_BROADCAST_RING_POLICY_MAX)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	capacity = (muggle_atomic_int)next_pow_of_2((uint64_t)capacity);
+	if (capacity <= 0)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	ring->capacity = capacity;
+	ring->flags = flags;
+	ring->policy = policy;
+	ring->max_reader = max_reader;
+	ring->spin_cnt = MUGGLE_ADAPTIVE_WAIT_SPIN_CNT;
+	ring->yield_cnt = MUGGLE_ADAPTIVE_WAIT_YIELD_CNT;
+	ring->next = 0;
+	ring->gate = 0;
+	ring->cursor = 0;
+	ring->read_waiters = 0;
+	ring->evict_cnt = 0;
+	ring->block_cnt = 0;
+
+	ring->datas = (void**)malloc(sizeof(void*) * capacity);
+	if (ring->datas == NULL)
+	{
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+
+	ring->readers = (muggle_broadcast_ring_reader_t*)malloc(
+		sizeof(muggle_broadcast_ring_reader_t) * max_reader);
+	if (ring->readers == NULL)
+	{
+		free(ring->datas);
+		ring->datas = NULL;
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+	memset(ring->readers, 0, sizeof(muggle_broadcast_ring_reader_t) * max_reader);
+
+	return MUGGLE_OK;
+}
+
+void muggle_broadcast_ring_destroy(muggle_broadcast_ring_t *ring)
+{
+	if (ring->readers)
+	{
+		free(ring->readers);
+		ring->readers = NULL;
+	}
+
+	if (ring->datas)
+	{
+		free(ring->datas);
+		ring->datas = NULL;
+	}
+}
+
+// slowest reader moved, wake writers parked in muggle_broadcast_ring_gate
+static void muggle_broadcast_ring_wake_writers(muggle_broadcast_ring_t *ring)
+{
+	if (ring->policy != MUGGLE_BROADCAST_RING_POLICY_BLOCK)
+	{
+		return;
+	}
+
+	// pair with write_waiters increase in muggle_broadcast_ring_gate
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	if (muggle_atomic_load(&ring->write_waiters, muggle_memory_order_relaxed) > 0)
+	{
+		muggle_atomic_fetch_add(&ring->read_seq, 1, muggle_memory_order_relaxed);
+		muggle_futex_wake_all(&ring->read_seq);
+	}
+}
+
+int muggle_broadcast_ring_add_reader(muggle_broadcast_ring_t *ring)
+{
+	for (int i = 0; i < ring->max_reader; i++)
+	{
+		muggle_broadcast_ring_reader_t *reader = &ring->readers[i];
+		muggle_atomic_int status = MUGGLE_BROADCAST_RING_READER_UNUSED;
+		if (!muggle_atomic_cmp_exch_strong(&reader->status, &status,
+				MUGGLE_BROADCAST_RING_READER_REGISTERING, muggle_memory_order_acq_rel))
+		{
+			continue;
+		}
+
+		muggle_atomic_store64(&reader->overrun, 0, muggle_memory_order_relaxed);
+		muggle_atomic_store(&reader->cursor,
+			muggle_atomic_load(&ring->next, muggle_memory_order_acquire),
+			muggle_memory_order_relaxed);
+		muggle_atomic_store(&reader->status,
+			MUGGLE_BROADCAST_RING_READER_ACTIVE, muggle_memory_order_seq_cst);
+
+		// a writer's scan either see this reader, or it claimed index before
+		// the reload (pair with fence in muggle_broadcast_ring_gate). Every
+		// cached gate is not beyond the reloaded next, start from it, so
+		// writers skip scan can't overwrite message this reader need
+		muggle_atomic_store(&reader->cursor,
+			muggle_atomic_load(&ring->next, muggle_memory_order_seq_cst),
+			muggle_memory_order_seq_cst);
+
+		return i;
+	}
+
+	return -1;
+}
+
+void muggle_broadcast_ring_remove_reader(muggle_broadcast_ring_t *ring, int reader_id)
+{
+	if (reader_id < 0 || reader_id >= ring->max_reader)
+	{
+		return;
+	}
+
+	muggle_atomic_store(&ring->readers[reader_id].status,
+		MUGGLE_BROADCAST_RING_READER_UNUSED, muggle_memory_order_release);
+	muggle_broadcast_ring_wake_writers(ring);
+}
+
+// return cursor of slowest active reader, when evict is true, evict all
+// readers that lag a whole ring before seq
+static muggle_atomic_int muggle_broadcast_ring_min_cursor(
+	muggle_broadcast_ring_t *ring, muggle_atomic_int seq, int evict)
+{
+	muggle_atomic_int max_lag = 0;
+	for (int i = 0; i < ring->max_reader; i++)
+	{
+		muggle_broadcast_ring_reader_t *reader = &ring->readers[i];
+		if (muggle_atomic_load(&reader->status, muggle_memory_order_acquire) !=
+			MUGGLE_BROADCAST_RING_READER_ACTIVE)
+		{
+			continue;
+		}
+
+		muggle_atomic_int lag =
+			seq - muggle_atomic_load(&reader->cursor, muggle_memory_order_acquire);
+		if (evict && lag >= ring->capacity)
+		{
+			muggle_atomic_int status = MUGGLE_BROADCAST_RING_READER_ACTIVE;
+			if (muggle_atomic_cmp_exch_strong(&reader->status, &status,
+					MUGGLE_BROADCAST_RING_READER_EVICTED, muggle_memory_order_seq_cst))
+			{
+				muggle_atomic_fetch_add(&ring->evict_cnt, 1, muggle_memory_order_relaxed);
+			}
+			continue;
+		}
+
+		if (lag > max_lag)
+		{
+			max_lag = lag;
+		}
+	}
+
+	return seq - max_lag;
+}
+
+// wait until slot of seq is not needed by any reader
+static void muggle_broadcast_ring_gate(muggle_broadcast_ring_t *ring, muggle_atomic_int seq)
+{
+	if (seq - muggle_atomic_load(&ring->gate, muggle_memory_order_relaxed) < ring->capacity)
+	{
+		return;
+	}
+
+	// claimed index before scan readers, pair with reload next in
+	// muggle_broadcast_ring_add_reader
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+
+	int evict = ring->policy == MUGGLE_BROADCAST_RING_POLICY_EVICT_SLOW;
+	int round = 0;
+	while (1)
+	{
+		muggle_atomic_int min_cursor = muggle_broadcast_ring_min_cursor(ring, seq, evict);
+		muggle_atomic_store(&ring->gate, min_cursor, muggle_memory_order_relaxed);
+		if (seq - min_cursor < ring->capacity)
+		{
+			break;
+		}
+
+		if (round == 0)
+		{
+			muggle_atomic_fetch_add(&ring->block_cnt, 1, muggle_memory_order_relaxed);
+		}
+
+		if (round < ring->spin_cnt)
+		{
+			muggle_thread_pause();
+			round++;
+		}
+		else if (round < ring->spin_cnt + ring->yield_cnt)
+		{
+			muggle_thread_yield();
+			round++;
+		}
+		else
+		{
+			// register as waiter, recheck slowest reader and futex wait
+			muggle_atomic_int read_seq = muggle_atomic_load(&ring->read_seq, muggle_memory_order_acquire);
+			muggle_atomic_fetch_add(&ring->write_waiters, 1, muggle_memory_order_seq_cst);
+			if (seq - muggle_broadcast_ring_min_cursor(ring, seq, evict) >= ring->capacity)
+			{
+				muggle_futex_wait(&ring->read_seq, read_seq, NULL);
+			}
+			muggle_atomic_fetch_sub(&ring->write_waiters, 1, muggle_memory_order_relaxed);
+		}
+	}
+}
+
+int muggle_broadcast_ring_write(muggle_broadcast_ring_t *ring, void *data)
+{
+	muggle_atomic_int seq;
+	if (ring->flags & MUGGLE_BROADCAST_RING_FLAG_SINGLE_WRITER)
+	{
+		seq = ring->next;
+		muggle_atomic_store(&ring->next, seq + 1, muggle_memory_order_relaxed);
+	}
+	else
+	{
+		seq = muggle_atomic_fetch_add(&ring->next, 1, muggle_memory_order_relaxed);
+	}
+
+	if (ring->policy != MUGGLE_BROADCAST_RING_POLICY_DROP_OLDEST)
+	{
+		muggle_broadcast_ring_gate(ring, seq);
+	}
+
+	// claimed index must be visible before overwrite slot, pair with acquire
+	// fence in muggle_broadcast_ring_read
+	muggle_atomic_thread_fence(muggle_memory_order_release);
+	ring->datas[IDX_IN_POW_OF_2_RING(seq, ring->capacity)] = data;
+
+	// publish in order
+	if (ring->flags & MUGGLE_BROADCAST_RING_FLAG_SINGLE_WRITER)
+	{
+		muggle_atomic_store(&ring->cursor, seq + 1, muggle_memory_order_release);
+	}
+	else
+	{
+		muggle_atomic_int expected = seq;
+		while (!muggle_atomic_cmp_exch_weak(&ring->cursor, &expected, seq + 1, muggle_memory_order_release))
+		{
+			expected = seq;
+			muggle_thread_yield();
+		}
+	}
+
+	if (!(ring->flags & MUGGLE_BROADCAST_RING_FLAG_READ_BUSY_LOOP))
+	{
+		// pair with read_waiters increase in muggle_broadcast_ring_park
+		muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+		if (muggle_atomic_load(&ring->read_waiters, muggle_memory_order_relaxed) > 0)
+		{
+			muggle_futex_wake_all(&ring->cursor);
+		}
+	}
+
+	return MUGGLE_OK;
+}
+
+// register as waiter, recheck cursor and futex wait
+static void muggle_broadcast_ring_park(muggle_broadcast_ring_t *ring, muggle_atomic_int w_cursor)
+{
+	muggle_atomic_fetch_add(&ring->read_waiters, 1, muggle_memory_order_seq_cst);
+	if (muggle_atomic_load(&ring->cursor, muggle_memory_order_seq_cst) == w_cursor)
+	{
+		muggle_futex_wait(&ring->cursor, w_cursor, NULL);
+	}
+	muggle_atomic_fetch_sub(&ring->read_waiters, 1, muggle_memory_order_relaxed);
+}
+
+// wait until message of idx published, return published cursor
+static muggle_atomic_int muggle_broadcast_ring_wait(muggle_broadcast_ring_t *ring, muggle_atomic_int idx)
+{
+	int round = 0;
+	while (1)
+	{
+		muggle_atomic_int w_cursor = muggle_atomic_load(&ring->cursor, muggle_memory_order_acquire);
+		if (w_cursor - idx > 0)
+		{
+			return w_cursor;
+		}
+
+		if (ring->flags & MUGGLE_BROADCAST_RING_FLAG_READ_BUSY_LOOP)
+		{
+			muggle_thread_yield();
+		}
+		else if (round < ring->spin_cnt)
+		{
+			muggle_thread_pause();
+			round++;
+		}
+		else if (round < ring->spin_cnt + ring->yield_cnt)
+		{
+			muggle_thread_yield();
+			round++;
+		}
+		else
+		{
+			muggle_broadcast_ring_park(ring, w_cursor);
+		}
+	}
+}
+
+int muggle_broadcast_ring_read(muggle_broadcast_ring_t *ring, int reader_id, void **data)
+{
+	if (reader_id < 0 || reader_id >= ring->max_reader)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	muggle_broadcast_ring_reader_t *reader = &ring->readers[reader_id];
+	muggle_atomic_int idx = muggle_atomic_load(&reader->cursor, muggle_memory_order_relaxed);
+	void *d = NULL;
+	while (1)
+	{
+		if (muggle_atomic_load(&reader->status, muggle_memory_order_acquire) !=
+			MUGGLE_BROADCAST_RING_READER_ACTIVE)
+		{
+			return MUGGLE_ERR_BEYOND_RANGE;
+		}
+
+		muggle_atomic_int w_cursor = muggle_broadcast_ring_wait(ring, idx);
+
+		if (ring->policy == MUGGLE_BROADCAST_RING_POLICY_DROP_OLDEST &&
+			w_cursor - idx > ring->capacity)
+		{
+			// only reader thread write overrun, relaxed load and store avoid locked instruction
+			muggle_atomic_store64(&reader->overrun,
+				muggle_atomic_load64(&reader->overrun, muggle_memory_order_relaxed) +
+				(muggle_atomic_int64)(w_cursor - ring->capacity - idx),
+				muggle_memory_order_relaxed);
+			idx = w_cursor - ring->capacity;
+		}
+
+		d = ring->datas[IDX_IN_POW_OF_2_RING(idx, ring->capacity)];
+
+		// pair with release fence in muggle_broadcast_ring_write, check
+		// whether slot was overwritten or reader was evicted while reading
+		muggle_atomic_thread_fence(muggle_memory_order_acquire);
+		if (ring->policy == MUGGLE_BROADCAST_RING_POLICY_DROP_OLDEST)
+		{
+			muggle_atomic_int next = muggle_atomic_load(&ring->next, muggle_memory_order_relaxed);
+			if (next - idx > ring->capacity)
+			{
+				continue;
+			}
+		}
+		else if (ring->policy == MUGGLE_BROADCAST_RING_POLICY_EVICT_SLOW)
+		{
+			if (muggle_atomic_load(&reader->status, muggle_memory_order_relaxed) !=
+				MUGGLE_BROADCAST_RING_READER_ACTIVE)
+			{
+				return MUGGLE_ERR_BEYOND_RANGE;
+			}
+		}
+
+		break;
+	}
+
+	muggle_atomic_store(&reader->cursor, idx + 1, muggle_memory_order_release);
+	*data = d;
+
+	muggle_broadcast_ring_wake_writers(ring);
+
+	return MUGGLE_OK;
+}
+
+uint64_t muggle_broadcast_ring_get_overrun(muggle_broadcast_ring_t *ring, int reader_id)
+{
+	if (reader_id < 0 || reader_id >= ring->max_reader)
+	{
+		return 0;
+	}
+
+	return (uint64_t)muggle_atomic_load64(&ring->readers[reader_id].overrun, muggle_memory_order_relaxed);
+}
@@ -0,0 +1,193 @@
+/******************************************************************************
+ *  @file         broadcast_ring.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec bounded broadcast ring
+ *
+ * Every registered reader get every message written into ring, each reader
+ * own a cache line padded cursor, and writer know where readers are.
+ *
+ * When the slowest reader lag a whole ring, writer act according to policy
+ *   - BLOCK: writer wait until slowest reader move forward
+ *   - DROP_OLDEST: writer overwrite oldest message, slow reader skip the lost
+ *     messages and record them in its overrun counter
+ *   - EVICT_SLOW: writer evict the slow reader, the reader's next read return
+ *     MUGGLE_ERR_BEYOND_RANGE and it need register again
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_BROADCAST_RING_H_
+#define MUGGLE_C_BROADCAST_RING_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/base/atomic.h"
+#include <stdint.h>
+
+EXTERN_C_BEGIN
+
+enum
+{
+	MUGGLE_BROADCAST_RING_FLAG_WRITE_MULTI    = 0x00, //!< default, multiple writers
+	MUGGLE_BROADCAST_RING_FLAG_READ_WAIT      = 0x00, //!< default, reader spin, yield and then wait
+	MUGGLE_BROADCAST_RING_FLAG_SINGLE_WRITER  = 0x01, //!< user guarantee only one writer use this ring
+	MUGGLE_BROADCAST_RING_FLAG_READ_BUSY_LOOP = 0x02, //!< reader busy loop until message arrived
+};
+
+enum
+{
+	MUGGLE_BROADCAST_RING_POLICY_BLOCK = 0,   //!< writer wait slowest reader
+	MUGGLE_BROADCAST_RING_POLICY_DROP_OLDEST, //!< writer overwrite oldest message, slow reader record overrun
+	MUGGLE_BROADCAST_RING_POLICY_EVICT_SLOW,  //!< writer evict reader that lag a whole ring
+	MUGGLE_BROADCAST_RING_POLICY_MAX,
+};
+
+enum
+{
+	MUGGLE_BROADCAST_RING_READER_UNUSED = 0,
+	MUGGLE_BROADCAST_RING_READER_REGISTERING,
+	MUGGLE_BROADCAST_RING_READER_ACTIVE,
+	MUGGLE_BROADCAST_RING_READER_EVICTED,
+};
+
+/**
+ * @brief broadcast ring reader
+ */
+typedef struct muggle_broadcast_ring_reader
+{
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	muggle_atomic_int cursor;  //!< index of next message to read
+	muggle_atomic_int status;  //!< MUGGLE_BROADCAST_RING_READER_*
+	muggle_atomic_int64 overrun; //!< number of messages lost by this reader, only written by reader thread
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
+}muggle_broadcast_ring_reader_t;
+
+/**
+ * @brief bounded broadcast ring
+ */
+typedef struct muggle_broadcast_ring
+{
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	muggle_atomic_int capacity;
+	int               flags;
+	int               policy;
+	int               max_reader;
+	int               spin_cnt;
+	int               yield_cnt;
+	void              **datas;
+	muggle_broadcast_ring_reader_t *readers;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
+	muggle_atomic_int next;         //!< next index writer claim
+	muggle_atomic_int gate;         //!< cached cursor of slowest reader
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(2);
+	muggle_atomic_int cursor;       //!< messages before cursor are published
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(3);
+	muggle_atomic_int read_waiters; //!< number of parked readers
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(4);
+	muggle_atomic_int read_seq;      //!< futex word of writers wait slow reader, BLOCK policy only
+	muggle_atomic_int write_waiters; //!< number of parked writers
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(5);
+	muggle_atomic_int evict_cnt;    //!< number of evicted readers
+	muggle_atomic_int block_cnt;    //!< number of writes that wait for slow reader
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(6);
+}muggle_broadcast_ring_t;
+
+/**
+ * @brief init broadcast ring
+ *
+ * @param ring        pointer to broadcast ring
+ * @param capacity    capacity of ring
+ * @param max_reader  max number of readers register at the same time
+ * @param policy      MUGGLE_BROADCAST_RING_POLICY_*
+ * @param flags       bitwise or of MUGGLE_BROADCAST_RING_FLAG_*
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_broadcast_ring_init(
+	muggle_broadcast_ring_t *ring, muggle_atomic_int capacity,
+	int max_reader, int policy, int flags);
+
+/**
+ * @brief destroy broadcast ring
+ *
+ * @param ring  pointer to broadcast ring
+ */
+MUGGLE_C_EXPORT
+void muggle_broadcast_ring_destroy(muggle_broadcast_ring_t *ring);
+
+/**
+ * @brief register a reader, reader start from next message written
+ *
+ * @param ring  pointer to broadcast ring
+ *
+ * NOTE: slot of evicted reader is not reused until its owner invoke
+ * muggle_broadcast_ring_remove_reader, owner may still use the reader id
+ *
+ * @return
+ *     - on success, return reader id
+ *     - return -1 when reach max_reader
+ */
+MUGGLE_C_EXPORT
+int muggle_broadcast_ring_add_reader(muggle_broadcast_ring_t *ring);
+
+/**
+ * @brief unregister a reader
+ *
+ * NOTE: evicted reader must be removed too, otherwise its slot is never
+ * reused
+ *
+ * @param ring       pointer to broadcast ring
+ * @param reader_id  reader id returned by muggle_broadcast_ring_add_reader
+ */
+MUGGLE_C_EXPORT
+void muggle_broadcast_ring_remove_reader(muggle_broadcast_ring_t *ring, int reader_id);
+
+/**
+ * @brief write data into broadcast ring
+ *
+ * @param ring  pointer to broadcast ring
+ * @param data  data pointer
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_broadcast_ring_write(muggle_broadcast_ring_t *ring, void *data);
+
+/**
+ * @brief read data from broadcast ring
+ *
+ * @param ring       pointer to broadcast ring
+ * @param reader_id  reader id returned by muggle_broadcast_ring_add_reader
+ * @param data       output data pointer
+ *
+ * @return
+ *     - return 0 on success
+ *     - return MUGGLE_ERR_BEYOND_RANGE when reader was evicted, invoke
+ *       muggle_broadcast_ring_remove_reader to release its slot
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_broadcast_ring_read(muggle_broadcast_ring_t *ring, int reader_id, void **data);
+
+/**
+ * @brief get number of messages lost by reader
+ *
+ * NOTE: can be invoked from any thread
+ *
+ * @param ring       pointer to broadcast ring
+ * @param reader_id  reader id
+ *
+ * @return number of overrun messages
+ */
+MUGGLE_C_EXPORT
+uint64_t muggle_broadcast_ring_get_overrun(muggle_broadcast_ring_t *ring, int reader_id);
+
+EXTERN_C_END
+
+#endif
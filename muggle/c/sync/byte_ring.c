@@ -0,0 +1,250 @@
+/******************************************************************************
+ *  @file         byte_ring.c
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec variable length record byte ring
+ *****************************************************************************/
+
+#include "byte_ring.h"
+#include <stdlib.h>
+#include <string.h>
+#include "muggle/c/base/err.h"
+#include "muggle/c/base/utils.h"
+#include "muggle/c/base/thread.h"
+#include "muggle/c/sync/futex.h"
+
+enum
+{
+	MUGGLE_BYTE_RING_RECORD_EMPTY = 0,
+	MUGGLE_BYTE_RING_RECORD_COMMITTED,
+	MUGGLE_BYTE_RING_RECORD_PADDING,
+};
+
+#define MUGGLE_BYTE_RING_MIN_CAPACITY 64
+
+#define MUGGLE_BYTE_RING_OFFSET(ring, pos) \
+	((uint32_t)(pos) & (uint32_t)((ring)->capacity - 1))
+
+#define MUGGLE_BYTE_RING_RECORD(ring, pos) \
+	((muggle_byte_ring_record_t*)((ring)->buf + MUGGLE_BYTE_RING_OFFSET(ring, pos)))
+
+#define MUGGLE_BYTE_RING_PAYLOAD(record) \
+	((void*)((char*)(record) + MUGGLE_BYTE_RING_RECORD_HEAD_SIZE))
+
+#define MUGGLE_BYTE_RING_RECORD_OF_PAYLOAD(payload) \
+	((muggle_byte_ring_record_t*)((char*)(payload) - MUGGLE_BYTE_RING_RECORD_HEAD_SIZE))
+
+#define MUGGLE_BYTE_RING_BLOCK_SIZE(size) \
+	((uint32_t)ROUND_UP_POW_OF_2_MUL(MUGGLE_BYTE_RING_RECORD_HEAD_SIZE + (size), MUGGLE_BYTE_RING_RECORD_ALIGN))
+
+// cursors are byte positions, they wrap around as unsigned 32 bits integer
+#define MUGGLE_BYTE_RING_CURSOR_ADD(pos, n) \
+	((muggle_atomic_int)((uint32_t)(pos) + (uint32_t)(n)))
+
+int muggle_byte_ring_init(muggle_byte_ring_t *ring, muggle_atomic_int capacity, int flags)
+{
+	memset(ring, 0, sizeof(muggle_byte_ring_t));
+
+	if (capacity <= 0)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	if (capacity < MUGGLE_BYTE_RING_MIN_CAPACITY)
+	{
+		capacity = MUGGLE_BYTE_RING_MIN_CAPACITY;
+	}
+	capacity = (muggle_atomic_int)next_pow_of_2((uint64_t)capacity);
+	if (capacity <= 0 || capacity > (1 << 30))
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	ring->capacity = capacity;
+	ring->flags = flags;
+	// record never wrap, so record with padding before it always fit in ring
+	ring->max_payload = (uint32_t)capacity / 2 - MUGGLE_BYTE_RING_RECORD_HEAD_SIZE;
+	ring->write_cursor = 0;
+	ring->read_cursor = 0;
+	ring->read_waiters = 0;
+
+	// every position may become a record head, they must be empty
+	ring->buf = (char*)calloc(1, (size_t)capacity);
+	if (ring->buf == NULL)
+	{
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+
+	return MUGGLE_OK;
+}
+
+void muggle_byte_ring_destroy(muggle_byte_ring_t *ring)
+{
+	if (ring->buf)
+	{
+		free(ring->buf);
+		ring->buf = NULL;
+	}
+}
+
+static void muggle_byte_ring_wake(muggle_byte_ring_t *ring, muggle_byte_ring_record_t *record)
+{
+	if (!(ring->flags & MUGGLE_BYTE_RING_FLAG_READ_BUSY_LOOP))
+	{
+		// pair with read_waiters increase in muggle_byte_ring_peek
+		muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+		if (muggle_atomic_load(&ring->read_waiters, muggle_memory_order_relaxed) > 0)
+		{
+			muggle_futex_wake_one(&record->state);
+		}
+	}
+}
+
+void* muggle_byte_ring_reserve(muggle_byte_ring_t *ring, uint32_t size)
+{
+	if (size > ring->max_payload)
+	{
+		return NULL;
+	}
+
+	uint32_t need = MUGGLE_BYTE_RING_BLOCK_SIZE(size);
+	uint32_t capacity = (uint32_t)ring->capacity;
+	uint32_t tail = 0;
+	uint32_t total = 0;
+	muggle_atomic_int pos = muggle_atomic_load(&ring->write_cursor, muggle_memory_order_relaxed);
+	while (1)
+	{
+		tail = capacity - MUGGLE_BYTE_RING_OFFSET(ring, pos);
+		total = need > tail ? tail + need : need;
+
+		muggle_atomic_int read_pos = muggle_atomic_load(&ring->read_cursor, muggle_memory_order_acquire);
+		if ((uint32_t)pos - (uint32_t)read_pos + total > capacity)
+		{
+			return NULL;
+		}
+
+		if (ring->flags & MUGGLE_BYTE_RING_FLAG_SINGLE_WRITER)
+		{
+			muggle_atomic_store(&ring->write_cursor, MUGGLE_BYTE_RING_CURSOR_ADD(pos, total), muggle_memory_order_relaxed);
+			break;
+		}
+
+		if (muggle_atomic_cmp_exch_weak(
+				&ring->write_cursor, &pos, MUGGLE_BYTE_RING_CURSOR_ADD(pos, total), muggle_memory_order_relaxed))
+		{
+			break;
+		}
+	}
+
+	if (need > tail)
+	{
+		// tail space is not enough, fill it with padding record
+		muggle_byte_ring_record_t *pad = MUGGLE_BYTE_RING_RECORD(ring, pos);
+		pad->size = tail - MUGGLE_BYTE_RING_RECORD_HEAD_SIZE;
+		muggle_atomic_store(&pad->state, MUGGLE_BYTE_RING_RECORD_PADDING, muggle_memory_order_release);
+		muggle_byte_ring_wake(ring, pad);
+
+		pos = MUGGLE_BYTE_RING_CURSOR_ADD(pos, tail);
+	}
+
+	muggle_byte_ring_record_t *record = MUGGLE_BYTE_RING_RECORD(ring, pos);
+	record->size = size;
+
+	return MUGGLE_BYTE_RING_PAYLOAD(record);
+}
+
+void muggle_byte_ring_commit(muggle_byte_ring_t *ring, void *payload)
+{
+	muggle_byte_ring_record_t *record = MUGGLE_BYTE_RING_RECORD_OF_PAYLOAD(payload);
+	muggle_atomic_store(&record->state, MUGGLE_BYTE_RING_RECORD_COMMITTED, muggle_memory_order_release);
+	muggle_byte_ring_wake(ring, record);
+}
+
+/**
+ * @brief give space of the oldest record back to writers
+ *
+ * every position in released space may become a record head later, so clear
+ * the whole record before writers see it
+ */
+static void muggle_byte_ring_consume(muggle_byte_ring_t *ring, muggle_byte_ring_record_t *record)
+{
+	uint32_t block_size = MUGGLE_BYTE_RING_BLOCK_SIZE(record->size);
+	memset(record, 0, block_size);
+	muggle_atomic_store(
+		&ring->read_cursor,
+		MUGGLE_BYTE_RING_CURSOR_ADD(ring->read_cursor, block_size),
+		muggle_memory_order_release);
+}
+
+void* muggle_byte_ring_peek(muggle_byte_ring_t *ring, uint32_t *size)
+{
+	muggle_byte_ring_record_t *record = MUGGLE_BYTE_RING_RECORD(ring, ring->read_cursor);
+	while (1)
+	{
+		muggle_atomic_int state = muggle_atomic_load(&record->state, muggle_memory_order_acquire);
+		if (state == MUGGLE_BYTE_RING_RECORD_COMMITTED)
+		{
+			break;
+		}
+
+		if (state == MUGGLE_BYTE_RING_RECORD_PADDING)
+		{
+			muggle_byte_ring_consume(ring, record);
+			record = MUGGLE_BYTE_RING_RECORD(ring, ring->read_cursor);
+			continue;
+		}
+
+		if (ring->flags & MUGGLE_BYTE_RING_FLAG_READ_BUSY_LOOP)
+		{
+			muggle_thread_yield();
+		}
+		else
+		{
+			muggle_atomic_fetch_add(&ring->read_waiters, 1, muggle_memory_order_seq_cst);
+			if (muggle_atomic_load(&record->state, muggle_memory_order_seq_cst) == state)
+			{
+				muggle_futex_wait(&record->state, state, NULL);
+			}
+			muggle_atomic_fetch_sub(&ring->read_waiters, 1, muggle_memory_order_relaxed);
+		}
+	}
+
+	if (size)
+	{
+		*size = record->size;
+	}
+
+	return MUGGLE_BYTE_RING_PAYLOAD(record);
+}
+
+void* muggle_byte_ring_try_peek(muggle_byte_ring_t *ring, uint32_t *size)
+{
+	muggle_byte_ring_record_t *record = MUGGLE_BYTE_RING_RECORD(ring, ring->read_cursor);
+	muggle_atomic_int state = muggle_atomic_load(&record->state, muggle_memory_order_acquire);
+	if (state == MUGGLE_BYTE_RING_RECORD_PADDING)
+	{
+		muggle_byte_ring_consume(ring, record);
+		record = MUGGLE_BYTE_RING_RECORD(ring, ring->read_cursor);
+		state = muggle_atomic_load(&record->state, muggle_memory_order_acquire);
+	}
+
+	if (state != MUGGLE_BYTE_RING_RECORD_COMMITTED)
+	{
+		return NULL;
+	}
+
+	if (size)
+	{
+		*size = record->size;
+	}
+
+	return MUGGLE_BYTE_RING_PAYLOAD(record);
+}
+
+void muggle_byte_ring_release(muggle_byte_ring_t *ring)
+{
+	muggle_byte_ring_consume(ring, MUGGLE_BYTE_RING_RECORD(ring, ring->read_cursor));
+}
@@ -0,0 +1,154 @@
+/******************************************************************************
+ *  @file         byte_ring.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec variable length record byte ring
+ *
+ * Passing variable length messages between threads, every record take only
+ * its own size (8 bytes head + payload, round up to 8 bytes) in a contiguous
+ * byte buffer.
+ *
+ * writer: reserve a record, fill payload in place, then commit it
+ * reader: peek the oldest record, consume payload in place, then release it
+ *
+ * A record never wrap around the end of buffer, when the tail space is not
+ * enough, writer fill it with a padding record that reader skip silently.
+ * Records are committed out of order by multiple writers, but read in the
+ * order they were reserved.
+ *
+ * multiple writers are allowed unless MUGGLE_BYTE_RING_FLAG_SINGLE_WRITER is
+ * set, user must guarantee only one reader use the ring at the same time.
+ * When ring full, reserve will return NULL
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_BYTE_RING_H_
+#define MUGGLE_C_BYTE_RING_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/base/atomic.h"
+#include <stdint.h>
+
+EXTERN_C_BEGIN
+
+enum
+{
+	MUGGLE_BYTE_RING_FLAG_READ_WAIT      = 0x00, //!< default, if no record in ring, reader wait
+	MUGGLE_BYTE_RING_FLAG_SINGLE_WRITER  = 0x01, //!< user guarantee only one writer use this ring
+	MUGGLE_BYTE_RING_FLAG_READ_BUSY_LOOP = 0x02, //!< reader busy loop until record committed
+};
+
+// size of record head and alignment of record
+#define MUGGLE_BYTE_RING_RECORD_HEAD_SIZE 8
+#define MUGGLE_BYTE_RING_RECORD_ALIGN 8
+
+/**
+ * @brief byte ring record head
+ */
+typedef struct muggle_byte_ring_record_tag
+{
+	muggle_atomic_int state; //!< 0: not committed, otherwise committed or padding
+	uint32_t          size;  //!< payload size
+}muggle_byte_ring_record_t;
+
+/**
+ * @brief variable length record byte ring
+ */
+typedef struct muggle_byte_ring_tag
+{
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	muggle_atomic_int capacity;    //!< bytes of buffer
+	int               flags;
+	uint32_t          max_payload; //!< max payload size of a record
+	char              *buf;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
+	muggle_atomic_int write_cursor;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(2);
+	muggle_atomic_int read_cursor;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(3);
+	muggle_atomic_int read_waiters; //!< number of parked readers
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(4);
+}muggle_byte_ring_t;
+
+/**
+ * @brief init byte ring
+ *
+ * @param ring      pointer to byte ring
+ * @param capacity  bytes of buffer, round up to power of 2, the max payload
+ *                  size of a record is about half of it
+ * @param flags     bitwise or of MUGGLE_BYTE_RING_FLAG_*
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_byte_ring_init(muggle_byte_ring_t *ring, muggle_atomic_int capacity, int flags);
+
+/**
+ * @brief destroy byte ring
+ *
+ * @param ring  pointer to byte ring
+ */
+MUGGLE_C_EXPORT
+void muggle_byte_ring_destroy(muggle_byte_ring_t *ring);
+
+/**
+ * @brief reserve a record for write
+ *
+ * @param ring  pointer to byte ring
+ * @param size  payload size, must not greater than ring's max_payload
+ *
+ * @return
+ *     - on success, return payload address of record, it's 8 bytes aligned,
+ *       user fill payload then invoke muggle_byte_ring_commit
+ *     - return NULL when ring is full or size is too large
+ */
+MUGGLE_C_EXPORT
+void* muggle_byte_ring_reserve(muggle_byte_ring_t *ring, uint32_t size);
+
+/**
+ * @brief commit reserved record, make it visible to reader
+ *
+ * @param ring     pointer to byte ring
+ * @param payload  payload address returned by muggle_byte_ring_reserve
+ */
+MUGGLE_C_EXPORT
+void muggle_byte_ring_commit(muggle_byte_ring_t *ring, void *payload);
+
+/**
+ * @brief wait and peek the oldest record
+ *
+ * @param ring  pointer to byte ring
+ * @param size  if not NULL, output payload size
+ *
+ * @return payload address of record, it's valid until muggle_byte_ring_release
+ */
+MUGGLE_C_EXPORT
+void* muggle_byte_ring_peek(muggle_byte_ring_t *ring, uint32_t *size);
+
+/**
+ * @brief peek the oldest record without wait
+ *
+ * @param ring  pointer to byte ring
+ * @param size  if not NULL, output payload size
+ *
+ * @return payload address of record, or NULL when the oldest record is not
+ * committed yet
+ */
+MUGGLE_C_EXPORT
+void* muggle_byte_ring_try_peek(muggle_byte_ring_t *ring, uint32_t *size);
+
+/**
+ * @brief release the record returned by peek, give space back to writers
+ *
+ * @param ring  pointer to byte ring
+ */
+MUGGLE_C_EXPORT
+void muggle_byte_ring_release(muggle_byte_ring_t *ring);
+
+EXTERN_C_END
+
+#endif
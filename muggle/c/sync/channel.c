@@ -15,22 +15,14 @@
 #include "muggle/c/base/utils.h"
 #include "muggle/c/base/thread.h"
 #include "muggle/c/sync/futex.h"
+#include "muggle/c/time/deadline.h"
 
-static void muggle_channel_lock_write(muggle_channel_t *chan)
+// whether channel write lock is muggle_mutex_t, otherwise the write lock
+// union member is muggle_fast_mutex_t or unused
+static int muggle_channel_use_write_mutex(int flags)
 {
-	muggle_atomic_int expected = MUGGLE_CHANNEL_LOCK_STATUS_UNLOCK;
-	while (!muggle_atomic_cmp_exch_weak(&chan->write_futex, &expected, MUGGLE_CHANNEL_LOCK_STATUS_LOCK, muggle_memory_order_acquire)
-			&& expected != MUGGLE_CHANNEL_LOCK_STATUS_UNLOCK)
-	{
-		muggle_futex_wait(&chan->write_futex, expected, NULL);
-		expected = MUGGLE_CHANNEL_LOCK_STATUS_UNLOCK;
-	}
-}
-
-static void muggle_channel_unlock_write(muggle_channel_t *chan)
-{
-	muggle_atomic_store(&chan->write_futex, MUGGLE_CHANNEL_LOCK_STATUS_UNLOCK, muggle_memory_order_relaxed);
-	muggle_futex_wake_one(&chan->write_futex);
+	return !(flags & (MUGGLE_CHANNEL_FLAG_MULTI_READER |
+		MUGGLE_CHANNEL_FLAG_SINGLE_WRITER | MUGGLE_CHANNEL_FLAG_WRITE_FUTEX));
 }
 
 /***************** write *****************/
@@ -65,18 +57,49 @@ static int muggle_channel_write_single_writer(muggle_channel_t *chan, void *data
 }
 static int muggle_channel_write_futex(muggle_channel_t *chan, void *data)
 {
-	muggle_channel_lock_write(chan);
+	muggle_fast_mutex_lock(&chan->write_futex);
 
 	if (chan->write_cursor + 1 == chan->read_cursor)
 	{
-		muggle_channel_unlock_write(chan);
+		muggle_fast_mutex_unlock(&chan->write_futex);
 		return MUGGLE_ERR_FULL;
 	}
 
 	chan->blocks[IDX_IN_POW_OF_2_RING(chan->write_cursor, chan->capacity)].data = data;
 	muggle_atomic_store(&chan->write_cursor, chan->write_cursor + 1, muggle_memory_order_release);
 
-	muggle_channel_unlock_write(chan);
+	muggle_fast_mutex_unlock(&chan->write_futex);
+
+	return MUGGLE_OK;
+}
+static int muggle_channel_write_multi_reader(muggle_channel_t *chan, void *data)
+{
+	muggle_channel_block_t *block = NULL;
+	muggle_atomic_int pos = muggle_atomic_load(&chan->write_cursor, muggle_memory_order_relaxed);
+	while (1)
+	{
+		block = &chan->blocks[IDX_IN_POW_OF_2_RING(pos, chan->capacity)];
+		muggle_atomic_int seq = muggle_atomic_load(&block->seq, muggle_memory_order_acquire);
+		muggle_atomic_int diff = seq - pos;
+		if (diff == 0)
+		{
+			if (muggle_atomic_cmp_exch_weak(&chan->write_cursor, &pos, pos + 1, muggle_memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (diff < 0)
+		{
+			return MUGGLE_ERR_FULL;
+		}
+		else
+		{
+			pos = muggle_atomic_load(&chan->write_cursor, muggle_memory_order_relaxed);
+		}
+	}
+
+	block->data = data;
+	muggle_atomic_store(&block->seq, pos + 1, muggle_memory_order_release);
 
 	return MUGGLE_OK;
 }
@@ -90,6 +113,40 @@ static void muggle_channel_wake_busy_loop(struct muggle_channel *chan)
 {
 	// do nothing
 }
+static void muggle_channel_wake_adaptive(struct muggle_channel *chan)
+{
+	// pair with read_waiters increase in muggle_channel_adaptive_wait
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	if (muggle_atomic_load(&chan->read_waiters, muggle_memory_order_relaxed) > 0)
+	{
+		muggle_futex_wake_one(&chan->write_cursor);
+	}
+}
+
+/***************** adaptive wait *****************/
+static void muggle_channel_adaptive_wait(struct muggle_channel *chan, int *round, muggle_atomic_int w_cursor)
+{
+	if (*round < chan->spin_cnt)
+	{
+		muggle_thread_pause();
+	}
+	else if (*round < chan->spin_cnt + chan->yield_cnt)
+	{
+		muggle_thread_yield();
+	}
+	else
+	{
+		// register as waiter, then recheck write_cursor before sleep
+		muggle_atomic_fetch_add(&chan->read_waiters, 1, muggle_memory_order_seq_cst);
+		if (muggle_atomic_load(&chan->write_cursor, muggle_memory_order_seq_cst) == w_cursor)
+		{
+			muggle_futex_wait(&chan->write_cursor, w_cursor, NULL);
+		}
+		muggle_atomic_fetch_sub(&chan->read_waiters, 1, muggle_memory_order_relaxed);
+		return;
+	}
+	(*round)++;
+}
 
 /***************** read *****************/
 static void* muggle_channel_read_futex(struct muggle_channel *chan)
@@ -128,8 +185,148 @@ static void* muggle_channel_read_busy_loop(struct muggle_channel *chan)
 
 	return NULL;
 }
+static void* muggle_channel_read_adaptive(struct muggle_channel *chan)
+{
+	muggle_atomic_int r_pos = IDX_IN_POW_OF_2_RING(chan->read_cursor + 1, chan->capacity);
+	muggle_atomic_int w_cursor;
+	int round = 0;
+	while (1)
+	{
+		w_cursor = muggle_atomic_load(&chan->write_cursor, muggle_memory_order_acquire);
+		if (IDX_IN_POW_OF_2_RING(w_cursor, chan->capacity) != r_pos)
+		{
+			void *data = chan->blocks[r_pos].data;
+			chan->read_cursor++;
+			return data;
+		}
+
+		muggle_channel_adaptive_wait(chan, &round, w_cursor);
+	}
+
+	return NULL;
+}
+
+// multiple reader try to take data, return 0 when channel is empty
+static int muggle_channel_try_read_multi_reader(struct muggle_channel *chan, void **data)
+{
+	muggle_channel_block_t *block = NULL;
+	muggle_atomic_int pos = muggle_atomic_load(&chan->read_cursor, muggle_memory_order_relaxed);
+	while (1)
+	{
+		block = &chan->blocks[IDX_IN_POW_OF_2_RING(pos, chan->capacity)];
+		muggle_atomic_int seq = muggle_atomic_load(&block->seq, muggle_memory_order_acquire);
+		muggle_atomic_int diff = seq - (pos + 1);
+		if (diff == 0)
+		{
+			if (muggle_atomic_cmp_exch_weak(&chan->read_cursor, &pos, pos + 1, muggle_memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (diff < 0)
+		{
+			return 0;
+		}
+		else
+		{
+			pos = muggle_atomic_load(&chan->read_cursor, muggle_memory_order_relaxed);
+		}
+	}
+
+	*data = block->data;
+	muggle_atomic_store(&block->seq, pos + chan->capacity, muggle_memory_order_release);
+
+	return 1;
+}
+// single reader try to take data, return 0 when channel is empty
+static int muggle_channel_try_read_single_reader(struct muggle_channel *chan, void **data)
+{
+	muggle_atomic_int r_pos = IDX_IN_POW_OF_2_RING(chan->read_cursor + 1, chan->capacity);
+	muggle_atomic_int w_cursor = muggle_atomic_load(&chan->write_cursor, muggle_memory_order_acquire);
+	if (IDX_IN_POW_OF_2_RING(w_cursor, chan->capacity) == r_pos)
+	{
+		return 0;
+	}
+
+	*data = chan->blocks[r_pos].data;
+	chan->read_cursor++;
+
+	return 1;
+}
+static void* muggle_channel_read_multi_reader_futex(struct muggle_channel *chan)
+{
+	void *data = NULL;
+	while (1)
+	{
+		if (muggle_channel_try_read_multi_reader(chan, &data))
+		{
+			return data;
+		}
+
+		// if write_cursor moved beyond read_cursor, a writer already claimed
+		// the slot but not yet published it, just yield and retry
+		muggle_atomic_int r_cursor = muggle_atomic_load(&chan->read_cursor, muggle_memory_order_relaxed);
+		muggle_atomic_int w_cursor = muggle_atomic_load(&chan->write_cursor, muggle_memory_order_acquire);
+		if (w_cursor == r_cursor)
+		{
+			muggle_futex_wait(&chan->write_cursor, w_cursor, NULL);
+		}
+		else
+		{
+			muggle_thread_yield();
+		}
+	}
+
+	return NULL;
+}
+static void* muggle_channel_read_multi_reader_busy_loop(struct muggle_channel *chan)
+{
+	void *data = NULL;
+	while (1)
+	{
+		if (muggle_channel_try_read_multi_reader(chan, &data))
+		{
+			return data;
+		}
+
+		muggle_thread_yield();
+	}
+
+	return NULL;
+}
+static void* muggle_channel_read_multi_reader_adaptive(struct muggle_channel *chan)
+{
+	void *data = NULL;
+	int round = 0;
+	while (1)
+	{
+		if (muggle_channel_try_read_multi_reader(chan, &data))
+		{
+			return data;
+		}
+
+		muggle_atomic_int r_cursor = muggle_atomic_load(&chan->read_cursor, muggle_memory_order_relaxed);
+		muggle_atomic_int w_cursor = muggle_atomic_load(&chan->write_cursor, muggle_memory_order_acquire);
+		if (w_cursor == r_cursor)
+		{
+			muggle_channel_adaptive_wait(chan, &round, w_cursor);
+		}
+		else
+		{
+			muggle_thread_pause();
+		}
+	}
+
+	return NULL;
+}
 
 int muggle_channel_init(muggle_channel_t *chan, muggle_atomic_int capacity, int flags)
+{
+	return muggle_channel_init_with_policy(chan, capacity, flags, NULL);
+}
+
+int muggle_channel_init_with_policy(
+	muggle_channel_t *chan, muggle_atomic_int capacity, int flags, const muggle_page_policy_t *policy)
 {
 	if (capacity <= 0)
 	{
@@ -146,24 +343,62 @@ int muggle_channel_init(muggle_channel_t *chan, muggle_atomic_int capacity, int
 	chan->flags = flags;
 	chan->write_cursor = 0;
 	chan->read_cursor = capacity - 1;
-	chan->write_futex = MUGGLE_CHANNEL_LOCK_STATUS_UNLOCK;
+	chan->read_waiters = 0;
+	chan->spin_cnt = MUGGLE_ADAPTIVE_WAIT_SPIN_CNT;
+	chan->yield_cnt = MUGGLE_ADAPTIVE_WAIT_YIELD_CNT;
 
-	int ret = muggle_mutex_init(&chan->write_mutex);
-	if (ret != MUGGLE_OK)
+	if (muggle_channel_use_write_mutex(flags))
 	{
-		return ret;
+		int ret = muggle_mutex_init(&chan->write_mutex);
+		if (ret != MUGGLE_OK)
+		{
+			return ret;
+		}
+	}
+	else
+	{
+		muggle_fast_mutex_init(&chan->write_futex);
 	}
 
-	chan->blocks = (muggle_channel_block_t*)malloc(sizeof(muggle_channel_block_t) * capacity);
+	chan->blocks = (muggle_channel_block_t*)muggle_page_alloc(sizeof(muggle_channel_block_t) * capacity, policy);
 	if (chan->blocks == NULL)
 	{
-		muggle_mutex_destroy(&chan->write_mutex);
+		if (muggle_channel_use_write_mutex(flags))
+		{
+			muggle_mutex_destroy(&chan->write_mutex);
+		}
 		return MUGGLE_ERR_MEM_ALLOC;
 	}
 
 	for (muggle_atomic_int i = 0; i < capacity; i++)
 	{
 		memset(&chan->blocks[i], 0, sizeof(muggle_channel_block_t));
+		chan->blocks[i].seq = i;
+	}
+
+	if (chan->flags & MUGGLE_CHANNEL_FLAG_MULTI_READER)
+	{
+		// in multiple reader mode, read_cursor point to next slot to read
+		chan->read_cursor = 0;
+
+		chan->fn_write = muggle_channel_write_multi_reader;
+		if (chan->flags & MUGGLE_CHANNEL_FLAG_READ_BUSY_LOOP)
+		{
+			chan->fn_read = muggle_channel_read_multi_reader_busy_loop;
+			chan->fn_wake = muggle_channel_wake_busy_loop;
+		}
+		else if (chan->flags & MUGGLE_CHANNEL_FLAG_READ_ADAPTIVE)
+		{
+			chan->fn_read = muggle_channel_read_multi_reader_adaptive;
+			chan->fn_wake = muggle_channel_wake_adaptive;
+		}
+		else
+		{
+			chan->fn_read = muggle_channel_read_multi_reader_futex;
+			chan->fn_wake = muggle_channel_wake_futex;
+		}
+
+		return MUGGLE_OK;
 	}
 
 	if (chan->flags & MUGGLE_CHANNEL_FLAG_SINGLE_WRITER)
@@ -184,6 +419,11 @@ int muggle_channel_init(muggle_channel_t *chan, muggle_atomic_int capacity, int
 		chan->fn_read = muggle_channel_read_busy_loop;
 		chan->fn_wake = muggle_channel_wake_busy_loop;
 	}
+	else if (chan->flags & MUGGLE_CHANNEL_FLAG_READ_ADAPTIVE)
+	{
+		chan->fn_read = muggle_channel_read_adaptive;
+		chan->fn_wake = muggle_channel_wake_adaptive;
+	}
 	else
 	{
 		chan->fn_read = muggle_channel_read_futex;
@@ -193,15 +433,24 @@ int muggle_channel_init(muggle_channel_t *chan, muggle_atomic_int capacity, int
 	return MUGGLE_OK;
 }
 
+void muggle_channel_set_adaptive_wait(muggle_channel_t *chan, int spin_cnt, int yield_cnt)
+{
+	chan->spin_cnt = spin_cnt < 0 ? 0 : spin_cnt;
+	chan->yield_cnt = yield_cnt < 0 ? 0 : yield_cnt;
+}
+
 void muggle_channel_destroy(muggle_channel_t *chan)
 {
 	if (chan->blocks)
 	{
-		free(chan->blocks);
+		muggle_page_free(chan->blocks);
 		chan->blocks = NULL;
 	}
 
-	muggle_mutex_destroy(&chan->write_mutex);
+	if (muggle_channel_use_write_mutex(chan->flags))
+	{
+		muggle_mutex_destroy(&chan->write_mutex);
+	}
 }
 
 int muggle_channel_write(muggle_channel_t *chan, void *data)
@@ -218,3 +467,53 @@ void* muggle_channel_read(muggle_channel_t *chan)
 {
 	return chan->fn_read(chan);
 }
+
+int muggle_channel_try_read(muggle_channel_t *chan, void **data)
+{
+	int ok = 0;
+	if (chan->flags & MUGGLE_CHANNEL_FLAG_MULTI_READER)
+	{
+		ok = muggle_channel_try_read_multi_reader(chan, data);
+	}
+	else
+	{
+		ok = muggle_channel_try_read_single_reader(chan, data);
+	}
+
+	return ok ? MUGGLE_OK : MUGGLE_ERR_EMPTY;
+}
+
+int muggle_channel_read_timed(muggle_channel_t *chan, const struct timespec *deadline, void **data)
+{
+	struct timespec remain;
+	while (1)
+	{
+		// load write_cursor before try, futex wait return immediately if
+		// any write happened after that
+		muggle_atomic_int w_cursor = muggle_atomic_load(&chan->write_cursor, muggle_memory_order_acquire);
+		if (muggle_channel_try_read(chan, data) == MUGGLE_OK)
+		{
+			return MUGGLE_OK;
+		}
+
+		if (!muggle_deadline_remaining(deadline, &remain))
+		{
+			return MUGGLE_ERR_TIMEOUT;
+		}
+
+		if ((chan->flags & MUGGLE_CHANNEL_FLAG_READ_BUSY_LOOP) ||
+			((chan->flags & MUGGLE_CHANNEL_FLAG_MULTI_READER) &&
+			 muggle_atomic_load(&chan->read_cursor, muggle_memory_order_relaxed) != w_cursor))
+		{
+			muggle_thread_yield();
+			continue;
+		}
+
+		muggle_atomic_fetch_add(&chan->read_waiters, 1, muggle_memory_order_seq_cst);
+		if (muggle_atomic_load(&chan->write_cursor, muggle_memory_order_seq_cst) == w_cursor)
+		{
+			muggle_futex_wait(&chan->write_cursor, w_cursor, &remain);
+		}
+		muggle_atomic_fetch_sub(&chan->read_waiters, 1, muggle_memory_order_relaxed);
+	}
+}
@@ -7,7 +7,8 @@
  *  @license      MIT License
  *  @brief        mugglec channel
  *
- * Passing data between threads, user must gurantee only one reader use channel at the same time
+ * Passing data between threads, user must gurantee only one reader use channel at the same time,
+ * unless MUGGLE_CHANNEL_FLAG_MULTI_READER is set
  * When channel full, write will failed and return enum MUGGLE_ERR_*
  * When channel empty, read will block until data write into channel
  *
@@ -22,6 +23,9 @@
 #include "muggle/c/base/macro.h"
 #include "muggle/c/base/atomic.h"
 #include "muggle/c/sync/mutex.h"
+#include "muggle/c/sync/fast_mutex.h"
+#include "muggle/c/memory/page_provider.h"
+#include <time.h>
 
 EXTERN_C_BEGIN
 
@@ -32,13 +36,9 @@ enum
 
 	MUGGLE_CHANNEL_FLAG_SINGLE_WRITER  = 0x01, //!< user guarantee only one writer use this channel
 	MUGGLE_CHANNEL_FLAG_READ_BUSY_LOOP = 0x02, //!< reader busy loop until read message from channel
-	MUGGLE_CHANNEL_FLAG_WRITE_FUTEX    = 0x04, //!< write lock use futex
-};
-
-enum
-{
-	MUGGLE_CHANNEL_LOCK_STATUS_UNLOCK,
-	MUGGLE_CHANNEL_LOCK_STATUS_LOCK,
+	MUGGLE_CHANNEL_FLAG_WRITE_FUTEX    = 0x04, //!< write lock use muggle_fast_mutex_t
+	MUGGLE_CHANNEL_FLAG_MULTI_READER   = 0x08, //!< multiple writers and readers, both sides use CAS only, write lock flags are ignored
+	MUGGLE_CHANNEL_FLAG_READ_ADAPTIVE  = 0x10, //!< reader spin, then yield, then futex wait; writer only wake when reader parked
 };
 
 /**
@@ -47,6 +47,7 @@ enum
 typedef struct muggle_channel_block
 {
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	muggle_atomic_int seq; //!< sequence number, only use in MUGGLE_CHANNEL_FLAG_MULTI_READER
 	void *data;
 }muggle_channel_block_t;
 
@@ -66,14 +67,20 @@ typedef struct muggle_channel
 	fn_muggle_channel_write fn_write;
 	fn_muggle_channel_read  fn_read;
 	fn_muggle_channel_wake  fn_wake;
+	int                     spin_cnt;   //!< spin round for MUGGLE_CHANNEL_FLAG_READ_ADAPTIVE
+	int                     yield_cnt;  //!< yield round for MUGGLE_CHANNEL_FLAG_READ_ADAPTIVE
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
 	muggle_atomic_int write_cursor;
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(2);
 	muggle_atomic_int read_cursor;
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(3);
-	muggle_atomic_int write_futex;
+	muggle_atomic_int read_waiters; //!< number of parked readers
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(4);
-	muggle_mutex_t write_mutex;
+	union
+	{
+		muggle_mutex_t      write_mutex; //!< MUGGLE_CHANNEL_FLAG_WRITE_MUTEX
+		muggle_fast_mutex_t write_futex; //!< MUGGLE_CHANNEL_FLAG_WRITE_FUTEX
+	};
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(5);
 	muggle_channel_block_t *blocks;
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(6);
@@ -93,6 +100,35 @@ typedef struct muggle_channel
 MUGGLE_C_EXPORT
 int muggle_channel_init(muggle_channel_t *chan, muggle_atomic_int capacity, int flags);
 
+/**
+ * @brief init muggle_channel_t with allocation policy of blocks
+ *
+ * @param chan      pointer to muggle_channel_t
+ * @param capacity  capacity of channel
+ * @param flags     bitwise or of MUGGLE_CHANNEL_FLAG_*
+ * @param policy    allocation policy of blocks, if it's NULL, use malloc
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_channel_init_with_policy(
+	muggle_channel_t *chan, muggle_atomic_int capacity, int flags, const muggle_page_policy_t *policy);
+
+/**
+ * @brief set spin and yield round of adaptive reader
+ *
+ * only take effect when MUGGLE_CHANNEL_FLAG_READ_ADAPTIVE is set, reader spin
+ * spin_cnt times with cpu pause, then yield yield_cnt times, then futex wait
+ *
+ * @param chan       pointer to muggle_channel_t
+ * @param spin_cnt   spin round
+ * @param yield_cnt  yield round
+ */
+MUGGLE_C_EXPORT
+void muggle_channel_set_adaptive_wait(muggle_channel_t *chan, int spin_cnt, int yield_cnt);
+
 /**
  * @brief destroy muggle_channel_t
  *
@@ -124,6 +160,33 @@ int muggle_channel_write(muggle_channel_t *chan, void *data);
 MUGGLE_C_EXPORT
 void* muggle_channel_read(muggle_channel_t *chan);
 
+/**
+ * @brief read data from channel without wait
+ *
+ * @param chan  pointer to muggle_channel_t
+ * @param data  output data pointer
+ *
+ * @return
+ *     - return 0 on success
+ *     - return MUGGLE_ERR_EMPTY when channel is empty
+ */
+MUGGLE_C_EXPORT
+int muggle_channel_try_read(muggle_channel_t *chan, void **data);
+
+/**
+ * @brief read data from channel, wait until deadline when channel is empty
+ *
+ * @param chan      pointer to muggle_channel_t
+ * @param deadline  absolute deadline, see muggle/c/time/deadline.h
+ * @param data      output data pointer
+ *
+ * @return
+ *     - return 0 on success
+ *     - return MUGGLE_ERR_TIMEOUT when deadline is reached
+ */
+MUGGLE_C_EXPORT
+int muggle_channel_read_timed(muggle_channel_t *chan, const struct timespec *deadline, void **data);
+
 EXTERN_C_END
 
 #endif
@@ -10,6 +10,7 @@
 
 #include "condition_variable.h"
 #include "muggle/c/base/err.h"
+#include "muggle/c/time/deadline.h"
 
 #if MUGGLE_PLATFORM_WINDOWS
 
@@ -45,6 +46,27 @@ int muggle_condition_variable_wait(muggle_condition_variable_t *cv, muggle_mutex
 	return ret ? MUGGLE_OK : MUGGLE_ERR_SYS_CALL;
 }
 
+int muggle_condition_variable_wait_until(muggle_condition_variable_t *cv, muggle_mutex_t *mutex, const struct timespec *deadline)
+{
+	struct timespec remain;
+	if (!muggle_deadline_remaining(deadline, &remain))
+	{
+		return MUGGLE_ERR_TIMEOUT;
+	}
+
+	DWORD ms = remain.tv_nsec / 1000000;
+	if (ms == 0 && remain.tv_nsec != 0)
+	{
+		ms = 1;
+	}
+	DWORD dwMilliseconds = (DWORD)(remain.tv_sec * 1000 + ms);
+	if (SleepConditionVariableCS(&cv->cond_var, &mutex->cs, dwMilliseconds))
+	{
+		return MUGGLE_OK;
+	}
+	return GetLastError() == ERROR_TIMEOUT ? MUGGLE_ERR_TIMEOUT : MUGGLE_ERR_SYS_CALL;
+}
+
 int muggle_condition_variable_notify_one(muggle_condition_variable_t *cv)
 {
 	WakeConditionVariable(&cv->cond_var);
@@ -61,12 +83,61 @@ int muggle_condition_variable_notify_all(muggle_condition_variable_t *cv)
 
 #include <errno.h>
 
+// pthread_condattr_setclock is not available on apple
+#if MUGGLE_PLATFORM_APPLE
+	#define MUGGLE_CONDITION_VARIABLE_MONOTONIC 0
+#else
+	#define MUGGLE_CONDITION_VARIABLE_MONOTONIC 1
+#endif
+
 int muggle_condition_variable_init(muggle_condition_variable_t *cv)
 {
+#if MUGGLE_CONDITION_VARIABLE_MONOTONIC
+	// wait on deadline clock, so wall clock change not affect timeout
+	pthread_condattr_t attr;
+	if (pthread_condattr_init(&attr) != 0)
+	{
+		return MUGGLE_ERR_SYS_CALL;
+	}
+	int ret = pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	if (ret == 0)
+	{
+		ret = pthread_cond_init(&cv->cond_var, &attr);
+	}
+	pthread_condattr_destroy(&attr);
+#else
 	int ret = pthread_cond_init(&cv->cond_var, NULL);
+#endif
 	return ret == 0 ? MUGGLE_OK : MUGGLE_ERR_SYS_CALL;
 }
 
+/**
+ * @brief convert absolute time of clock_from to absolute time of clock_to
+ */
+static void muggle_condition_variable_convert_clock(
+	clockid_t clock_from, const struct timespec *ts, clockid_t clock_to, struct timespec *out)
+{
+	struct timespec now_from, now_to;
+	clock_gettime(clock_from, &now_from);
+	clock_gettime(clock_to, &now_to);
+
+	time_t sec = ts->tv_sec - now_from.tv_sec;
+	long nsec = ts->tv_nsec - now_from.tv_nsec;
+	if (nsec < 0)
+	{
+		sec -= 1;
+		nsec += 1000000000;
+	}
+
+	out->tv_sec = now_to.tv_sec + sec;
+	out->tv_nsec = now_to.tv_nsec + nsec;
+	if (out->tv_nsec >= 1000000000)
+	{
+		out->tv_sec += 1;
+		out->tv_nsec -= 1000000000;
+	}
+}
+
 int muggle_condition_variable_destroy(muggle_condition_variable_t *cv)
 {
 	int ret = pthread_cond_destroy(&cv->cond_var);
@@ -83,7 +154,14 @@ int muggle_condition_variable_wait(muggle_condition_variable_t *cv, muggle_mutex
 	}
 	else
 	{
+#if MUGGLE_CONDITION_VARIABLE_MONOTONIC
+		// timeout is absolute realtime
+		struct timespec abstime;
+		muggle_condition_variable_convert_clock(CLOCK_REALTIME, timeout, CLOCK_MONOTONIC, &abstime);
+		ret = pthread_cond_timedwait(&cv->cond_var, &mutex->mtx, &abstime);
+#else
 		ret = pthread_cond_timedwait(&cv->cond_var, &mutex->mtx, timeout);
+#endif
 		if (ret == 0 || ret == ETIMEDOUT)
 		{
 			return MUGGLE_OK;
@@ -92,6 +170,30 @@ int muggle_condition_variable_wait(muggle_condition_variable_t *cv, muggle_mutex
 	}
 }
 
+int muggle_condition_variable_wait_until(muggle_condition_variable_t *cv, muggle_mutex_t *mutex, const struct timespec *deadline)
+{
+	if (!muggle_deadline_remaining(deadline, NULL))
+	{
+		return MUGGLE_ERR_TIMEOUT;
+	}
+
+#if MUGGLE_CONDITION_VARIABLE_MONOTONIC
+	// condition variable use the same monotonic clock as deadline
+	const struct timespec *p_abstime = deadline;
+#else
+	struct timespec abstime;
+	muggle_condition_variable_convert_clock(CLOCK_MONOTONIC, deadline, CLOCK_REALTIME, &abstime);
+	const struct timespec *p_abstime = &abstime;
+#endif
+
+	int ret = pthread_cond_timedwait(&cv->cond_var, &mutex->mtx, p_abstime);
+	if (ret == 0)
+	{
+		return MUGGLE_OK;
+	}
+	return ret == ETIMEDOUT ? MUGGLE_ERR_TIMEOUT : MUGGLE_ERR_SYS_CALL;
+}
+
 int muggle_condition_variable_notify_one(muggle_condition_variable_t *cv)
 {
 	int ret = pthread_cond_signal(&cv->cond_var);
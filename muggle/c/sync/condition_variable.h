@@ -72,6 +72,22 @@ int muggle_condition_variable_destroy(muggle_condition_variable_t *cv);
 MUGGLE_C_EXPORT
 int muggle_condition_variable_wait(muggle_condition_variable_t *cv, muggle_mutex_t *mutex, const struct timespec *timeout);
 
+/**
+ * @brief current thread block until condition variable is notified or
+ * deadline is reached
+ *
+ * @param cv        condition variable pointer
+ * @param mutex     mutex pointer
+ * @param deadline  absolute deadline, see muggle/c/time/deadline.h
+ *
+ * @return
+ *     - return 0 when notified
+ *     - return MUGGLE_ERR_TIMEOUT when deadline is reached
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_condition_variable_wait_until(muggle_condition_variable_t *cv, muggle_mutex_t *mutex, const struct timespec *deadline);
+
 /**
  * @brief notify one waiting thread
  *
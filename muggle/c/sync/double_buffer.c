@@ -12,14 +12,179 @@
 #include <stdlib.h>
 #include <string.h>
 #include "muggle/c/base/err.h"
+#include "muggle/c/base/thread.h"
+#include "muggle/c/sync/futex.h"
+#include "muggle/c/time/deadline.h"
+
+static void muggle_double_buffer_swap(muggle_double_buffer_t *buf)
+{
+	buf->front->cnt = 0;
+	muggle_single_buffer_t *tmp = buf->front;
+	buf->front = buf->back;
+	buf->back = tmp;
+
+	muggle_condition_variable_notify_one(&buf->cv_not_full);
+}
+
+/***************** lockfree *****************/
+// register as waiter, recheck futex value and wait
+static void muggle_double_buffer_park(
+	muggle_atomic_int *futex_addr, muggle_atomic_int val,
+	muggle_atomic_int *waiters, const struct timespec *timeout)
+{
+	muggle_atomic_fetch_add(waiters, 1, muggle_memory_order_seq_cst);
+	if (muggle_atomic_load(futex_addr, muggle_memory_order_seq_cst) == val)
+	{
+		muggle_futex_wait(futex_addr, val, timeout);
+	}
+	muggle_atomic_fetch_sub(waiters, 1, muggle_memory_order_relaxed);
+}
+
+// when wait is 0, only try once; when deadline is NULL, wait until success
+static int muggle_double_buffer_lockfree_write(
+	muggle_double_buffer_t *buf, void *data, int wait, const struct timespec *deadline)
+{
+	struct timespec remain;
+	const struct timespec *timeout = NULL;
+	while (1)
+	{
+		muggle_atomic_int seq = muggle_atomic_load(&buf->swap_seq, muggle_memory_order_acquire);
+		int idx = seq & 1;
+		// only claim while buffer has room, failed write never move reserve
+		// count, so it can't overflow or run into sealed range
+		muggle_atomic_int pos = muggle_atomic_load(&buf->reserve[idx], muggle_memory_order_relaxed);
+		while (pos < buf->capacity &&
+			!muggle_atomic_cmp_exch_weak(&buf->reserve[idx], &pos, pos + 1, muggle_memory_order_relaxed))
+		{
+		}
+		if (pos < buf->capacity)
+		{
+			buf->buf[idx].datas[pos] = data;
+			if (muggle_atomic_fetch_add(&buf->commit[idx], 1, muggle_memory_order_release) == 0)
+			{
+				// reader only park when back buffer is empty, pair with
+				// read_waiters increase in muggle_double_buffer_park
+				muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+				if (muggle_atomic_load(&buf->read_waiters, muggle_memory_order_relaxed) > 0)
+				{
+					muggle_futex_wake_one(&buf->commit[idx]);
+				}
+			}
+			return MUGGLE_OK;
+		}
+
+		if (pos >= MUGGLE_DOUBLE_BUFFER_SEALED)
+		{
+			// reader already swapped this buffer out, retry with new back buffer
+			continue;
+		}
+
+		if (buf->non_blocking || !wait)
+		{
+			return MUGGLE_ERR_FULL;
+		}
+
+		if (deadline)
+		{
+			if (!muggle_deadline_remaining(deadline, &remain))
+			{
+				return MUGGLE_ERR_TIMEOUT;
+			}
+			timeout = &remain;
+		}
+
+		muggle_double_buffer_park(&buf->swap_seq, seq, &buf->write_waiters, timeout);
+	}
+}
+
+// swap front and back, wait writers that claimed slot in back buffer
+static muggle_single_buffer_t* muggle_double_buffer_lockfree_swap(muggle_double_buffer_t *buf)
+{
+	muggle_atomic_int seq = buf->swap_seq;
+	int back_idx = seq & 1;
+	int front_idx = back_idx ^ 1;
+
+	// front buffer was consumed, reset it and make it back buffer
+	buf->buf[front_idx].cnt = 0;
+	muggle_atomic_store(&buf->commit[front_idx], 0, muggle_memory_order_relaxed);
+	muggle_atomic_store(&buf->reserve[front_idx], 0, muggle_memory_order_relaxed);
+	muggle_atomic_store(&buf->swap_seq, seq + 1, muggle_memory_order_release);
+
+	// seal old back buffer, writers claim after this point will retry
+	muggle_atomic_int cnt = muggle_atomic_fetch_add(
+		&buf->reserve[back_idx], MUGGLE_DOUBLE_BUFFER_SEALED, muggle_memory_order_acq_rel);
+	if (cnt > buf->capacity)
+	{
+		cnt = buf->capacity;
+	}
+	while (muggle_atomic_load(&buf->commit[back_idx], muggle_memory_order_acquire) != cnt)
+	{
+		muggle_thread_yield();
+	}
+
+	buf->buf[back_idx].cnt = cnt;
+	buf->front = &buf->buf[back_idx];
+	buf->back = &buf->buf[front_idx];
+
+	// pair with write_waiters increase in muggle_double_buffer_park
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	if (muggle_atomic_load(&buf->write_waiters, muggle_memory_order_relaxed) > 0)
+	{
+		muggle_futex_wake_all(&buf->swap_seq);
+	}
+
+	return buf->front;
+}
+
+// when wait is 0, only try once; when deadline is NULL, wait until success
+static muggle_single_buffer_t* muggle_double_buffer_lockfree_read(
+	muggle_double_buffer_t *buf, int wait, const struct timespec *deadline)
+{
+	struct timespec remain;
+	const struct timespec *timeout = NULL;
+	int back_idx = buf->swap_seq & 1;
+	while (muggle_atomic_load(&buf->commit[back_idx], muggle_memory_order_acquire) == 0)
+	{
+		if (!wait)
+		{
+			return NULL;
+		}
+
+		if (deadline)
+		{
+			if (!muggle_deadline_remaining(deadline, &remain))
+			{
+				return NULL;
+			}
+			timeout = &remain;
+		}
+
+		muggle_double_buffer_park(&buf->commit[back_idx], 0, &buf->read_waiters, timeout);
+	}
+
+	return muggle_double_buffer_lockfree_swap(buf);
+}
 
 int muggle_double_buffer_init(muggle_double_buffer_t *buf, int capacity, int non_blocking)
+{
+	return muggle_double_buffer_init_ex(buf, capacity, non_blocking, MUGGLE_DOUBLE_BUFFER_FLAG_LOCK);
+}
+
+int muggle_double_buffer_init_ex(muggle_double_buffer_t *buf, int capacity, int non_blocking, int flags)
 {
 	memset(buf, 0, sizeof(muggle_double_buffer_t));
-	if (capacity <= 0)
+	if (capacity <= 0 || capacity >= MUGGLE_DOUBLE_BUFFER_SEALED)
 	{
 		return MUGGLE_ERR_INVALID_PARAM;
 	}
+	buf->flags = flags;
+	buf->swap_seq = 0;
+	buf->reserve[0] = 0;
+	buf->reserve[1] = 0;
+	buf->commit[0] = 0;
+	buf->commit[1] = 0;
+	buf->read_waiters = 0;
+	buf->write_waiters = 0;
 	buf->capacity = capacity;
 	for (int i = 0; i < 2; ++i)
 	{
@@ -35,8 +200,16 @@ int muggle_double_buffer_init(muggle_double_buffer_t *buf, int capacity, int non
 			return MUGGLE_ERR_MEM_ALLOC;
 		}
 	}
-	buf->front = &buf->buf[0];
-	buf->back = &buf->buf[1];
+	if (flags & MUGGLE_DOUBLE_BUFFER_FLAG_LOCKFREE)
+	{
+		buf->front = &buf->buf[1];
+		buf->back = &buf->buf[0];
+	}
+	else
+	{
+		buf->front = &buf->buf[0];
+		buf->back = &buf->buf[1];
+	}
 	buf->non_blocking = non_blocking;
 
 	int ret = 0;
@@ -74,6 +247,11 @@ int muggle_double_buffer_destroy(muggle_double_buffer_t *buf)
 
 int muggle_double_buffer_write(muggle_double_buffer_t *buf, void *data)
 {
+	if (buf->flags & MUGGLE_DOUBLE_BUFFER_FLAG_LOCKFREE)
+	{
+		return muggle_double_buffer_lockfree_write(buf, data, 1, NULL);
+	}
+
 	int ret = 0;
 	ret = muggle_mutex_lock(&buf->mutex);
 	if (ret != MUGGLE_OK)
@@ -103,6 +281,11 @@ int muggle_double_buffer_write(muggle_double_buffer_t *buf, void *data)
 
 muggle_single_buffer_t* muggle_double_buffer_read(muggle_double_buffer_t *buf)
 {
+	if (buf->flags & MUGGLE_DOUBLE_BUFFER_FLAG_LOCKFREE)
+	{
+		return muggle_double_buffer_lockfree_read(buf, 1, NULL);
+	}
+
 	int ret = 0;
 	ret = muggle_mutex_lock(&buf->mutex);
 	if (ret != MUGGLE_OK)
@@ -115,12 +298,102 @@ muggle_single_buffer_t* muggle_double_buffer_read(muggle_double_buffer_t *buf)
 		muggle_condition_variable_wait(&buf->cv_not_empty, &buf->mutex, NULL);
 	}
 
-	buf->front->cnt = 0;
-	muggle_single_buffer_t *tmp = buf->front;
-	buf->front = buf->back;
-	buf->back = tmp;
+	muggle_double_buffer_swap(buf);
+	muggle_mutex_unlock(&buf->mutex);
 
-	muggle_condition_variable_notify_one(&buf->cv_not_full);
+	return buf->front;
+}
+
+int muggle_double_buffer_write_timed(muggle_double_buffer_t *buf, void *data, const struct timespec *deadline)
+{
+	if (buf->flags & MUGGLE_DOUBLE_BUFFER_FLAG_LOCKFREE)
+	{
+		return muggle_double_buffer_lockfree_write(buf, data, 1, deadline);
+	}
+
+	int ret = 0;
+	ret = muggle_mutex_lock(&buf->mutex);
+	if (ret != MUGGLE_OK)
+	{
+		return ret;
+	}
+
+	muggle_single_buffer_t *p_back = buf->back;
+	while (p_back->cnt == buf->capacity)
+	{
+		if (buf->non_blocking)
+		{
+			muggle_mutex_unlock(&buf->mutex);
+			return MUGGLE_ERR_FULL;
+		}
+		ret = muggle_condition_variable_wait_until(&buf->cv_not_full, &buf->mutex, deadline);
+		p_back = buf->back;
+		if (ret != MUGGLE_OK && p_back->cnt == buf->capacity)
+		{
+			muggle_mutex_unlock(&buf->mutex);
+			return ret;
+		}
+	}
+
+	p_back->datas[p_back->cnt++] = data;
+
+	muggle_condition_variable_notify_one(&buf->cv_not_empty);
+	muggle_mutex_unlock(&buf->mutex);
+
+	return MUGGLE_OK;
+}
+
+muggle_single_buffer_t* muggle_double_buffer_try_read(muggle_double_buffer_t *buf)
+{
+	if (buf->flags & MUGGLE_DOUBLE_BUFFER_FLAG_LOCKFREE)
+	{
+		return muggle_double_buffer_lockfree_read(buf, 0, NULL);
+	}
+
+	int ret = 0;
+	ret = muggle_mutex_lock(&buf->mutex);
+	if (ret != MUGGLE_OK)
+	{
+		return NULL;
+	}
+
+	if (buf->back->cnt == 0)
+	{
+		muggle_mutex_unlock(&buf->mutex);
+		return NULL;
+	}
+
+	muggle_double_buffer_swap(buf);
+	muggle_mutex_unlock(&buf->mutex);
+
+	return buf->front;
+}
+
+muggle_single_buffer_t* muggle_double_buffer_read_timed(muggle_double_buffer_t *buf, const struct timespec *deadline)
+{
+	if (buf->flags & MUGGLE_DOUBLE_BUFFER_FLAG_LOCKFREE)
+	{
+		return muggle_double_buffer_lockfree_read(buf, 1, deadline);
+	}
+
+	int ret = 0;
+	ret = muggle_mutex_lock(&buf->mutex);
+	if (ret != MUGGLE_OK)
+	{
+		return NULL;
+	}
+
+	while (buf->back->cnt == 0)
+	{
+		ret = muggle_condition_variable_wait_until(&buf->cv_not_empty, &buf->mutex, deadline);
+		if (ret != MUGGLE_OK && buf->back->cnt == 0)
+		{
+			muggle_mutex_unlock(&buf->mutex);
+			return NULL;
+		}
+	}
+
+	muggle_double_buffer_swap(buf);
 	muggle_mutex_unlock(&buf->mutex);
 
 	return buf->front;
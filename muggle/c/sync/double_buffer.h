@@ -15,11 +15,21 @@
 #define MUGGLE_C_DOUBLE_BUFFER_H_
 
 #include "muggle/c/base/macro.h"
+#include "muggle/c/base/atomic.h"
 #include "muggle/c/sync/mutex.h"
 #include "muggle/c/sync/condition_variable.h"
 
 EXTERN_C_BEGIN
 
+enum
+{
+	MUGGLE_DOUBLE_BUFFER_FLAG_LOCK     = 0x00, //!< default, every write take mutex
+	MUGGLE_DOUBLE_BUFFER_FLAG_LOCKFREE = 0x01, //!< writers claim slot with atomic index, reader swap buffer atomically
+};
+
+// added into reserve count of buffer when reader swap it out
+#define MUGGLE_DOUBLE_BUFFER_SEALED (1 << 30)
+
 /**
  * @brief buffer in double buffer
  */
@@ -42,6 +52,19 @@ typedef struct muggle_double_buffer_tag
 	muggle_mutex_t mutex;
 	muggle_condition_variable_t cv_not_empty;
 	muggle_condition_variable_t cv_not_full;
+
+	// lockfree mode
+	int flags;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	muggle_atomic_int swap_seq;      //!< index of back buffer is (swap_seq & 1)
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
+	muggle_atomic_int reserve[2];    //!< number of slots claimed by writers
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(2);
+	muggle_atomic_int commit[2];     //!< number of slots written
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(3);
+	muggle_atomic_int read_waiters;  //!< number of parked readers
+	muggle_atomic_int write_waiters; //!< number of parked writers
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(4);
 }muggle_double_buffer_t;
 
 /**
@@ -58,6 +81,25 @@ typedef struct muggle_double_buffer_tag
 MUGGLE_C_EXPORT
 int muggle_double_buffer_init(muggle_double_buffer_t *buf, int capacity, int non_blocking);
 
+/**
+ * @brief initialize double buffer with flags
+ *
+ * in MUGGLE_DOUBLE_BUFFER_FLAG_LOCKFREE mode, writers append into back buffer
+ * without mutex, and reader swap front/back with atomic operation, so only one
+ * reader is allowed
+ *
+ * @param buf           double buffer pointer
+ * @param capacity      initialized capacity for double buffer
+ * @param non_blocking  double buffer is blocking
+ * @param flags         bitwise or of MUGGLE_DOUBLE_BUFFER_FLAG_*
+ *
+ * @return 
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_double_buffer_init_ex(muggle_double_buffer_t *buf, int capacity, int non_blocking, int flags);
+
 /**
  * @brief destroy double buffer
  *
@@ -93,6 +135,43 @@ int muggle_double_buffer_write(muggle_double_buffer_t *buf, void *data);
 MUGGLE_C_EXPORT
 muggle_single_buffer_t* muggle_double_buffer_read(muggle_double_buffer_t *buf);
 
+/**
+ * @brief write data into double buffer, wait until deadline when buffer is full
+ *
+ * @param buf       double buffer pointer
+ * @param data      data pointer
+ * @param deadline  absolute deadline, see muggle/c/time/deadline.h
+ *
+ * @return
+ *     - return 0 on success
+ *     - return MUGGLE_ERR_FULL when buffer is full in non blocking mode
+ *     - return MUGGLE_ERR_TIMEOUT when deadline is reached
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_double_buffer_write_timed(muggle_double_buffer_t *buf, void *data, const struct timespec *deadline);
+
+/**
+ * @brief swap buffer and return buffer for read without wait
+ *
+ * @param buf   double buffer pointer
+ *
+ * @return buffer in double buffer that need to read, NULL when no data
+ */
+MUGGLE_C_EXPORT
+muggle_single_buffer_t* muggle_double_buffer_try_read(muggle_double_buffer_t *buf);
+
+/**
+ * @brief swap buffer and return buffer for read, wait until deadline when no data
+ *
+ * @param buf       double buffer pointer
+ * @param deadline  absolute deadline, see muggle/c/time/deadline.h
+ *
+ * @return buffer in double buffer that need to read, NULL when deadline is reached
+ */
+MUGGLE_C_EXPORT
+muggle_single_buffer_t* muggle_double_buffer_read_timed(muggle_double_buffer_t *buf, const struct timespec *deadline);
+
 EXTERN_C_END
 
 #endif
@@ -0,0 +1,89 @@
+/******************************************************************************
+ *  @file         fast_condition_variable.c
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec fast condition variable
+ *****************************************************************************/
+
+#include "fast_condition_variable.h"
+#include "muggle/c/base/err.h"
+#include "muggle/c/sync/futex.h"
+#include "muggle/c/time/deadline.h"
+
+// relock mutex after wakeup, other notified waiters may wait on the mutex,
+// so always mark it contended
+static void muggle_fast_condition_variable_relock(muggle_fast_mutex_t *mutex)
+{
+	while (muggle_atomic_exchange(&mutex->status,
+			MUGGLE_FAST_MUTEX_STATUS_CONTENDED, muggle_memory_order_acquire) !=
+		MUGGLE_FAST_MUTEX_STATUS_UNLOCK)
+	{
+		muggle_futex_wait(&mutex->status, MUGGLE_FAST_MUTEX_STATUS_CONTENDED, NULL);
+	}
+}
+
+int muggle_fast_condition_variable_init(muggle_fast_condition_variable_t *cv)
+{
+	muggle_atomic_store(&cv->seq, 0, muggle_memory_order_relaxed);
+	return MUGGLE_OK;
+}
+
+int muggle_fast_condition_variable_destroy(muggle_fast_condition_variable_t *cv)
+{
+	// fast condition variable hold no resource
+	(void)cv;
+	return MUGGLE_OK;
+}
+
+int muggle_fast_condition_variable_wait(
+	muggle_fast_condition_variable_t *cv, muggle_fast_mutex_t *mutex, const struct timespec *timeout)
+{
+	muggle_atomic_int seq = muggle_atomic_load(&cv->seq, muggle_memory_order_relaxed);
+
+	muggle_fast_mutex_unlock(mutex);
+	muggle_futex_wait(&cv->seq, seq, timeout);
+	muggle_fast_condition_variable_relock(mutex);
+
+	return MUGGLE_OK;
+}
+
+int muggle_fast_condition_variable_wait_until(
+	muggle_fast_condition_variable_t *cv, muggle_fast_mutex_t *mutex, const struct timespec *deadline)
+{
+	struct timespec remain;
+	if (!muggle_deadline_remaining(deadline, &remain))
+	{
+		return MUGGLE_ERR_TIMEOUT;
+	}
+
+	muggle_atomic_int seq = muggle_atomic_load(&cv->seq, muggle_memory_order_relaxed);
+
+	muggle_fast_mutex_unlock(mutex);
+	muggle_futex_wait(&cv->seq, seq, &remain);
+	muggle_fast_condition_variable_relock(mutex);
+
+	if (muggle_atomic_load(&cv->seq, muggle_memory_order_relaxed) == seq &&
+		!muggle_deadline_remaining(deadline, NULL))
+	{
+		return MUGGLE_ERR_TIMEOUT;
+	}
+
+	return MUGGLE_OK;
+}
+
+int muggle_fast_condition_variable_notify_one(muggle_fast_condition_variable_t *cv)
+{
+	muggle_atomic_fetch_add(&cv->seq, 1, muggle_memory_order_release);
+	muggle_futex_wake_one(&cv->seq);
+	return MUGGLE_OK;
+}
+
+int muggle_fast_condition_variable_notify_all(muggle_fast_condition_variable_t *cv)
+{
+	muggle_atomic_fetch_add(&cv->seq, 1, muggle_memory_order_release);
+	muggle_futex_wake_all(&cv->seq);
+	return MUGGLE_OK;
+}
@@ -0,0 +1,116 @@
+/******************************************************************************
+ *  @file         fast_condition_variable.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec fast condition variable
+ *
+ * A futex based condition variable work with muggle_fast_mutex_t, it only
+ * occupy one int. Waiter record sequence before release mutex and wait on
+ * it, notify bump sequence, so a notify between unlock and futex wait is
+ * not lost. Like other condition variables, spurious wakeup may happen.
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_FAST_CONDITION_VARIABLE_H_
+#define MUGGLE_C_FAST_CONDITION_VARIABLE_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/base/atomic.h"
+#include <time.h>
+#include "muggle/c/sync/fast_mutex.h"
+
+EXTERN_C_BEGIN
+
+/**
+ * @brief fast condition variable
+ */
+typedef struct muggle_fast_condition_variable
+{
+	muggle_atomic_int seq; //!< notify sequence
+}muggle_fast_condition_variable_t;
+
+/**
+ * @brief initialize fast condition variable
+ *
+ * @param cv  fast condition variable pointer
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_fast_condition_variable_init(muggle_fast_condition_variable_t *cv);
+
+/**
+ * @brief destroy fast condition variable
+ *
+ * @param cv  fast condition variable pointer
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_fast_condition_variable_destroy(muggle_fast_condition_variable_t *cv);
+
+/**
+ * @brief current thread block until condition variable is notified
+ *
+ * @param cv       fast condition variable pointer
+ * @param mutex    fast mutex pointer, must be locked by current thread
+ * @param timeout  relative timeout, NULL represent wait forever
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_fast_condition_variable_wait(
+	muggle_fast_condition_variable_t *cv, muggle_fast_mutex_t *mutex, const struct timespec *timeout);
+
+/**
+ * @brief current thread block until condition variable is notified or
+ * deadline is reached
+ *
+ * @param cv        fast condition variable pointer
+ * @param mutex     fast mutex pointer, must be locked by current thread
+ * @param deadline  absolute deadline, see muggle/c/time/deadline.h
+ *
+ * @return
+ *     - return 0 when notified
+ *     - return MUGGLE_ERR_TIMEOUT when deadline is reached
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_fast_condition_variable_wait_until(
+	muggle_fast_condition_variable_t *cv, muggle_fast_mutex_t *mutex, const struct timespec *deadline);
+
+/**
+ * @brief notify one waiting thread
+ *
+ * @param cv  fast condition variable pointer
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_fast_condition_variable_notify_one(muggle_fast_condition_variable_t *cv);
+
+/**
+ * @brief notify all waiting thread
+ *
+ * @param cv  fast condition variable pointer
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_fast_condition_variable_notify_all(muggle_fast_condition_variable_t *cv);
+
+EXTERN_C_END
+
+#endif
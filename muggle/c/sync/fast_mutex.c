@@ -0,0 +1,89 @@
+/******************************************************************************
+ *  @file         fast_mutex.c
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec fast mutex
+ *****************************************************************************/
+
+#include "fast_mutex.h"
+#include "muggle/c/base/err.h"
+#include "muggle/c/base/thread.h"
+#include "muggle/c/sync/futex.h"
+
+int muggle_fast_mutex_init(muggle_fast_mutex_t *mutex)
+{
+	muggle_atomic_store(&mutex->status, MUGGLE_FAST_MUTEX_STATUS_UNLOCK, muggle_memory_order_relaxed);
+	return MUGGLE_OK;
+}
+
+int muggle_fast_mutex_destroy(muggle_fast_mutex_t *mutex)
+{
+	// fast mutex hold no resource
+	(void)mutex;
+	return MUGGLE_OK;
+}
+
+int muggle_fast_mutex_lock(muggle_fast_mutex_t *mutex)
+{
+	muggle_atomic_int status = MUGGLE_FAST_MUTEX_STATUS_UNLOCK;
+	if (muggle_atomic_cmp_exch_strong(&mutex->status, &status,
+			MUGGLE_FAST_MUTEX_STATUS_LOCK, muggle_memory_order_acquire))
+	{
+		return MUGGLE_OK;
+	}
+
+	// bounded spin, lock holder usually release soon
+	for (int i = 0; i < MUGGLE_FAST_MUTEX_SPIN_CNT; i++)
+	{
+		if (status == MUGGLE_FAST_MUTEX_STATUS_CONTENDED)
+		{
+			break;
+		}
+
+		muggle_thread_pause();
+
+		status = MUGGLE_FAST_MUTEX_STATUS_UNLOCK;
+		if (muggle_atomic_cmp_exch_strong(&mutex->status, &status,
+				MUGGLE_FAST_MUTEX_STATUS_LOCK, muggle_memory_order_acquire))
+		{
+			return MUGGLE_OK;
+		}
+	}
+
+	// mark contended before wait, so the holder know need to wake
+	status = muggle_atomic_exchange(&mutex->status,
+		MUGGLE_FAST_MUTEX_STATUS_CONTENDED, muggle_memory_order_acquire);
+	while (status != MUGGLE_FAST_MUTEX_STATUS_UNLOCK)
+	{
+		muggle_futex_wait(&mutex->status, MUGGLE_FAST_MUTEX_STATUS_CONTENDED, NULL);
+		status = muggle_atomic_exchange(&mutex->status,
+			MUGGLE_FAST_MUTEX_STATUS_CONTENDED, muggle_memory_order_acquire);
+	}
+
+	return MUGGLE_OK;
+}
+
+int muggle_fast_mutex_trylock(muggle_fast_mutex_t *mutex)
+{
+	muggle_atomic_int status = MUGGLE_FAST_MUTEX_STATUS_UNLOCK;
+	if (!muggle_atomic_cmp_exch_strong(&mutex->status, &status,
+			MUGGLE_FAST_MUTEX_STATUS_LOCK, muggle_memory_order_acquire))
+	{
+		return MUGGLE_ERR_ACQ_LOCK;
+	}
+	return MUGGLE_OK;
+}
+
+int muggle_fast_mutex_unlock(muggle_fast_mutex_t *mutex)
+{
+	// only system call when someone may be waiting
+	if (muggle_atomic_exchange(&mutex->status, MUGGLE_FAST_MUTEX_STATUS_UNLOCK,
+			muggle_memory_order_release) == MUGGLE_FAST_MUTEX_STATUS_CONTENDED)
+	{
+		muggle_futex_wake_one(&mutex->status);
+	}
+	return MUGGLE_OK;
+}
@@ -0,0 +1,106 @@
+/******************************************************************************
+ *  @file         fast_mutex.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec fast mutex
+ *
+ * A futex based mutex that only occupy one int. Lock state is one of
+ *   - UNLOCK: nobody hold the lock
+ *   - LOCK: locked and no thread wait on futex
+ *   - CONTENDED: locked and may be some threads wait on futex
+ * Uncontended lock and unlock are a single atomic operation without system
+ * call, contended locker spin bounded round before wait on futex.
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_FAST_MUTEX_H_
+#define MUGGLE_C_FAST_MUTEX_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/base/atomic.h"
+
+EXTERN_C_BEGIN
+
+// spin round of contended locker before futex wait
+#define MUGGLE_FAST_MUTEX_SPIN_CNT 128
+
+enum
+{
+	MUGGLE_FAST_MUTEX_STATUS_UNLOCK = 0,
+	MUGGLE_FAST_MUTEX_STATUS_LOCK,
+	MUGGLE_FAST_MUTEX_STATUS_CONTENDED,
+};
+
+/**
+ * @brief fast mutex
+ */
+typedef struct muggle_fast_mutex
+{
+	muggle_atomic_int status; //!< MUGGLE_FAST_MUTEX_STATUS_*
+}muggle_fast_mutex_t;
+
+/**
+ * @brief initialize fast mutex
+ *
+ * @param mutex  fast mutex pointer
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_fast_mutex_init(muggle_fast_mutex_t *mutex);
+
+/**
+ * @brief destroy fast mutex
+ *
+ * @param mutex  fast mutex pointer
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_fast_mutex_destroy(muggle_fast_mutex_t *mutex);
+
+/**
+ * @brief lock fast mutex
+ *
+ * @param mutex  fast mutex pointer
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_fast_mutex_lock(muggle_fast_mutex_t *mutex);
+
+/**
+ * @brief try lock fast mutex
+ *
+ * @param mutex  fast mutex pointer
+ *
+ * @return
+ *     - return 0 on success
+ *     - return MUGGLE_ERR_ACQ_LOCK when mutex is held by other thread
+ */
+MUGGLE_C_EXPORT
+int muggle_fast_mutex_trylock(muggle_fast_mutex_t *mutex);
+
+/**
+ * @brief unlock fast mutex
+ *
+ * @param mutex  fast mutex pointer
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_fast_mutex_unlock(muggle_fast_mutex_t *mutex);
+
+EXTERN_C_END
+
+#endif
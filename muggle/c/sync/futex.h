@@ -17,6 +17,10 @@
 
 EXTERN_C_BEGIN
 
+// default spin/yield round of adaptive wait before futex wait
+#define MUGGLE_ADAPTIVE_WAIT_SPIN_CNT  1024
+#define MUGGLE_ADAPTIVE_WAIT_YIELD_CNT 16
+
 /**
  * @brief futex wait
  *
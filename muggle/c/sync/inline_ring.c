@@ -0,0 +1,204 @@
+/******************************************************************************
+ *  @file         inline_ring.c
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec inline payload ring
+ *****************************************************************************/
+
+#include "inline_ring.h"
+#include <stdlib.h>
+#include <string.h>
+#include "muggle/c/base/err.h"
+#include "muggle/c/base/utils.h"
+#include "muggle/c/base/thread.h"
+#include "muggle/c/sync/futex.h"
+
+#define MUGGLE_INLINE_RING_SLOT(ring, pos) \
+	((muggle_inline_ring_slot_t*)((ring)->slots + \
+		(size_t)IDX_IN_POW_OF_2_RING(pos, (ring)->capacity) * (ring)->block_size))
+
+#define MUGGLE_INLINE_RING_PAYLOAD(slot) \
+	((void*)((char*)(slot) + MUGGLE_INLINE_RING_SLOT_HEAD_SIZE))
+
+#define MUGGLE_INLINE_RING_SLOT_OF_PAYLOAD(payload) \
+	((muggle_inline_ring_slot_t*)((char*)(payload) - MUGGLE_INLINE_RING_SLOT_HEAD_SIZE))
+
+int muggle_inline_ring_init(muggle_inline_ring_t *ring, muggle_atomic_int capacity, uint32_t slot_size, int flags)
+{
+	memset(ring, 0, sizeof(muggle_inline_ring_t));
+
+	if (capacity <= 0 || slot_size == 0)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	capacity = (muggle_atomic_int)next_pow_of_2((uint64_t)capacity);
+	if (capacity <= 0)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	ring->capacity = capacity;
+	ring->flags = flags;
+	ring->slot_size = slot_size;
+	ring->block_size = (uint32_t)ROUND_UP_POW_OF_2_MUL(
+		MUGGLE_INLINE_RING_SLOT_HEAD_SIZE + slot_size, MUGGLE_CACHE_LINE_SIZE);
+	ring->write_cursor = 0;
+	ring->read_cursor = 0;
+	ring->read_waiters = 0;
+
+	// allocate one more cache line, make every slot cache line aligned
+	ring->raw_mem = malloc((size_t)ring->block_size * capacity + MUGGLE_CACHE_LINE_SIZE);
+	if (ring->raw_mem == NULL)
+	{
+		return MUGGLE_ERR_MEM_ALLOC;
+	}
+	ring->slots = (char*)ROUND_UP_POW_OF_2_MUL((uintptr_t)ring->raw_mem, MUGGLE_CACHE_LINE_SIZE);
+
+	for (muggle_atomic_int i = 0; i < capacity; i++)
+	{
+		muggle_inline_ring_slot_t *slot = MUGGLE_INLINE_RING_SLOT(ring, i);
+		slot->seq = i;
+		slot->size = 0;
+	}
+
+	return MUGGLE_OK;
+}
+
+void muggle_inline_ring_destroy(muggle_inline_ring_t *ring)
+{
+	if (ring->raw_mem)
+	{
+		free(ring->raw_mem);
+		ring->raw_mem = NULL;
+		ring->slots = NULL;
+	}
+}
+
+void* muggle_inline_ring_reserve(muggle_inline_ring_t *ring, uint32_t size)
+{
+	if (size > ring->slot_size)
+	{
+		return NULL;
+	}
+
+	muggle_inline_ring_slot_t *slot = NULL;
+	muggle_atomic_int pos = muggle_atomic_load(&ring->write_cursor, muggle_memory_order_relaxed);
+	if (ring->flags & MUGGLE_INLINE_RING_FLAG_SINGLE_WRITER)
+	{
+		slot = MUGGLE_INLINE_RING_SLOT(ring, pos);
+		if (muggle_atomic_load(&slot->seq, muggle_memory_order_acquire) != pos)
+		{
+			return NULL;
+		}
+		muggle_atomic_store(&ring->write_cursor, pos + 1, muggle_memory_order_relaxed);
+	}
+	else
+	{
+		while (1)
+		{
+			slot = MUGGLE_INLINE_RING_SLOT(ring, pos);
+			muggle_atomic_int seq = muggle_atomic_load(&slot->seq, muggle_memory_order_acquire);
+			muggle_atomic_int diff = seq - pos;
+			if (diff == 0)
+			{
+				if (muggle_atomic_cmp_exch_weak(&ring->write_cursor, &pos, pos + 1, muggle_memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (diff < 0)
+			{
+				return NULL;
+			}
+			else
+			{
+				pos = muggle_atomic_load(&ring->write_cursor, muggle_memory_order_relaxed);
+			}
+		}
+	}
+
+	slot->size = size;
+
+	return MUGGLE_INLINE_RING_PAYLOAD(slot);
+}
+
+void muggle_inline_ring_commit(muggle_inline_ring_t *ring, void *payload)
+{
+	// writer own the slot, seq is the position it reserved
+	muggle_inline_ring_slot_t *slot = MUGGLE_INLINE_RING_SLOT_OF_PAYLOAD(payload);
+	muggle_atomic_store(&slot->seq, slot->seq + 1, muggle_memory_order_release);
+
+	if (!(ring->flags & MUGGLE_INLINE_RING_FLAG_READ_BUSY_LOOP))
+	{
+		// pair with read_waiters increase in muggle_inline_ring_peek
+		muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+		if (muggle_atomic_load(&ring->read_waiters, muggle_memory_order_relaxed) > 0)
+		{
+			muggle_futex_wake_one(&slot->seq);
+		}
+	}
+}
+
+void* muggle_inline_ring_peek(muggle_inline_ring_t *ring, uint32_t *size)
+{
+	muggle_atomic_int pos = ring->read_cursor;
+	muggle_inline_ring_slot_t *slot = MUGGLE_INLINE_RING_SLOT(ring, pos);
+	while (1)
+	{
+		muggle_atomic_int seq = muggle_atomic_load(&slot->seq, muggle_memory_order_acquire);
+		if (seq == pos + 1)
+		{
+			break;
+		}
+
+		if (ring->flags & MUGGLE_INLINE_RING_FLAG_READ_BUSY_LOOP)
+		{
+			muggle_thread_yield();
+		}
+		else
+		{
+			muggle_atomic_fetch_add(&ring->read_waiters, 1, muggle_memory_order_seq_cst);
+			if (muggle_atomic_load(&slot->seq, muggle_memory_order_seq_cst) == seq)
+			{
+				muggle_futex_wait(&slot->seq, seq, NULL);
+			}
+			muggle_atomic_fetch_sub(&ring->read_waiters, 1, muggle_memory_order_relaxed);
+		}
+	}
+
+	if (size)
+	{
+		*size = slot->size;
+	}
+
+	return MUGGLE_INLINE_RING_PAYLOAD(slot);
+}
+
+void* muggle_inline_ring_try_peek(muggle_inline_ring_t *ring, uint32_t *size)
+{
+	muggle_atomic_int pos = ring->read_cursor;
+	muggle_inline_ring_slot_t *slot = MUGGLE_INLINE_RING_SLOT(ring, pos);
+	if (muggle_atomic_load(&slot->seq, muggle_memory_order_acquire) != pos + 1)
+	{
+		return NULL;
+	}
+
+	if (size)
+	{
+		*size = slot->size;
+	}
+
+	return MUGGLE_INLINE_RING_PAYLOAD(slot);
+}
+
+void muggle_inline_ring_release(muggle_inline_ring_t *ring)
+{
+	muggle_atomic_int pos = ring->read_cursor;
+	muggle_inline_ring_slot_t *slot = MUGGLE_INLINE_RING_SLOT(ring, pos);
+	muggle_atomic_store(&slot->seq, pos + ring->capacity, muggle_memory_order_release);
+	ring->read_cursor = pos + 1;
+}
@@ -0,0 +1,148 @@
+/******************************************************************************
+ *  @file         inline_ring.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec inline payload ring
+ *
+ * Passing messages between threads without allocate payload outside of ring,
+ * every message live directly in a cache line aligned slot of the ring.
+ *
+ * writer: reserve a slot, fill payload in place, then commit it
+ * reader: peek the oldest committed slot, consume payload in place, then release it
+ *
+ * multiple writers are allowed unless MUGGLE_INLINE_RING_FLAG_SINGLE_WRITER is
+ * set, user must guarantee only one reader use the ring at the same time.
+ * When ring full, reserve will return NULL
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_INLINE_RING_H_
+#define MUGGLE_C_INLINE_RING_H_
+
+#include "muggle/c/base/macro.h"
+#include "muggle/c/base/atomic.h"
+#include <stdint.h>
+
+EXTERN_C_BEGIN
+
+enum
+{
+	MUGGLE_INLINE_RING_FLAG_READ_WAIT      = 0x00, //!< default, if no message in ring, reader wait
+	MUGGLE_INLINE_RING_FLAG_SINGLE_WRITER  = 0x01, //!< user guarantee only one writer use this ring
+	MUGGLE_INLINE_RING_FLAG_READ_BUSY_LOOP = 0x02, //!< reader busy loop until message committed
+};
+
+// size of slot head, payload start after it
+#define MUGGLE_INLINE_RING_SLOT_HEAD_SIZE 16
+
+/**
+ * @brief inline ring slot head
+ */
+typedef struct muggle_inline_ring_slot
+{
+	muggle_atomic_int seq;  //!< sequence number of slot
+	uint32_t          size; //!< payload size of committed message
+}muggle_inline_ring_slot_t;
+
+/**
+ * @brief inline payload ring
+ */
+typedef struct muggle_inline_ring
+{
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(0);
+	muggle_atomic_int capacity;
+	int               flags;
+	uint32_t          slot_size;  //!< max payload size of every slot
+	uint32_t          block_size; //!< slot head + payload, round up to cache line
+	char              *slots;
+	void              *raw_mem;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(1);
+	muggle_atomic_int write_cursor;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(2);
+	muggle_atomic_int read_cursor;
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(3);
+	muggle_atomic_int read_waiters; //!< number of parked readers
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(4);
+}muggle_inline_ring_t;
+
+/**
+ * @brief init inline ring
+ *
+ * @param ring       pointer to inline ring
+ * @param capacity   number of slots
+ * @param slot_size  max payload size of every slot
+ * @param flags      bitwise or of MUGGLE_INLINE_RING_FLAG_*
+ *
+ * @return
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_inline_ring_init(muggle_inline_ring_t *ring, muggle_atomic_int capacity, uint32_t slot_size, int flags);
+
+/**
+ * @brief destroy inline ring
+ *
+ * @param ring  pointer to inline ring
+ */
+MUGGLE_C_EXPORT
+void muggle_inline_ring_destroy(muggle_inline_ring_t *ring);
+
+/**
+ * @brief reserve a slot for write
+ *
+ * @param ring  pointer to inline ring
+ * @param size  payload size, must not greater than slot_size
+ *
+ * @return
+ *     - on success, return payload address in slot, user fill payload then
+ *       invoke muggle_inline_ring_commit
+ *     - return NULL when ring is full or size is too large
+ */
+MUGGLE_C_EXPORT
+void* muggle_inline_ring_reserve(muggle_inline_ring_t *ring, uint32_t size);
+
+/**
+ * @brief commit reserved slot, make it visible to reader
+ *
+ * @param ring     pointer to inline ring
+ * @param payload  payload address returned by muggle_inline_ring_reserve
+ */
+MUGGLE_C_EXPORT
+void muggle_inline_ring_commit(muggle_inline_ring_t *ring, void *payload);
+
+/**
+ * @brief wait and peek the oldest committed message
+ *
+ * @param ring  pointer to inline ring
+ * @param size  if not NULL, output payload size
+ *
+ * @return payload address in slot, it's valid until muggle_inline_ring_release
+ */
+MUGGLE_C_EXPORT
+void* muggle_inline_ring_peek(muggle_inline_ring_t *ring, uint32_t *size);
+
+/**
+ * @brief peek the oldest committed message without wait
+ *
+ * @param ring  pointer to inline ring
+ * @param size  if not NULL, output payload size
+ *
+ * @return payload address in slot, or NULL when no message committed
+ */
+MUGGLE_C_EXPORT
+void* muggle_inline_ring_try_peek(muggle_inline_ring_t *ring, uint32_t *size);
+
+/**
+ * @brief release the message returned by peek, give slot back to writers
+ *
+ * @param ring  pointer to inline ring
+ */
+MUGGLE_C_EXPORT
+void muggle_inline_ring_release(muggle_inline_ring_t *ring);
+
+EXTERN_C_END
+
+#endif
@@ -16,6 +16,7 @@
 #include "muggle/c/base/utils.h"
 #include "muggle/c/base/thread.h"
 #include "muggle/c/sync/futex.h"
+#include "muggle/c/time/deadline.h"
 
 enum
 {
@@ -31,12 +32,16 @@ enum
 	MUGGLE_RING_BUFFER_READ_MODE_SINGLE_WAIT = 1,
 	MUGGLE_RING_BUFFER_READ_MODE_BUSY_LOOP = 2,
 	MUGGLE_RING_BUFFER_READ_MODE_LOCK = 3,
+	MUGGLE_RING_BUFFER_READ_MODE_ADAPTIVE = 4,
 	MUGGLE_RING_BUFFER_READ_MODE_MAX,
 };
 
 typedef void (*fn_muggle_ring_buffer_write)(muggle_ring_buffer_t *r, void *data);
 typedef void (*fn_muggle_ring_buffer_wake)(muggle_ring_buffer_t *r);
 typedef void* (*fn_muggle_ring_buffer_read)(muggle_ring_buffer_t *r, muggle_atomic_int idx);
+typedef void (*fn_muggle_ring_buffer_write_n)(muggle_ring_buffer_t *r, void **datas, muggle_atomic_int cnt);
+typedef muggle_atomic_int (*fn_muggle_ring_buffer_read_n)(
+	muggle_ring_buffer_t *r, muggle_atomic_int idx, void **datas, muggle_atomic_int max_cnt);
 
 // convert flag to mode
 static int muggle_ring_buffer_get_mode(int flag, int *w_mode, int *r_mode)
@@ -62,6 +67,10 @@ static int muggle_ring_buffer_get_mode(int flag, int *w_mode, int *r_mode)
 		{
 			*r_mode = MUGGLE_RING_BUFFER_READ_MODE_BUSY_LOOP;
 		}
+		else if (flag & MUGGLE_RING_BUFFER_FLAG_READ_ADAPTIVE)
+		{
+			*r_mode = MUGGLE_RING_BUFFER_READ_MODE_ADAPTIVE;
+		}
 		else
 		{
 			*r_mode = MUGGLE_RING_BUFFER_READ_MODE_SINGLE_WAIT;
@@ -69,7 +78,7 @@ static int muggle_ring_buffer_get_mode(int flag, int *w_mode, int *r_mode)
 	}
 	else if (flag & MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE)
 	{
-		if (flag & MUGGLE_RING_BUFFER_FLAG_READ_BUSY_LOOP)
+		if (flag & (MUGGLE_RING_BUFFER_FLAG_READ_BUSY_LOOP | MUGGLE_RING_BUFFER_FLAG_READ_ADAPTIVE))
 		{
 			return MUGGLE_ERR_INVALID_PARAM;
 		}
@@ -81,6 +90,10 @@ static int muggle_ring_buffer_get_mode(int flag, int *w_mode, int *r_mode)
 		{
 			*r_mode = MUGGLE_RING_BUFFER_READ_MODE_BUSY_LOOP;
 		}
+		else if (flag & MUGGLE_RING_BUFFER_FLAG_READ_ADAPTIVE)
+		{
+			*r_mode = MUGGLE_RING_BUFFER_READ_MODE_ADAPTIVE;
+		}
 		else
 		{
 			*r_mode = MUGGLE_RING_BUFFER_READ_MODE_WAIT;
@@ -131,10 +144,96 @@ inline static void muggle_ring_buffer_write_busy_loop(muggle_ring_buffer_t *r, v
 	}
 }
 
+// copy batch of datas in/out of ring, split into at most two memcpy
+inline static void muggle_ring_buffer_copy_in(
+	muggle_ring_buffer_t *r, muggle_atomic_int idx, void **datas, muggle_atomic_int cnt)
+{
+	muggle_atomic_int pos = IDX_IN_POW_OF_2_RING(idx, r->capacity);
+	muggle_atomic_int first = r->capacity - pos;
+	if (first >= cnt)
+	{
+		memcpy(&r->datas[pos], datas, sizeof(void*) * cnt);
+	}
+	else
+	{
+		memcpy(&r->datas[pos], datas, sizeof(void*) * first);
+		memcpy(&r->datas[0], datas + first, sizeof(void*) * (cnt - first));
+	}
+}
+
+inline static void muggle_ring_buffer_copy_out(
+	muggle_ring_buffer_t *r, muggle_atomic_int idx, void **datas, muggle_atomic_int cnt)
+{
+	muggle_atomic_int pos = IDX_IN_POW_OF_2_RING(idx, r->capacity);
+	muggle_atomic_int first = r->capacity - pos;
+	if (first >= cnt)
+	{
+		memcpy(datas, &r->datas[pos], sizeof(void*) * cnt);
+	}
+	else
+	{
+		memcpy(datas, &r->datas[pos], sizeof(void*) * first);
+		memcpy(datas + first, &r->datas[0], sizeof(void*) * (cnt - first));
+	}
+}
+
+// muggle ring_buffer batch write functions
+inline static void muggle_ring_buffer_write_n_lock(muggle_ring_buffer_t *r, void **datas, muggle_atomic_int cnt)
+{
+	muggle_mutex_lock(&r->write_mutex);
+
+	// assignment
+	muggle_ring_buffer_copy_in(r, r->cursor, datas, cnt);
+
+	// move cursor
+	muggle_atomic_store(&r->cursor, r->cursor+cnt, muggle_memory_order_release);
+
+	muggle_mutex_unlock(&r->write_mutex);
+}
+
+inline static void muggle_ring_buffer_write_n_single(muggle_ring_buffer_t *r, void **datas, muggle_atomic_int cnt)
+{
+	// assignment
+	muggle_ring_buffer_copy_in(r, r->cursor, datas, cnt);
+
+	// move cursor
+	muggle_atomic_store(&r->cursor, r->cursor+cnt, muggle_memory_order_release);
+}
+
+inline static void muggle_ring_buffer_write_n_busy_loop(muggle_ring_buffer_t *r, void **datas, muggle_atomic_int cnt)
+{
+	// move next
+	muggle_atomic_int idx = muggle_atomic_fetch_add(&r->next, cnt, muggle_memory_order_relaxed);
+
+	// assignment
+	muggle_ring_buffer_copy_in(r, idx, datas, cnt);
+
+	// move cursor
+	muggle_atomic_int cur_idx = idx;
+	while (!muggle_atomic_cmp_exch_weak(&r->cursor, &cur_idx, idx + cnt, muggle_memory_order_release)
+			&& cur_idx != idx)
+	{
+		muggle_thread_yield();
+		cur_idx = idx;
+	}
+}
+
 // muggle ring_buffer wakeup functions
+// writer only issue futex wake when some reader already parked, see
+// muggle_ring_buffer_park
+inline static int muggle_ring_buffer_has_waiter(muggle_ring_buffer_t *r)
+{
+	// pair with read_waiters increase in muggle_ring_buffer_park
+	muggle_atomic_thread_fence(muggle_memory_order_seq_cst);
+	return muggle_atomic_load(&r->read_waiters, muggle_memory_order_relaxed) > 0;
+}
+
 inline static void muggle_ring_buffer_wake_wait(muggle_ring_buffer_t *r)
 {
-	muggle_futex_wake_all(&r->cursor);
+	if (muggle_ring_buffer_has_waiter(r))
+	{
+		muggle_futex_wake_all(&r->cursor);
+	}
 }
 
 inline static void muggle_ring_buffer_wake_busy_loop(muggle_ring_buffer_t *r)
@@ -144,12 +243,49 @@ inline static void muggle_ring_buffer_wake_busy_loop(muggle_ring_buffer_t *r)
 
 inline static void muggle_ring_buffer_wake_single_wait(muggle_ring_buffer_t *r)
 {
-	muggle_futex_wake_one(&r->cursor);
+	if (muggle_ring_buffer_has_waiter(r))
+	{
+		muggle_futex_wake_one(&r->cursor);
+	}
 }
 
 inline static void muggle_ring_buffer_wake_lock(muggle_ring_buffer_t *r)
 {
-	muggle_futex_wake_one(&r->cursor);
+	if (muggle_ring_buffer_has_waiter(r))
+	{
+		muggle_futex_wake_one(&r->cursor);
+	}
+}
+
+// register as waiter, recheck cursor and futex wait
+inline static void muggle_ring_buffer_park(
+	muggle_ring_buffer_t *r, muggle_atomic_int w_cursor, const struct timespec *timeout)
+{
+	muggle_atomic_fetch_add(&r->read_waiters, 1, muggle_memory_order_seq_cst);
+	if (muggle_atomic_load(&r->cursor, muggle_memory_order_seq_cst) == w_cursor)
+	{
+		muggle_futex_wait(&r->cursor, w_cursor, timeout);
+	}
+	muggle_atomic_fetch_sub(&r->read_waiters, 1, muggle_memory_order_relaxed);
+}
+
+// adaptive wait: spin, then yield, then park
+inline static void muggle_ring_buffer_adaptive_wait(muggle_ring_buffer_t *r, int *round, muggle_atomic_int w_cursor)
+{
+	if (*round < r->spin_cnt)
+	{
+		muggle_thread_pause();
+	}
+	else if (*round < r->spin_cnt + r->yield_cnt)
+	{
+		muggle_thread_yield();
+	}
+	else
+	{
+		muggle_ring_buffer_park(r, w_cursor, NULL);
+		return;
+	}
+	(*round)++;
 }
 
 // muggle ring_buffer read functions
@@ -164,7 +300,7 @@ inline static void* muggle_ring_buffer_read_wait(muggle_ring_buffer_t *r, muggle
 			return r->datas[r_pos];
 		}
 
-		muggle_futex_wait(&r->cursor, w_cursor, NULL);
+		muggle_ring_buffer_park(r, w_cursor, NULL);
 	} while (1);
 
 	return NULL;
@@ -188,6 +324,25 @@ inline static void* muggle_ring_buffer_read_busy_loop(muggle_ring_buffer_t *r, m
 	return NULL;
 }
 
+inline static void* muggle_ring_buffer_read_adaptive(muggle_ring_buffer_t *r, muggle_atomic_int idx)
+{
+	muggle_atomic_int r_pos = IDX_IN_POW_OF_2_RING(idx, r->capacity);
+	muggle_atomic_int w_cursor;
+	int round = 0;
+
+	do {
+		w_cursor = muggle_atomic_load(&r->cursor, muggle_memory_order_acquire);
+		if (IDX_IN_POW_OF_2_RING(w_cursor, r->capacity) != r_pos)
+		{
+			return r->datas[r_pos];
+		}
+
+		muggle_ring_buffer_adaptive_wait(r, &round, w_cursor);
+	} while (1);
+
+	return NULL;
+}
+
 inline static void* muggle_ring_buffer_read_lock(muggle_ring_buffer_t *r, muggle_atomic_int idx)
 {
 	void *ret = NULL;
@@ -201,13 +356,148 @@ inline static void* muggle_ring_buffer_read_lock(muggle_ring_buffer_t *r, muggle
 			r->read_cursor++;
 			break;
 		}
-		muggle_futex_wait(&r->cursor, w_cursor, NULL);
+		muggle_ring_buffer_park(r, w_cursor, NULL);
 	} while (1);
 	muggle_mutex_unlock(&r->read_mutex);
 
 	return ret;
 }
 
+// try take data without wait, output writer's cursor observed before check
+inline static int muggle_ring_buffer_try_take(
+	muggle_ring_buffer_t *r, muggle_atomic_int idx, void **data, muggle_atomic_int *w_cursor)
+{
+	if (r->read_mode == MUGGLE_RING_BUFFER_READ_MODE_LOCK)
+	{
+		if (muggle_mutex_trylock(&r->read_mutex) != MUGGLE_OK)
+		{
+			*w_cursor = muggle_atomic_load(&r->cursor, muggle_memory_order_acquire);
+			return MUGGLE_ERR_ACQ_LOCK;
+		}
+
+		int ret = MUGGLE_ERR_EMPTY;
+		*w_cursor = muggle_atomic_load(&r->cursor, muggle_memory_order_acquire);
+		muggle_atomic_int r_pos = IDX_IN_POW_OF_2_RING(r->read_cursor, r->capacity);
+		if (IDX_IN_POW_OF_2_RING(*w_cursor, r->capacity) != r_pos)
+		{
+			*data = r->datas[r_pos];
+			r->read_cursor++;
+			ret = MUGGLE_OK;
+		}
+		muggle_mutex_unlock(&r->read_mutex);
+
+		return ret;
+	}
+
+	muggle_atomic_int r_pos = IDX_IN_POW_OF_2_RING(idx, r->capacity);
+	*w_cursor = muggle_atomic_load(&r->cursor, muggle_memory_order_acquire);
+	if (IDX_IN_POW_OF_2_RING(*w_cursor, r->capacity) == r_pos)
+	{
+		return MUGGLE_ERR_EMPTY;
+	}
+	*data = r->datas[r_pos];
+
+	return MUGGLE_OK;
+}
+
+// muggle ring_buffer batch read functions
+inline static muggle_atomic_int muggle_ring_buffer_read_n_wait(
+	muggle_ring_buffer_t *r, muggle_atomic_int idx, void **datas, muggle_atomic_int max_cnt)
+{
+	muggle_atomic_int w_cursor;
+	muggle_atomic_int cnt;
+	do {
+		w_cursor = muggle_atomic_load(&r->cursor, muggle_memory_order_acquire);
+		cnt = IDX_IN_POW_OF_2_RING(w_cursor - idx, r->capacity);
+		if (cnt != 0)
+		{
+			if (cnt > max_cnt)
+			{
+				cnt = max_cnt;
+			}
+			muggle_ring_buffer_copy_out(r, idx, datas, cnt);
+			return cnt;
+		}
+
+		muggle_ring_buffer_park(r, w_cursor, NULL);
+	} while (1);
+
+	return 0;
+}
+
+inline static muggle_atomic_int muggle_ring_buffer_read_n_busy_loop(
+	muggle_ring_buffer_t *r, muggle_atomic_int idx, void **datas, muggle_atomic_int max_cnt)
+{
+	muggle_atomic_int w_cursor;
+	muggle_atomic_int cnt;
+	do {
+		w_cursor = muggle_atomic_load(&r->cursor, muggle_memory_order_acquire);
+		cnt = IDX_IN_POW_OF_2_RING(w_cursor - idx, r->capacity);
+		if (cnt != 0)
+		{
+			if (cnt > max_cnt)
+			{
+				cnt = max_cnt;
+			}
+			muggle_ring_buffer_copy_out(r, idx, datas, cnt);
+			return cnt;
+		}
+
+		muggle_thread_yield();
+	} while (1);
+
+	return 0;
+}
+
+inline static muggle_atomic_int muggle_ring_buffer_read_n_adaptive(
+	muggle_ring_buffer_t *r, muggle_atomic_int idx, void **datas, muggle_atomic_int max_cnt)
+{
+	muggle_atomic_int w_cursor;
+	muggle_atomic_int cnt;
+	int round = 0;
+	do {
+		w_cursor = muggle_atomic_load(&r->cursor, muggle_memory_order_acquire);
+		cnt = IDX_IN_POW_OF_2_RING(w_cursor - idx, r->capacity);
+		if (cnt != 0)
+		{
+			if (cnt > max_cnt)
+			{
+				cnt = max_cnt;
+			}
+			muggle_ring_buffer_copy_out(r, idx, datas, cnt);
+			return cnt;
+		}
+
+		muggle_ring_buffer_adaptive_wait(r, &round, w_cursor);
+	} while (1);
+
+	return 0;
+}
+
+inline static muggle_atomic_int muggle_ring_buffer_read_n_lock(
+	muggle_ring_buffer_t *r, muggle_atomic_int idx, void **datas, muggle_atomic_int max_cnt)
+{
+	muggle_atomic_int cnt = 0;
+	muggle_mutex_lock(&r->read_mutex);
+	do {
+		muggle_atomic_int w_cursor = muggle_atomic_load(&r->cursor, muggle_memory_order_acquire);
+		cnt = IDX_IN_POW_OF_2_RING(w_cursor - r->read_cursor, r->capacity);
+		if (cnt != 0)
+		{
+			if (cnt > max_cnt)
+			{
+				cnt = max_cnt;
+			}
+			muggle_ring_buffer_copy_out(r, r->read_cursor, datas, cnt);
+			r->read_cursor += cnt;
+			break;
+		}
+		muggle_ring_buffer_park(r, w_cursor, NULL);
+	} while (1);
+	muggle_mutex_unlock(&r->read_mutex);
+
+	return cnt;
+}
 
 // write, wake and read callbacks
 static fn_muggle_ring_buffer_write muggle_ring_buffer_write_functions[MUGGLE_RING_BUFFER_WRITE_MODE_MAX] = {
@@ -221,6 +511,7 @@ static fn_muggle_ring_buffer_wake muggle_ring_buffer_wake_functions[MUGGLE_RING_
 	muggle_ring_buffer_wake_single_wait, // MUGGLE_RING_BUFFER_READ_MODE_SINGLE_WAIT 
 	muggle_ring_buffer_wake_busy_loop, // MUGGLE_RING_BUFFER_READ_MODE_BUSY_LOOP 
 	muggle_ring_buffer_wake_lock, // MUGGLE_RING_BUFFER_READ_MODE_LOCK 
+	muggle_ring_buffer_wake_wait, // MUGGLE_RING_BUFFER_READ_MODE_ADAPTIVE 
 };
 
 static fn_muggle_ring_buffer_read muggle_ring_buffer_read_functions[MUGGLE_RING_BUFFER_READ_MODE_MAX] = {
@@ -228,9 +519,30 @@ static fn_muggle_ring_buffer_read muggle_ring_buffer_read_functions[MUGGLE_RING_
 	muggle_ring_buffer_read_wait, // MUGGLE_RING_BUFFER_READ_MODE_SINGLE_WAIT 
 	muggle_ring_buffer_read_busy_loop, // MUGGLE_RING_BUFFER_READ_MODE_BUSY_LOOP 
 	muggle_ring_buffer_read_lock, // MUGGLE_RING_BUFFER_READ_MODE_LOCK 
+	muggle_ring_buffer_read_adaptive, // MUGGLE_RING_BUFFER_READ_MODE_ADAPTIVE 
+};
+
+static fn_muggle_ring_buffer_write_n muggle_ring_buffer_write_n_functions[MUGGLE_RING_BUFFER_WRITE_MODE_MAX] = {
+	muggle_ring_buffer_write_n_lock, // MUGGLE_RING_BUFFER_WRITE_MODE_LOCK 
+	muggle_ring_buffer_write_n_single, // MUGGLE_RING_BUFFER_WRITE_MODE_SINGLE 
+	muggle_ring_buffer_write_n_busy_loop // MUGGLE_RING_BUFFER_WRITE_MODE_BUSY_LOOP 
+};
+
+static fn_muggle_ring_buffer_read_n muggle_ring_buffer_read_n_functions[MUGGLE_RING_BUFFER_READ_MODE_MAX] = {
+	muggle_ring_buffer_read_n_wait, // MUGGLE_RING_BUFFER_READ_MODE_WAIT 
+	muggle_ring_buffer_read_n_wait, // MUGGLE_RING_BUFFER_READ_MODE_SINGLE_WAIT 
+	muggle_ring_buffer_read_n_busy_loop, // MUGGLE_RING_BUFFER_READ_MODE_BUSY_LOOP 
+	muggle_ring_buffer_read_n_lock, // MUGGLE_RING_BUFFER_READ_MODE_LOCK 
+	muggle_ring_buffer_read_n_adaptive, // MUGGLE_RING_BUFFER_READ_MODE_ADAPTIVE 
 };
 
 int muggle_ring_buffer_init(muggle_ring_buffer_t *r, muggle_atomic_int capacity, int flag)
+{
+	return muggle_ring_buffer_init_with_policy(r, capacity, flag, NULL);
+}
+
+int muggle_ring_buffer_init_with_policy(
+	muggle_ring_buffer_t *r, muggle_atomic_int capacity, int flag, const muggle_page_policy_t *policy)
 {
 	memset(r, 0, sizeof(muggle_ring_buffer_t));
 	if (capacity <= 0)
@@ -254,6 +566,9 @@ int muggle_ring_buffer_init(muggle_ring_buffer_t *r, muggle_atomic_int capacity,
 	r->next = 0;
 	r->cursor = 0;
 	r->read_cursor = 0;
+	r->read_waiters = 0;
+	r->spin_cnt = MUGGLE_ADAPTIVE_WAIT_SPIN_CNT;
+	r->yield_cnt = MUGGLE_ADAPTIVE_WAIT_YIELD_CNT;
 
 	ret = muggle_mutex_init(&r->write_mutex);
 	if (ret != MUGGLE_OK)
@@ -273,7 +588,7 @@ int muggle_ring_buffer_init(muggle_ring_buffer_t *r, muggle_atomic_int capacity,
 		return ret;
 	}
 
-	r->datas = (void**)malloc(sizeof(void*) * r->capacity);
+	r->datas = (void**)muggle_page_alloc(sizeof(void*) * r->capacity, policy);
 	if (r->datas == NULL)
 	{
 		return MUGGLE_ERR_MEM_ALLOC;
@@ -282,9 +597,15 @@ int muggle_ring_buffer_init(muggle_ring_buffer_t *r, muggle_atomic_int capacity,
 	return MUGGLE_OK;
 }
 
+void muggle_ring_buffer_set_adaptive_wait(muggle_ring_buffer_t *r, int spin_cnt, int yield_cnt)
+{
+	r->spin_cnt = spin_cnt < 0 ? 0 : spin_cnt;
+	r->yield_cnt = yield_cnt < 0 ? 0 : yield_cnt;
+}
+
 int muggle_ring_buffer_destroy(muggle_ring_buffer_t *r)
 {
-	free(r->datas);
+	muggle_page_free(r->datas);
 	muggle_mutex_destroy(&r->write_mutex);
 	muggle_mutex_destroy(&r->read_mutex);
 	muggle_condition_variable_destroy(&r->read_cv);
@@ -307,3 +628,66 @@ void* muggle_ring_buffer_read(muggle_ring_buffer_t *r, muggle_atomic_int idx)
 	return (*muggle_ring_buffer_read_functions[r->read_mode])(r, idx);
 }
 
+int muggle_ring_buffer_write_n(muggle_ring_buffer_t *r, void **datas, muggle_atomic_int cnt)
+{
+	// reader see w_cursor == idx as empty, a full capacity batch would be lost
+	if (cnt <= 0 || cnt >= r->capacity)
+	{
+		return MUGGLE_ERR_INVALID_PARAM;
+	}
+
+	// write
+	(*muggle_ring_buffer_write_n_functions[r->write_mode])(r, datas, cnt);
+
+	// wake
+	(*muggle_ring_buffer_wake_functions[r->read_mode])(r);
+
+	return MUGGLE_OK;
+}
+
+muggle_atomic_int muggle_ring_buffer_read_n(
+	muggle_ring_buffer_t *r, muggle_atomic_int idx, void **datas, muggle_atomic_int max_cnt)
+{
+	if (max_cnt <= 0)
+	{
+		return 0;
+	}
+
+	return (*muggle_ring_buffer_read_n_functions[r->read_mode])(r, idx, datas, max_cnt);
+}
+
+int muggle_ring_buffer_try_read(muggle_ring_buffer_t *r, muggle_atomic_int idx, void **data)
+{
+	muggle_atomic_int w_cursor;
+	return muggle_ring_buffer_try_take(r, idx, data, &w_cursor) == MUGGLE_OK ? MUGGLE_OK : MUGGLE_ERR_EMPTY;
+}
+
+int muggle_ring_buffer_read_timed(
+	muggle_ring_buffer_t *r, muggle_atomic_int idx, const struct timespec *deadline, void **data)
+{
+	struct timespec remain;
+	muggle_atomic_int w_cursor;
+	while (1)
+	{
+		int ret = muggle_ring_buffer_try_take(r, idx, data, &w_cursor);
+		if (ret == MUGGLE_OK)
+		{
+			return MUGGLE_OK;
+		}
+
+		if (!muggle_deadline_remaining(deadline, &remain))
+		{
+			return MUGGLE_ERR_TIMEOUT;
+		}
+
+		// another reader hold read lock, or reader busy loop
+		if (ret == MUGGLE_ERR_ACQ_LOCK ||
+			r->read_mode == MUGGLE_RING_BUFFER_READ_MODE_BUSY_LOOP)
+		{
+			muggle_thread_yield();
+			continue;
+		}
+
+		muggle_ring_buffer_park(r, w_cursor, &remain);
+	}
+}
@@ -15,6 +15,8 @@
 #include "muggle/c/base/atomic.h"
 #include "muggle/c/sync/mutex.h"
 #include "muggle/c/sync/condition_variable.h"
+#include "muggle/c/memory/page_provider.h"
+#include <time.h>
 
 EXTERN_C_BEGIN
 
@@ -29,6 +31,7 @@ enum
 	MUGGLE_RING_BUFFER_FLAG_WRITE_BUSY_LOOP = 0x04, //!< every writer busy loop until write message into ring
 	MUGGLE_RING_BUFFER_FLAG_READ_BUSY_LOOP  = 0x08, //!< reader busy loop until read message from ring
 	MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE   = 0x10, //!< every message will only be read once
+	MUGGLE_RING_BUFFER_FLAG_READ_ADAPTIVE   = 0x20, //!< reader spin, then yield, then futex wait; writer only wake when reader parked
 };
 
 typedef struct muggle_ring_buffer_tag
@@ -39,6 +42,8 @@ typedef struct muggle_ring_buffer_tag
 	int flag;
 	int write_mode;
 	int read_mode;
+	int spin_cnt;  //!< spin round for MUGGLE_RING_BUFFER_FLAG_READ_ADAPTIVE
+	int yield_cnt; //!< yield round for MUGGLE_RING_BUFFER_FLAG_READ_ADAPTIVE
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(2);
 	muggle_atomic_int next;
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(3);
@@ -54,6 +59,8 @@ typedef struct muggle_ring_buffer_tag
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(8);
 	void **datas;
 	MUGGLE_STRUCT_CACHE_LINE_PADDING(9);
+	muggle_atomic_int read_waiters; //!< number of parked readers
+	MUGGLE_STRUCT_CACHE_LINE_PADDING(10);
 }muggle_ring_buffer_t;
 
 /**
@@ -70,6 +77,35 @@ typedef struct muggle_ring_buffer_tag
 MUGGLE_C_EXPORT
 int muggle_ring_buffer_init(muggle_ring_buffer_t *r, muggle_atomic_int capacity, int flag);
 
+/**
+ * @brief initialize ring buffer with allocation policy of slots
+ *
+ * @param r         ring buffer pointer
+ * @param capacity  initialize capacity for ring buffer
+ * @param flag      bit OR operationg of MUGGLE_RING_BUFFER_FLAG_*
+ * @param policy    allocation policy of slots, if it's NULL, use malloc
+ *
+ * @return 
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_ring_buffer_init_with_policy(
+	muggle_ring_buffer_t *r, muggle_atomic_int capacity, int flag, const muggle_page_policy_t *policy);
+
+/**
+ * @brief set spin and yield round of adaptive reader
+ *
+ * only take effect when MUGGLE_RING_BUFFER_FLAG_READ_ADAPTIVE is set, reader
+ * spin spin_cnt times with cpu pause, then yield yield_cnt times, then futex wait
+ *
+ * @param r          ring buffer pointer
+ * @param spin_cnt   spin round
+ * @param yield_cnt  yield round
+ */
+MUGGLE_C_EXPORT
+void muggle_ring_buffer_set_adaptive_wait(muggle_ring_buffer_t *r, int spin_cnt, int yield_cnt);
+
 /**
  * @brief destroy ring buffer
  *
@@ -106,6 +142,73 @@ int muggle_ring_buffer_write(muggle_ring_buffer_t *r, void *data);
 MUGGLE_C_EXPORT
 void* muggle_ring_buffer_read(muggle_ring_buffer_t *r, muggle_atomic_int idx);
 
+/**
+ * @brief write a batch of data into ring buffer
+ *
+ * claim cnt contiguous slots at once and publish them with a single cursor
+ * update, so all datas become visible to readers together
+ *
+ * @param r      ring buffer pointer
+ * @param datas  array of data pointers
+ * @param cnt    number of data in datas, must in range (0, capacity)
+ *
+ * @return 
+ *     - return 0 on success
+ *     - otherwise return error code in muggle/c/base/err.h
+ */
+MUGGLE_C_EXPORT
+int muggle_ring_buffer_write_n(muggle_ring_buffer_t *r, void **datas, muggle_atomic_int cnt);
+
+/**
+ * @brief read a batch of data from ring buffer
+ *
+ * wait until at least one data is ready, then copy every ready data from idx
+ * up to the writer's cursor (at most max_cnt) into datas
+ *
+ * @param r        ring buffer pointer
+ * @param idx      index of first data, ignored when
+ *                 MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE is set
+ * @param datas    output array of data pointers
+ * @param max_cnt  capacity of datas
+ *
+ * @return number of data copied into datas, caller should move its next idx
+ *         forward by this number
+ */
+MUGGLE_C_EXPORT
+muggle_atomic_int muggle_ring_buffer_read_n(
+	muggle_ring_buffer_t *r, muggle_atomic_int idx, void **datas, muggle_atomic_int max_cnt);
+
+/**
+ * @brief read data from ring buffer without wait
+ *
+ * @param r     ring buffer pointer
+ * @param idx   index of data, ignored when MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE is set
+ * @param data  output data pointer
+ *
+ * @return
+ *     - return 0 on success
+ *     - return MUGGLE_ERR_EMPTY when data of idx is not ready, or another
+ *       reader is reading in MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE mode
+ */
+MUGGLE_C_EXPORT
+int muggle_ring_buffer_try_read(muggle_ring_buffer_t *r, muggle_atomic_int idx, void **data);
+
+/**
+ * @brief read data from ring buffer, wait until deadline when data is not ready
+ *
+ * @param r         ring buffer pointer
+ * @param idx       index of data, ignored when MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE is set
+ * @param deadline  absolute deadline, see muggle/c/time/deadline.h
+ * @param data      output data pointer
+ *
+ * @return
+ *     - return 0 on success
+ *     - return MUGGLE_ERR_TIMEOUT when deadline is reached
+ */
+MUGGLE_C_EXPORT
+int muggle_ring_buffer_read_timed(
+	muggle_ring_buffer_t *r, muggle_atomic_int idx, const struct timespec *deadline, void **data);
+
 EXTERN_C_END
 
 #endif
@@ -0,0 +1,72 @@
+/******************************************************************************
+ *  @file         deadline.c
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec deadline
+ *****************************************************************************/
+
+#include "deadline.h"
+
+#if MUGGLE_PLATFORM_WINDOWS
+
+#include <windows.h>
+
+void muggle_deadline_now(struct timespec *ts)
+{
+	LARGE_INTEGER freq, cnt;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&cnt);
+	ts->tv_sec = (time_t)(cnt.QuadPart / freq.QuadPart);
+	ts->tv_nsec = (long)((cnt.QuadPart % freq.QuadPart) * 1000000000 / freq.QuadPart);
+}
+
+#else
+
+void muggle_deadline_now(struct timespec *ts)
+{
+	clock_gettime(CLOCK_MONOTONIC, ts);
+}
+
+#endif
+
+void muggle_deadline_after(struct timespec *deadline, unsigned long ms)
+{
+	muggle_deadline_now(deadline);
+	deadline->tv_sec += (time_t)(ms / 1000);
+	deadline->tv_nsec += (long)(ms % 1000) * 1000000;
+	if (deadline->tv_nsec >= 1000000000)
+	{
+		deadline->tv_sec += 1;
+		deadline->tv_nsec -= 1000000000;
+	}
+}
+
+int muggle_deadline_remaining(const struct timespec *deadline, struct timespec *remain)
+{
+	struct timespec now;
+	muggle_deadline_now(&now);
+
+	time_t sec = deadline->tv_sec - now.tv_sec;
+	long nsec = deadline->tv_nsec - now.tv_nsec;
+	if (nsec < 0)
+	{
+		sec -= 1;
+		nsec += 1000000000;
+	}
+
+	if (sec < 0 || (sec == 0 && nsec == 0))
+	{
+		return 0;
+	}
+
+	if (remain)
+	{
+		remain->tv_sec = sec;
+		remain->tv_nsec = nsec;
+	}
+
+	return 1;
+}
@@ -0,0 +1,54 @@
+/******************************************************************************
+ *  @file         deadline.h
+ *  @author       Muggle Wei
+ *  @email        mugglewei@gmail.com
+ *  @date         2026-10-17
+ *  @copyright    Copyright 2026 Muggle Wei
+ *  @license      MIT License
+ *  @brief        mugglec deadline
+ *
+ * Deadline is an absolute time point of monotonic clock (CLOCK_MONOTONIC on
+ * posix), it's not affected by system time changes
+ *****************************************************************************/
+
+#ifndef MUGGLE_C_DEADLINE_H_
+#define MUGGLE_C_DEADLINE_H_
+
+#include "muggle/c/base/macro.h"
+#include <time.h>
+
+EXTERN_C_BEGIN
+
+/**
+ * @brief get current time of monotonic clock
+ *
+ * @param ts  output current time
+ */
+MUGGLE_C_EXPORT
+void muggle_deadline_now(struct timespec *ts);
+
+/**
+ * @brief set deadline to milliseconds later
+ *
+ * @param deadline  output deadline
+ * @param ms        milliseconds from now
+ */
+MUGGLE_C_EXPORT
+void muggle_deadline_after(struct timespec *deadline, unsigned long ms);
+
+/**
+ * @brief get remaining time before deadline
+ *
+ * @param deadline  absolute deadline
+ * @param remain    if not NULL, output relative remaining time
+ *
+ * @return
+ *     - return 1 when deadline not yet reached
+ *     - return 0 when deadline is reached
+ */
+MUGGLE_C_EXPORT
+int muggle_deadline_remaining(const struct timespec *deadline, struct timespec *remain);
+
+EXTERN_C_END
+
+#endif
@@ -0,0 +1,137 @@
+#include <stdint.h>
+#include <string.h>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+TEST(arena, alloc_align)
+{
+	muggle_arena_t arena;
+	ASSERT_EQ(muggle_arena_init(&arena, 256), MUGGLE_OK);
+
+	for (int i = 0; i < 64; i++)
+	{
+		void *p = muggle_arena_alloc(&arena, (size_t)i + 1);
+		ASSERT_TRUE(p != NULL);
+		EXPECT_EQ((uintptr_t)p % MUGGLE_ARENA_DEFAULT_ALIGN, 0u);
+		memset(p, 0xff, (size_t)i + 1);
+	}
+
+	size_t alignments[] = {1, 2, 8, 64, 128, 4096};
+	for (size_t i = 0; i < sizeof(alignments) / sizeof(alignments[0]); i++)
+	{
+		void *p = muggle_arena_alloc_aligned(&arena, 3, alignments[i]);
+		ASSERT_TRUE(p != NULL);
+		EXPECT_EQ((uintptr_t)p % alignments[i], 0u);
+	}
+	EXPECT_TRUE(muggle_arena_alloc_aligned(&arena, 8, 3) == NULL);
+
+	// oversize data
+	char *big = (char*)muggle_arena_alloc(&arena, 1024 * 16);
+	ASSERT_TRUE(big != NULL);
+	memset(big, 0, 1024 * 16);
+
+	muggle_arena_destroy(&arena);
+}
+
+TEST(arena, mark_rewind)
+{
+	muggle_arena_t arena;
+	ASSERT_EQ(muggle_arena_init(&arena, 128), MUGGLE_OK);
+
+	int *a = (int*)muggle_arena_alloc(&arena, sizeof(int));
+	ASSERT_TRUE(a != NULL);
+	*a = 1;
+
+	muggle_arena_mark_t mark;
+	muggle_arena_mark(&arena, &mark);
+
+	// cross several blocks
+	void *first = NULL;
+	for (int i = 0; i < 32; i++)
+	{
+		void *p = muggle_arena_alloc(&arena, 48);
+		ASSERT_TRUE(p != NULL);
+		if (i == 0)
+		{
+			first = p;
+		}
+	}
+	size_t capacity = muggle_arena_capacity(&arena);
+
+	muggle_arena_rewind(&arena, &mark);
+	EXPECT_EQ(*a, 1);
+
+	// same position after rewind, blocks are reused
+	EXPECT_EQ(muggle_arena_alloc(&arena, 48), first);
+	for (int i = 1; i < 32; i++)
+	{
+		ASSERT_TRUE(muggle_arena_alloc(&arena, 48) != NULL);
+	}
+	EXPECT_EQ(muggle_arena_capacity(&arena), capacity);
+
+	muggle_arena_destroy(&arena);
+}
+
+TEST(arena, reset)
+{
+	muggle_arena_t arena;
+	ASSERT_EQ(muggle_arena_init(&arena, 0), MUGGLE_OK);
+
+	void *first = muggle_arena_alloc(&arena, 16);
+	ASSERT_TRUE(first != NULL);
+
+	for (int round = 0; round < 8; round++)
+	{
+		for (int i = 0; i < 1024; i++)
+		{
+			ASSERT_TRUE(muggle_arena_alloc(&arena, 100) != NULL);
+		}
+		size_t capacity = muggle_arena_capacity(&arena);
+
+		muggle_arena_reset(&arena);
+		EXPECT_EQ(muggle_arena_alloc(&arena, 16), first);
+
+		for (int i = 0; i < 1024; i++)
+		{
+			ASSERT_TRUE(muggle_arena_alloc(&arena, 100) != NULL);
+		}
+		EXPECT_EQ(muggle_arena_capacity(&arena), capacity);
+
+		muggle_arena_reset(&arena);
+		EXPECT_EQ(muggle_arena_alloc(&arena, 16), first);
+	}
+
+	muggle_arena_destroy(&arena);
+}
+
+TEST(arena, hash_table_per_request)
+{
+	muggle_arena_t arena;
+	ASSERT_EQ(muggle_arena_init(&arena, 0), MUGGLE_OK);
+
+	for (int round = 0; round < 4; round++)
+	{
+		muggle_hash_table_t table;
+		ASSERT_TRUE(muggle_hash_table_init_with_arena(&table, 64, NULL,
+			[](const void *d1, const void *d2) { return strcmp((const char*)d1, (const char*)d2); },
+			&arena));
+
+		for (int i = 0; i < 256; i++)
+		{
+			char *key = (char*)muggle_arena_alloc(&arena, 16);
+			ASSERT_TRUE(key != NULL);
+			snprintf(key, 16, "%d", i);
+			ASSERT_TRUE(muggle_hash_table_put(&table, key, NULL) != NULL);
+		}
+
+		muggle_hash_table_node_t *node = muggle_hash_table_find(&table, (void*)"128");
+		ASSERT_TRUE(node != NULL);
+		muggle_hash_table_remove(&table, node, muggle_arena_free, &arena, NULL, NULL);
+		EXPECT_TRUE(muggle_hash_table_find(&table, (void*)"128") == NULL);
+
+		muggle_hash_table_destroy(&table, muggle_arena_free, &arena, NULL, NULL);
+		muggle_arena_reset(&arena);
+	}
+
+	muggle_arena_destroy(&arena);
+}
@@ -55,7 +55,7 @@ TEST(array_blocking_queue, write_read_in_single_thread)
 }
 
 void producer_consumer(int cnt_producer, int cnt_consumer, int cnt_interval, int interval_ms,
-	int capacity = 1024 * 2, int total = 10000)
+	int capacity = 1024 * 2, int total = 10000, int flags = MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_LOCK)
 {
 	muggle_array_blocking_queue_t queue;
 	int *arr = (int*)malloc(sizeof(int) * total);
@@ -64,7 +64,7 @@ void producer_consumer(int cnt_producer, int cnt_consumer, int cnt_interval, int
 		arr[i] = i;
 	}
 
-	muggle_array_blocking_queue_init(&queue, capacity);
+	ASSERT_EQ(muggle_array_blocking_queue_init_ex(&queue, capacity, flags), MUGGLE_OK);
 
 	muggle_atomic_int consumer_ready = 0;
 	muggle_atomic_int total_read = 0;
@@ -191,3 +191,107 @@ TEST(array_blocking_queue, mul_producer_mul_consumer)
 
 	producer_consumer(hc, hc, g_cnt_interval, g_interval_ms);
 }
+
+static void test_try_and_timeout(int flags)
+{
+	muggle_array_blocking_queue_t queue;
+	ASSERT_EQ(muggle_array_blocking_queue_init_ex(&queue, 2, flags), MUGGLE_OK);
+
+	void *data = NULL;
+	EXPECT_EQ(muggle_array_blocking_queue_try_take(&queue, &data), MUGGLE_ERR_EMPTY);
+
+	struct timespec deadline;
+	muggle_deadline_after(&deadline, 5);
+	EXPECT_EQ(muggle_array_blocking_queue_take_timed(&queue, &deadline, &data), MUGGLE_ERR_TIMEOUT);
+	EXPECT_FALSE(muggle_deadline_remaining(&deadline, NULL));
+
+	int arr[2] = {1, 2};
+	EXPECT_EQ(muggle_array_blocking_queue_try_put(&queue, &arr[0]), MUGGLE_OK);
+	EXPECT_EQ(muggle_array_blocking_queue_try_put(&queue, &arr[1]), MUGGLE_OK);
+	EXPECT_EQ(muggle_array_blocking_queue_try_put(&queue, &arr[0]), MUGGLE_ERR_FULL);
+
+	muggle_deadline_after(&deadline, 5);
+	EXPECT_EQ(muggle_array_blocking_queue_put_timed(&queue, &arr[0], &deadline), MUGGLE_ERR_TIMEOUT);
+
+	EXPECT_EQ(muggle_array_blocking_queue_try_take(&queue, &data), MUGGLE_OK);
+	EXPECT_EQ(*(int*)data, 1);
+	muggle_deadline_after(&deadline, 5);
+	EXPECT_EQ(muggle_array_blocking_queue_take_timed(&queue, &deadline, &data), MUGGLE_OK);
+	EXPECT_EQ(*(int*)data, 2);
+
+	muggle_array_blocking_queue_destroy(&queue);
+}
+
+TEST(array_blocking_queue, try_and_timeout)
+{
+	test_try_and_timeout(MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_LOCK);
+	test_try_and_timeout(MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_LOCKFREE);
+}
+
+static void test_timed_take_race_with_put(int flags)
+{
+	const int cnt = 200;
+	std::vector<int> vals(cnt);
+	muggle_array_blocking_queue_t queue;
+	ASSERT_EQ(muggle_array_blocking_queue_init_ex(&queue, 4, flags), MUGGLE_OK);
+
+	std::thread writer([&]{
+		for (int i = 0; i < cnt; ++i)
+		{
+			vals[i] = i;
+			std::this_thread::sleep_for(std::chrono::microseconds(i % 3 * 500));
+
+			struct timespec deadline;
+			do {
+				muggle_deadline_after(&deadline, 1);
+			} while (muggle_array_blocking_queue_put_timed(&queue, &vals[i], &deadline) != MUGGLE_OK);
+		}
+	});
+
+	for (int i = 0; i < cnt;)
+	{
+		struct timespec deadline;
+		muggle_deadline_after(&deadline, 1);
+
+		void *data = NULL;
+		int ret = muggle_array_blocking_queue_take_timed(&queue, &deadline, &data);
+		if (ret == MUGGLE_ERR_TIMEOUT)
+		{
+			continue;
+		}
+		ASSERT_EQ(ret, MUGGLE_OK);
+		ASSERT_EQ(*(int*)data, i);
+		i++;
+	}
+
+	writer.join();
+
+	void *data = NULL;
+	EXPECT_EQ(muggle_array_blocking_queue_try_take(&queue, &data), MUGGLE_ERR_EMPTY);
+
+	muggle_array_blocking_queue_destroy(&queue);
+}
+
+TEST(array_blocking_queue, timed_take_race_with_put)
+{
+	test_timed_take_race_with_put(MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_LOCK);
+	test_timed_take_race_with_put(MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_LOCKFREE);
+}
+
+TEST(array_blocking_queue, lockfree_mul_producer_mul_consumer)
+{
+	int hc = (int)std::thread::hardware_concurrency();
+	hc /= 2;
+	if (hc <= 1)
+	{
+		hc = 2;
+	}
+
+	producer_consumer(1, 1, g_cnt_interval, g_interval_ms,
+		1024 * 2, 10000, MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_LOCKFREE);
+	producer_consumer(hc, hc, g_cnt_interval, g_interval_ms,
+		1024 * 2, 10000, MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_LOCKFREE);
+
+	// small capacity, make both putters and takers park
+	producer_consumer(hc, hc, 0, 0, 4, 100000, MUGGLE_ARRAY_BLOCKING_QUEUE_FLAG_LOCKFREE);
+}
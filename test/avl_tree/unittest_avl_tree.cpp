@@ -18,18 +18,25 @@ public:
 
 		ret = muggle_avl_tree_init(&tree_[1], test_utils_cmp_int, 8);
 		ASSERT_TRUE(ret);
+
+		ASSERT_EQ(muggle_arena_init(&arena_, 0), MUGGLE_OK);
+		ret = muggle_avl_tree_init_with_arena(&tree_[2], test_utils_cmp_int, &arena_);
+		ASSERT_TRUE(ret);
 	}
 
 	void TearDown()
 	{
 		muggle_avl_tree_destroy(&tree_[0], test_utils_free_int, &test_utils_, test_utils_free_str, &test_utils_);
 		muggle_avl_tree_destroy(&tree_[1], test_utils_free_int, &test_utils_, test_utils_free_str, &test_utils_);
+		muggle_avl_tree_destroy(&tree_[2], test_utils_free_int, &test_utils_, test_utils_free_str, &test_utils_);
+		muggle_arena_destroy(&arena_);
 
 		muggle_debug_memory_leak_end(&mem_state_);
 	}
 
 protected:
-	muggle_avl_tree_t tree_[2];
+	muggle_avl_tree_t tree_[3];
+	muggle_arena_t arena_;
 
 	TestUtils test_utils_;
 	muggle_debug_memory_state mem_state_;
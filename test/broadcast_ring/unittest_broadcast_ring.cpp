@@ -0,0 +1,281 @@
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+TEST(broadcast_ring, init_destroy)
+{
+	muggle_broadcast_ring_t ring;
+	ASSERT_EQ(muggle_broadcast_ring_init(&ring, 0, 4, MUGGLE_BROADCAST_RING_POLICY_BLOCK, 0), MUGGLE_ERR_INVALID_PARAM);
+	ASSERT_EQ(muggle_broadcast_ring_init(&ring, 16, 0, MUGGLE_BROADCAST_RING_POLICY_BLOCK, 0), MUGGLE_ERR_INVALID_PARAM);
+	ASSERT_EQ(muggle_broadcast_ring_init(&ring, 16, 4, MUGGLE_BROADCAST_RING_POLICY_MAX, 0), MUGGLE_ERR_INVALID_PARAM);
+
+	ASSERT_EQ(muggle_broadcast_ring_init(&ring, 10, 2, MUGGLE_BROADCAST_RING_POLICY_BLOCK, 0), MUGGLE_OK);
+	EXPECT_EQ(ring.capacity, 16);
+
+	int r0 = muggle_broadcast_ring_add_reader(&ring);
+	int r1 = muggle_broadcast_ring_add_reader(&ring);
+	EXPECT_EQ(r0, 0);
+	EXPECT_EQ(r1, 1);
+	EXPECT_EQ(muggle_broadcast_ring_add_reader(&ring), -1);
+
+	muggle_broadcast_ring_remove_reader(&ring, r0);
+	EXPECT_EQ(muggle_broadcast_ring_add_reader(&ring), r0);
+
+	muggle_broadcast_ring_destroy(&ring);
+}
+
+TEST(broadcast_ring, every_reader_get_all)
+{
+	muggle_broadcast_ring_t ring;
+	ASSERT_EQ(muggle_broadcast_ring_init(&ring, 8, 4, MUGGLE_BROADCAST_RING_POLICY_BLOCK, 0), MUGGLE_OK);
+
+	int readers[3];
+	for (int i = 0; i < 3; i++)
+	{
+		readers[i] = muggle_broadcast_ring_add_reader(&ring);
+		ASSERT_GE(readers[i], 0);
+	}
+
+	static int vals[8];
+	for (int i = 0; i < 8; i++)
+	{
+		vals[i] = i;
+		ASSERT_EQ(muggle_broadcast_ring_write(&ring, &vals[i]), MUGGLE_OK);
+	}
+
+	for (int r = 0; r < 3; r++)
+	{
+		for (int i = 0; i < 8; i++)
+		{
+			void *data = NULL;
+			ASSERT_EQ(muggle_broadcast_ring_read(&ring, readers[r], &data), MUGGLE_OK);
+			ASSERT_EQ(*(int*)data, i);
+		}
+		EXPECT_EQ(muggle_broadcast_ring_get_overrun(&ring, readers[r]), 0u);
+	}
+
+	muggle_broadcast_ring_destroy(&ring);
+}
+
+TEST(broadcast_ring, drop_oldest)
+{
+	muggle_broadcast_ring_t ring;
+	ASSERT_EQ(muggle_broadcast_ring_init(&ring, 8, 2, MUGGLE_BROADCAST_RING_POLICY_DROP_OLDEST, 0), MUGGLE_OK);
+
+	int reader = muggle_broadcast_ring_add_reader(&ring);
+	ASSERT_GE(reader, 0);
+
+	static int vals[20];
+	for (int i = 0; i < 20; i++)
+	{
+		vals[i] = i;
+		ASSERT_EQ(muggle_broadcast_ring_write(&ring, &vals[i]), MUGGLE_OK);
+	}
+	EXPECT_EQ(ring.block_cnt, 0);
+
+	for (int i = 12; i < 20; i++)
+	{
+		void *data = NULL;
+		ASSERT_EQ(muggle_broadcast_ring_read(&ring, reader, &data), MUGGLE_OK);
+		ASSERT_EQ(*(int*)data, i);
+	}
+	EXPECT_EQ(muggle_broadcast_ring_get_overrun(&ring, reader), 12u);
+
+	muggle_broadcast_ring_destroy(&ring);
+}
+
+TEST(broadcast_ring, evict_slow)
+{
+	muggle_broadcast_ring_t ring;
+	ASSERT_EQ(muggle_broadcast_ring_init(&ring, 8, 2, MUGGLE_BROADCAST_RING_POLICY_EVICT_SLOW, 0), MUGGLE_OK);
+
+	int slow = muggle_broadcast_ring_add_reader(&ring);
+	int fast = muggle_broadcast_ring_add_reader(&ring);
+	ASSERT_GE(slow, 0);
+	ASSERT_GE(fast, 0);
+
+	static int vals[20];
+	for (int i = 0; i < 20; i++)
+	{
+		vals[i] = i;
+		ASSERT_EQ(muggle_broadcast_ring_write(&ring, &vals[i]), MUGGLE_OK);
+
+		void *data = NULL;
+		ASSERT_EQ(muggle_broadcast_ring_read(&ring, fast, &data), MUGGLE_OK);
+		ASSERT_EQ(*(int*)data, i);
+	}
+	EXPECT_EQ(ring.evict_cnt, 1);
+
+	void *data = NULL;
+	EXPECT_EQ(muggle_broadcast_ring_read(&ring, slow, &data), MUGGLE_ERR_BEYOND_RANGE);
+
+	// register again
+	muggle_broadcast_ring_remove_reader(&ring, slow);
+	slow = muggle_broadcast_ring_add_reader(&ring);
+	ASSERT_GE(slow, 0);
+	ASSERT_EQ(muggle_broadcast_ring_write(&ring, &vals[0]), MUGGLE_OK);
+	ASSERT_EQ(muggle_broadcast_ring_read(&ring, slow, &data), MUGGLE_OK);
+	EXPECT_EQ(*(int*)data, 0);
+
+	muggle_broadcast_ring_destroy(&ring);
+}
+
+static void test_broadcast_block(int flags, int num_writer, int num_reader)
+{
+	const int cnt_per_writer = 5000;
+
+	muggle_broadcast_ring_t ring;
+	ASSERT_EQ(muggle_broadcast_ring_init(&ring, 64, num_reader, MUGGLE_BROADCAST_RING_POLICY_BLOCK, flags), MUGGLE_OK);
+
+	std::vector<int> reader_ids;
+	for (int i = 0; i < num_reader; i++)
+	{
+		reader_ids.push_back(muggle_broadcast_ring_add_reader(&ring));
+		ASSERT_GE(reader_ids[i], 0);
+	}
+
+	std::vector<std::vector<int>> vals(num_writer, std::vector<int>(cnt_per_writer));
+	std::vector<std::vector<int>> received(num_reader, std::vector<int>(num_writer, 0));
+	std::vector<int> in_order(num_reader, 1);
+
+	std::vector<std::thread> readers;
+	for (int r = 0; r < num_reader; r++)
+	{
+		readers.push_back(std::thread([&, r]{
+			std::vector<int> last(num_writer, -1);
+			for (int i = 0; i < num_writer * cnt_per_writer; i++)
+			{
+				void *data = NULL;
+				if (muggle_broadcast_ring_read(&ring, reader_ids[r], &data) != MUGGLE_OK)
+				{
+					in_order[r] = 0;
+					break;
+				}
+				int v = *(int*)data;
+				int w = v / cnt_per_writer;
+				int idx = v % cnt_per_writer;
+				if (idx != last[w] + 1)
+				{
+					in_order[r] = 0;
+				}
+				last[w] = idx;
+				received[r][w]++;
+			}
+		}));
+	}
+
+	std::vector<std::thread> writers;
+	for (int w = 0; w < num_writer; w++)
+	{
+		writers.push_back(std::thread([&, w]{
+			for (int i = 0; i < cnt_per_writer; i++)
+			{
+				vals[w][i] = w * cnt_per_writer + i;
+				muggle_broadcast_ring_write(&ring, &vals[w][i]);
+			}
+		}));
+	}
+
+	for (auto &t : writers)
+	{
+		t.join();
+	}
+	for (auto &t : readers)
+	{
+		t.join();
+	}
+
+	for (int r = 0; r < num_reader; r++)
+	{
+		EXPECT_TRUE(in_order[r]);
+		EXPECT_EQ(muggle_broadcast_ring_get_overrun(&ring, reader_ids[r]), 0u);
+		for (int w = 0; w < num_writer; w++)
+		{
+			EXPECT_EQ(received[r][w], cnt_per_writer);
+		}
+	}
+
+	muggle_broadcast_ring_destroy(&ring);
+}
+
+TEST(broadcast_ring, block_single_writer)
+{
+	test_broadcast_block(MUGGLE_BROADCAST_RING_FLAG_SINGLE_WRITER, 1, 4);
+	test_broadcast_block(MUGGLE_BROADCAST_RING_FLAG_SINGLE_WRITER | MUGGLE_BROADCAST_RING_FLAG_READ_BUSY_LOOP, 1, 4);
+}
+
+TEST(broadcast_ring, block_multi_writer)
+{
+	test_broadcast_block(MUGGLE_BROADCAST_RING_FLAG_WRITE_MULTI, 4, 3);
+	test_broadcast_block(MUGGLE_BROADCAST_RING_FLAG_READ_BUSY_LOOP, 4, 3);
+}
+
+TEST(broadcast_ring, add_reader_while_writing)
+{
+	const intptr_t cnt_read = 2000;
+
+	muggle_broadcast_ring_t ring;
+	ASSERT_EQ(muggle_broadcast_ring_init(&ring, 16, 2, MUGGLE_BROADCAST_RING_POLICY_BLOCK, 0), MUGGLE_OK);
+
+	// keep ring moving, so writer has cached gate when late reader register
+	int fast = muggle_broadcast_ring_add_reader(&ring);
+	ASSERT_GE(fast, 0);
+
+	muggle_atomic_int fast_cnt = 0;
+	muggle_atomic_int late_done = 0;
+
+	// messages are consecutive integers, -1 represent end
+	std::thread fast_reader([&]{
+		intptr_t expect = 0;
+		while (1)
+		{
+			void *data = NULL;
+			ASSERT_EQ(muggle_broadcast_ring_read(&ring, fast, &data), MUGGLE_OK);
+			if ((intptr_t)data == -1)
+			{
+				break;
+			}
+			ASSERT_EQ((intptr_t)data, expect);
+			expect++;
+			muggle_atomic_store(&fast_cnt, (muggle_atomic_int)expect, muggle_memory_order_relaxed);
+		}
+	});
+
+	std::thread writer([&]{
+		intptr_t i = 0;
+		while (!muggle_atomic_load(&late_done, muggle_memory_order_acquire))
+		{
+			muggle_broadcast_ring_write(&ring, (void*)i);
+			i++;
+		}
+		muggle_broadcast_ring_write(&ring, (void*)(intptr_t)-1);
+	});
+
+	// late reader must see consecutive messages, none overwritten before read
+	while (muggle_atomic_load(&fast_cnt, muggle_memory_order_relaxed) < 1000)
+	{
+		muggle_thread_yield();
+	}
+	int late = muggle_broadcast_ring_add_reader(&ring);
+	EXPECT_GE(late, 0);
+	if (late >= 0)
+	{
+		void *data = NULL;
+		EXPECT_EQ(muggle_broadcast_ring_read(&ring, late, &data), MUGGLE_OK);
+		intptr_t last = (intptr_t)data;
+		for (intptr_t i = 1; i < cnt_read; i++)
+		{
+			EXPECT_EQ(muggle_broadcast_ring_read(&ring, late, &data), MUGGLE_OK);
+			EXPECT_EQ((intptr_t)data, last + 1);
+			last = (intptr_t)data;
+		}
+		muggle_broadcast_ring_remove_reader(&ring, late);
+	}
+	muggle_atomic_store(&late_done, 1, muggle_memory_order_release);
+
+	writer.join();
+	fast_reader.join();
+
+	muggle_broadcast_ring_destroy(&ring);
+}
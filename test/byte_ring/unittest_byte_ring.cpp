@@ -0,0 +1,211 @@
+#include <thread>
+#include <vector>
+#include <map>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+TEST(byte_ring, init_destroy)
+{
+	muggle_byte_ring_t ring;
+	ASSERT_EQ(muggle_byte_ring_init(&ring, 0, 0), MUGGLE_ERR_INVALID_PARAM);
+
+	ASSERT_EQ(muggle_byte_ring_init(&ring, 1000, 0), MUGGLE_OK);
+	EXPECT_EQ(ring.capacity, 1024);
+	EXPECT_EQ(ring.max_payload, (uint32_t)(512 - MUGGLE_BYTE_RING_RECORD_HEAD_SIZE));
+	muggle_byte_ring_destroy(&ring);
+
+	ASSERT_EQ(muggle_byte_ring_init(&ring, 1, 0), MUGGLE_OK);
+	EXPECT_EQ(ring.capacity, 64);
+	muggle_byte_ring_destroy(&ring);
+}
+
+TEST(byte_ring, reserve_commit_peek_release)
+{
+	muggle_byte_ring_t ring;
+	ASSERT_EQ(muggle_byte_ring_init(&ring, 256, MUGGLE_BYTE_RING_FLAG_SINGLE_WRITER), MUGGLE_OK);
+
+	// too large
+	EXPECT_TRUE(muggle_byte_ring_reserve(&ring, ring.max_payload + 1) == NULL);
+
+	// empty
+	EXPECT_TRUE(muggle_byte_ring_try_peek(&ring, NULL) == NULL);
+
+	// variable record sizes make records wrap with padding many times
+	int seq = 0;
+	for (int loop = 0; loop < 100; loop++)
+	{
+		int cnt = 0;
+		while (1)
+		{
+			uint32_t size = (uint32_t)(1 + (seq + cnt) % 37);
+			char *p = (char*)muggle_byte_ring_reserve(&ring, size);
+			if (p == NULL)
+			{
+				break;
+			}
+			ASSERT_EQ((uintptr_t)p % MUGGLE_BYTE_RING_RECORD_ALIGN, 0u);
+			memset(p, (seq + cnt) & 0xff, size);
+			muggle_byte_ring_commit(&ring, p);
+			++cnt;
+		}
+		ASSERT_GT(cnt, 0);
+
+		for (int i = 0; i < cnt; i++)
+		{
+			uint32_t size = 0;
+			char *p = (char*)muggle_byte_ring_peek(&ring, &size);
+			ASSERT_TRUE(p != NULL);
+			ASSERT_EQ(size, (uint32_t)(1 + seq % 37));
+			for (uint32_t j = 0; j < size; j++)
+			{
+				ASSERT_EQ((unsigned char)p[j], (unsigned char)(seq & 0xff));
+			}
+			muggle_byte_ring_release(&ring);
+			++seq;
+		}
+		EXPECT_TRUE(muggle_byte_ring_try_peek(&ring, NULL) == NULL);
+	}
+
+	muggle_byte_ring_destroy(&ring);
+}
+
+TEST(byte_ring, max_payload_wrap)
+{
+	muggle_byte_ring_t ring;
+	ASSERT_EQ(muggle_byte_ring_init(&ring, 128, 0), MUGGLE_OK);
+
+	// max payload record always fit once ring is empty, whatever write position
+	for (uint32_t first = 1; first <= ring.max_payload; first += 5)
+	{
+		void *p = muggle_byte_ring_reserve(&ring, first);
+		ASSERT_TRUE(p != NULL);
+		muggle_byte_ring_commit(&ring, p);
+		ASSERT_TRUE(muggle_byte_ring_peek(&ring, NULL) == p);
+		muggle_byte_ring_release(&ring);
+
+		p = muggle_byte_ring_reserve(&ring, ring.max_payload);
+		ASSERT_TRUE(p != NULL);
+		muggle_byte_ring_commit(&ring, p);
+		uint32_t size = 0;
+		ASSERT_TRUE(muggle_byte_ring_peek(&ring, &size) == p);
+		ASSERT_EQ(size, ring.max_payload);
+		muggle_byte_ring_release(&ring);
+	}
+
+	muggle_byte_ring_destroy(&ring);
+}
+
+TEST(byte_ring, commit_out_of_order)
+{
+	muggle_byte_ring_t ring;
+	ASSERT_EQ(muggle_byte_ring_init(&ring, 256, 0), MUGGLE_OK);
+
+	int *p0 = (int*)muggle_byte_ring_reserve(&ring, sizeof(int));
+	int *p1 = (int*)muggle_byte_ring_reserve(&ring, sizeof(int) * 4);
+	ASSERT_TRUE(p0 != NULL && p1 != NULL);
+	*p0 = 0;
+	*p1 = 1;
+
+	// second record commit first, reader still can't see anything
+	muggle_byte_ring_commit(&ring, p1);
+	EXPECT_TRUE(muggle_byte_ring_try_peek(&ring, NULL) == NULL);
+
+	muggle_byte_ring_commit(&ring, p0);
+	int *p = (int*)muggle_byte_ring_try_peek(&ring, NULL);
+	ASSERT_TRUE(p != NULL);
+	EXPECT_EQ(*p, 0);
+	muggle_byte_ring_release(&ring);
+
+	uint32_t size = 0;
+	p = (int*)muggle_byte_ring_try_peek(&ring, &size);
+	ASSERT_TRUE(p != NULL);
+	EXPECT_EQ(*p, 1);
+	EXPECT_EQ(size, (uint32_t)sizeof(int) * 4);
+	muggle_byte_ring_release(&ring);
+
+	muggle_byte_ring_destroy(&ring);
+}
+
+void test_byte_ring(int flags, int cnt_writer)
+{
+	int msg_per_writer = 1024 * 16;
+	muggle_byte_ring_t ring;
+	ASSERT_EQ(muggle_byte_ring_init(&ring, 1024 * 8, flags), MUGGLE_OK);
+
+	std::vector<std::thread> writers;
+	for (int i = 0; i < cnt_writer; i++)
+	{
+		writers.push_back(std::thread([i, &ring, msg_per_writer]{
+			char buf[64];
+			for (int j = 0; j < msg_per_writer; j++)
+			{
+				int n = snprintf(buf, sizeof(buf), "%d-%d-%0*d", i, j, j % 23, 0);
+				char *msg = NULL;
+				while ((msg = (char*)muggle_byte_ring_reserve(&ring, (uint32_t)n + 1)) == NULL)
+				{
+					muggle_thread_yield();
+				}
+				memcpy(msg, buf, n + 1);
+				muggle_byte_ring_commit(&ring, msg);
+			}
+		}));
+	}
+
+	std::map<int, int> thread_cnts;
+	for (int i = 0; i < cnt_writer; i++)
+	{
+		thread_cnts[i] = 0;
+	}
+
+	char buf[64];
+	for (int i = 0; i < cnt_writer * msg_per_writer; i++)
+	{
+		uint32_t size = 0;
+		char *msg = (char*)muggle_byte_ring_peek(&ring, &size);
+		int thread_idx = atoi(msg);
+		ASSERT_LT(thread_idx, cnt_writer);
+		int j = thread_cnts[thread_idx];
+		int n = snprintf(buf, sizeof(buf), "%d-%d-%0*d", thread_idx, j, j % 23, 0);
+		ASSERT_EQ(size, (uint32_t)n + 1);
+		ASSERT_STREQ(msg, buf);
+		thread_cnts[thread_idx]++;
+		muggle_byte_ring_release(&ring);
+	}
+
+	for (auto &writer : writers)
+	{
+		writer.join();
+	}
+
+	muggle_byte_ring_destroy(&ring);
+}
+
+TEST(byte_ring, single_w_wait_r)
+{
+	test_byte_ring(MUGGLE_BYTE_RING_FLAG_SINGLE_WRITER, 1);
+}
+
+TEST(byte_ring, single_w_busyloop_r)
+{
+	test_byte_ring(MUGGLE_BYTE_RING_FLAG_SINGLE_WRITER | MUGGLE_BYTE_RING_FLAG_READ_BUSY_LOOP, 1);
+}
+
+TEST(byte_ring, mul_w_wait_r)
+{
+	int cnt_writer = (int)std::thread::hardware_concurrency();
+	if (cnt_writer <= 1)
+	{
+		cnt_writer = 2;
+	}
+	test_byte_ring(0, cnt_writer);
+}
+
+TEST(byte_ring, mul_w_busyloop_r)
+{
+	int cnt_writer = (int)std::thread::hardware_concurrency();
+	if (cnt_writer <= 1)
+	{
+		cnt_writer = 2;
+	}
+	test_byte_ring(MUGGLE_BYTE_RING_FLAG_READ_BUSY_LOOP, cnt_writer);
+}
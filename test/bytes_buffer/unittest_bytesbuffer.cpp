@@ -474,3 +474,126 @@ TEST(bytes_buffer, truncate)
 
 	muggle_bytes_buffer_destroy(&bytes_buf);
 }
+
+TEST(bytes_buffer, iov)
+{
+	int capacity = TEST_BYTES_BUF_SPACE;
+	muggle_bytes_buffer_t bytes_buf;
+	bool ret = muggle_bytes_buffer_init(&bytes_buf, capacity);
+	ASSERT_TRUE(ret);
+
+	char space[2 * TEST_BYTES_BUF_SPACE];
+	char out[2 * TEST_BYTES_BUF_SPACE];
+	for (int i = 0; i < (int)sizeof(space); ++i)
+	{
+		space[i] = (char)i;
+	}
+
+	muggle_iovec_t iov[2];
+	for (int w = 1; w < capacity; ++w)
+	{
+		for (int r = 1; r <= w; ++r)
+		{
+			muggle_bytes_buffer_clear(&bytes_buf);
+			ASSERT_TRUE(muggle_bytes_buffer_write(&bytes_buf, w, space));
+			ASSERT_TRUE(muggle_bytes_buffer_read(&bytes_buf, r, out));
+
+			// fill all writable spans
+			int writable = muggle_bytes_buffer_writable(&bytes_buf);
+			int cnt = muggle_bytes_buffer_writable_iov(&bytes_buf, iov);
+			int total = 0;
+			for (int i = 0; i < cnt; ++i)
+			{
+				memcpy(iov[i].iov_base, space + total, iov[i].iov_len);
+				total += (int)iov[i].iov_len;
+			}
+			ASSERT_EQ(total, writable);
+			ASSERT_TRUE(muggle_bytes_buffer_writer_move_iov(&bytes_buf, total));
+			ASSERT_FALSE(muggle_bytes_buffer_writer_move_iov(&bytes_buf, 1));
+
+			int readable = muggle_bytes_buffer_readable(&bytes_buf);
+			ASSERT_EQ(readable, capacity - 1);
+
+			// drain part by part across the wrap
+			int consumed = 0;
+			while (consumed < readable)
+			{
+				cnt = muggle_bytes_buffer_readable_iov(&bytes_buf, iov);
+				ASSERT_GT(cnt, 0);
+
+				int n = (int)iov[0].iov_len > 3 ? 3 : (int)iov[0].iov_len;
+				if (consumed < w - r)
+				{
+					ASSERT_EQ(((char*)iov[0].iov_base)[0], space[r + consumed]);
+				}
+				else
+				{
+					ASSERT_EQ(((char*)iov[0].iov_base)[0], space[consumed - (w - r)]);
+				}
+				ASSERT_TRUE(muggle_bytes_buffer_reader_move_iov(&bytes_buf, n));
+				consumed += n;
+			}
+			ASSERT_EQ(muggle_bytes_buffer_readable(&bytes_buf), 0);
+			ASSERT_EQ(muggle_bytes_buffer_readable_iov(&bytes_buf, iov), 0);
+		}
+	}
+
+	muggle_bytes_buffer_destroy(&bytes_buf);
+}
+
+#if !MUGGLE_PLATFORM_WINDOWS
+TEST(bytes_buffer, recv_send_peer)
+{
+	int fds[2];
+	ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+	muggle_socket_peer_t peers[2];
+	for (int i = 0; i < 2; ++i)
+	{
+		muggle_socket_peer_init(&peers[i], fds[i], MUGGLE_SOCKET_PEER_TYPE_TCP_PEER, NULL, 0);
+		muggle_socket_set_nonblock(fds[i], 1);
+	}
+
+	int capacity = TEST_BYTES_BUF_SPACE;
+	muggle_bytes_buffer_t send_buf, recv_buf;
+	ASSERT_TRUE(muggle_bytes_buffer_init(&send_buf, capacity));
+	ASSERT_TRUE(muggle_bytes_buffer_init(&recv_buf, capacity));
+
+	// let readable and writable region wrap around
+	char space[2 * TEST_BYTES_BUF_SPACE];
+	char out[2 * TEST_BYTES_BUF_SPACE];
+	for (int i = 0; i < (int)sizeof(space); ++i)
+	{
+		space[i] = (char)i;
+	}
+	ASSERT_TRUE(muggle_bytes_buffer_write(&send_buf, 12, space));
+	ASSERT_TRUE(muggle_bytes_buffer_read(&send_buf, 10, out));
+	ASSERT_TRUE(muggle_bytes_buffer_write(&send_buf, 10, space + 12));
+	ASSERT_TRUE(muggle_bytes_buffer_write(&recv_buf, 12, space));
+	ASSERT_TRUE(muggle_bytes_buffer_read(&recv_buf, 12, out));
+	ASSERT_TRUE(muggle_bytes_buffer_write(&recv_buf, 8, space));
+	ASSERT_TRUE(muggle_bytes_buffer_read(&recv_buf, 6, out));
+
+	ASSERT_EQ(muggle_bytes_buffer_send_to(&send_buf, &peers[0]), 12);
+	ASSERT_EQ(muggle_bytes_buffer_readable(&send_buf), 0);
+
+	ASSERT_EQ(muggle_bytes_buffer_recv_from(&recv_buf, &peers[1]), 12);
+	ASSERT_EQ(muggle_bytes_buffer_readable(&recv_buf), 14);
+	ASSERT_TRUE(muggle_bytes_buffer_read(&recv_buf, 14, out));
+	ASSERT_EQ(memcmp(out, space + 6, 2), 0);
+	ASSERT_EQ(memcmp(out + 2, space + 10, 12), 0);
+
+	// nothing to receive
+	ASSERT_EQ(muggle_bytes_buffer_recv_from(&recv_buf, &peers[1]), -1);
+	ASSERT_EQ(peers[1].status, MUGGLE_SOCKET_PEER_STATUS_ACTIVE);
+
+	// peer closed
+	muggle_socket_close(fds[0]);
+	ASSERT_EQ(muggle_bytes_buffer_recv_from(&recv_buf, &peers[1]), 0);
+	ASSERT_EQ(peers[1].status, MUGGLE_SOCKET_PEER_STATUS_CLOSED);
+
+	muggle_socket_close(fds[1]);
+	muggle_bytes_buffer_destroy(&send_buf);
+	muggle_bytes_buffer_destroy(&recv_buf);
+}
+#endif
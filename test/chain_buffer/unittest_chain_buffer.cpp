@@ -0,0 +1,220 @@
+#include <string>
+#include <vector>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+static std::string chain_buffer_str(muggle_chain_buffer_t *buf)
+{
+	std::string s(muggle_chain_buffer_readable(buf), '\0');
+	if (!s.empty())
+	{
+		EXPECT_EQ(muggle_chain_buffer_fetch(buf, &s[0], (int)s.size()), MUGGLE_OK);
+	}
+	return s;
+}
+
+static std::string gen_str(int len)
+{
+	std::string s;
+	for (int i = 0; i < len; i++)
+	{
+		s.push_back((char)('a' + i % 26));
+	}
+	return s;
+}
+
+TEST(chain_buffer, write_read)
+{
+	muggle_chain_buffer_t buf;
+	ASSERT_EQ(muggle_chain_buffer_init(&buf, 16), MUGGLE_OK);
+
+	std::string s = gen_str(100);
+	ASSERT_EQ(muggle_chain_buffer_write(&buf, s.data(), (int)s.size()), MUGGLE_OK);
+	EXPECT_EQ(muggle_chain_buffer_readable(&buf), 100);
+	EXPECT_EQ(chain_buffer_str(&buf), s);
+
+	char tmp[64];
+	char *p = (char*)muggle_chain_buffer_peek(&buf, 8, tmp);
+	EXPECT_NE(p, tmp);
+	EXPECT_EQ(std::string(p, 8), s.substr(0, 8));
+
+	p = (char*)muggle_chain_buffer_peek(&buf, 40, tmp);
+	EXPECT_EQ(p, tmp);
+	EXPECT_EQ(std::string(p, 40), s.substr(0, 40));
+	EXPECT_TRUE(muggle_chain_buffer_peek(&buf, 101, tmp) == NULL);
+
+	ASSERT_EQ(muggle_chain_buffer_read(&buf, tmp, 20), MUGGLE_OK);
+	EXPECT_EQ(std::string(tmp, 20), s.substr(0, 20));
+	EXPECT_EQ(chain_buffer_str(&buf), s.substr(20));
+
+	ASSERT_EQ(muggle_chain_buffer_consume(&buf, 80), MUGGLE_OK);
+	EXPECT_EQ(muggle_chain_buffer_readable(&buf), 0);
+	EXPECT_NE(muggle_chain_buffer_consume(&buf, 1), MUGGLE_OK);
+
+	// write after drained
+	ASSERT_EQ(muggle_chain_buffer_write(&buf, s.data(), 30), MUGGLE_OK);
+	EXPECT_EQ(chain_buffer_str(&buf), s.substr(0, 30));
+
+	muggle_chain_buffer_destroy(&buf);
+}
+
+TEST(chain_buffer, reserve_commit)
+{
+	muggle_chain_buffer_t buf;
+	ASSERT_EQ(muggle_chain_buffer_init(&buf, 16), MUGGLE_OK);
+	ASSERT_EQ(muggle_chain_buffer_write(&buf, "hello", 5), MUGGLE_OK);
+
+	muggle_iovec_t iov[8];
+	int cnt = muggle_chain_buffer_reserve_iov(&buf, 40, iov, 8);
+	ASSERT_EQ(cnt, 3);
+	EXPECT_EQ(iov[0].iov_len, 11u);
+	EXPECT_EQ(iov[1].iov_len, 16u);
+
+	// simulate readv receive 30 bytes
+	std::string s = gen_str(30);
+	int remain = 30;
+	const char *src = s.data();
+	for (int i = 0; i < cnt && remain > 0; i++)
+	{
+		int n = (int)iov[i].iov_len < remain ? (int)iov[i].iov_len : remain;
+		memcpy(iov[i].iov_base, src, n);
+		src += n;
+		remain -= n;
+	}
+	ASSERT_EQ(muggle_chain_buffer_commit(&buf, 30), MUGGLE_OK);
+	EXPECT_EQ(chain_buffer_str(&buf), "hello" + s);
+
+	// continue write into reserved space
+	ASSERT_EQ(muggle_chain_buffer_write(&buf, "world", 5), MUGGLE_OK);
+	EXPECT_EQ(chain_buffer_str(&buf), "hello" + s + "world");
+
+	cnt = muggle_chain_buffer_read_iov(&buf, iov, 8);
+	ASSERT_EQ(cnt, 3);
+	size_t total = 0;
+	for (int i = 0; i < cnt; i++)
+	{
+		total += iov[i].iov_len;
+	}
+	EXPECT_EQ(total, 40u);
+
+	muggle_chain_buffer_destroy(&buf);
+}
+
+TEST(chain_buffer, splice_append_ref)
+{
+	muggle_chain_buffer_t src, dst, fwd;
+	muggle_chain_buffer_init(&src, 16);
+	muggle_chain_buffer_init(&dst, 16);
+	muggle_chain_buffer_init(&fwd, 16);
+
+	std::string s = gen_str(50);
+	ASSERT_EQ(muggle_chain_buffer_write(&src, s.data(), (int)s.size()), MUGGLE_OK);
+	ASSERT_EQ(muggle_chain_buffer_write(&dst, "head", 4), MUGGLE_OK);
+
+	// share first 20 bytes without copy
+	ASSERT_EQ(muggle_chain_buffer_append_ref(&fwd, &src, 20), MUGGLE_OK);
+	EXPECT_EQ(chain_buffer_str(&fwd), s.substr(0, 20));
+	EXPECT_EQ(chain_buffer_str(&src), s);
+
+	// move 20 bytes, segment across boundary is split
+	ASSERT_EQ(muggle_chain_buffer_splice(&dst, &src, 20), MUGGLE_OK);
+	EXPECT_EQ(chain_buffer_str(&dst), "head" + s.substr(0, 20));
+	EXPECT_EQ(chain_buffer_str(&src), s.substr(20));
+
+	// src still writable, dst write after spliced bytes
+	ASSERT_EQ(muggle_chain_buffer_write(&src, "xyz", 3), MUGGLE_OK);
+	ASSERT_EQ(muggle_chain_buffer_write(&dst, "tail", 4), MUGGLE_OK);
+	EXPECT_EQ(chain_buffer_str(&src), s.substr(20) + "xyz");
+	EXPECT_EQ(chain_buffer_str(&dst), "head" + s.substr(0, 20) + "tail");
+	EXPECT_EQ(chain_buffer_str(&fwd), s.substr(0, 20));
+
+	// move all
+	ASSERT_EQ(muggle_chain_buffer_splice(&dst, &src, muggle_chain_buffer_readable(&src)), MUGGLE_OK);
+	EXPECT_EQ(muggle_chain_buffer_readable(&src), 0);
+	EXPECT_EQ(chain_buffer_str(&dst), "head" + s.substr(0, 20) + "tail" + s.substr(20) + "xyz");
+	ASSERT_EQ(muggle_chain_buffer_write(&src, "new", 3), MUGGLE_OK);
+	EXPECT_EQ(chain_buffer_str(&src), "new");
+	EXPECT_EQ(chain_buffer_str(&dst), "head" + s.substr(0, 20) + "tail" + s.substr(20) + "xyz");
+
+	EXPECT_NE(muggle_chain_buffer_splice(&dst, &src, 4), MUGGLE_OK);
+
+	muggle_chain_buffer_destroy(&src);
+	muggle_chain_buffer_destroy(&dst);
+	muggle_chain_buffer_destroy(&fwd);
+}
+
+static void chain_buffer_test_free(void *ctx, void *data)
+{
+	EXPECT_TRUE(data != NULL);
+	(*(int*)ctx)++;
+}
+
+TEST(chain_buffer, append_block)
+{
+	int free_cnt = 0;
+	static char msg[] = "zero copy message";
+	muggle_chain_block_t *block = muggle_chain_block_wrap(
+		msg, (int)strlen(msg), chain_buffer_test_free, &free_cnt);
+	ASSERT_TRUE(block != NULL);
+
+	muggle_chain_buffer_t bufs[4];
+	for (int i = 0; i < 4; i++)
+	{
+		muggle_chain_buffer_init(&bufs[i], 0);
+		ASSERT_EQ(muggle_chain_buffer_write(&bufs[i], "> ", 2), MUGGLE_OK);
+		ASSERT_EQ(muggle_chain_buffer_append_block(&bufs[i], block, 0, block->capacity), MUGGLE_OK);
+		ASSERT_EQ(muggle_chain_buffer_write(&bufs[i], "\n", 1), MUGGLE_OK);
+	}
+	EXPECT_NE(muggle_chain_buffer_append_block(&bufs[0], block, 1, block->capacity), MUGGLE_OK);
+	muggle_chain_block_release(block);
+	EXPECT_EQ(free_cnt, 0);
+
+	for (int i = 0; i < 4; i++)
+	{
+		EXPECT_EQ(chain_buffer_str(&bufs[i]), std::string("> ") + msg + "\n");
+		muggle_chain_buffer_destroy(&bufs[i]);
+	}
+	EXPECT_EQ(free_cnt, 1);
+}
+
+#if !MUGGLE_PLATFORM_WINDOWS
+TEST(chain_buffer, recv_send_peer)
+{
+	int fds[2];
+	ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+
+	muggle_socket_peer_t peers[2];
+	for (int i = 0; i < 2; ++i)
+	{
+		muggle_socket_peer_init(&peers[i], fds[i], MUGGLE_SOCKET_PEER_TYPE_TCP_PEER, NULL, 0);
+		muggle_socket_set_nonblock(fds[i], 1);
+	}
+
+	// small blocks, so bytes span several segments
+	muggle_chain_buffer_t send_buf, recv_buf;
+	ASSERT_EQ(muggle_chain_buffer_init(&send_buf, 16), MUGGLE_OK);
+	ASSERT_EQ(muggle_chain_buffer_init(&recv_buf, 16), MUGGLE_OK);
+
+	std::string s = gen_str(100);
+	ASSERT_EQ(muggle_chain_buffer_write(&send_buf, s.data(), (int)s.size()), MUGGLE_OK);
+	ASSERT_EQ(muggle_chain_buffer_send_to(&send_buf, &peers[0]), (int)s.size());
+	EXPECT_EQ(muggle_chain_buffer_readable(&send_buf), 0);
+
+	ASSERT_EQ(muggle_chain_buffer_recv_from(&recv_buf, &peers[1], (int)s.size()), (int)s.size());
+	EXPECT_EQ(chain_buffer_str(&recv_buf), s);
+
+	// nothing to receive
+	ASSERT_EQ(muggle_chain_buffer_recv_from(&recv_buf, &peers[1], 16), -1);
+	ASSERT_EQ(peers[1].status, MUGGLE_SOCKET_PEER_STATUS_ACTIVE);
+	EXPECT_EQ(muggle_chain_buffer_readable(&recv_buf), (int)s.size());
+
+	// peer closed
+	muggle_socket_close(fds[0]);
+	ASSERT_EQ(muggle_chain_buffer_recv_from(&recv_buf, &peers[1], 16), 0);
+	ASSERT_EQ(peers[1].status, MUGGLE_SOCKET_PEER_STATUS_CLOSED);
+
+	muggle_socket_close(fds[1]);
+	muggle_chain_buffer_destroy(&send_buf);
+	muggle_chain_buffer_destroy(&recv_buf);
+}
+#endif
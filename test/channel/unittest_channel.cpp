@@ -1,6 +1,7 @@
 #include <thread>
 #include <vector>
 #include <map>
+#include <chrono>
 #include "gtest/gtest.h"
 #include "muggle/c/muggle_c.h"
 
@@ -11,7 +12,7 @@ struct chan_data
 	int thread_msg_idx;
 };
 
-void test_chan(int flags, int cnt_writer)
+void test_chan(int flags, int cnt_writer, int spin_cnt = -1, int yield_cnt = -1)
 {
 	muggle_atomic_int capacity = 1024 * 4;
 	int cnt_msg = capacity * 32;
@@ -20,6 +21,10 @@ void test_chan(int flags, int cnt_writer)
 
 	muggle_channel_t chan;
 	muggle_channel_init(&chan, capacity, flags);
+	if (spin_cnt >= 0 && yield_cnt >= 0)
+	{
+		muggle_channel_set_adaptive_wait(&chan, spin_cnt, yield_cnt);
+	}
 
 	std::map<int, int> thread_cnts;
 	for (int i = 0; i < cnt_writer; i++)
@@ -109,6 +114,17 @@ TEST(channel, default_w_busyloop_r)
 	test_chan(MUGGLE_CHANNEL_FLAG_READ_BUSY_LOOP, cnt_writer);
 }
 
+TEST(channel, futex_w_default_r)
+{
+	int cnt_writer = (int)std::thread::hardware_concurrency() * 2;
+	if (cnt_writer <= 0)
+	{
+		cnt_writer = 4;
+	}
+
+	test_chan(MUGGLE_CHANNEL_FLAG_WRITE_FUTEX, cnt_writer);
+}
+
 TEST(channel, single_w_default_r)
 {
 	test_chan(MUGGLE_CHANNEL_FLAG_SINGLE_WRITER, 1);
@@ -118,3 +134,228 @@ TEST(channel, single_w_busyloop_r)
 {
 	test_chan(MUGGLE_CHANNEL_FLAG_SINGLE_WRITER | MUGGLE_CHANNEL_FLAG_READ_BUSY_LOOP, 1);
 }
+TEST(channel, default_w_adaptive_r)
+{
+	int cnt_writer = (int)std::thread::hardware_concurrency() * 2;
+	if (cnt_writer <= 0)
+	{
+		cnt_writer = 4;
+	}
+
+	test_chan(MUGGLE_CHANNEL_FLAG_READ_ADAPTIVE, cnt_writer);
+}
+
+TEST(channel, single_w_adaptive_r_no_spin)
+{
+	// reader park immediately, writer must wake it every time it parked
+	test_chan(MUGGLE_CHANNEL_FLAG_SINGLE_WRITER | MUGGLE_CHANNEL_FLAG_READ_ADAPTIVE, 1, 0, 0);
+}
+
+void test_chan_multi_reader(int flags, int cnt_writer, int cnt_reader)
+{
+	muggle_atomic_int capacity = 1024;
+	int cnt_msg = capacity * 32;
+	muggle_atomic_int msg_idx = 0;
+	chan_data *datas = (chan_data*)malloc(cnt_msg * sizeof(chan_data));
+	muggle_atomic_int *recv_flags = (muggle_atomic_int*)malloc(cnt_msg * sizeof(muggle_atomic_int));
+	memset(recv_flags, 0, cnt_msg * sizeof(muggle_atomic_int));
+
+	muggle_channel_t chan;
+	muggle_channel_init(&chan, capacity, flags | MUGGLE_CHANNEL_FLAG_MULTI_READER);
+
+	// write
+	std::vector<std::thread> writers;
+	for (int i = 0; i < cnt_writer; i++)
+	{
+		writers.push_back(std::thread([i, &chan, &msg_idx, &cnt_msg, &datas]{
+			int thread_msg_idx = 0;
+
+			muggle_atomic_int cur_idx = 0;
+			while (true)
+			{
+				cur_idx = muggle_atomic_fetch_add(&msg_idx, 1, muggle_memory_order_relaxed);
+				if (cur_idx >= cnt_msg)
+				{
+					break;
+				}
+
+				datas[cur_idx].idx = cur_idx;
+				datas[cur_idx].thread_idx = i;
+				datas[cur_idx].thread_msg_idx = thread_msg_idx++;
+
+				while (muggle_channel_write(&chan, &datas[cur_idx]) == MUGGLE_ERR_FULL)
+				{
+					muggle_thread_yield();
+				}
+			} 
+		}));
+	}
+
+	// read
+	muggle_atomic_int recv_cnt = 0;
+	std::vector<std::thread> readers;
+	for (int i = 0; i < cnt_reader; i++)
+	{
+		readers.push_back(std::thread([&]{
+			while (true)
+			{
+				chan_data *data = (chan_data*)muggle_channel_read(&chan);
+				if (data == nullptr)
+				{
+					break;
+				}
+
+				ASSERT_LT(data->thread_idx, cnt_writer);
+				ASSERT_EQ(muggle_atomic_fetch_add(&recv_flags[data->idx], 1, muggle_memory_order_relaxed), 0);
+				muggle_atomic_fetch_add(&recv_cnt, 1, muggle_memory_order_relaxed);
+			}
+		}));
+	}
+
+	for (int i = 0; i < cnt_writer; i++)
+	{
+		writers[i].join();
+	}
+
+	for (int i = 0; i < cnt_reader; i++)
+	{
+		while (muggle_channel_write(&chan, nullptr) == MUGGLE_ERR_FULL)
+		{
+			muggle_thread_yield();
+		}
+	}
+
+	for (int i = 0; i < cnt_reader; i++)
+	{
+		readers[i].join();
+	}
+
+	ASSERT_EQ(recv_cnt, cnt_msg);
+	for (int i = 0; i < cnt_msg; i++)
+	{
+		ASSERT_EQ(recv_flags[i], 1);
+	}
+
+	// free resource
+	free(recv_flags);
+	free(datas);
+	muggle_channel_destroy(&chan);
+}
+
+TEST(channel, multi_w_multi_r)
+{
+	int cnt = (int)std::thread::hardware_concurrency();
+	if (cnt <= 1)
+	{
+		cnt = 2;
+	}
+
+	test_chan_multi_reader(0, cnt, cnt);
+	test_chan_multi_reader(0, 1, cnt);
+	test_chan_multi_reader(0, cnt, 1);
+}
+
+TEST(channel, multi_w_multi_busyloop_r)
+{
+	int cnt = (int)std::thread::hardware_concurrency();
+	if (cnt <= 1)
+	{
+		cnt = 2;
+	}
+
+	test_chan_multi_reader(MUGGLE_CHANNEL_FLAG_READ_BUSY_LOOP, cnt, cnt);
+}
+
+TEST(channel, multi_w_multi_adaptive_r)
+{
+	int cnt = (int)std::thread::hardware_concurrency();
+	if (cnt <= 1)
+	{
+		cnt = 2;
+	}
+
+	test_chan_multi_reader(MUGGLE_CHANNEL_FLAG_READ_ADAPTIVE, cnt, cnt);
+}
+
+TEST(channel, try_read_and_timeout)
+{
+	int flags[] = {
+		MUGGLE_CHANNEL_FLAG_READ_WAIT,
+		MUGGLE_CHANNEL_FLAG_READ_BUSY_LOOP,
+		MUGGLE_CHANNEL_FLAG_READ_ADAPTIVE,
+		MUGGLE_CHANNEL_FLAG_MULTI_READER,
+		MUGGLE_CHANNEL_FLAG_MULTI_READER | MUGGLE_CHANNEL_FLAG_READ_ADAPTIVE
+	};
+	for (int i = 0; i < (int)(sizeof(flags) / sizeof(flags[0])); ++i)
+	{
+		muggle_channel_t chan;
+		ASSERT_EQ(muggle_channel_init(&chan, 16, flags[i]), MUGGLE_OK);
+
+		void *data = NULL;
+		EXPECT_EQ(muggle_channel_try_read(&chan, &data), MUGGLE_ERR_EMPTY);
+
+		struct timespec deadline;
+		muggle_deadline_after(&deadline, 5);
+		EXPECT_EQ(muggle_channel_read_timed(&chan, &deadline, &data), MUGGLE_ERR_TIMEOUT);
+		EXPECT_FALSE(muggle_deadline_remaining(&deadline, NULL));
+
+		int val = 7;
+		ASSERT_EQ(muggle_channel_write(&chan, &val), MUGGLE_OK);
+		muggle_deadline_after(&deadline, 5);
+		ASSERT_EQ(muggle_channel_read_timed(&chan, &deadline, &data), MUGGLE_OK);
+		EXPECT_EQ(*(int*)data, 7);
+		EXPECT_EQ(muggle_channel_try_read(&chan, &data), MUGGLE_ERR_EMPTY);
+
+		muggle_channel_destroy(&chan);
+	}
+}
+
+TEST(channel, timed_read_race_with_write)
+{
+	int flags[] = {
+		MUGGLE_CHANNEL_FLAG_READ_WAIT,
+		MUGGLE_CHANNEL_FLAG_READ_ADAPTIVE,
+		MUGGLE_CHANNEL_FLAG_MULTI_READER
+	};
+	for (int i = 0; i < (int)(sizeof(flags) / sizeof(flags[0])); ++i)
+	{
+		const int cnt = 200;
+		std::vector<int> vals(cnt);
+		muggle_channel_t chan;
+		ASSERT_EQ(muggle_channel_init(&chan, 1024, flags[i]), MUGGLE_OK);
+		muggle_channel_set_adaptive_wait(&chan, 0, 0);
+
+		std::thread writer([&]{
+			for (int j = 0; j < cnt; ++j)
+			{
+				vals[j] = j;
+				std::this_thread::sleep_for(std::chrono::microseconds(j % 3 * 500));
+				muggle_channel_write(&chan, &vals[j]);
+			}
+		});
+
+		for (int j = 0; j < cnt;)
+		{
+			struct timespec deadline;
+			muggle_deadline_after(&deadline, 1);
+
+			void *data = NULL;
+			int ret = muggle_channel_read_timed(&chan, &deadline, &data);
+			if (ret == MUGGLE_ERR_TIMEOUT)
+			{
+				continue;
+			}
+			ASSERT_EQ(ret, MUGGLE_OK);
+			ASSERT_EQ(*(int*)data, j);
+			j++;
+		}
+
+		writer.join();
+
+		void *data = NULL;
+		EXPECT_EQ(muggle_channel_try_read(&chan, &data), MUGGLE_ERR_EMPTY);
+		EXPECT_EQ(chan.read_waiters, 0);
+
+		muggle_channel_destroy(&chan);
+	}
+}
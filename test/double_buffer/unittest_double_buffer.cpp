@@ -0,0 +1,201 @@
+#include <thread>
+#include <chrono>
+#include <vector>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+static void test_try_and_timeout(int flags)
+{
+	muggle_double_buffer_t buf;
+	ASSERT_EQ(muggle_double_buffer_init_ex(&buf, 2, 0, flags), MUGGLE_OK);
+
+	EXPECT_TRUE(muggle_double_buffer_try_read(&buf) == NULL);
+
+	struct timespec deadline;
+	muggle_deadline_after(&deadline, 5);
+	EXPECT_TRUE(muggle_double_buffer_read_timed(&buf, &deadline) == NULL);
+	EXPECT_FALSE(muggle_deadline_remaining(&deadline, NULL));
+
+	int arr[2] = {1, 2};
+	muggle_deadline_after(&deadline, 5);
+	EXPECT_EQ(muggle_double_buffer_write_timed(&buf, &arr[0], &deadline), MUGGLE_OK);
+	EXPECT_EQ(muggle_double_buffer_write_timed(&buf, &arr[1], &deadline), MUGGLE_OK);
+	EXPECT_EQ(muggle_double_buffer_write_timed(&buf, &arr[0], &deadline), MUGGLE_ERR_TIMEOUT);
+
+	muggle_single_buffer_t *p = muggle_double_buffer_try_read(&buf);
+	ASSERT_TRUE(p != NULL);
+	ASSERT_EQ(p->cnt, 2);
+	EXPECT_EQ(*(int*)p->datas[0], 1);
+	EXPECT_EQ(*(int*)p->datas[1], 2);
+
+	EXPECT_TRUE(muggle_double_buffer_try_read(&buf) == NULL);
+
+	muggle_double_buffer_destroy(&buf);
+}
+
+TEST(double_buffer, try_and_timeout)
+{
+	test_try_and_timeout(MUGGLE_DOUBLE_BUFFER_FLAG_LOCK);
+	test_try_and_timeout(MUGGLE_DOUBLE_BUFFER_FLAG_LOCKFREE);
+}
+
+static void test_timed_read_race_with_write(int flags)
+{
+	const int cnt = 200;
+	std::vector<int> vals(cnt);
+	muggle_double_buffer_t buf;
+	ASSERT_EQ(muggle_double_buffer_init_ex(&buf, 8, 0, flags), MUGGLE_OK);
+
+	std::thread writer([&]{
+		for (int i = 0; i < cnt; ++i)
+		{
+			vals[i] = i;
+			std::this_thread::sleep_for(std::chrono::microseconds(i % 3 * 500));
+			muggle_double_buffer_write(&buf, &vals[i]);
+		}
+	});
+
+	int expect = 0;
+	while (expect < cnt)
+	{
+		struct timespec deadline;
+		muggle_deadline_after(&deadline, 1);
+
+		muggle_single_buffer_t *p = muggle_double_buffer_read_timed(&buf, &deadline);
+		if (p == NULL)
+		{
+			continue;
+		}
+
+		ASSERT_GT(p->cnt, 0);
+		for (int i = 0; i < p->cnt; ++i)
+		{
+			ASSERT_EQ(*(int*)p->datas[i], expect);
+			expect++;
+		}
+	}
+
+	writer.join();
+
+	EXPECT_TRUE(muggle_double_buffer_try_read(&buf) == NULL);
+
+	muggle_double_buffer_destroy(&buf);
+}
+
+TEST(double_buffer, timed_read_race_with_write)
+{
+	test_timed_read_race_with_write(MUGGLE_DOUBLE_BUFFER_FLAG_LOCK);
+	test_timed_read_race_with_write(MUGGLE_DOUBLE_BUFFER_FLAG_LOCKFREE);
+}
+
+static void test_mul_writer_batch_drain(int flags, int capacity)
+{
+	int cnt_writer = (int)std::thread::hardware_concurrency();
+	if (cnt_writer < 2)
+	{
+		cnt_writer = 2;
+	}
+	const int cnt_per_writer = 20000;
+
+	muggle_double_buffer_t buf;
+	ASSERT_EQ(muggle_double_buffer_init_ex(&buf, capacity, 0, flags), MUGGLE_OK);
+
+	std::vector<std::vector<int>> vals(cnt_writer, std::vector<int>(cnt_per_writer));
+	std::vector<std::thread> writers;
+	for (int w = 0; w < cnt_writer; ++w)
+	{
+		writers.push_back(std::thread([&, w]{
+			for (int i = 0; i < cnt_per_writer; ++i)
+			{
+				vals[w][i] = w * cnt_per_writer + i;
+				ASSERT_EQ(muggle_double_buffer_write(&buf, &vals[w][i]), MUGGLE_OK);
+			}
+		}));
+	}
+
+	// every writer's messages arrive in order, and nothing lost
+	std::vector<int> next(cnt_writer, 0);
+	int total = 0;
+	while (total < cnt_writer * cnt_per_writer)
+	{
+		muggle_single_buffer_t *p = muggle_double_buffer_read(&buf);
+		ASSERT_GT(p->cnt, 0);
+		ASSERT_LE(p->cnt, capacity);
+		for (int i = 0; i < p->cnt; ++i)
+		{
+			int v = *(int*)p->datas[i];
+			int w = v / cnt_per_writer;
+			ASSERT_EQ(v % cnt_per_writer, next[w]);
+			next[w]++;
+		}
+		total += p->cnt;
+	}
+
+	for (auto &t : writers)
+	{
+		t.join();
+	}
+
+	EXPECT_TRUE(muggle_double_buffer_try_read(&buf) == NULL);
+
+	muggle_double_buffer_destroy(&buf);
+}
+
+TEST(double_buffer, mul_writer_batch_drain)
+{
+	test_mul_writer_batch_drain(MUGGLE_DOUBLE_BUFFER_FLAG_LOCK, 1024);
+	test_mul_writer_batch_drain(MUGGLE_DOUBLE_BUFFER_FLAG_LOCKFREE, 1024);
+
+	// small capacity, make writers park on full buffer
+	test_mul_writer_batch_drain(MUGGLE_DOUBLE_BUFFER_FLAG_LOCKFREE, 4);
+}
+
+TEST(double_buffer, lockfree_non_blocking_full)
+{
+	muggle_double_buffer_t buf;
+	ASSERT_EQ(muggle_double_buffer_init_ex(&buf, 2, 1, MUGGLE_DOUBLE_BUFFER_FLAG_LOCKFREE), MUGGLE_OK);
+
+	int arr[3] = {1, 2, 3};
+	EXPECT_EQ(muggle_double_buffer_write(&buf, &arr[0]), MUGGLE_OK);
+	EXPECT_EQ(muggle_double_buffer_write(&buf, &arr[1]), MUGGLE_OK);
+	EXPECT_EQ(muggle_double_buffer_write(&buf, &arr[2]), MUGGLE_ERR_FULL);
+
+	muggle_single_buffer_t *p = muggle_double_buffer_read(&buf);
+	ASSERT_EQ(p->cnt, 2);
+	EXPECT_EQ(*(int*)p->datas[1], 2);
+
+	EXPECT_EQ(muggle_double_buffer_write(&buf, &arr[2]), MUGGLE_OK);
+	p = muggle_double_buffer_read(&buf);
+	ASSERT_EQ(p->cnt, 1);
+	EXPECT_EQ(*(int*)p->datas[0], 3);
+
+	muggle_double_buffer_destroy(&buf);
+}
+
+TEST(double_buffer, lockfree_non_blocking_full_many)
+{
+	muggle_double_buffer_t buf;
+	ASSERT_EQ(muggle_double_buffer_init_ex(&buf, 2, 1, MUGGLE_DOUBLE_BUFFER_FLAG_LOCKFREE), MUGGLE_OK);
+
+	int arr[3] = {1, 2, 3};
+	for (int round = 0; round < 4; round++)
+	{
+		EXPECT_EQ(muggle_double_buffer_write(&buf, &arr[0]), MUGGLE_OK);
+		EXPECT_EQ(muggle_double_buffer_write(&buf, &arr[1]), MUGGLE_OK);
+
+		// failed writes must not move reserve count toward sealed range
+		int idx = buf.swap_seq & 1;
+		for (int i = 0; i < 100000; i++)
+		{
+			ASSERT_EQ(muggle_double_buffer_write(&buf, &arr[2]), MUGGLE_ERR_FULL);
+		}
+		EXPECT_EQ(buf.reserve[idx], 2);
+
+		muggle_single_buffer_t *p = muggle_double_buffer_read(&buf);
+		ASSERT_EQ(p->cnt, 2);
+		EXPECT_EQ(*(int*)p->datas[0], 1);
+		EXPECT_EQ(*(int*)p->datas[1], 2);
+	}
+
+	muggle_double_buffer_destroy(&buf);
+}
@@ -0,0 +1,226 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+#define TEST_EBR_MAGIC_ALIVE 0x5a5a5a5a
+#define TEST_EBR_MAGIC_DEAD  0x0
+
+struct test_ebr_node
+{
+	struct test_ebr_node *next;
+	muggle_atomic_int magic;
+	int value;
+};
+
+static muggle_atomic_int s_free_cnt = 0;
+
+static void test_ebr_free(void *ptr)
+{
+	struct test_ebr_node *node = (struct test_ebr_node*)ptr;
+	muggle_atomic_store(&node->magic, TEST_EBR_MAGIC_DEAD, muggle_memory_order_relaxed);
+	free(node);
+	muggle_atomic_fetch_add(&s_free_cnt, 1, muggle_memory_order_relaxed);
+}
+
+static void test_ebr_count_free(void *ptr)
+{
+	int *cnt = (int*)ptr;
+	(*cnt)++;
+}
+
+TEST(ebr, retire_collect)
+{
+	muggle_ebr_t ebr;
+	ASSERT_EQ(muggle_ebr_init(&ebr), MUGGLE_OK);
+
+	muggle_ebr_thread_t thread;
+	ASSERT_EQ(muggle_ebr_register(&ebr, &thread), MUGGLE_OK);
+
+	int freed = 0;
+	muggle_ebr_enter(&thread);
+	for (int i = 0; i < MUGGLE_EBR_COLLECT_THRESHOLD * 2; i++)
+	{
+		ASSERT_EQ(muggle_ebr_retire(&thread, &freed, test_ebr_count_free), MUGGLE_OK);
+	}
+
+	// still in critical section, nothing can be freed
+	EXPECT_EQ(muggle_ebr_collect(&thread), 0);
+	EXPECT_EQ(freed, 0);
+	EXPECT_EQ(muggle_ebr_pending(&thread), MUGGLE_EBR_COLLECT_THRESHOLD * 2);
+	muggle_ebr_exit(&thread);
+
+	for (int i = 0; i < 3; i++)
+	{
+		muggle_ebr_collect(&thread);
+	}
+	EXPECT_EQ(freed, MUGGLE_EBR_COLLECT_THRESHOLD * 2);
+	EXPECT_EQ(muggle_ebr_pending(&thread), 0);
+
+	muggle_ebr_unregister(&thread);
+	muggle_ebr_destroy(&ebr);
+}
+
+TEST(ebr, block_by_reader)
+{
+	muggle_ebr_t ebr;
+	ASSERT_EQ(muggle_ebr_init(&ebr), MUGGLE_OK);
+
+	muggle_ebr_thread_t writer, reader;
+	ASSERT_EQ(muggle_ebr_register(&ebr, &writer), MUGGLE_OK);
+	ASSERT_EQ(muggle_ebr_register(&ebr, &reader), MUGGLE_OK);
+
+	int freed = 0;
+	muggle_ebr_enter(&reader);
+	muggle_ebr_enter(&reader);  // nested
+	muggle_ebr_exit(&reader);
+
+	muggle_ebr_retire(&writer, &freed, test_ebr_count_free);
+	for (int i = 0; i < 8; i++)
+	{
+		muggle_ebr_collect(&writer);
+	}
+	EXPECT_EQ(freed, 0);
+
+	muggle_ebr_exit(&reader);
+	for (int i = 0; i < 3; i++)
+	{
+		muggle_ebr_collect(&writer);
+	}
+	EXPECT_EQ(freed, 1);
+
+	muggle_ebr_unregister(&reader);
+	muggle_ebr_unregister(&writer);
+	muggle_ebr_destroy(&ebr);
+}
+
+TEST(ebr, unregister_orphans)
+{
+	muggle_ebr_t ebr;
+	ASSERT_EQ(muggle_ebr_init(&ebr), MUGGLE_OK);
+
+	muggle_ebr_thread_t t1, t2;
+	ASSERT_EQ(muggle_ebr_register(&ebr, &t1), MUGGLE_OK);
+	ASSERT_EQ(muggle_ebr_register(&ebr, &t2), MUGGLE_OK);
+
+	int freed = 0;
+	for (int i = 0; i < 10; i++)
+	{
+		muggle_ebr_retire(&t1, &freed, test_ebr_count_free);
+	}
+	muggle_ebr_unregister(&t1);
+	EXPECT_EQ(freed, 0);
+
+	for (int i = 0; i < 3; i++)
+	{
+		muggle_ebr_collect(&t2);
+	}
+	EXPECT_EQ(freed, 10);
+
+	// destroy free nodes still pending
+	muggle_ebr_retire(&t2, &freed, test_ebr_count_free);
+	muggle_ebr_destroy(&ebr);
+	EXPECT_EQ(freed, 11);
+}
+
+TEST(ebr, treiber_stack_stress)
+{
+	muggle_ebr_t ebr;
+	ASSERT_EQ(muggle_ebr_init(&ebr), MUGGLE_OK);
+
+	std::atomic<struct test_ebr_node*> head(nullptr);
+	muggle_atomic_int alloc_cnt = 0;
+	muggle_atomic_int bad_read = 0;
+	s_free_cnt = 0;
+
+	const int cnt_writer = 4;
+	const int cnt_reader = 4;
+	const int cnt_op = 20000;
+	std::vector<std::thread> threads;
+
+	for (int i = 0; i < cnt_writer; i++)
+	{
+		threads.push_back(std::thread([&]{
+			muggle_ebr_thread_t thread;
+			muggle_ebr_register(&ebr, &thread);
+
+			for (int j = 0; j < cnt_op; j++)
+			{
+				// push
+				struct test_ebr_node *node = (struct test_ebr_node*)malloc(sizeof(struct test_ebr_node));
+				node->magic = TEST_EBR_MAGIC_ALIVE;
+				node->value = j;
+				muggle_atomic_fetch_add(&alloc_cnt, 1, muggle_memory_order_relaxed);
+
+				struct test_ebr_node *expected = head.load(std::memory_order_relaxed);
+				do {
+					node->next = expected;
+				} while (!head.compare_exchange_weak(expected, node, std::memory_order_release, std::memory_order_relaxed));
+
+				// pop
+				muggle_ebr_enter(&thread);
+				struct test_ebr_node *top = head.load(std::memory_order_acquire);
+				while (top)
+				{
+					if (muggle_atomic_load(&top->magic, muggle_memory_order_relaxed) != TEST_EBR_MAGIC_ALIVE)
+					{
+						muggle_atomic_fetch_add(&bad_read, 1, muggle_memory_order_relaxed);
+					}
+					if (head.compare_exchange_weak(top, top->next, std::memory_order_acquire, std::memory_order_acquire))
+					{
+						break;
+					}
+				}
+				muggle_ebr_exit(&thread);
+
+				if (top)
+				{
+					muggle_ebr_retire(&thread, top, test_ebr_free);
+				}
+			}
+
+			muggle_ebr_unregister(&thread);
+		}));
+	}
+
+	for (int i = 0; i < cnt_reader; i++)
+	{
+		threads.push_back(std::thread([&]{
+			muggle_ebr_thread_t thread;
+			muggle_ebr_register(&ebr, &thread);
+
+			for (int j = 0; j < cnt_op; j++)
+			{
+				muggle_ebr_enter(&thread);
+				int depth = 0;
+				struct test_ebr_node *node = head.load(std::memory_order_acquire);
+				while (node && depth++ < 8)
+				{
+					if (muggle_atomic_load(&node->magic, muggle_memory_order_relaxed) != TEST_EBR_MAGIC_ALIVE)
+					{
+						muggle_atomic_fetch_add(&bad_read, 1, muggle_memory_order_relaxed);
+					}
+					node = node->next;
+				}
+				muggle_ebr_exit(&thread);
+			}
+
+			muggle_ebr_unregister(&thread);
+		}));
+	}
+
+	for (auto &t : threads)
+	{
+		t.join();
+	}
+
+	EXPECT_EQ(bad_read, 0);
+
+	// every push is followed by a pop, stack is empty
+	EXPECT_TRUE(head.load() == nullptr);
+
+	muggle_ebr_destroy(&ebr);
+	EXPECT_EQ(s_free_cnt, alloc_cnt);
+	EXPECT_EQ(alloc_cnt, cnt_writer * cnt_op);
+}
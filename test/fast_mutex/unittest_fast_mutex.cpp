@@ -0,0 +1,163 @@
+#include <thread>
+#include <vector>
+#include <chrono>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+TEST(fast_mutex, lock_unlock)
+{
+	muggle_fast_mutex_t mtx;
+	ASSERT_EQ(muggle_fast_mutex_init(&mtx), MUGGLE_OK);
+	EXPECT_EQ(sizeof(mtx), sizeof(muggle_atomic_int));
+
+	EXPECT_EQ(muggle_fast_mutex_lock(&mtx), MUGGLE_OK);
+	EXPECT_EQ(mtx.status, MUGGLE_FAST_MUTEX_STATUS_LOCK);
+	EXPECT_EQ(muggle_fast_mutex_trylock(&mtx), MUGGLE_ERR_ACQ_LOCK);
+	EXPECT_EQ(muggle_fast_mutex_unlock(&mtx), MUGGLE_OK);
+	EXPECT_EQ(mtx.status, MUGGLE_FAST_MUTEX_STATUS_UNLOCK);
+
+	EXPECT_EQ(muggle_fast_mutex_trylock(&mtx), MUGGLE_OK);
+	EXPECT_EQ(muggle_fast_mutex_unlock(&mtx), MUGGLE_OK);
+
+	muggle_fast_mutex_destroy(&mtx);
+}
+
+TEST(fast_mutex, mul_thread_counter)
+{
+	int cnt_thread = (int)std::thread::hardware_concurrency() * 2;
+	if (cnt_thread <= 0)
+	{
+		cnt_thread = 4;
+	}
+	const int cnt_per_thread = 100000;
+
+	muggle_fast_mutex_t mtx;
+	muggle_fast_mutex_init(&mtx);
+
+	int counter = 0;
+	std::vector<std::thread> threads;
+	for (int i = 0; i < cnt_thread; i++)
+	{
+		threads.push_back(std::thread([&]{
+			for (int j = 0; j < cnt_per_thread; j++)
+			{
+				muggle_fast_mutex_lock(&mtx);
+				counter++;
+				muggle_fast_mutex_unlock(&mtx);
+			}
+		}));
+	}
+
+	for (auto &t : threads)
+	{
+		t.join();
+	}
+
+	EXPECT_EQ(counter, cnt_thread * cnt_per_thread);
+	EXPECT_EQ(mtx.status, MUGGLE_FAST_MUTEX_STATUS_UNLOCK);
+
+	muggle_fast_mutex_destroy(&mtx);
+}
+
+TEST(fast_condition_variable, producer_consumer)
+{
+	int cnt_consumer = 4;
+	const int cnt_msg = 20000;
+
+	muggle_fast_mutex_t mtx;
+	muggle_fast_condition_variable_t cv;
+	muggle_fast_mutex_init(&mtx);
+	muggle_fast_condition_variable_init(&cv);
+
+	int produced = 0;
+	int consumed = 0;
+	bool done = false;
+
+	std::vector<std::thread> consumers;
+	for (int i = 0; i < cnt_consumer; i++)
+	{
+		consumers.push_back(std::thread([&]{
+			muggle_fast_mutex_lock(&mtx);
+			while (true)
+			{
+				while (produced == consumed && !done)
+				{
+					muggle_fast_condition_variable_wait(&cv, &mtx, NULL);
+				}
+				if (produced == consumed && done)
+				{
+					break;
+				}
+				consumed++;
+			}
+			muggle_fast_mutex_unlock(&mtx);
+		}));
+	}
+
+	for (int i = 0; i < cnt_msg; i++)
+	{
+		muggle_fast_mutex_lock(&mtx);
+		produced++;
+		muggle_fast_mutex_unlock(&mtx);
+		muggle_fast_condition_variable_notify_one(&cv);
+	}
+
+	muggle_fast_mutex_lock(&mtx);
+	done = true;
+	muggle_fast_mutex_unlock(&mtx);
+	muggle_fast_condition_variable_notify_all(&cv);
+
+	for (auto &t : consumers)
+	{
+		t.join();
+	}
+
+	EXPECT_EQ(consumed, cnt_msg);
+
+	muggle_fast_condition_variable_destroy(&cv);
+	muggle_fast_mutex_destroy(&mtx);
+}
+
+TEST(fast_condition_variable, wait_until)
+{
+	muggle_fast_mutex_t mtx;
+	muggle_fast_condition_variable_t cv;
+	muggle_fast_mutex_init(&mtx);
+	muggle_fast_condition_variable_init(&cv);
+
+	struct timespec deadline;
+	muggle_deadline_after(&deadline, 5);
+
+	muggle_fast_mutex_lock(&mtx);
+	int ret = MUGGLE_OK;
+	while (ret == MUGGLE_OK)
+	{
+		ret = muggle_fast_condition_variable_wait_until(&cv, &mtx, &deadline);
+	}
+	EXPECT_EQ(ret, MUGGLE_ERR_TIMEOUT);
+	EXPECT_FALSE(muggle_deadline_remaining(&deadline, NULL));
+	muggle_fast_mutex_unlock(&mtx);
+
+	// notified before deadline
+	bool ready = false;
+	std::thread notifier([&]{
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		muggle_fast_mutex_lock(&mtx);
+		ready = true;
+		muggle_fast_mutex_unlock(&mtx);
+		muggle_fast_condition_variable_notify_one(&cv);
+	});
+
+	muggle_deadline_after(&deadline, 5000);
+	muggle_fast_mutex_lock(&mtx);
+	while (!ready)
+	{
+		ASSERT_EQ(muggle_fast_condition_variable_wait_until(&cv, &mtx, &deadline), MUGGLE_OK);
+	}
+	muggle_fast_mutex_unlock(&mtx);
+
+	notifier.join();
+
+	muggle_fast_condition_variable_destroy(&cv);
+	muggle_fast_mutex_destroy(&mtx);
+}
@@ -18,18 +18,25 @@ public:
 
 		ret = muggle_hash_table_init(&tables_[1], 0, NULL, test_utils_cmp_str, 16);
 		ASSERT_TRUE(ret);
+
+		ASSERT_EQ(muggle_arena_init(&arena_, 0), MUGGLE_OK);
+		ret = muggle_hash_table_init_with_arena(&tables_[2], 0, NULL, test_utils_cmp_str, &arena_);
+		ASSERT_TRUE(ret);
 	}
 
 	void TearDown()
 	{
 		muggle_hash_table_destroy(&tables_[0], test_utils_free_str, &test_utils_, test_utils_free_int, &test_utils_);
 		muggle_hash_table_destroy(&tables_[1], test_utils_free_str, &test_utils_, test_utils_free_int, &test_utils_);
+		muggle_hash_table_destroy(&tables_[2], test_utils_free_str, &test_utils_, test_utils_free_int, &test_utils_);
+		muggle_arena_destroy(&arena_);
 
 		muggle_debug_memory_leak_end(&mem_state_);
 	}
 
 protected:
-	muggle_hash_table_t tables_[2];
+	muggle_hash_table_t tables_[3];
+	muggle_arena_t arena_;
 
 	TestUtils test_utils_;
 	muggle_debug_memory_state mem_state_;
@@ -0,0 +1,176 @@
+#include <thread>
+#include <vector>
+#include <map>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+struct ring_msg
+{
+	int thread_idx;
+	int thread_msg_idx;
+	char buf[100];
+};
+
+TEST(inline_ring, init_destroy)
+{
+	muggle_inline_ring_t ring;
+	ASSERT_EQ(muggle_inline_ring_init(&ring, 0, 64, 0), MUGGLE_ERR_INVALID_PARAM);
+	ASSERT_EQ(muggle_inline_ring_init(&ring, 16, 0, 0), MUGGLE_ERR_INVALID_PARAM);
+
+	ASSERT_EQ(muggle_inline_ring_init(&ring, 10, 100, 0), MUGGLE_OK);
+	EXPECT_EQ(ring.capacity, 16);
+	EXPECT_EQ(ring.block_size % MUGGLE_CACHE_LINE_SIZE, 0);
+	EXPECT_GE(ring.block_size, (uint32_t)(100 + MUGGLE_INLINE_RING_SLOT_HEAD_SIZE));
+	EXPECT_EQ((uintptr_t)ring.slots % MUGGLE_CACHE_LINE_SIZE, 0);
+	muggle_inline_ring_destroy(&ring);
+}
+
+TEST(inline_ring, reserve_commit_peek_release)
+{
+	muggle_inline_ring_t ring;
+	ASSERT_EQ(muggle_inline_ring_init(&ring, 8, sizeof(int), MUGGLE_INLINE_RING_FLAG_SINGLE_WRITER), MUGGLE_OK);
+
+	// too large
+	EXPECT_TRUE(muggle_inline_ring_reserve(&ring, sizeof(int) + 1) == NULL);
+
+	// empty
+	EXPECT_TRUE(muggle_inline_ring_try_peek(&ring, NULL) == NULL);
+
+	for (int loop = 0; loop < 5; loop++)
+	{
+		// fill ring
+		for (int i = 0; i < 8; i++)
+		{
+			int *p = (int*)muggle_inline_ring_reserve(&ring, sizeof(int));
+			ASSERT_TRUE(p != NULL);
+			*p = loop * 8 + i;
+			muggle_inline_ring_commit(&ring, p);
+		}
+		EXPECT_TRUE(muggle_inline_ring_reserve(&ring, sizeof(int)) == NULL);
+
+		for (int i = 0; i < 8; i++)
+		{
+			uint32_t size = 0;
+			int *p = (int*)muggle_inline_ring_peek(&ring, &size);
+			ASSERT_TRUE(p != NULL);
+			ASSERT_EQ(size, (uint32_t)sizeof(int));
+			ASSERT_EQ(*p, loop * 8 + i);
+			muggle_inline_ring_release(&ring);
+		}
+		EXPECT_TRUE(muggle_inline_ring_try_peek(&ring, NULL) == NULL);
+	}
+
+	muggle_inline_ring_destroy(&ring);
+}
+
+TEST(inline_ring, commit_out_of_order)
+{
+	muggle_inline_ring_t ring;
+	ASSERT_EQ(muggle_inline_ring_init(&ring, 8, sizeof(int), 0), MUGGLE_OK);
+
+	int *p0 = (int*)muggle_inline_ring_reserve(&ring, sizeof(int));
+	int *p1 = (int*)muggle_inline_ring_reserve(&ring, sizeof(int));
+	ASSERT_TRUE(p0 != NULL && p1 != NULL);
+	*p0 = 0;
+	*p1 = 1;
+
+	// second slot commit first, reader still can't see anything
+	muggle_inline_ring_commit(&ring, p1);
+	EXPECT_TRUE(muggle_inline_ring_try_peek(&ring, NULL) == NULL);
+
+	muggle_inline_ring_commit(&ring, p0);
+	int *p = (int*)muggle_inline_ring_try_peek(&ring, NULL);
+	ASSERT_TRUE(p != NULL);
+	EXPECT_EQ(*p, 0);
+	muggle_inline_ring_release(&ring);
+
+	p = (int*)muggle_inline_ring_try_peek(&ring, NULL);
+	ASSERT_TRUE(p != NULL);
+	EXPECT_EQ(*p, 1);
+	muggle_inline_ring_release(&ring);
+
+	muggle_inline_ring_destroy(&ring);
+}
+
+void test_inline_ring(int flags, int cnt_writer)
+{
+	int msg_per_writer = 1024 * 16;
+	muggle_inline_ring_t ring;
+	ASSERT_EQ(muggle_inline_ring_init(&ring, 1024, sizeof(ring_msg), flags), MUGGLE_OK);
+
+	std::vector<std::thread> writers;
+	for (int i = 0; i < cnt_writer; i++)
+	{
+		writers.push_back(std::thread([i, &ring, msg_per_writer]{
+			for (int j = 0; j < msg_per_writer; j++)
+			{
+				ring_msg *msg = NULL;
+				while ((msg = (ring_msg*)muggle_inline_ring_reserve(&ring, sizeof(ring_msg))) == NULL)
+				{
+					muggle_thread_yield();
+				}
+				msg->thread_idx = i;
+				msg->thread_msg_idx = j;
+				snprintf(msg->buf, sizeof(msg->buf), "%d-%d", i, j);
+				muggle_inline_ring_commit(&ring, msg);
+			}
+		}));
+	}
+
+	std::map<int, int> thread_cnts;
+	for (int i = 0; i < cnt_writer; i++)
+	{
+		thread_cnts[i] = 0;
+	}
+
+	char buf[100];
+	for (int i = 0; i < cnt_writer * msg_per_writer; i++)
+	{
+		uint32_t size = 0;
+		ring_msg *msg = (ring_msg*)muggle_inline_ring_peek(&ring, &size);
+		ASSERT_EQ(size, (uint32_t)sizeof(ring_msg));
+		ASSERT_LT(msg->thread_idx, cnt_writer);
+		ASSERT_EQ(msg->thread_msg_idx, thread_cnts[msg->thread_idx]);
+		snprintf(buf, sizeof(buf), "%d-%d", msg->thread_idx, msg->thread_msg_idx);
+		ASSERT_STREQ(msg->buf, buf);
+		thread_cnts[msg->thread_idx]++;
+		muggle_inline_ring_release(&ring);
+	}
+
+	for (auto &writer : writers)
+	{
+		writer.join();
+	}
+
+	muggle_inline_ring_destroy(&ring);
+}
+
+TEST(inline_ring, single_w_wait_r)
+{
+	test_inline_ring(MUGGLE_INLINE_RING_FLAG_SINGLE_WRITER, 1);
+}
+
+TEST(inline_ring, single_w_busyloop_r)
+{
+	test_inline_ring(MUGGLE_INLINE_RING_FLAG_SINGLE_WRITER | MUGGLE_INLINE_RING_FLAG_READ_BUSY_LOOP, 1);
+}
+
+TEST(inline_ring, mul_w_wait_r)
+{
+	int cnt_writer = (int)std::thread::hardware_concurrency();
+	if (cnt_writer <= 1)
+	{
+		cnt_writer = 2;
+	}
+	test_inline_ring(0, cnt_writer);
+}
+
+TEST(inline_ring, mul_w_busyloop_r)
+{
+	int cnt_writer = (int)std::thread::hardware_concurrency();
+	if (cnt_writer <= 1)
+	{
+		cnt_writer = 2;
+	}
+	test_inline_ring(MUGGLE_INLINE_RING_FLAG_READ_BUSY_LOOP, cnt_writer);
+}
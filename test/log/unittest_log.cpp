@@ -1,3 +1,5 @@
+#include <thread>
+#include <vector>
 #include "gtest/gtest.h"
 #include "muggle/c/muggle_c.h"
 
@@ -64,3 +66,435 @@ TEST(log, fmt)
 	EXPECT_TRUE(muggle_str_startswith(buf, "<L>WARNING|<F>log_fmt_test_file:666|<f>log_fmt_test_func|<T>"));
 	EXPECT_TRUE(muggle_str_endswith(buf, "| - hello\n"));
 }
+
+TEST(log, fmt_time_cache)
+{
+	char buf[256];
+	char expect[256];
+	muggle_log_fmt_arg_t arg;
+	memset(&arg, 0, sizeof(arg));
+	arg.level = MUGGLE_LOG_LEVEL_INFO;
+	arg.line = 7;
+	arg.file = "/a/b\\log_fmt_test_file.c";
+	arg.func = "func";
+	arg.tid = 12345;
+
+	struct timespec ts;
+	ts.tv_sec = 1700000000;
+	ts.tv_nsec = 5;
+	arg.ts = &ts;
+
+	int fmt_flag =
+		MUGGLE_LOG_FMT_LEVEL |
+		MUGGLE_LOG_FMT_FILE |
+		MUGGLE_LOG_FMT_FUNC |
+		MUGGLE_LOG_FMT_TIME |
+		MUGGLE_LOG_FMT_THREAD;
+
+	muggle_log_fmt_time_cache_t cache;
+	muggle_log_fmt_time_cache_init(&cache);
+
+	long nsecs[] = { 5, 999999999, 0, 123456789 };
+	time_t secs[] = { 1700000000, 1700000000, 1700000001, 9 };
+	for (size_t i = 0; i < sizeof(nsecs) / sizeof(nsecs[0]); i++)
+	{
+		ts.tv_sec = secs[i];
+		ts.tv_nsec = nsecs[i];
+		int n = snprintf(expect, sizeof(expect),
+			"<L>INFO|<F>log_fmt_test_file.c:7|<f>func|<T>%lld.%09ld|<t>12345| - hello\n",
+			(long long)secs[i], nsecs[i]);
+
+		int num_write = muggle_log_fmt_gen_cached(fmt_flag, &arg, "hello", buf, sizeof(buf), &cache);
+		EXPECT_EQ(num_write, n);
+		EXPECT_STREQ(buf, expect);
+
+		num_write = muggle_log_fmt_gen(fmt_flag, &arg, "hello", buf, sizeof(buf));
+		EXPECT_EQ(num_write, n);
+		EXPECT_STREQ(buf, expect);
+	}
+}
+
+TEST(log, fmt_truncate)
+{
+	char buf[16];
+	muggle_log_fmt_arg_t arg;
+	memset(&arg, 0, sizeof(arg));
+	arg.level = MUGGLE_LOG_LEVEL_WARNING;
+	arg.func = "log_fmt_test_func";
+
+	int num_write = muggle_log_fmt_gen(
+		MUGGLE_LOG_FMT_LEVEL | MUGGLE_LOG_FMT_FUNC, &arg, "hello", buf, sizeof(buf));
+	EXPECT_EQ(num_write, (int)sizeof(buf) - 1);
+	EXPECT_STREQ(buf, "<L>WARNING|<f>l");
+
+	num_write = muggle_log_fmt_gen(0, &arg, "hello world, hello", buf, sizeof(buf));
+	EXPECT_EQ(num_write, (int)sizeof(buf) - 1);
+	EXPECT_STREQ(buf, " - hello world,");
+}
+
+static void check_deferred(const char *format, ...)
+{
+	char expect[1024];
+	char data[1024];
+	char buf[1024];
+	va_list args;
+
+	va_start(args, format);
+	vsnprintf(expect, sizeof(expect), format, args);
+	va_end(args);
+
+	va_start(args, format);
+	int len = muggle_log_deferred_encode(format, args, data, (int)sizeof(data));
+	va_end(args);
+	ASSERT_GE(len, 0) << format;
+
+	int n = muggle_log_deferred_decode(format, data, len, buf, (int)sizeof(buf));
+	ASSERT_EQ(n, (int)strlen(expect)) << format;
+	ASSERT_STREQ(buf, expect) << format;
+}
+
+TEST(log, deferred_encode_decode)
+{
+	check_deferred("hello world");
+	check_deferred("100%% sure");
+	check_deferred("%d %i %u %o %x %X %c", -5, 6, 7u, 8u, 255u, 255u, 'a');
+	check_deferred("%hhd %hd %ld %lld %jd %zu %td", (char)-1, (short)-2, -3L, -4LL, (intmax_t)-5, (size_t)6, (ptrdiff_t)-7);
+	check_deferred("%lu %llx %hu", 4000000000UL, 0xffffffffffffULL, (unsigned short)65535);
+	check_deferred("%-8d|%08d|%+d|% d|%#x", 1, 2, 3, 4, 5);
+	check_deferred("%f %.3f %e %g %10.2f %Lf", 3.14159, 2.71828, 12345.678, 0.0001, -1.5, (long double)1.25);
+	check_deferred("%*d|%-*d|%.*f|%*.*s|%.*d", 6, 42, 6, 42, 2, 3.14159, 8, 3, "abcdef", -1, 7);
+	check_deferred("%s and %s, %10s|%-10s|%.2s", "foo", "", "right", "left", "truncate");
+	check_deferred("%p", (void*)&check_deferred);
+	check_deferred("mix %s=%d (%5.1f%%)", "key", 10, 99.5);
+
+	// string with precision is not required to be null terminated
+	char unterminated[4] = { 'a', 'b', 'c', 'd' };
+	check_deferred("%.*s|%.3s|%-6.*s|", 4, unterminated, unterminated, 2, unterminated);
+	check_deferred("%.*s|%.0s|%.*s", -1, "negative", unterminated, 8, "ab");
+}
+
+TEST(log, deferred_unsupported)
+{
+	char data[64];
+	int n = 0;
+
+	auto encode = [&](const char *format, ...) -> int {
+		va_list args;
+		va_start(args, format);
+		int ret = muggle_log_deferred_encode(format, args, data, (int)sizeof(data));
+		va_end(args);
+		return ret;
+	};
+
+	EXPECT_EQ(encode("%n", &n), -1);
+	EXPECT_EQ(encode("%ls", L"wide"), -1);
+	EXPECT_EQ(encode("%s", "a string longer than the sixty four bytes buffer of encoded data"), -1);
+}
+
+TEST(log, deferred_decode_truncate)
+{
+	char data[256];
+	char buf[8];
+
+	auto encode = [&](const char *format, ...) -> int {
+		va_list args;
+		va_start(args, format);
+		int ret = muggle_log_deferred_encode(format, args, data, (int)sizeof(data));
+		va_end(args);
+		return ret;
+	};
+
+	int len = encode("%s-%d", "hello", 12345);
+	ASSERT_GE(len, 0);
+	int n = muggle_log_deferred_decode("%s-%d", data, len, buf, (int)sizeof(buf));
+	EXPECT_EQ(n, 7);
+	EXPECT_STREQ(buf, "hello-1");
+
+	EXPECT_EQ(muggle_log_deferred_decode("%s-%d", data, len - 1, buf, (int)sizeof(buf)), -1);
+}
+
+TEST(log, deferred_handle)
+{
+	const char *path = "unittest_log_deferred.log";
+	remove(path);
+
+	muggle_log_handle_t handle;
+	int ret = muggle_log_handle_file_init(
+		&handle, MUGGLE_LOG_WRITE_TYPE_ASYNC_DEFERRED,
+		MUGGLE_LOG_FMT_LEVEL | MUGGLE_LOG_FMT_TIME, MUGGLE_LOG_LEVEL_INFO,
+		0, NULL, NULL, path);
+	ASSERT_EQ(ret, MUGGLE_OK);
+
+	muggle_log_category_t category;
+	memset(&category, 0, sizeof(category));
+	category.lowest_log_level = MUGGLE_LOG_LEVEL_FATAL + 1;
+	muggle_log_category_add(&category, &handle);
+
+	struct timespec start;
+	timespec_get(&start, TIME_UTC);
+
+	for (int i = 0; i < 16; i++)
+	{
+		char tmp[16];
+		snprintf(tmp, sizeof(tmp), "str%d", i);
+		MUGGLE_LOG(&category, MUGGLE_LOG_LEVEL_INFO, "deferred %d %s %.2f", i, tmp, i * 0.5);
+	}
+	MUGGLE_LOG(&category, MUGGLE_LOG_LEVEL_TRACE, "filtered %d", 0);
+	MUGGLE_LOG(&category, MUGGLE_LOG_LEVEL_WARNING, "unsupported %ls", L"x");
+
+	muggle_log_category_destroy(&category, 1);
+
+	FILE *fp = fopen(path, "rb");
+	ASSERT_TRUE(fp != NULL);
+	char line[1024];
+	int cnt = 0;
+	while (fgets(line, sizeof(line), fp))
+	{
+		ASSERT_TRUE(muggle_str_startswith(line, "<L>"));
+		const char *t = strstr(line, "<T>");
+		ASSERT_TRUE(t != NULL);
+		long long sec = atoll(t + 3);
+		EXPECT_LE(llabs(sec - (long long)start.tv_sec), 2);
+
+		if (cnt < 16)
+		{
+			char expect[64];
+			snprintf(expect, sizeof(expect), " - deferred %d str%d %.2f\n", cnt, cnt, cnt * 0.5);
+			EXPECT_TRUE(muggle_str_endswith(line, expect)) << line;
+		}
+		else
+		{
+			EXPECT_TRUE(muggle_str_startswith(line, "<L>WARNING|")) << line;
+			EXPECT_TRUE(muggle_str_endswith(line, " - unsupported x\n")) << line;
+		}
+		++cnt;
+	}
+	fclose(fp);
+	remove(path);
+
+	EXPECT_EQ(cnt, 17);
+}
+
+static void test_log_async_threads(int write_type)
+{
+	const char *path = "unittest_log_async_threads.log";
+	remove(path);
+
+	muggle_log_handle_t handle;
+	int ret = muggle_log_handle_file_init(
+		&handle, write_type, MUGGLE_LOG_FMT_TIME, MUGGLE_LOG_LEVEL_INFO,
+		64, NULL, NULL, path);
+	ASSERT_EQ(ret, MUGGLE_OK);
+
+	muggle_log_category_t category;
+	memset(&category, 0, sizeof(category));
+	category.lowest_log_level = MUGGLE_LOG_LEVEL_FATAL + 1;
+	muggle_log_category_add(&category, &handle);
+
+	// threads exit before handle destroy, their staging rings still drained
+	int cnt_thread = 8;
+	int cnt_msg = 2000;
+	std::vector<std::thread> threads;
+	for (int i = 0; i < cnt_thread; i++)
+	{
+		threads.push_back(std::thread([&category, i, cnt_msg]{
+			for (int j = 0; j < cnt_msg; j++)
+			{
+				MUGGLE_LOG(&category, MUGGLE_LOG_LEVEL_INFO, "%d %d", i, j);
+			}
+		}));
+	}
+	for (auto &t : threads)
+	{
+		t.join();
+	}
+
+	// new thread after others exit
+	std::thread([&category]{
+		MUGGLE_LOG(&category, MUGGLE_LOG_LEVEL_INFO, "%d %d", -1, 0);
+	}).join();
+
+	muggle_log_category_destroy(&category, 1);
+
+	FILE *fp = fopen(path, "rb");
+	ASSERT_TRUE(fp != NULL);
+	std::vector<int> next_msg(cnt_thread, 0);
+	char line[256];
+	int cnt = 0;
+	int cnt_last = 0;
+	while (fgets(line, sizeof(line), fp))
+	{
+		const char *p = strstr(line, " - ");
+		ASSERT_TRUE(p != NULL);
+		int thread_idx = 0, msg_idx = 0;
+		ASSERT_EQ(sscanf(p + 3, "%d %d", &thread_idx, &msg_idx), 2);
+		if (thread_idx == -1)
+		{
+			++cnt_last;
+			continue;
+		}
+		ASSERT_GE(thread_idx, 0);
+		ASSERT_LT(thread_idx, cnt_thread);
+		ASSERT_EQ(msg_idx, next_msg[thread_idx]);
+		next_msg[thread_idx]++;
+		++cnt;
+	}
+	fclose(fp);
+	remove(path);
+
+	EXPECT_EQ(cnt, cnt_thread * cnt_msg);
+	EXPECT_EQ(cnt_last, 1);
+}
+
+TEST(log, async_threads)
+{
+	test_log_async_threads(MUGGLE_LOG_WRITE_TYPE_ASYNC);
+}
+
+TEST(log, async_deferred_threads)
+{
+	test_log_async_threads(MUGGLE_LOG_WRITE_TYPE_ASYNC_DEFERRED);
+}
+
+static int count_lines(const char *path)
+{
+	FILE *fp = fopen(path, "rb");
+	if (fp == NULL)
+	{
+		return -1;
+	}
+	char line[1024];
+	int cnt = 0;
+	while (fgets(line, sizeof(line), fp))
+	{
+		++cnt;
+	}
+	fclose(fp);
+	return cnt;
+}
+
+TEST(log, async_flush)
+{
+	const char *path = "unittest_log_flush.log";
+	remove(path);
+
+	muggle_log_handle_t handle;
+	int ret = muggle_log_handle_file_init(
+		&handle, MUGGLE_LOG_WRITE_TYPE_ASYNC,
+		MUGGLE_LOG_FMT_LEVEL, MUGGLE_LOG_LEVEL_INFO,
+		0, NULL, NULL, path);
+	ASSERT_EQ(ret, MUGGLE_OK);
+
+	// records stay in batch until flush
+	ret = muggle_log_handle_set_async_flush(&handle, 0, 60 * 1000);
+	ASSERT_EQ(ret, MUGGLE_OK);
+
+	muggle_log_category_t category;
+	memset(&category, 0, sizeof(category));
+	category.lowest_log_level = MUGGLE_LOG_LEVEL_FATAL + 1;
+	muggle_log_category_add(&category, &handle);
+
+	const int cnt_thread = 4;
+	const int cnt_msg = 64;
+	std::vector<std::thread> threads;
+	for (int i = 0; i < cnt_thread; i++)
+	{
+		threads.push_back(std::thread([&category, i, cnt_msg] {
+			for (int j = 0; j < cnt_msg; j++)
+			{
+				MUGGLE_LOG(&category, MUGGLE_LOG_LEVEL_INFO, "thread %d msg %d", i, j);
+			}
+		}));
+	}
+	for (auto &th : threads)
+	{
+		th.join();
+	}
+
+	muggle_msleep(20);
+	EXPECT_EQ(count_lines(path), 0);
+
+	ret = muggle_log_category_flush(&category);
+	EXPECT_EQ(ret, MUGGLE_OK);
+	EXPECT_EQ(count_lines(path), cnt_thread * cnt_msg);
+
+	MUGGLE_LOG(&category, MUGGLE_LOG_LEVEL_INFO, "after flush");
+	ret = muggle_log_category_flush(&category);
+	EXPECT_EQ(ret, MUGGLE_OK);
+	EXPECT_EQ(count_lines(path), cnt_thread * cnt_msg + 1);
+
+	muggle_log_category_destroy(&category, 1);
+	remove(path);
+}
+
+static int find_line(const char *path, const char *text)
+{
+	FILE *fp = fopen(path, "rb");
+	if (fp == NULL)
+	{
+		return 0;
+	}
+	char line[1024];
+	int found = 0;
+	while (fgets(line, sizeof(line), fp))
+	{
+		if (strstr(line, text))
+		{
+			found = 1;
+			break;
+		}
+	}
+	fclose(fp);
+	return found;
+}
+
+TEST(log, async_flush_under_load)
+{
+	const char *path = "unittest_log_flush_load.log";
+	remove(path);
+
+	muggle_log_handle_t handle;
+	int ret = muggle_log_handle_file_init(
+		&handle, MUGGLE_LOG_WRITE_TYPE_ASYNC,
+		MUGGLE_LOG_FMT_LEVEL, MUGGLE_LOG_LEVEL_INFO,
+		0, NULL, NULL, path);
+	ASSERT_EQ(ret, MUGGLE_OK);
+
+	muggle_log_category_t category;
+	memset(&category, 0, sizeof(category));
+	category.lowest_log_level = MUGGLE_LOG_LEVEL_FATAL + 1;
+	muggle_log_category_add(&category, &handle);
+
+	// staging rings never empty, flush must not wait for it
+	muggle_atomic_int stop = 0;
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 2; i++)
+	{
+		threads.push_back(std::thread([&category, &stop, i] {
+			int j = 0;
+			while (!muggle_atomic_load(&stop, muggle_memory_order_relaxed))
+			{
+				MUGGLE_LOG(&category, MUGGLE_LOG_LEVEL_INFO, "load %d %d", i, j++);
+			}
+		}));
+	}
+
+	char marker[64];
+	for (int i = 0; i < 8; i++)
+	{
+		snprintf(marker, sizeof(marker), "flush marker %d", i);
+		MUGGLE_LOG(&category, MUGGLE_LOG_LEVEL_INFO, "%s", marker);
+		ret = muggle_log_category_flush(&category);
+		EXPECT_EQ(ret, MUGGLE_OK);
+		EXPECT_TRUE(find_line(path, marker)) << marker;
+	}
+
+	muggle_atomic_store(&stop, 1, muggle_memory_order_relaxed);
+	for (auto &th : threads)
+	{
+		th.join();
+	}
+
+	muggle_log_category_destroy(&category, 1);
+	remove(path);
+}
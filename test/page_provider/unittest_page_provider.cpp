@@ -0,0 +1,113 @@
+#include <stdint.h>
+#include <string.h>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+static void test_page_alloc(const muggle_page_policy_t *policy, size_t size)
+{
+	char *p = (char*)muggle_page_alloc(size, policy);
+	ASSERT_TRUE(p != NULL);
+	EXPECT_EQ((uintptr_t)p % MUGGLE_CACHE_LINE_SIZE, 0u);
+
+	if (policy == NULL || policy->flags == 0)
+	{
+		EXPECT_EQ(muggle_page_kind(p), MUGGLE_PAGE_KIND_MALLOC);
+	}
+	else
+	{
+		EXPECT_NE(muggle_page_kind(p), MUGGLE_PAGE_KIND_MALLOC);
+
+		// no head before mapped memory, size of whole pages map no more page
+		EXPECT_EQ((uintptr_t)p % muggle_page_size(), 0u);
+	}
+
+	memset(p, 0x5a, size);
+	EXPECT_EQ(p[0], 0x5a);
+	EXPECT_EQ(p[size - 1], 0x5a);
+
+	muggle_page_free(p);
+}
+
+TEST(page_provider, alloc_free)
+{
+	size_t sizes[] = {1, 4096, 1024 * 1024 * 2, 1024 * 1024 * 3 + 7};
+	int flags[] = {
+		0,
+		MUGGLE_PAGE_FLAG_PREFAULT,
+		MUGGLE_PAGE_FLAG_HUGETLB,
+		MUGGLE_PAGE_FLAG_THP | MUGGLE_PAGE_FLAG_PREFAULT,
+		MUGGLE_PAGE_FLAG_NUMA | MUGGLE_PAGE_FLAG_PREFAULT,
+		MUGGLE_PAGE_FLAG_HUGETLB | MUGGLE_PAGE_FLAG_THP | MUGGLE_PAGE_FLAG_NUMA | MUGGLE_PAGE_FLAG_PREFAULT,
+	};
+
+	for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+	{
+		test_page_alloc(NULL, sizes[i]);
+		for (size_t j = 0; j < sizeof(flags) / sizeof(flags[0]); j++)
+		{
+			muggle_page_policy_t policy;
+			policy.flags = flags[j];
+			policy.numa_node = 0;
+			test_page_alloc(&policy, sizes[i]);
+		}
+	}
+
+	muggle_page_free(NULL);
+	EXPECT_GT(muggle_page_size(), 0u);
+}
+
+TEST(page_provider, containers)
+{
+	muggle_page_policy_t policy;
+	policy.flags = MUGGLE_PAGE_FLAG_THP | MUGGLE_PAGE_FLAG_PREFAULT;
+	policy.numa_node = 0;
+
+	muggle_ring_buffer_t ring;
+	ASSERT_EQ(muggle_ring_buffer_init_with_policy(&ring, 1024, 0, &policy), MUGGLE_OK);
+	int v = 1;
+	ASSERT_EQ(muggle_ring_buffer_write(&ring, &v), MUGGLE_OK);
+	EXPECT_EQ(muggle_ring_buffer_read(&ring, 0), &v);
+	muggle_ring_buffer_destroy(&ring);
+
+	muggle_channel_t chan;
+	ASSERT_EQ(muggle_channel_init_with_policy(&chan, 1024, 0, &policy), MUGGLE_OK);
+	ASSERT_EQ(muggle_channel_write(&chan, &v), MUGGLE_OK);
+	EXPECT_EQ(muggle_channel_read(&chan), &v);
+	muggle_channel_destroy(&chan);
+
+	muggle_ts_memory_pool_t ts_pool;
+	ASSERT_EQ(muggle_ts_memory_pool_init_with_policy(
+		&ts_pool, 64, sizeof(int), MUGGLE_TS_MEMORY_POOL_FLAG_GROWABLE, &policy), MUGGLE_OK);
+	void *datas[128];
+	for (int i = 0; i < 128; i++)
+	{
+		datas[i] = muggle_ts_memory_pool_alloc(&ts_pool);
+		ASSERT_TRUE(datas[i] != NULL);
+	}
+	for (int i = 0; i < 128; i++)
+	{
+		muggle_ts_memory_pool_free(datas[i]);
+	}
+	muggle_ts_memory_pool_destroy(&ts_pool);
+
+	muggle_sowr_memory_pool_t sowr_pool;
+	ASSERT_EQ(muggle_sowr_memory_pool_init_with_policy(
+		&sowr_pool, 64, sizeof(int), MUGGLE_SOWR_MEMORY_POOL_FLAG_SEQ_FREE, &policy), MUGGLE_OK);
+	void *data = muggle_sowr_memory_pool_alloc(&sowr_pool);
+	ASSERT_TRUE(data != NULL);
+	muggle_sowr_memory_pool_free(data);
+	muggle_sowr_memory_pool_destroy(&sowr_pool);
+
+	muggle_memory_pool_t pool;
+	ASSERT_TRUE(muggle_memory_pool_init_with_policy(&pool, 8, sizeof(int), &policy));
+	for (int i = 0; i < 128; i++)
+	{
+		datas[i] = muggle_memory_pool_alloc(&pool);
+		ASSERT_TRUE(datas[i] != NULL);
+	}
+	for (int i = 0; i < 128; i++)
+	{
+		muggle_memory_pool_free(&pool, datas[i]);
+	}
+	muggle_memory_pool_destroy(&pool);
+}
@@ -0,0 +1,258 @@
+#include <string>
+#include <thread>
+#include <vector>
+#include <map>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+TEST(pool_stats, counter)
+{
+	muggle_pool_counter_t counter;
+	muggle_pool_counter_init(&counter);
+
+	const int cnt_thread = 8;
+	const int cnt_per_thread = 10000;
+	std::vector<std::thread> threads;
+	for (int i = 0; i < cnt_thread; i++)
+	{
+		threads.push_back(std::thread([&counter, cnt_per_thread]{
+			for (int j = 0; j < cnt_per_thread; j++)
+			{
+				muggle_pool_counter_alloc(&counter);
+				if (j % 2 == 0)
+				{
+					muggle_pool_counter_free(&counter);
+				}
+			}
+		}));
+	}
+	for (auto &t : threads)
+	{
+		t.join();
+	}
+
+	uint64_t alloc_cnt = 0, free_cnt = 0;
+	muggle_pool_counter_sum(&counter, &alloc_cnt, &free_cnt);
+	EXPECT_EQ(alloc_cnt, (uint64_t)cnt_thread * cnt_per_thread);
+	EXPECT_EQ(free_cnt, (uint64_t)cnt_thread * cnt_per_thread / 2);
+}
+
+TEST(pool_stats, memory_pool)
+{
+	muggle_memory_pool_t pool;
+	ASSERT_TRUE(muggle_memory_pool_init(&pool, 4, 32));
+
+	void *arr[10];
+	for (int i = 0; i < 10; i++)
+	{
+		arr[i] = muggle_memory_pool_alloc(&pool);
+		ASSERT_TRUE(arr[i] != NULL);
+	}
+	for (int i = 0; i < 6; i++)
+	{
+		muggle_memory_pool_free(&pool, arr[i]);
+	}
+
+	muggle_pool_stats_t stats;
+	muggle_memory_pool_get_stats(&pool, &stats);
+	EXPECT_EQ(stats.capacity, 16);
+	EXPECT_EQ(stats.in_use, 4);
+	EXPECT_EQ(stats.high_water_mark, 10);
+	EXPECT_EQ(stats.alloc_cnt, 10u);
+	EXPECT_EQ(stats.free_cnt, 6u);
+	EXPECT_EQ(stats.fail_cnt, 0u);
+	EXPECT_EQ(stats.grow_cnt, 2u);
+
+	muggle_memory_pool_set_flag(&pool, MUGGLE_MEMORY_POOL_CONSTANT_SIZE);
+	for (int i = 0; i < 12; i++)
+	{
+		ASSERT_TRUE(muggle_memory_pool_alloc(&pool) != NULL);
+	}
+	ASSERT_TRUE(muggle_memory_pool_alloc(&pool) == NULL);
+	muggle_memory_pool_get_stats(&pool, &stats);
+	EXPECT_EQ(stats.in_use, 16);
+	EXPECT_EQ(stats.high_water_mark, 16);
+	EXPECT_EQ(stats.fail_cnt, 1u);
+	EXPECT_EQ(stats.grow_cnt, 2u);
+
+	muggle_memory_pool_destroy(&pool);
+}
+
+TEST(pool_stats, sowr_memory_pool)
+{
+	int flags[] = {
+		MUGGLE_SOWR_MEMORY_POOL_FLAG_SEQ_FREE,
+		MUGGLE_SOWR_MEMORY_POOL_FLAG_MULTI_FREE
+	};
+	for (int flag : flags)
+	{
+		muggle_sowr_memory_pool_t pool;
+		ASSERT_EQ(muggle_sowr_memory_pool_init_ex(&pool, 8, 32, flag), MUGGLE_OK);
+
+		void *arr[8];
+		for (int i = 0; i < 7; i++)
+		{
+			arr[i] = muggle_sowr_memory_pool_alloc(&pool);
+			ASSERT_TRUE(arr[i] != NULL);
+		}
+		ASSERT_TRUE(muggle_sowr_memory_pool_alloc(&pool) == NULL);
+		for (int i = 0; i < 3; i++)
+		{
+			muggle_sowr_memory_pool_free(arr[i]);
+		}
+
+		// reclaim happen in allocate
+		arr[7] = muggle_sowr_memory_pool_alloc(&pool);
+		ASSERT_TRUE(arr[7] != NULL);
+
+		muggle_pool_stats_t stats;
+		muggle_sowr_memory_pool_get_stats(&pool, &stats);
+		EXPECT_EQ(stats.capacity, 8);
+		EXPECT_EQ(stats.in_use, 5);
+		EXPECT_EQ(stats.high_water_mark, 7);
+		EXPECT_EQ(stats.alloc_cnt, 8u);
+		EXPECT_EQ(stats.free_cnt, 3u);
+		EXPECT_EQ(stats.fail_cnt, 1u);
+		EXPECT_EQ(stats.grow_cnt, 0u);
+
+		muggle_sowr_memory_pool_destroy(&pool);
+	}
+
+	// more than one lap of ring, one block in use at a time
+	for (int flag : flags)
+	{
+		muggle_sowr_memory_pool_t pool;
+		ASSERT_EQ(muggle_sowr_memory_pool_init_ex(&pool, 8, 32, flag), MUGGLE_OK);
+
+		const int cnt = 2000;
+		for (int i = 0; i < cnt; i++)
+		{
+			void *data = muggle_sowr_memory_pool_alloc(&pool);
+			ASSERT_TRUE(data != NULL);
+			muggle_sowr_memory_pool_free(data);
+		}
+
+		muggle_pool_stats_t stats;
+		muggle_sowr_memory_pool_get_stats(&pool, &stats);
+		EXPECT_EQ(stats.alloc_cnt, (uint64_t)cnt);
+		EXPECT_EQ(stats.fail_cnt, 0u);
+		if (flag == MUGGLE_SOWR_MEMORY_POOL_FLAG_SEQ_FREE)
+		{
+			EXPECT_EQ(stats.in_use, 0);
+			EXPECT_EQ(stats.free_cnt, (uint64_t)cnt);
+			EXPECT_EQ(stats.high_water_mark, 1);
+		}
+		else
+		{
+			// released blocks are counted until reclaimed
+			EXPECT_LT(stats.high_water_mark, 8);
+		}
+
+		muggle_sowr_memory_pool_destroy(&pool);
+	}
+}
+
+TEST(pool_stats, slab_allocator)
+{
+	muggle_slab_allocator_t allocator;
+	ASSERT_EQ(muggle_slab_allocator_init(&allocator), MUGGLE_OK);
+
+	const int cnt_thread = 4;
+	const int cnt_per_thread = 1000;
+	std::vector<std::thread> threads;
+	for (int i = 0; i < cnt_thread; i++)
+	{
+		threads.push_back(std::thread([&allocator, cnt_per_thread]{
+			std::vector<void*> datas;
+			for (int j = 0; j < cnt_per_thread; j++)
+			{
+				datas.push_back(muggle_slab_allocator_alloc(&allocator, 64));
+			}
+			datas.push_back(muggle_slab_allocator_alloc(&allocator, 1024 * 1024));
+			for (void *data : datas)
+			{
+				muggle_slab_allocator_free(data);
+			}
+		}));
+	}
+	for (auto &t : threads)
+	{
+		t.join();
+	}
+
+	void *data = muggle_slab_allocator_alloc(&allocator, 64);
+	ASSERT_TRUE(data != NULL);
+
+	muggle_pool_stats_t stats;
+	muggle_slab_allocator_get_stats(&allocator, &stats);
+	EXPECT_EQ(stats.alloc_cnt, (uint64_t)cnt_thread * (cnt_per_thread + 1) + 1);
+	EXPECT_EQ(stats.free_cnt, (uint64_t)cnt_thread * (cnt_per_thread + 1));
+	EXPECT_EQ(stats.in_use, 1);
+	EXPECT_GE(stats.capacity, cnt_per_thread);
+	EXPECT_GE(stats.high_water_mark, stats.capacity);
+	EXPECT_GE(stats.grow_cnt, 1u);
+	EXPECT_EQ(stats.fail_cnt, 0u);
+
+	muggle_slab_allocator_free(data);
+	muggle_slab_allocator_destroy(&allocator);
+}
+
+static void pool_stats_collect(const char *name, void *pool, const muggle_pool_stats_t *stats, void *ctx)
+{
+	EXPECT_TRUE(pool != NULL);
+	std::map<std::string, muggle_pool_stats_t> *m = (std::map<std::string, muggle_pool_stats_t>*)ctx;
+	(*m)[name] = *stats;
+}
+
+TEST(pool_stats, registry)
+{
+	muggle_ts_memory_pool_t ts_pool;
+	ASSERT_EQ(muggle_ts_memory_pool_init(&ts_pool, 8, 32), MUGGLE_OK);
+	muggle_memory_pool_t pool;
+	ASSERT_TRUE(muggle_memory_pool_init(&pool, 8, 32));
+
+	ASSERT_EQ(muggle_pool_stats_register(
+		"ts", &ts_pool, (muggle_pool_stats_fn)muggle_ts_memory_pool_get_stats), MUGGLE_OK);
+	ASSERT_EQ(muggle_pool_stats_register(
+		"mp", &pool, (muggle_pool_stats_fn)muggle_memory_pool_get_stats), MUGGLE_OK);
+	EXPECT_NE(muggle_pool_stats_register("null", NULL, NULL), MUGGLE_OK);
+
+	void *p1 = muggle_ts_memory_pool_alloc(&ts_pool);
+	void *p2 = muggle_memory_pool_alloc(&pool);
+	void *p3 = muggle_memory_pool_alloc(&pool);
+
+	std::map<std::string, muggle_pool_stats_t> m;
+	ASSERT_EQ(muggle_pool_stats_foreach(pool_stats_collect, &m), 2);
+	ASSERT_EQ(m.size(), 2u);
+	EXPECT_EQ(m["ts"].in_use, 1);
+	EXPECT_EQ(m["ts"].alloc_cnt, 1u);
+	EXPECT_EQ(m["mp"].in_use, 2);
+	EXPECT_EQ(m["mp"].alloc_cnt, 2u);
+
+	FILE *fp = tmpfile();
+	ASSERT_TRUE(fp != NULL);
+	ASSERT_EQ(muggle_pool_stats_dump(fp), 2);
+	rewind(fp);
+	char line[512];
+	int cnt_line = 0;
+	while (fgets(line, sizeof(line), fp))
+	{
+		EXPECT_TRUE(strstr(line, "pool[ts]") || strstr(line, "pool[mp]"));
+		cnt_line++;
+	}
+	EXPECT_EQ(cnt_line, 2);
+	fclose(fp);
+
+	muggle_pool_stats_unregister(&ts_pool);
+	m.clear();
+	ASSERT_EQ(muggle_pool_stats_foreach(pool_stats_collect, &m), 1);
+	EXPECT_EQ(m.count("ts"), 0u);
+	muggle_pool_stats_unregister(&pool);
+	ASSERT_EQ(muggle_pool_stats_foreach(pool_stats_collect, &m), 0);
+
+	muggle_ts_memory_pool_free(p1);
+	muggle_memory_pool_free(&pool, p2);
+	muggle_memory_pool_free(&pool, p3);
+	muggle_ts_memory_pool_destroy(&ts_pool);
+	muggle_memory_pool_destroy(&pool);
+}
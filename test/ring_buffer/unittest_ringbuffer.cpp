@@ -16,10 +16,13 @@ int r_flags[] = {
 	MUGGLE_RING_BUFFER_FLAG_READ_ALL | MUGGLE_RING_BUFFER_FLAG_READ_WAIT,
 	MUGGLE_RING_BUFFER_FLAG_READ_BUSY_LOOP,
 	MUGGLE_RING_BUFFER_FLAG_SINGLE_READER | MUGGLE_RING_BUFFER_FLAG_READ_WAIT,
-	MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE 
+	MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE,
+	MUGGLE_RING_BUFFER_FLAG_READ_ADAPTIVE,
+	MUGGLE_RING_BUFFER_FLAG_SINGLE_READER | MUGGLE_RING_BUFFER_FLAG_READ_ADAPTIVE
 };
 int invalid_r_flags[] = {
-	MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE | MUGGLE_RING_BUFFER_FLAG_READ_BUSY_LOOP
+	MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE | MUGGLE_RING_BUFFER_FLAG_READ_BUSY_LOOP,
+	MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE | MUGGLE_RING_BUFFER_FLAG_READ_ADAPTIVE
 };
 
 TEST(ring_buffer, usage_utils)
@@ -148,6 +151,268 @@ TEST(ring_buffer, write_read_in_single_thread)
 	}
 }
 
+void test_write_read_n_in_single_thread(int flag)
+{
+	muggle_ring_buffer_t r;
+	muggle_atomic_int capacity = 16;
+	muggle_atomic_int pos = 0;
+	int arr[160];
+	void *in[16];
+	void *out[16];
+
+	muggle_ring_buffer_init(&r, capacity, flag);
+
+	EXPECT_EQ(muggle_ring_buffer_write_n(&r, in, 0), MUGGLE_ERR_INVALID_PARAM);
+	EXPECT_EQ(muggle_ring_buffer_write_n(&r, in, capacity + 1), MUGGLE_ERR_INVALID_PARAM);
+	EXPECT_EQ(muggle_ring_buffer_write_n(&r, in, capacity), MUGGLE_ERR_INVALID_PARAM);
+
+	// the largest batch
+	int val = 0;
+	for (muggle_atomic_int i = 0; i < capacity - 1; ++i)
+	{
+		arr[i] = (int)i;
+		in[i] = &arr[i];
+	}
+	ASSERT_EQ(muggle_ring_buffer_write_n(&r, in, capacity - 1), MUGGLE_OK);
+	ASSERT_EQ(muggle_ring_buffer_read_n(&r, pos, out, capacity), capacity - 1);
+	for (muggle_atomic_int i = 0; i < capacity - 1; ++i)
+	{
+		EXPECT_EQ(*(int*)out[i], (int)i);
+	}
+	pos += capacity - 1;
+	val += (int)capacity - 1;
+
+	// push batches of different size, cross the ring boundary several times
+	for (int loop = 0; loop < 10; ++loop)
+	{
+		muggle_atomic_int cnt = (loop % 7) + 1;
+		for (muggle_atomic_int i = 0; i < cnt; ++i)
+		{
+			arr[val + i] = val + i;
+			in[i] = &arr[val + i];
+		}
+		ASSERT_EQ(muggle_ring_buffer_write_n(&r, in, cnt), MUGGLE_OK);
+
+		// read with a smaller output array first, then drain the rest
+		muggle_atomic_int n = muggle_ring_buffer_read_n(&r, pos, out, 2);
+		ASSERT_EQ(n, cnt < 2 ? cnt : 2);
+		muggle_atomic_int total = n;
+		pos += n;
+		if (total < cnt)
+		{
+			n = muggle_ring_buffer_read_n(&r, pos, out + total, capacity);
+			ASSERT_EQ(n, cnt - total);
+			total += n;
+			pos += n;
+		}
+
+		for (muggle_atomic_int i = 0; i < cnt; ++i)
+		{
+			EXPECT_EQ(*(int*)out[i], val + (int)i);
+		}
+		val += (int)cnt;
+	}
+
+	muggle_ring_buffer_destroy(&r);
+}
+TEST(ring_buffer, write_read_n_in_single_thread)
+{
+	for (int w_flag = 0; w_flag < (int)(sizeof(w_flags) / sizeof(w_flags[0])); ++w_flag)
+	{
+		for (int r_flag = 0; r_flag < (int)(sizeof(r_flags) / sizeof(r_flags[0])); ++r_flag)
+		{
+			test_write_read_n_in_single_thread(w_flags[w_flag] | r_flags[r_flag]);
+		}
+	}
+}
+
+void producer_consumer_n(int flag, int burst, int capacity = 1024 * 16, int total = 10000)
+{
+	muggle_ring_buffer_t r;
+	int *arr = (int*)malloc(sizeof(int) * total);
+	for (int i = 0; i < total; ++i)
+	{
+		arr[i] = i;
+	}
+	muggle_ring_buffer_init(&r, capacity, flag);
+
+	std::thread consumer([&]{
+		std::vector<void*> datas(burst);
+		muggle_atomic_int pos = 0;
+		int recv_idx = 0;
+		while (recv_idx < total)
+		{
+			muggle_atomic_int n = muggle_ring_buffer_read_n(&r, pos, datas.data(), (muggle_atomic_int)burst);
+			ASSERT_GT(n, 0);
+			ASSERT_LE(n, burst);
+			for (muggle_atomic_int i = 0; i < n; ++i)
+			{
+				ASSERT_EQ(*(int*)datas[i], recv_idx);
+				++recv_idx;
+			}
+			pos += n;
+		}
+	});
+
+	std::vector<void*> datas(burst);
+	for (int i = 0; i < total; i += burst)
+	{
+		int cnt = total - i < burst ? total - i : burst;
+		for (int j = 0; j < cnt; ++j)
+		{
+			datas[j] = &arr[i + j];
+		}
+		muggle_ring_buffer_write_n(&r, datas.data(), (muggle_atomic_int)cnt);
+	}
+
+	consumer.join();
+
+	muggle_ring_buffer_destroy(&r);
+	free(arr);
+}
+
+TEST(ring_buffer, one_producer_one_consumer_n)
+{
+	// capacity is larger than total, so no message will be overwritten
+	int bursts[] = { 1, 7, 64 };
+	for (int w_flag = 0; w_flag < (int)(sizeof(w_flags) / sizeof(w_flags[0])); ++w_flag)
+	{
+		for (int r_flag = 0; r_flag < (int)(sizeof(r_flags) / sizeof(r_flags[0])); ++r_flag)
+		{
+			for (int b = 0; b < (int)(sizeof(bursts) / sizeof(bursts[0])); ++b)
+			{
+				producer_consumer_n(w_flags[w_flag] | r_flags[r_flag], bursts[b]);
+			}
+		}
+	}
+}
+
+TEST(ring_buffer, wake_parked_reader)
+{
+	int flags[] = {
+		MUGGLE_RING_BUFFER_FLAG_READ_WAIT,
+		MUGGLE_RING_BUFFER_FLAG_SINGLE_READER | MUGGLE_RING_BUFFER_FLAG_READ_WAIT,
+		MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE,
+		MUGGLE_RING_BUFFER_FLAG_READ_ADAPTIVE
+	};
+	for (int i = 0; i < (int)(sizeof(flags) / sizeof(flags[0])); ++i)
+	{
+		muggle_ring_buffer_t r;
+		muggle_ring_buffer_init(&r, 16, flags[i]);
+		muggle_ring_buffer_set_adaptive_wait(&r, 0, 0);
+
+		int val = 5;
+		std::thread reader([&r]{
+			for (muggle_atomic_int pos = 0; pos < 2; ++pos)
+			{
+				int *data = (int*)muggle_ring_buffer_read(&r, pos);
+				ASSERT_EQ(*data, 5);
+			}
+		});
+
+		// let reader park before every write
+		for (int j = 0; j < 2; ++j)
+		{
+			while (muggle_atomic_load(&r.read_waiters, muggle_memory_order_acquire) == 0)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+			muggle_ring_buffer_write(&r, &val);
+		}
+
+		reader.join();
+		muggle_ring_buffer_destroy(&r);
+	}
+}
+
+TEST(ring_buffer, try_read_and_timeout)
+{
+	int flags[] = {
+		MUGGLE_RING_BUFFER_FLAG_READ_WAIT,
+		MUGGLE_RING_BUFFER_FLAG_READ_BUSY_LOOP,
+		MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE,
+		MUGGLE_RING_BUFFER_FLAG_READ_ADAPTIVE
+	};
+	for (int i = 0; i < (int)(sizeof(flags) / sizeof(flags[0])); ++i)
+	{
+		muggle_ring_buffer_t r;
+		muggle_ring_buffer_init(&r, 16, flags[i]);
+
+		void *data = NULL;
+		EXPECT_EQ(muggle_ring_buffer_try_read(&r, 0, &data), MUGGLE_ERR_EMPTY);
+
+		struct timespec t1, t2, deadline;
+		muggle_deadline_now(&t1);
+		muggle_deadline_after(&deadline, 10);
+		EXPECT_EQ(muggle_ring_buffer_read_timed(&r, 0, &deadline, &data), MUGGLE_ERR_TIMEOUT);
+		muggle_deadline_now(&t2);
+		int64_t elapsed_ms = (t2.tv_sec - t1.tv_sec) * 1000 + (t2.tv_nsec - t1.tv_nsec) / 1000000;
+		EXPECT_GE(elapsed_ms, 9);
+
+		int val = 5;
+		muggle_ring_buffer_write(&r, &val);
+		ASSERT_EQ(muggle_ring_buffer_try_read(&r, 0, &data), MUGGLE_OK);
+		EXPECT_EQ(*(int*)data, 5);
+
+		muggle_ring_buffer_destroy(&r);
+	}
+}
+
+TEST(ring_buffer, timed_read_race_with_write)
+{
+	int flags[] = {
+		MUGGLE_RING_BUFFER_FLAG_READ_WAIT,
+		MUGGLE_RING_BUFFER_FLAG_SINGLE_READER | MUGGLE_RING_BUFFER_FLAG_READ_WAIT,
+		MUGGLE_RING_BUFFER_FLAG_MSG_READ_ONCE,
+		MUGGLE_RING_BUFFER_FLAG_READ_ADAPTIVE
+	};
+	for (int i = 0; i < (int)(sizeof(flags) / sizeof(flags[0])); ++i)
+	{
+		const int cnt = 200;
+		std::vector<int> vals(cnt);
+		muggle_ring_buffer_t r;
+		muggle_ring_buffer_init(&r, 1024, flags[i]);
+		muggle_ring_buffer_set_adaptive_wait(&r, 0, 0);
+
+		// writer write around reader's deadline, every message must be read
+		// exactly once, either before or after timeout
+		std::thread writer([&]{
+			for (int j = 0; j < cnt; ++j)
+			{
+				vals[j] = j;
+				std::this_thread::sleep_for(std::chrono::microseconds(j % 3 * 500));
+				muggle_ring_buffer_write(&r, &vals[j]);
+			}
+		});
+
+		int timeout_cnt = 0;
+		for (muggle_atomic_int pos = 0; pos < cnt;)
+		{
+			struct timespec deadline;
+			muggle_deadline_after(&deadline, 1);
+
+			void *data = NULL;
+			int ret = muggle_ring_buffer_read_timed(&r, pos, &deadline, &data);
+			if (ret == MUGGLE_ERR_TIMEOUT)
+			{
+				timeout_cnt++;
+				continue;
+			}
+			ASSERT_EQ(ret, MUGGLE_OK);
+			ASSERT_EQ(*(int*)data, (int)pos);
+			pos++;
+		}
+
+		writer.join();
+
+		void *data = NULL;
+		EXPECT_EQ(muggle_ring_buffer_try_read(&r, cnt, &data), MUGGLE_ERR_EMPTY);
+		EXPECT_EQ(r.read_waiters, 0);
+
+		muggle_ring_buffer_destroy(&r);
+	}
+}
+
 void producer_consumer(int flag, int cnt_producer, int cnt_consumer, int cnt_interval, int interval_ms,
 	int capacity = 1024 * 2, int total = 10000)
 {
@@ -0,0 +1,145 @@
+#include <thread>
+#include <vector>
+#include <string.h>
+#include "gtest/gtest.h"
+#include "muggle/c/muggle_c.h"
+
+TEST(slab_allocator, size_class)
+{
+	EXPECT_EQ(muggle_slab_allocator_size_class(0), 0);
+	EXPECT_EQ(muggle_slab_allocator_size_class(1), 0);
+	EXPECT_EQ(muggle_slab_allocator_size_class(16), 0);
+	EXPECT_EQ(muggle_slab_allocator_size_class(17), 1);
+	EXPECT_EQ(muggle_slab_allocator_size_class(32), 1);
+	EXPECT_EQ(muggle_slab_allocator_size_class(1024), 6);
+	EXPECT_EQ(muggle_slab_allocator_size_class(1 << MUGGLE_SLAB_MAX_SHIFT), MUGGLE_SLAB_NUM_CLASS - 1);
+	EXPECT_EQ(muggle_slab_allocator_size_class((1 << MUGGLE_SLAB_MAX_SHIFT) + 1), MUGGLE_SLAB_LARGE_CLASS);
+}
+
+TEST(slab_allocator, single_thread)
+{
+	muggle_slab_allocator_t allocator;
+	ASSERT_EQ(muggle_slab_allocator_init(&allocator), MUGGLE_OK);
+
+	size_t sizes[] = {1, 16, 100, 512, 4096, 65536, 100000};
+	std::vector<void*> datas;
+	for (int round = 0; round < 300; round++)
+	{
+		for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+		{
+			unsigned char *p = (unsigned char*)muggle_slab_allocator_alloc(&allocator, sizes[i]);
+			ASSERT_TRUE(p != NULL);
+			EXPECT_EQ((uintptr_t)p % sizeof(void*), 0u);
+
+			muggle_slab_block_head_t *head = (muggle_slab_block_head_t*)p - 1;
+			EXPECT_EQ(head->allocator, &allocator);
+			EXPECT_EQ(head->size_class, muggle_slab_allocator_size_class(sizes[i]));
+
+			memset(p, (int)i, sizes[i]);
+			datas.push_back(p);
+		}
+	}
+
+	// no block overlap
+	for (size_t i = 0; i < datas.size(); i++)
+	{
+		size_t idx = i % (sizeof(sizes) / sizeof(sizes[0]));
+		unsigned char *p = (unsigned char*)datas[i];
+		ASSERT_EQ(p[0], (unsigned char)idx);
+		ASSERT_EQ(p[sizes[idx] - 1], (unsigned char)idx);
+	}
+
+	for (void *p : datas)
+	{
+		muggle_slab_allocator_free(p);
+	}
+
+	// reuse cached block
+	void *p = muggle_slab_allocator_alloc(&allocator, 100);
+	EXPECT_EQ(p, datas[datas.size() - 1 - 4]);
+	muggle_slab_allocator_free(p);
+
+	muggle_slab_allocator_flush(&allocator);
+	muggle_slab_allocator_destroy(&allocator);
+}
+
+TEST(slab_allocator, cross_thread_free)
+{
+	int cnt_thread = (int)std::thread::hardware_concurrency();
+	if (cnt_thread < 2)
+	{
+		cnt_thread = 2;
+	}
+	const int cnt_per_thread = 20000;
+
+	muggle_slab_allocator_t allocator;
+	ASSERT_EQ(muggle_slab_allocator_init(&allocator), MUGGLE_OK);
+
+	// thread i allocate, thread i+1 free
+	std::vector<muggle_channel_t> chans(cnt_thread);
+	for (int i = 0; i < cnt_thread; i++)
+	{
+		ASSERT_EQ(muggle_channel_init(&chans[i], 1024, 0), MUGGLE_OK);
+	}
+
+	std::vector<int> err_cnt(cnt_thread, 0);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < cnt_thread; t++)
+	{
+		threads.push_back(std::thread([&, t]{
+			std::thread consumer([&, t]{
+				int n = 0;
+				while (n < cnt_per_thread)
+				{
+					int *p = (int*)muggle_channel_read(&chans[t]);
+					if (p == NULL)
+					{
+						continue;
+					}
+					size_t size = (size_t)p[0];
+					if (((unsigned char*)p)[size - 1] != (unsigned char)t)
+					{
+						err_cnt[t]++;
+					}
+					muggle_slab_allocator_free(p);
+					n++;
+				}
+			});
+
+			for (int i = 0; i < cnt_per_thread; i++)
+			{
+				size_t size = 8 + (size_t)(i * 37) % 3000;
+				int *p = (int*)muggle_slab_allocator_alloc(&allocator, size);
+				if (p == NULL)
+				{
+					err_cnt[t]++;
+					continue;
+				}
+				p[0] = (int)size;
+				((unsigned char*)p)[size - 1] = (unsigned char)t;
+				while (muggle_channel_write(&chans[t], p) != MUGGLE_OK)
+				{
+					muggle_thread_yield();
+				}
+			}
+
+			consumer.join();
+		}));
+	}
+
+	for (auto &t : threads)
+	{
+		t.join();
+	}
+
+	for (int t = 0; t < cnt_thread; t++)
+	{
+		EXPECT_EQ(err_cnt[t], 0);
+		muggle_channel_destroy(&chans[t]);
+	}
+
+	// thread caches flushed at thread exit
+	EXPECT_TRUE(allocator.caches == NULL);
+
+	muggle_slab_allocator_destroy(&allocator);
+}
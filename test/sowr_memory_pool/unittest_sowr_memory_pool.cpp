@@ -163,3 +163,128 @@ TEST(sowr_memory_pool, mul_pool_alloc_free)
 	loss_producer.join();
 	normal_producer.join();
 }
+
+TEST(sowr_memory_pool, multi_free_out_of_order)
+{
+	muggle_atomic_int capacity = 8;
+
+	muggle_sowr_memory_pool_t pool;
+	ASSERT_EQ(muggle_sowr_memory_pool_init_ex(&pool, capacity, sizeof(sowr_data),
+		MUGGLE_SOWR_MEMORY_POOL_FLAG_MULTI_FREE), MUGGLE_OK);
+
+	sowr_data *arr[8];
+	for (int i = 0; i < capacity - 1; ++i)
+	{
+		arr[i] = (sowr_data*)muggle_sowr_memory_pool_alloc(&pool);
+		ASSERT_TRUE(arr[i] != NULL);
+	}
+	ASSERT_TRUE(muggle_sowr_memory_pool_alloc(&pool) == NULL);
+
+	// free later blocks first, oldest block still in use stall reclaim
+	for (int i = capacity - 2; i > 0; --i)
+	{
+		muggle_sowr_memory_pool_free(arr[i]);
+	}
+	ASSERT_FALSE(muggle_sowr_memory_pool_is_all_free(&pool));
+	ASSERT_TRUE(muggle_sowr_memory_pool_alloc(&pool) == NULL);
+
+	// free oldest, all blocks reclaimed
+	muggle_sowr_memory_pool_free(arr[0]);
+	ASSERT_TRUE(muggle_sowr_memory_pool_is_all_free(&pool));
+	for (int i = 0; i < capacity - 1; ++i)
+	{
+		arr[i] = (sowr_data*)muggle_sowr_memory_pool_alloc(&pool);
+		ASSERT_TRUE(arr[i] != NULL);
+		muggle_sowr_block_head_t *head = (muggle_sowr_block_head_t*)arr[i] - 1;
+		ASSERT_EQ(head->released, 0);
+	}
+	ASSERT_TRUE(muggle_sowr_memory_pool_alloc(&pool) == NULL);
+
+	for (int i = 0; i < capacity - 1; ++i)
+	{
+		muggle_sowr_memory_pool_free(arr[i]);
+	}
+	ASSERT_TRUE(muggle_sowr_memory_pool_is_all_free(&pool));
+
+	muggle_sowr_memory_pool_destroy(&pool);
+}
+
+TEST(sowr_memory_pool, multi_free_mul_consumer)
+{
+	int cnt_consumer = (int)std::thread::hardware_concurrency();
+	if (cnt_consumer < 2)
+	{
+		cnt_consumer = 2;
+	}
+	const int cnt = 1024 * 100;
+
+	muggle_sowr_memory_pool_t pool;
+	ASSERT_EQ(muggle_sowr_memory_pool_init_ex(&pool, 1024, sizeof(sowr_data),
+		MUGGLE_SOWR_MEMORY_POOL_FLAG_MULTI_FREE), MUGGLE_OK);
+
+	muggle_channel_t chan;
+	ASSERT_EQ(muggle_channel_init(&chan, 1024 * 4, MUGGLE_CHANNEL_FLAG_MULTI_READER), MUGGLE_OK);
+
+	std::vector<int> recv_cnt(cnt_consumer, 0);
+	std::vector<std::thread> consumers;
+	for (int c = 0; c < cnt_consumer; ++c)
+	{
+		consumers.push_back(std::thread([&, c]{
+			while (true)
+			{
+				sowr_data *p = (sowr_data*)muggle_channel_read(&chan);
+				if (p == NULL)
+				{
+					continue;
+				}
+				if (p->is_end)
+				{
+					muggle_sowr_memory_pool_free(p);
+					break;
+				}
+
+				// hold some messages longer, release out of order
+				if (p->idx % 7 == 0)
+				{
+					std::this_thread::yield();
+				}
+				recv_cnt[c]++;
+				muggle_sowr_memory_pool_free(p);
+			}
+		}));
+	}
+
+	for (int i = 0; i < cnt + cnt_consumer; ++i)
+	{
+		sowr_data *data = (sowr_data*)muggle_sowr_memory_pool_alloc(&pool);
+		while (data == NULL)
+		{
+			muggle_thread_yield();
+			data = (sowr_data*)muggle_sowr_memory_pool_alloc(&pool);
+		}
+		data->info = 0;
+		data->idx = i;
+		data->is_end = i >= cnt ? 1 : 0;
+
+		while (muggle_channel_write(&chan, data) != MUGGLE_OK)
+		{
+			muggle_thread_yield();
+		}
+	}
+
+	for (auto &t : consumers)
+	{
+		t.join();
+	}
+
+	int total = 0;
+	for (int c = 0; c < cnt_consumer; ++c)
+	{
+		total += recv_cnt[c];
+	}
+	EXPECT_EQ(total, cnt);
+	EXPECT_TRUE(muggle_sowr_memory_pool_is_all_free(&pool));
+
+	muggle_channel_destroy(&chan);
+	muggle_sowr_memory_pool_destroy(&pool);
+}
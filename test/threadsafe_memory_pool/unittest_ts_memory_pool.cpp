@@ -148,7 +148,7 @@ TEST(ts_memory_pool, mul_thread)
 	free(datas);
 }
 
-TEST(ts_memory_pool, busy_alloc_free)
+static void test_busy_alloc_free(int flags)
 {
 	muggle_atomic_int capacity = 1024;
 	int msg_cnt = (int)capacity * 512;
@@ -173,7 +173,7 @@ TEST(ts_memory_pool, busy_alloc_free)
 	}
 
 	muggle_ts_memory_pool_t pool;
-	muggle_ts_memory_pool_init(&pool, capacity, sizeof(ts_data));
+	muggle_ts_memory_pool_init_ex(&pool, capacity, sizeof(ts_data), flags);
 
 	// run allocate threads
 	std::vector<std::thread> alloc_threads;
@@ -260,3 +260,158 @@ TEST(ts_memory_pool, busy_alloc_free)
 	muggle_ts_memory_pool_destroy(&pool);
 	free(datas);
 }
+
+TEST(ts_memory_pool, busy_alloc_free)
+{
+	test_busy_alloc_free(MUGGLE_TS_MEMORY_POOL_FLAG_MUTEX);
+}
+
+TEST(ts_memory_pool, busy_alloc_free_fast_mutex)
+{
+	test_busy_alloc_free(MUGGLE_TS_MEMORY_POOL_FLAG_FAST_MUTEX);
+}
+
+TEST(ts_memory_pool, busy_alloc_free_growable)
+{
+	test_busy_alloc_free(MUGGLE_TS_MEMORY_POOL_FLAG_GROWABLE);
+}
+
+TEST(ts_memory_pool, stats)
+{
+	muggle_ts_memory_pool_t pool;
+	ASSERT_EQ(muggle_ts_memory_pool_init(&pool, 8, sizeof(ts_data)), MUGGLE_OK);
+
+	ts_data *arr[8];
+	for (int i = 0; i < 8; i++)
+	{
+		arr[i] = (ts_data*)muggle_ts_memory_pool_alloc(&pool);
+		ASSERT_TRUE(arr[i] != NULL);
+	}
+	ASSERT_TRUE(muggle_ts_memory_pool_alloc(&pool) == NULL);
+	for (int i = 0; i < 4; i++)
+	{
+		muggle_ts_memory_pool_free(arr[i]);
+	}
+
+	muggle_pool_stats_t stats;
+	muggle_ts_memory_pool_get_stats(&pool, &stats);
+	EXPECT_EQ(stats.capacity, 8);
+	EXPECT_EQ(stats.grow_cnt, 0u);
+	EXPECT_EQ(stats.in_use, 4);
+	EXPECT_EQ(stats.high_water_mark, 8);
+	EXPECT_EQ(stats.fail_cnt, 1u);
+	EXPECT_EQ(stats.alloc_cnt, 8u);
+	EXPECT_EQ(stats.free_cnt, 4u);
+
+	for (int i = 4; i < 8; i++)
+	{
+		muggle_ts_memory_pool_free(arr[i]);
+	}
+	muggle_ts_memory_pool_destroy(&pool);
+}
+
+TEST(ts_memory_pool, growable_single_thread)
+{
+	muggle_ts_memory_pool_t pool;
+	ASSERT_EQ(muggle_ts_memory_pool_init_ex(
+		&pool, 8, sizeof(ts_data), MUGGLE_TS_MEMORY_POOL_FLAG_GROWABLE), MUGGLE_OK);
+
+	const int cnt = 8 * 5;
+	ts_data *arr[cnt];
+	for (int i = 0; i < cnt; i++)
+	{
+		arr[i] = (ts_data*)muggle_ts_memory_pool_alloc(&pool);
+		ASSERT_TRUE(arr[i] != NULL);
+		arr[i]->idx = i;
+	}
+	for (int i = 0; i < cnt; i++)
+	{
+		ASSERT_EQ(arr[i]->idx, i);
+	}
+
+	muggle_pool_stats_t stats;
+	muggle_ts_memory_pool_get_stats(&pool, &stats);
+	EXPECT_EQ(stats.capacity, cnt);
+	EXPECT_EQ(stats.grow_cnt, 4u);
+	EXPECT_EQ(stats.in_use, cnt);
+	EXPECT_EQ(stats.high_water_mark, cnt);
+	EXPECT_EQ(stats.fail_cnt, 0u);
+
+	// recycled blocks are reused before growing
+	for (int i = 0; i < cnt; i++)
+	{
+		muggle_ts_memory_pool_free(arr[i]);
+	}
+	for (int i = 0; i < cnt; i++)
+	{
+		arr[i] = (ts_data*)muggle_ts_memory_pool_alloc(&pool);
+		ASSERT_TRUE(arr[i] != NULL);
+	}
+	muggle_ts_memory_pool_get_stats(&pool, &stats);
+	EXPECT_EQ(stats.grow_cnt, 4u);
+	EXPECT_EQ(stats.fail_cnt, 0u);
+
+	for (int i = 0; i < cnt; i++)
+	{
+		muggle_ts_memory_pool_free(arr[i]);
+	}
+	muggle_ts_memory_pool_get_stats(&pool, &stats);
+	EXPECT_EQ(stats.in_use, 0);
+
+	muggle_ts_memory_pool_destroy(&pool);
+}
+
+TEST(ts_memory_pool, growable_mul_thread)
+{
+	muggle_ts_memory_pool_t pool;
+	ASSERT_EQ(muggle_ts_memory_pool_init_ex(
+		&pool, 16, sizeof(ts_data), MUGGLE_TS_MEMORY_POOL_FLAG_GROWABLE), MUGGLE_OK);
+
+	int hc = (int)std::thread::hardware_concurrency() * 2;
+	if (hc <= 0)
+	{
+		hc = 4;
+	}
+	const int cnt_per_thread = 256;
+	const int round = 100;
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < hc; i++)
+	{
+		threads.push_back(std::thread([&pool, i, cnt_per_thread, round]{
+			std::vector<ts_data*> datas(cnt_per_thread, nullptr);
+			for (int r = 0; r < round; r++)
+			{
+				for (int j = 0; j < cnt_per_thread; j++)
+				{
+					datas[j] = (ts_data*)muggle_ts_memory_pool_alloc(&pool);
+					ASSERT_TRUE(datas[j] != nullptr);
+					datas[j]->idx = j;
+					datas[j]->thread_idx = i;
+				}
+				for (int j = 0; j < cnt_per_thread; j++)
+				{
+					ASSERT_EQ(datas[j]->idx, j);
+					ASSERT_EQ(datas[j]->thread_idx, i);
+					muggle_ts_memory_pool_free(datas[j]);
+				}
+			}
+		}));
+	}
+	for (auto &t : threads)
+	{
+		t.join();
+	}
+
+	muggle_pool_stats_t stats;
+	muggle_ts_memory_pool_get_stats(&pool, &stats);
+	EXPECT_EQ(stats.in_use, 0);
+	EXPECT_LE(stats.high_water_mark, hc * cnt_per_thread);
+	EXPECT_GE(stats.capacity, stats.high_water_mark);
+	EXPECT_EQ(stats.capacity, 16 * (int64_t)(stats.grow_cnt + 1));
+	EXPECT_EQ(stats.fail_cnt, 0u);
+	EXPECT_EQ(stats.alloc_cnt, (uint64_t)hc * cnt_per_thread * round);
+	EXPECT_EQ(stats.free_cnt, stats.alloc_cnt);
+
+	muggle_ts_memory_pool_destroy(&pool);
+}